@@ -12,6 +12,7 @@
 #include <DrvAPIAllocator.hpp>
 #include <DrvAPIGlobal.hpp>
 #include <DrvAPIOp.hpp>
+#include <DrvAPIBarrier.hpp>
 #include <DrvAPISysConfig.hpp>
 #include <DrvAPIInfo.hpp>
 #include <DrvAPIMain.hpp>
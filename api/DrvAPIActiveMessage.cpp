@@ -0,0 +1,15 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+
+#include "DrvAPIActiveMessage.hpp"
+
+extern "C"
+__attribute__((visibility("default")))
+void DrvAPIActiveMessageExecute(DrvAPI::DrvAPIFunctionTypeId id, void *data, DrvAPI::DrvAPIActiveMessageContext *ctx)
+{
+    DrvAPI::DrvAPIActiveMessageContext *&current = DrvAPI::detail::active_message_context();
+    current = ctx;
+    std::unique_ptr<DrvAPI::DrvAPIFunction> fn(DrvAPI::DrvAPIFunction::FromIDAndBuffer(id, data));
+    fn->execute();
+    current = nullptr;
+}
@@ -0,0 +1,179 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+
+#ifndef DRV_API_ACTIVE_MESSAGE_H
+#define DRV_API_ACTIVE_MESSAGE_H
+#include <DrvAPIAddress.hpp>
+#include <DrvAPIFunction.hpp>
+#include <DrvAPIMemory.hpp>
+#include <DrvAPIThread.hpp>
+#include <memory>
+#include <type_traits>
+#include <utility>
+namespace DrvAPI
+{
+
+/**
+ * @brief The view of memory given to an active message
+ *
+ * An active message runs on the memory controller that owns its target
+ * address. It may only access memory owned by that same controller,
+ * e.g. the same L1SP, or the same L2SP/DRAM bank for interleaved memory.
+ * Accesses complete immediately and are not cached.
+ */
+class DrvAPIActiveMessageContext
+{
+public:
+  virtual ~DrvAPIActiveMessageContext() {}
+
+  /**
+   * @brief the absolute address the message was sent to
+   */
+  virtual DrvAPIAddress address() const = 0;
+
+  /**
+   * @brief read size bytes at address into p
+   */
+  virtual void read(DrvAPIAddress address, void *p, std::size_t size) = 0;
+
+  /**
+   * @brief write size bytes from p to address
+   */
+  virtual void write(DrvAPIAddress address, const void *p, std::size_t size) = 0;
+
+  /**
+   * @brief set the value returned to the sender
+   */
+  virtual void setResult(const void *p, std::size_t size) = 0;
+
+  /**
+   * @brief read a T at address
+   */
+  template <typename T>
+  T load(DrvAPIAddress address) {
+      T value;
+      read(address, &value, sizeof(T));
+      return value;
+  }
+
+  /**
+   * @brief write a T to address
+   */
+  template <typename T>
+  void store(DrvAPIAddress address, T value) {
+      write(address, &value, sizeof(T));
+  }
+};
+
+/**
+ * @brief signature of the executor the simulator looks up in the application
+ */
+typedef void (*DrvAPIActiveMessageExecute_t)(DrvAPIFunctionTypeId id, void *data, DrvAPIActiveMessageContext *ctx);
+
+namespace detail
+{
+/**
+ * @brief the context of the active message being executed
+ */
+inline DrvAPIActiveMessageContext *&active_message_context()
+{
+    static thread_local DrvAPIActiveMessageContext *ctx = nullptr;
+    return ctx;
+}
+
+/**
+ * @brief wraps a functor taking a context so that it can be a DrvAPIFunction
+ */
+template <typename F, typename R>
+struct active_message {
+    F f;
+    void operator()() {
+        DrvAPIActiveMessageContext *ctx = active_message_context();
+        R r = f(*ctx);
+        ctx->setResult(&r, sizeof(R));
+    }
+};
+
+template <typename F>
+struct active_message<F, void> {
+    F f;
+    void operator()() {
+        f(*active_message_context());
+    }
+};
+
+template <typename F>
+using active_message_result_t = decltype(std::declval<F&>()(std::declval<DrvAPIActiveMessageContext&>()));
+
+/**
+ * @brief bytes returned by an active message with result R
+ */
+template <typename R>
+struct active_message_result_size : std::integral_constant<std::size_t, sizeof(R)> {};
+
+template <>
+struct active_message_result_size<void> : std::integral_constant<std::size_t, 0> {};
+
+/**
+ * @brief ship f to address and block until it has run
+ */
+template <typename F>
+void execute_at(DrvAPIAddress address, const F &f)
+{
+    typedef active_message<F, active_message_result_t<F>> am_type;
+    static_assert(std::is_trivially_copyable<F>::value, "execute_at: functor must be trivially copyable");
+    static_assert(sizeof(am_type) <= DrvAPIThreadState::MAX_PAYLOAD_SIZE, "execute_at: functor too large");
+    DrvAPIFunctionConcrete<am_type> fn(am_type{f});
+    DrvAPIThread *thread = DrvAPIThread::current();
+    thread->getState().setActiveMessage(detail::to_absolute(thread, address)
+                                        ,fn.getFunctionTypeId()
+                                        ,&fn.f_
+                                        ,sizeof(am_type)
+                                        ,active_message_result_size<active_message_result_t<F>>::value);
+    thread->yield();
+}
+
+template <typename R>
+struct active_message_return {
+    static R get() { return DrvAPIThread::current()->getState().result<R>(); }
+};
+
+template <>
+struct active_message_return<void> {
+    static void get() {}
+};
+} // namespace detail
+
+/**
+ * @brief run f at the memory that owns address
+ *
+ * f is called as f(DrvAPIActiveMessageContext &ctx) on the memory
+ * controller that owns address, and its return value (if any) is returned
+ * to the caller. f travels as a single custom request, so a read-modify-write
+ * sequence on remote memory costs one round trip.
+ *
+ * f must be trivially copyable and captures plus result must each fit in
+ * DrvAPIThreadState::MAX_PAYLOAD_SIZE bytes.
+ */
+template <typename F>
+detail::active_message_result_t<F> execute_at(DrvAPIAddress address, const F &f)
+{
+    typedef detail::active_message_result_t<F> R;
+    static_assert(detail::active_message_result_size<R>::value <= DrvAPIThreadState::MAX_PAYLOAD_SIZE,
+                  "execute_at: result too large");
+    detail::execute_at(address, f);
+    return detail::active_message_return<R>::get();
+}
+
+} // namespace DrvAPI
+
+/**
+ * @brief run an active message on behalf of the simulator
+ *
+ * Looked up by name in the application executable. Defined once, in
+ * DrvAPIActiveMessage.cpp, which is built into every application.
+ */
+extern "C"
+__attribute__((visibility("default")))
+void DrvAPIActiveMessageExecute(DrvAPI::DrvAPIFunctionTypeId id, void *data, DrvAPI::DrvAPIActiveMessageContext *ctx);
+#endif
@@ -3,7 +3,10 @@
 #ifndef DRV_API_ADDRESS_TO_NATIVE_HPP
 #define DRV_API_ADDRESS_TO_NATIVE_HPP
 #include <DrvAPIAddress.hpp>
+#include <algorithm>
 #include <cstddef>
+#include <iterator>
+#include <stdexcept>
 namespace DrvAPI
 {
 /**
@@ -23,5 +26,103 @@ namespace DrvAPI
  * @param the number of valid bytes starting at the native pointer
  */
 void DrvAPIAddressToNative(DrvAPIAddress address, void **native, std::size_t *size);
+
+/**
+ * @brief A contiguous run of native memory backing part of a simulator address range
+ */
+struct native_run {
+    DrvAPIAddress address; //!< simulator address of the first byte
+    char *data;            //!< native pointer to the first byte
+    std::size_t size;      //!< bytes in the run
+};
+
+/**
+ * @brief Iterate over a simulator address range as contiguous native runs
+ *
+ * Interleaved memories are backed by one buffer per bank, so a range is split
+ * where it crosses into another bank's buffer; chunks that are adjacent in
+ * native memory are merged into one run. Same caveats as DrvAPIAddressToNative().
+ *
+ *   for (native_run run : native_span(addr, size))
+ *       std::memcpy(run.data, src + (run.address - addr), run.size);
+ */
+class native_span
+{
+public:
+    class iterator
+    {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef native_run value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const native_run *pointer;
+        typedef const native_run &reference;
+
+        iterator(DrvAPIAddress address, std::size_t size)
+            : next_(address), remaining_(size) {
+            advance();
+        }
+
+        reference operator*() const { return run_; }
+        pointer operator->() const { return &run_; }
+        iterator &operator++() { advance(); return *this; }
+        iterator operator++(int) { iterator tmp = *this; advance(); return tmp; }
+        bool operator==(const iterator &other) const {
+            return run_.address == other.run_.address && run_.size == other.run_.size;
+        }
+        bool operator!=(const iterator &other) const { return !(*this == other); }
+
+    private:
+        /**
+         * @brief translate next_ and take min(size, remaining_) bytes
+         */
+        std::size_t translate(char **data) {
+            void *native = nullptr;
+            std::size_t size = 0;
+            DrvAPIAddressToNative(next_, &native, &size);
+            if (size == 0) {
+                throw std::runtime_error("native_span: address has no native backing");
+            }
+            *data = static_cast<char*>(native);
+            return std::min(size, remaining_);
+        }
+
+        void advance() {
+            run_ = native_run{next_, nullptr, 0};
+            if (remaining_ == 0) {
+                return;
+            }
+            std::size_t size = translate(&run_.data);
+            do {
+                run_.size += size;
+                next_ += size;
+                remaining_ -= size;
+                if (remaining_ == 0) {
+                    break;
+                }
+                char *data = nullptr;
+                size = translate(&data);
+                if (data != run_.data + run_.size) {
+                    break;
+                }
+            } while (true);
+        }
+
+        DrvAPIAddress next_;    //!< first address after the current run
+        std::size_t remaining_; //!< bytes after the current run
+        native_run run_;        //!< the current run
+    };
+
+    native_span(DrvAPIAddress address, std::size_t size)
+        : address_(address), size_(size) {
+    }
+
+    iterator begin() const { return iterator(address_, size_); }
+    iterator end() const { return iterator(address_ + size_, 0); }
+
+private:
+    DrvAPIAddress address_; //!< first address of the range
+    std::size_t size_;      //!< bytes in the range
+};
 }
 #endif
@@ -111,14 +111,14 @@ public:
 struct lock_guard {
 public:
     lock_guard(pointer<lock_t> lock) : lock(lock) {
-        int cycles = 16;
         while (atomic_cas(lock, 0, 1) != 0) {
-            DrvAPI::wait(cycles);
+            DrvAPI::wait_until<lock_t>(lock, 0);
         }
     }
     ~lock_guard() {
         DrvAPI::fence();
-        *lock = 0;
+        // release with an atomic so that it reaches the waiters' memory
+        atomic_swap<lock_t>(lock, 0);
     }
 
 private:
@@ -139,12 +139,12 @@ void do_once(pointer<status_t> status, F && f) {
     if (s == STATUS_UNINIT) {
         f();
         DrvAPI::fence();
-        *status = s = STATUS_INIT;
+        atomic_swap<status_t>(status, STATUS_INIT);
+        s = STATUS_INIT;
     }
     // wait for init to complete
-    while (s != STATUS_INIT) {
-        DrvAPI::wait(32);
-        s = *status;
+    if (s != STATUS_INIT) {
+        DrvAPI::wait_until<status_t>(status, STATUS_INIT);
     }
 }
 
@@ -237,9 +237,11 @@ namespace allocator {
 class slab_allocator {
 public:
     FIELD(bump_allocator, bump_alloc, bump_alloc_)
+    FIELD(address_t, base, base_)
     template <typename Dst, typename Src>
     static void copy(Dst &dst, const Src &src) {
         dst.bump_alloc() = src.bump_alloc();
+        dst.base() = src.base();
     }
 };
 } // namespace allocator
@@ -248,6 +250,7 @@ template <>
 class value_handle<slab_allocator> {
     DRV_API_VALUE_HANDLE_DEFAULTS(slab_allocator)
     DRV_API_VALUE_HANDLE_FIELD(slab_allocator, bump_alloc, allocator::bump_allocator, bump_alloc_)
+    DRV_API_VALUE_HANDLE_FIELD(slab_allocator, base, address_t, base_) // absolute base of the memory
     void init(memtype_t type) {
         using namespace allocator;
         DrvAPISection &section = DrvAPI::DrvAPISection::GetSection(type);
@@ -257,6 +260,7 @@ class value_handle<slab_allocator> {
         // make a global address
         address_t localBase = section.getBase(myPXNId(), myPodId(), myCoreId());
         address_t globalBase = toAbsoluteAddress(localBase);
+        base() = globalBase;
         bump_alloc().init(globalBase+sz, getMemSize(type)-sz);
     }
 
@@ -493,6 +497,9 @@ class value_handle<block_allocator> {
         block.footer() = size;
         block.next() = block.address();
         block.prev() = block.address();
+        // the extra word is a sentinel header: never free, so coalescing stops here
+        block.successor().info() = 0;
+        block.successor().is_predecessor_free() = true;
         return block.address();
     }
 
@@ -630,6 +637,8 @@ public:
             if (!free_block.successor().is_free()) {
                 // do not coalesce
                 free_block.is_free() = true;
+                // the footer was part of the payload while allocated
+                free_block.footer() = free_block.size();
                 free_block.successor().is_predecessor_free() = true;
                 if (empty()) {
                     free_block.next() = free_block.address();
@@ -702,165 +711,99 @@ public:
     }
 };
 
-//////////////////////////
-// FIXED SIZE ALLOCATOR //
-//////////////////////////
+////////////////////////
+// SIZE CLASS OBJECTS //
+////////////////////////
 namespace allocator {
 /**
- * allocator for fixed size objects
+ * small objects are served from power-of-two size classes;
+ * larger objects go to the block allocator
  */
-template <address_t SIZE>
-struct object {
-    static constexpr address_t DWORDS = (SIZE + sizeof(address_t) - 1) / sizeof(address_t);
-    union {
-        pointer<object> next_;
-        std::array<address_t, DWORDS> data_;
-    };
-    const pointer<object> &next() const { return next_; }
-    pointer<object> &next() { return next_; }
-    const std::array<address_t, DWORDS> &data() const { return data_; }
-    std::array<address_t, DWORDS> &data() { return data_; }
-
-    template <typename Dst, typename Src>
-    static void copy(Dst &dst, const Src &src) {
-        dst.next() = src.next();
-        dst.data() = src.data();
-    }
-};
+static constexpr int       NUM_SIZE_CLASSES = 8;
+static constexpr address_t MIN_OBJECT_SIZE = 2*sizeof(uint64_t); // room for the two link words
+static constexpr address_t MAX_OBJECT_SIZE = MIN_OBJECT_SIZE << (NUM_SIZE_CLASSES - 1);
 
 /**
- * allocator for fixed size objects with free list
+ * threads with an id at or above this bypass the thread cache
  */
-template <address_t SIZE>
-class free_list_object_allocator {
-public:
-    FIELD(pointer<object<SIZE>>, head, head_)
-    FIELD(status_t, status, status_)
-    template <typename Dst, typename Src>
-    static void copy(Dst &dst, const Src &src) {
-        dst.head() = src.head();
-    }
-};
+static constexpr int MAX_CACHED_THREADS = 16;
 
 /**
- * fixed size object allocator with free list and bump
+ * @brief a link to a free object
+ *
+ * the low bits hold the object's index relative to its heap's base (0 is null),
+ * the high bits hold the length of the chain it starts or, for a list head,
+ * a tag that changes on every update (so a single-word cas is ABA-safe)
  */
-template <address_t SIZE>
-class object_allocator {
-public:
-    FIELD(free_list_object_allocator<SIZE>, free_list, free_list_)
-    FIELD(bump_allocator, bump, bump_)
-    FIELD(pointer<slab_allocator>, slab_alloc_ptr, slab_alloc_ptr_)
-    FIELD(status_t, status, status_)
-    template <typename Dst, typename Src>
-    static void copy(Dst &dst, const Src &src) {
-        dst.free_list() = src.free_list();
-        dst.bump() = src.bump();
-        dst.slab_alloc_ptr() = src.slab_alloc_ptr();
-    }    
-};
+typedef uint64_t link_t;
+typedef std::array<link_t, NUM_SIZE_CLASSES> class_links;
+
+static constexpr uint64_t LINK_INDEX_BITS = 36;
+static constexpr link_t   LINK_INDEX_MASK = (1ull << LINK_INDEX_BITS) - 1;
+
+inline link_t make_link(uint64_t hi, uint64_t index) {
+    return (hi << LINK_INDEX_BITS) | (index & LINK_INDEX_MASK);
+}
+inline uint64_t link_hi(link_t link) {
+    return link >> LINK_INDEX_BITS;
+}
+inline uint64_t link_index(link_t link) {
+    return link & LINK_INDEX_MASK;
+}
+inline uint64_t object_index(address_t base, address_t obj) {
+    return ((obj - base) >> 3) + 1;
+}
+inline address_t object_address(address_t base, uint64_t index) {
+    return base + ((index - 1) << 3);
 }
 
 /**
- * specialization for object
+ * @brief the size class for a size
  */
-template <address_t SIZE>
-class value_handle<allocator::object<SIZE>> {
-    DRV_API_VALUE_HANDLE_DEFAULTS(allocator::object<SIZE>)
-    DRV_API_VALUE_HANDLE_FIELD(allocator::object<SIZE>, next, pointer<allocator::object<SIZE>>, next_)
-};
+inline int size_class(address_t size) {
+    int c = 0;
+    while ((MIN_OBJECT_SIZE << c) < size)
+        c++;
+    return c;
+}
 
 /**
- * specialization for free_list_object_allocator
+ * @brief the object size of a size class
  */
-template <address_t SIZE>
-class value_handle<allocator::free_list_object_allocator<SIZE>> {
-    typedef pointer<allocator::object<SIZE>> object_pointer;
-    DRV_API_VALUE_HANDLE_DEFAULTS(allocator::free_list_object_allocator<SIZE>)
-    DRV_API_VALUE_HANDLE_FIELD(allocator::free_list_object_allocator<SIZE>, head, pointer<allocator::object<SIZE>>, head_)
-    void init() {
-        head() = head().address();
-        pr_dbg("free_list allocator: init: &head = %s, head = %s\n",
-               DrvAPIVAddress{head().address()}.to_string().c_str(),
-               DrvAPIVAddress{head()}.to_string().c_str());
-    }
-
-    bool empty() const {
-        pointer<void> head_ptr = head();
-        return head_ptr == head().address();
-    }
-
-    object_pointer allocate() {
-        while (true) {
-            object_pointer head_ptr = head();
-            object_pointer next_ptr = head_ptr->next();
-            pr_dbg("free_list allocator: allocate: &head = %s, head = %s, next = %s\n",
-                   DrvAPIVAddress{head().address()}.to_string().c_str(),
-                   DrvAPIVAddress{head_ptr}.to_string().c_str(),
-                   DrvAPIVAddress{next_ptr}.to_string().c_str());
-            object_pointer result = atomic_cas(head().address(), head_ptr, next_ptr);
-            pr_dbg("free_list allocator: allocate: &head = %s, allocated %s\n",
-                   DrvAPIVAddress{head().address()}.to_string().c_str(),
-                   DrvAPIVAddress{result}.to_string().c_str());
-            
-            if (result == head().address())
-                return allocator::null_ptr;
-            else if (result == head_ptr)
-                return head_ptr;
-        }
-    }
-    
-    void deallocate(object_pointer ptr) {
-        while (true) {
-            object_pointer head_ptr = head();
-            ptr->next() = head_ptr;
-            object_pointer result = atomic_cas(head().address(), head_ptr, ptr);
-            if (result == head_ptr)
-                return;
-        }
-    }
-};
-
-template <address_t SIZE>
-class value_handle<allocator::object_allocator<SIZE>> {
-    typedef pointer<allocator::object<SIZE>> object_pointer;    
-    DRV_API_VALUE_HANDLE_DEFAULTS(allocator::object_allocator<SIZE>)
-    DRV_API_VALUE_HANDLE_FIELD(allocator::object_allocator<SIZE>, free_list, allocator::free_list_object_allocator<SIZE>, free_list_)
-    DRV_API_VALUE_HANDLE_FIELD(allocator::object_allocator<SIZE>, bump, bump_allocator, bump_)
-    DRV_API_VALUE_HANDLE_FIELD(allocator::object_allocator<SIZE>, slab_alloc_ptr, pointer<slab_allocator>, slab_alloc_ptr_)
-    DRV_API_VALUE_HANDLE_FIELD(allocator::object_allocator<SIZE>, status, status_t, status_)
-    static constexpr address_t SLAB_SIZE = SIZE * 32;
-    void init(pointer<slab_allocator> slab_alloc_ptr) {
-        do_once(status().address(), [slab_alloc_ptr, this] {
-            this->slab_alloc_ptr() = slab_alloc_ptr;
-            this->free_list().init();
-            this->bump().init(0,0);
-        });
-    }
-
-    object_pointer allocate() {
-        object_pointer ptr;
-        ptr = bump().allocate(SIZE);
-        if (ptr != allocator::null_ptr)
-            return ptr;
+inline address_t class_size(int c) {
+    return MIN_OBJECT_SIZE << c;
+}
 
-        ptr = free_list().allocate();
-        if (ptr != allocator::null_ptr)
-            return ptr;
+/**
+ * @brief the number of objects moved between a thread cache and its heap at once
+ */
+inline uint64_t class_batch(int c) {
+    return std::max<uint64_t>(4, std::min<uint64_t>(32, MAX_OBJECT_SIZE / class_size(c)));
+}
 
-        pointer<slab_allocator> slab_alloc_ptr = this->slab_alloc_ptr();
-        bump().reset(slab_alloc_ptr->allocate(SLAB_SIZE), SLAB_SIZE);
-        ptr = bump().allocate(SIZE);
-        if (ptr != allocator::null_ptr)
-            return ptr;
+/**
+ * @brief the next object in a free object's chain (first word)
+ */
+inline value_handle<link_t> chain_link(address_t obj) {
+    return value_handle<link_t>(obj);
+}
 
-        throw std::runtime_error("object allocator: out of memory");
-    }
+/**
+ * @brief the next chain in a central list and this chain's length (second word)
+ */
+inline value_handle<link_t> batch_link(address_t obj) {
+    return value_handle<link_t>(obj + sizeof(link_t));
+}
 
-    void deallocate(pointer<allocator::object<SIZE>> ptr) {
-        free_list().deallocate(ptr);
-    }
+/**
+ * @brief per-thread cache of free objects
+ */
+struct thread_cache {
+    FIELD(class_links, list, list_)
+    FIELD(class_links, spare, spare_)
+    FIELD(address_t, base, base_)
 };
+} // namespace allocator
 
 ///////////////////////////
 // GLOBAL MEMORY OBJECTS //
@@ -872,14 +815,12 @@ namespace allocator {
 struct global_memory {
     FIELD(slab_allocator, slab_alloc, slab_alloc_)
     FIELD(block_allocator, block_alloc, block_alloc_)
-    FIELD(object_allocator<sizeof(uint64_t)>, dword_alloc, dword_alloc_)
-    FIELD(object_allocator<2*sizeof(uint64_t)>, qword_alloc, qword_alloc_)    
+    FIELD(class_links, central, central_)
+    FIELD(status_t, status, status_)
     template <typename Dst, typename Src>
     static void copy(Dst &dst, const Src &src) {
         dst.slab_alloc() = src.slab_alloc();
         dst.block_alloc() = src.block_alloc();
-        dst.dword_alloc() = src.dword_alloc();
-        dst.qword_alloc() = src.qword_alloc();
     }
 };
 } // namespace allocator
@@ -889,39 +830,164 @@ class value_handle<global_memory> {
     DRV_API_VALUE_HANDLE_DEFAULTS(global_memory)
     DRV_API_VALUE_HANDLE_FIELD(global_memory, slab_alloc, slab_allocator, slab_alloc_)
     DRV_API_VALUE_HANDLE_FIELD(global_memory, block_alloc, block_allocator, block_alloc_)
-    DRV_API_VALUE_HANDLE_FIELD(global_memory, dword_alloc, object_allocator<sizeof(uint64_t)>, dword_alloc_)
-    DRV_API_VALUE_HANDLE_FIELD(global_memory, qword_alloc, object_allocator<2*sizeof(uint64_t)>, qword_alloc_)
+    DRV_API_VALUE_HANDLE_FIELD(global_memory, status, status_t, status_)
+    /**
+     * @brief head of the central list of free chains for a size class
+     *
+     * shared by every thread on the pxn/pod/core that owns this memory
+     * and by any thread freeing an object back to it
+     */
+    value_handle<link_t> central(int c) {
+        return value_handle<link_t>(address() + offsetof(global_memory, central_) + c * sizeof(link_t));
+    }
+
     void init(memtype_t type) {
-        slab_alloc().init(type);
-        block_alloc().init(slab_alloc().address());
-        dword_alloc().init(slab_alloc().address());
-        qword_alloc().init(slab_alloc().address());
+        do_once(status().address(), [this, type]() {
+            for (int c = 0; c < NUM_SIZE_CLASSES; c++)
+                this->central(c) = 0;
+            this->slab_alloc().init(type);
+            this->block_alloc().init(this->slab_alloc().address());
+        });
     }
 
-    pointer<void> allocate(address_t size) {
-#define BUMP_ALLOCATE_ONLY
-#ifdef  BUMP_ALLOCATE_ONLY
-        return slab_alloc().allocate(size);
-#else
-        if (size <= sizeof(uint64_t))
-            return dword_alloc().allocate();
-        else if (size <= 2*sizeof(uint64_t))
-            return qword_alloc().allocate();
-        else
-            return block_alloc().allocate(size);
-#endif
+    /**
+     * @brief pop a chain of free objects from the central list
+     *
+     * @return a link to the chain, 0 if the list is empty
+     */
+    link_t pop_chain(int c, address_t base) {
+        value_handle<link_t> head_h = central(c);
+        while (true) {
+            link_t head = head_h;
+            if (link_index(head) == 0)
+                return 0;
+            address_t obj = object_address(base, link_index(head));
+            link_t next = batch_link(obj);
+            link_t swap = make_link(link_hi(head) + 1, link_index(next));
+            if (atomic_cas<link_t>(head_h.address(), head, swap) == head) {
+                pr_dbg("central %d: popped %lu objects\n", c, link_hi(next));
+                return make_link(link_hi(next), link_index(head));
+            }
+        }
     }
 
-    void deallocate(pointer<void> ptr, address_t size) {
-#ifdef BUMP_ALLOCATE_ONLY
-#else
-        if (size <= sizeof(uint64_t))
-            dword_alloc().deallocate(ptr);
-        else if (size <= 2*sizeof(uint64_t))
-            qword_alloc().deallocate(ptr);
-        else
-            block_alloc().deallocate(ptr);
-#endif
+    /**
+     * @brief push a chain of free objects onto the central list
+     */
+    void push_chain(int c, address_t base, link_t chain) {
+        value_handle<link_t> head_h = central(c);
+        address_t obj = object_address(base, link_index(chain));
+        while (true) {
+            link_t head = head_h;
+            batch_link(obj) = make_link(link_hi(chain), link_index(head));
+            DrvAPI::fence();
+            link_t swap = make_link(link_hi(head) + 1, link_index(chain));
+            if (atomic_cas<link_t>(head_h.address(), head, swap) == head) {
+                pr_dbg("central %d: pushed %lu objects\n", c, link_hi(chain));
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief carve a new chain of free objects from the slab
+     */
+    link_t carve_chain(int c, address_t base) {
+        uint64_t n = class_batch(c);
+        address_t size = class_size(c);
+        address_t first = slab_alloc().allocate(n * size);
+        for (uint64_t i = 0; i + 1 < n; i++) {
+            chain_link(first + i * size) = object_index(base, first + (i + 1) * size);
+        }
+        return make_link(n, object_index(base, first));
+    }
+
+    /**
+     * @brief allocate an object straight from the central list
+     */
+    pointer<void> allocate_object(int c) {
+        address_t base = slab_alloc().base();
+        link_t chain = pop_chain(c, base);
+        if (link_hi(chain) == 0)
+            chain = carve_chain(c, base);
+        address_t obj = object_address(base, link_index(chain));
+        if (link_hi(chain) > 1)
+            push_chain(c, base, make_link(link_hi(chain) - 1, chain_link(obj)));
+        return obj;
+    }
+
+    /**
+     * @brief free an object straight to the central list
+     */
+    void deallocate_object(int c, address_t obj) {
+        address_t base = slab_alloc().base();
+        push_chain(c, base, make_link(1, object_index(base, obj)));
+    }
+};
+
+/**
+ * specialization for thread_cache
+ */
+template <>
+class value_handle<thread_cache> {
+    DRV_API_VALUE_HANDLE_CONSTRUCTORS(thread_cache)
+    DRV_API_VALUE_HANDLE_ADDRESSOF_OPERATORS(thread_cache)
+    DRV_API_VALUE_HANDLE_INTERNAL(thread_cache)
+    DRV_API_VALUE_HANDLE_FIELD(thread_cache, base, address_t, base_) // base of the cached heap, 0 until first use
+    /**
+     * @brief cached objects of a size class
+     */
+    value_handle<link_t> list(int c) {
+        return value_handle<link_t>(address() + offsetof(thread_cache, list_) + c * sizeof(link_t));
+    }
+    /**
+     * @brief a full chain held back so that alternating alloc/free
+     * at the batch boundary does not go to the central list every time
+     */
+    value_handle<link_t> spare(int c) {
+        return value_handle<link_t>(address() + offsetof(thread_cache, spare_) + c * sizeof(link_t));
+    }
+
+    address_t heap_base(value_handle<global_memory> heap) {
+        address_t base = this->base();
+        if (base == 0) {
+            base = heap.slab_alloc().base();
+            this->base() = base;
+        }
+        return base;
+    }
+
+    pointer<void> allocate(value_handle<global_memory> heap, int c) {
+        address_t base = heap_base(heap);
+        link_t list = this->list(c);
+        if (link_hi(list) == 0) {
+            link_t spare = this->spare(c);
+            if (link_hi(spare) != 0) {
+                list = spare;
+                this->spare(c) = 0;
+            } else {
+                list = heap.pop_chain(c, base);
+                if (link_hi(list) == 0)
+                    list = heap.carve_chain(c, base);
+            }
+        }
+        address_t obj = object_address(base, link_index(list));
+        this->list(c) = make_link(link_hi(list) - 1, chain_link(obj));
+        return obj;
+    }
+
+    void deallocate(value_handle<global_memory> heap, int c, address_t obj) {
+        address_t base = heap_base(heap);
+        link_t list = this->list(c);
+        if (link_hi(list) >= class_batch(c)) {
+            link_t spare = this->spare(c);
+            if (link_hi(spare) != 0)
+                heap.push_chain(c, base, spare);
+            this->spare(c) = list;
+            list = 0;
+        }
+        chain_link(obj) = link_index(list);
+        this->list(c) = make_link(link_hi(list) + 1, object_index(base, obj));
     }
 };
 
@@ -941,8 +1007,74 @@ l2sp_static<global_memory> l2sp_memory; // one of these per pod
  */
 dram_static<global_memory> dram_memory; // one of these per pxn
 
+/**
+ * thread caches for the L2SP and DRAM allocators
+ */
+l1sp_static<std::array<thread_cache, 2*MAX_CACHED_THREADS>> thread_caches; // one of these per core
+
 } // namespace allocator
 
+namespace
+{
+/**
+ * @brief this thread's cache for a memory type
+ */
+value_handle<thread_cache> my_thread_cache(memtype_t type) {
+    int slot = 2 * myThreadId() + (type == DrvAPIMemoryType::DrvAPIMemoryDRAM ? 1 : 0);
+    return value_handle<thread_cache>(thread_caches.address() + slot * sizeof(thread_cache));
+}
+
+/**
+ * @brief allocate from this thread's heap of a memory type
+ */
+template <memtype_t MEMTYPE>
+pointer<void> heap_allocate(value_handle<global_memory> heap, address_t size) {
+    if (size > MAX_OBJECT_SIZE)
+        return heap.block_alloc().allocate(size);
+
+    int c = size_class(size);
+    if (MEMTYPE == DrvAPIMemoryType::DrvAPIMemoryL1SP || myThreadId() >= MAX_CACHED_THREADS)
+        return heap.allocate_object(c);
+
+    return my_thread_cache(MEMTYPE).allocate(heap, c);
+}
+
+/**
+ * @brief free to the heap that owns an address
+ *
+ * the owner is the instance of the heap's static on the
+ * pxn/pod/core that the address belongs to
+ */
+template <memtype_t MEMTYPE>
+void heap_deallocate(value_handle<global_memory> heap, address_t ptr, address_t size) {
+    ptr = toAbsoluteAddress(ptr);
+    DrvAPIAddressInfo owner = decodeAddress(ptr);
+    address_t local = toAbsoluteAddress(heap.address());
+    DrvAPIAddressInfo info = decodeAddress(local);
+    info.set_pxn(owner.pxn());
+    if (MEMTYPE != DrvAPIMemoryType::DrvAPIMemoryDRAM)
+        info.set_pod(owner.pod());
+    if (MEMTYPE == DrvAPIMemoryType::DrvAPIMemoryL1SP)
+        info.set_core(owner.core());
+    value_handle<global_memory> owner_heap(encodeAddressInfo(info));
+
+    if (size > MAX_OBJECT_SIZE) {
+        owner_heap.block_alloc().deallocate(ptr);
+        return;
+    }
+
+    int c = size_class(size);
+    if (MEMTYPE == DrvAPIMemoryType::DrvAPIMemoryL1SP
+        || myThreadId() >= MAX_CACHED_THREADS
+        || owner_heap.address() != local) {
+        owner_heap.deallocate_object(c, ptr);
+        return;
+    }
+
+    my_thread_cache(MEMTYPE).deallocate(heap, c, ptr);
+}
+} // namespace
+
 /////////
 // API //
 /////////
@@ -954,6 +1086,11 @@ void DrvAPIMemoryAllocatorInitType(DrvAPIMemoryType type) {
         } else if (type == DrvAPIMemoryType::DrvAPIMemoryL2SP) {
             l2sp_memory.init(DrvAPIMemoryType::DrvAPIMemoryL2SP);
         }
+    } else if (type == DrvAPIMemoryType::DrvAPIMemoryL1SP) {
+        if (!DrvAPIThread::current()->stackInL1SP())
+            l1sp_memory.init(DrvAPIMemoryType::DrvAPIMemoryL1SP);
+    } else if (type == DrvAPIMemoryType::DrvAPIMemoryL2SP) {
+        l2sp_memory.init(DrvAPIMemoryType::DrvAPIMemoryL2SP);
     } else if (type == DrvAPIMemoryType::DrvAPIMemoryDRAM) {
         dram_memory.init(DrvAPIMemoryType::DrvAPIMemoryDRAM);
     }
@@ -975,11 +1112,11 @@ DrvAPIPointer<void> DrvAPIMemoryAlloc(DrvAPIMemoryType type, size_t size) {
     // size should be 8-byte aligned
     switch (type) {
     case DrvAPIMemoryType::DrvAPIMemoryL1SP:
-        return l1sp_memory.allocate(size);
+        return heap_allocate<DrvAPIMemoryType::DrvAPIMemoryL1SP>(l1sp_memory, size);
     case DrvAPIMemoryType::DrvAPIMemoryL2SP:
-        return l2sp_memory.allocate(size);
+        return heap_allocate<DrvAPIMemoryType::DrvAPIMemoryL2SP>(l2sp_memory, size);
     case DrvAPIMemoryType::DrvAPIMemoryDRAM:
-        return dram_memory.allocate(size);
+        return heap_allocate<DrvAPIMemoryType::DrvAPIMemoryDRAM>(dram_memory, size);
     default:
         std::cerr << "ERROR: invalid memory type: " << static_cast<int>(type) << std::endl;
         exit(1);
@@ -990,11 +1127,11 @@ DrvAPIPointer<void> DrvAPIMemoryAlloc(DrvAPIMemoryType type, size_t size) {
 void DrvAPIMemoryFree(const DrvAPIPointer<void> &ptr, size_t size) {
     DrvAPIAddressInfo info = decodeAddress(ptr);
     if (info.is_l1sp()) {
-        l1sp_memory.deallocate(ptr, size);
+        heap_deallocate<DrvAPIMemoryType::DrvAPIMemoryL1SP>(l1sp_memory, ptr, size);
     } else if (info.is_l2sp()) {
-        l2sp_memory.deallocate(ptr, size);
+        heap_deallocate<DrvAPIMemoryType::DrvAPIMemoryL2SP>(l2sp_memory, ptr, size);
     } else if (info.is_dram()) {
-        dram_memory.deallocate(ptr, size);
+        heap_deallocate<DrvAPIMemoryType::DrvAPIMemoryDRAM>(dram_memory, ptr, size);
     } else {
         std::cerr << "ERROR: invalid memory address: " << ptr << std::endl;
         exit(1);
@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+
+#ifndef DRV_API_BARRIER_H
+#define DRV_API_BARRIER_H
+#include <DrvAPIThread.hpp>
+#include <DrvAPIThreadState.hpp>
+#include <cstdint>
+namespace DrvAPI
+{
+
+/**
+ * @brief sum value across every thread and return the total
+ *
+ * Blocks at the hardware barrier network until all threads connected
+ * to it have arrived. Each core combines its threads' values, and the
+ * per-pod and cross-PXN units combine their children's on the way up.
+ * On a core that is not connected to a barrier network only the threads
+ * on that core take part.
+ */
+inline int64_t allreduce_add(int64_t value)
+{
+    DrvAPIThread *thread = DrvAPIThread::current();
+    DrvAPIThreadState &state = thread->getState();
+    state.setBarrier(value);
+    thread->yield();
+    return state.result<int64_t>();
+}
+
+/**
+ * @brief block until every thread has reached the barrier
+ */
+inline void barrier()
+{
+    allreduce_add(0);
+}
+
+}
+#endif
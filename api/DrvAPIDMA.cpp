@@ -2,33 +2,50 @@
 #include <DrvAPIMemory.hpp>
 #include <DrvAPIAddressToNative.hpp>
 #include <DrvAPIInfo.hpp>
+#include <DrvAPIThread.hpp>
 #include <cstring>
 
 namespace DrvAPI
 {
 
+/**
+ * @brief true if the jobs cover more bytes than the dram cache holds
+ *
+ * then one whole-cache operation is cheaper than walking each range
+ */
+template <typename Job>
+static bool dmaExceedsCache(const Job *jobs, size_t count)
+{
+    size_t bytes = 0;
+    for (size_t i = 0; i < count; i++) {
+        bytes += jobs[i].size;
+    }
+    size_t capacity = static_cast<size_t>(numPXNDRAMCacheBanks())
+        * numPXNDRAMCacheLines()
+        * numPXNDRAMCacheLineSize();
+    return bytes > capacity;
+}
+
 static
 void dmaSimToNative(const DrvAPIDMASimToNative &job)
 {
     char *dst = job.dst();
-    DrvAPIAddress src = job.src();
-    size_t sz = job.size;
-    while (sz > 0) {
-        size_t chunk = 0;
-        void *src_as_native = nullptr;
-        DrvAPIAddressToNative(src, &src_as_native, &chunk);
-        chunk = std::min(chunk, sz);
-        memcpy(dst, src_as_native, chunk);
-        sz  -= chunk;
-        dst += chunk;
-        src += chunk;
+    for (const native_run &run : native_span(job.src(), job.size)) {
+        std::memcpy(dst, run.data, run.size);
+        dst += run.size;
     }
 }
 
 void dmaSimToNative(const DrvAPIDMASimToNative *jobs, size_t count)
 {
-    // flush the cache
-    pxn_flush_cache(myPXNId());
+    // flush the cache lines holding the sources
+    if (dmaExceedsCache(jobs, count)) {
+        pxn_flush_cache(myPXNId());
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            flush_range(jobs[i].src(), jobs[i].size);
+        }
+    }
 
     // handle each job
     for (size_t i = 0; i < count; i++) {
@@ -40,26 +57,24 @@ void dmaSimToNative(const DrvAPIDMASimToNative *jobs, size_t count)
 static
 void dmaNativeToSim(const DrvAPIDMANativeToSim &job)
 {
-    DrvAPIAddress dst = job.dst();
     const char *src = job.src();
-    size_t sz = job.size;
-    while (sz > 0) {
-        size_t chunk = 0;
-        void *dst_as_native = nullptr;
-        DrvAPIAddressToNative(dst, &dst_as_native, &chunk);
-        chunk = std::min(chunk, sz);
-        memcpy(dst_as_native, src, chunk);
-        sz  -= chunk;
-        src += chunk;
-        dst += chunk;
+    for (const native_run &run : native_span(job.dst(), job.size)) {
+        std::memcpy(run.data, src, run.size);
+        src += run.size;
     }
 }
 
 void dmaNativeToSim(const DrvAPIDMANativeToSim *jobs, size_t count)
 {
-    // flush and invalidate the cache
-    pxn_flush_cache(myPXNId());
-    pxn_invalidate_cache(myPXNId());
+    // flush and invalidate the cache lines holding the destinations
+    if (dmaExceedsCache(jobs, count)) {
+        pxn_flush_cache(myPXNId());
+        pxn_invalidate_cache(myPXNId());
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            invalidate_range(jobs[i].dst(), jobs[i].size);
+        }
+    }
 
     // handle each job
     for (size_t i = 0; i < count; i++){
@@ -68,4 +83,20 @@ void dmaNativeToSim(const DrvAPIDMANativeToSim *jobs, size_t count)
     }
 }
 
+DrvAPIDMAHandle dma_start(DrvAPIAddress dst, DrvAPIAddress src, size_t size)
+{
+    DrvAPIThread *thread = DrvAPIThread::current();
+    DrvAPIThreadState &state = thread->getState();
+    state.setDMAStart(detail::to_absolute(thread, dst), detail::to_absolute(thread, src), size);
+    thread->yield();
+    return state.result<DrvAPIDMAHandle>();
+}
+
+void dma_wait(DrvAPIDMAHandle handle)
+{
+    DrvAPIThread *thread = DrvAPIThread::current();
+    thread->getState().setDMAWait(handle);
+    thread->yield();
+}
+
 }
@@ -1,6 +1,7 @@
 #ifndef DRV_API_DMA_HPP
 #define DRV_API_DMA_HPP
 #include <DrvAPIAddress.hpp>
+#include <cstdint>
 namespace DrvAPI
 {
 
@@ -65,5 +66,27 @@ void dmaSimToNative(const DrvAPIDMASimToNative *jobs, size_t count);
  */
 void dmaNativeToSim(const DrvAPIDMANativeToSim *jobs, size_t count);
 
+/**
+ * @brief Handle of a copy queued on the core's dma engine
+ */
+typedef int64_t DrvAPIDMAHandle;
+
+/**
+ * @brief Queue a copy of size bytes from src to dst on the core's dma engine
+ *
+ * Either address may be in any simulated memory (L1SP, L2SP, DRAM) on any pxn.
+ * The copy proceeds in the background at the engine's modeled bandwidth;
+ * the calling thread resumes as soon as it is queued, or once the engine's
+ * queue has room. The data at dst is undefined until dma_wait() returns.
+ *
+ * @return a handle to pass to dma_wait()
+ */
+DrvAPIDMAHandle dma_start(DrvAPIAddress dst, DrvAPIAddress src, size_t size);
+
+/**
+ * @brief Block until the copy with this handle has completed
+ */
+void dma_wait(DrvAPIDMAHandle handle);
+
 }
 #endif
@@ -29,8 +29,9 @@ struct DrvAPIFunctionTypeInfo {
 };
 
 // forward declaration; these symbols should be provided by the linker
-extern "C" DrvAPIFunctionTypeInfo __start_drv_api_function_typev;
-extern "C" DrvAPIFunctionTypeInfo  __stop_drv_api_function_typev;
+// weak so that an executable with no function types still loads
+extern "C" __attribute__((weak)) DrvAPIFunctionTypeInfo __start_drv_api_function_typev;
+extern "C" __attribute__((weak)) DrvAPIFunctionTypeInfo  __stop_drv_api_function_typev;
 
 /**
  * A functor that can be serialized and written to a DrvAPIAddress
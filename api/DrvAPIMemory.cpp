@@ -5,42 +5,54 @@
 namespace DrvAPI
 {
 
-template <typename Op>
-void pxn_op_on_cache(int pxn, Op op)
+/**
+ * @brief flush dram cache on a pxn
+ */
+void pxn_flush_cache(int pxn)
 {
-    if (pxnDRAMHasCache()) {
-        DrvAPIAddress interleave = pxnDRAMAddressInterleave();
-        DrvAPIAddress cache_addr = absolutePXNDRAMBase(pxn);
-        for (int b = 0; b < numPXNDRAMCacheBanks(); b++) {
-            for (int l = 0; l < numPXNDRAMCacheLines(); l++) {
-                op(cache_addr, l);
-            }
-            cache_addr += interleave;
-        }
-    }
-    return;    
+    if (!pxnDRAMHasCache())
+        return;
+    DrvAPIThread *thread = DrvAPIThread::current();
+    thread->getState().setFlushCache(absolutePXNDRAMBase(pxn), numPXNDRAMCacheBanks() * numPXNDRAMCacheLines());
+    thread->yield();
 }
 
 /**
- * @brief flush and invalidate dram cache on a pxn
+ * @brief invalidate dram cache on a pxn
  */
-void pxn_flush_cache(int pxn)
+void pxn_invalidate_cache(int pxn)
 {
-    pxn_op_on_cache(pxn, [](DrvAPIAddress cache_addr, int l) {
-        flush_cache(cache_addr, l);
-    });
-    return;
+    if (!pxnDRAMHasCache())
+        return;
+    DrvAPIThread *thread = DrvAPIThread::current();
+    thread->getState().setInvCache(absolutePXNDRAMBase(pxn), numPXNDRAMCacheBanks() * numPXNDRAMCacheLines());
+    thread->yield();
 }
 
 /**
- * @brief flush and invalidate dram cache on a pxn
+ * @brief flush the dram cache lines holding a range
  */
-void pxn_invalidate_cache(int pxn)
+void flush_range(DrvAPIAddress address, std::size_t size)
+{
+    DrvAPIThread *thread = DrvAPIThread::current();
+    address = detail::to_absolute(thread, address);
+    if (size == 0 || !pxnDRAMHasCache() || !decodeAddress(address).is_dram())
+        return;
+    thread->getState().setFlushRange(address, size);
+    thread->yield();
+}
+
+/**
+ * @brief flush and invalidate the dram cache lines holding a range
+ */
+void invalidate_range(DrvAPIAddress address, std::size_t size)
 {
-    pxn_op_on_cache(pxn, [](DrvAPIAddress cache_addr, int l) {
-        invalidate_cache(cache_addr, l);
-    });
-    return;
+    DrvAPIThread *thread = DrvAPIThread::current();
+    address = detail::to_absolute(thread, address);
+    if (size == 0 || !pxnDRAMHasCache() || !decodeAddress(address).is_dram())
+        return;
+    thread->getState().setInvRange(address, size);
+    thread->yield();
 }
 
 } // namespace DrvAPI
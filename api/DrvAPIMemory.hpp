@@ -5,10 +5,194 @@
 #define DRV_API_MEMORY_H
 #include <DrvAPIAddress.hpp>
 #include <DrvAPIThread.hpp>
+#include <algorithm>
+#include <type_traits>
+#include <vector>
 
 namespace DrvAPI
 {
 
+namespace detail
+{
+/**
+ * @brief convert an address to absolute w.r.t the current thread
+ */
+inline DrvAPIAddress to_absolute(DrvAPIThread *thread, DrvAPIAddress address)
+{
+    return thread->getDecoder().to_absolute(address);
+}
+
+/**
+ * @brief the add operation for T: FADD for floating point types
+ */
+template <typename T>
+constexpr DrvAPIMemAtomicType add_op()
+{
+    return std::is_floating_point<T>::value ? DrvAPIMemAtomicFADD : DrvAPIMemAtomicADD;
+}
+
+/**
+ * @brief the min operation for T: signed or unsigned
+ */
+template <typename T>
+constexpr DrvAPIMemAtomicType min_op()
+{
+    return std::is_signed<T>::value ? DrvAPIMemAtomicMIN : DrvAPIMemAtomicMINU;
+}
+
+/**
+ * @brief the max operation for T: signed or unsigned
+ */
+template <typename T>
+constexpr DrvAPIMemAtomicType max_op()
+{
+    return std::is_signed<T>::value ? DrvAPIMemAtomicMAX : DrvAPIMemAtomicMAXU;
+}
+
+/**
+ * @brief atomic operation on a memory address
+ */
+template <typename T, DrvAPIMemAtomicType OP>
+T atomic_rmw(DrvAPIAddress address, T value)
+{
+    static_assert(sizeof(T) <= DrvAPIThreadState::MAX_ATOMIC_SIZE, "atomic: type too large");
+    DrvAPIThread *thread = DrvAPIThread::current();
+    DrvAPIThreadState &state = thread->getState();
+    state.setAtomic(detail::to_absolute(thread, address), OP, &value, sizeof(T));
+    thread->yield();
+    return state.result<T>();
+}
+
+/**
+ * @brief allocate an async state slot, waiting for one to free up if needed
+ *
+ * @return -1 if every slot is held by a completed request whose handle is
+ * still live, so none will free up; the caller then issues the request
+ * blocking, stalling the thread until it completes
+ */
+inline int async_alloc(DrvAPIThread *thread)
+{
+    int slot = thread->allocAsyncState();
+    while (slot < 0) {
+        if (thread->asyncPending() == 0) {
+            return -1;
+        }
+        thread->getState().setAsyncWait(DrvAPIThreadState::ASYNC_SLOT_ANY);
+        thread->yield();
+        slot = thread->allocAsyncState();
+    }
+    return slot;
+}
+
+/**
+ * @brief issue the request held in an async state slot
+ */
+inline void async_issue(DrvAPIThread *thread, int slot)
+{
+    thread->issueAsyncState();
+    thread->getState().setAsyncIssue(slot);
+    thread->yield();
+}
+} // namespace detail
+
+/**
+ * @brief handle to a non-blocking memory operation
+ *
+ * Handles are move-only and belong to the thread that issued the request.
+ * Dropping a handle without waiting on it is allowed; the request still
+ * completes and is accounted for by fence().
+ */
+class DrvAPIMemHandle
+{
+public:
+    DrvAPIMemHandle() : slot_(-1) {}
+    explicit DrvAPIMemHandle(int slot) : slot_(slot) {}
+    DrvAPIMemHandle(const DrvAPIMemHandle &) = delete;
+    DrvAPIMemHandle &operator=(const DrvAPIMemHandle &) = delete;
+    DrvAPIMemHandle(DrvAPIMemHandle &&o) : slot_(o.slot_) { o.slot_ = -1; }
+    DrvAPIMemHandle &operator=(DrvAPIMemHandle &&o) {
+        if (this != &o) {
+            release();
+            slot_ = o.slot_;
+            o.slot_ = -1;
+        }
+        return *this;
+    }
+    ~DrvAPIMemHandle() { release(); }
+
+    /**
+     * @brief true if this handle refers to a request
+     */
+    bool valid() const { return slot_ >= 0; }
+
+    /**
+     * @brief true if the request has completed
+     */
+    bool test() const {
+        return !valid() || DrvAPIThread::current()->getAsyncState(slot_).canResume();
+    }
+
+    /**
+     * @brief block until the request has completed
+     */
+    void wait() {
+        if (test()) {
+            return;
+        }
+        DrvAPIThread *thread = DrvAPIThread::current();
+        thread->getState().setAsyncWait(slot_);
+        thread->yield();
+    }
+
+protected:
+    void release() {
+        if (valid()) {
+            DrvAPIThread::current()->releaseAsyncState(slot_);
+            slot_ = -1;
+        }
+    }
+
+    int slot_; //!< async state slot
+};
+
+/**
+ * @brief handle to a non-blocking memory operation that returns a value
+ */
+template <typename T>
+class DrvAPIMemFuture : public DrvAPIMemHandle
+{
+public:
+    DrvAPIMemFuture() : DrvAPIMemHandle(), value_() {}
+    explicit DrvAPIMemFuture(int slot) : DrvAPIMemHandle(slot), value_() {}
+
+    /**
+     * @brief a future for a request that completed without a slot
+     */
+    static DrvAPIMemFuture ready(T value) {
+        DrvAPIMemFuture f;
+        f.value_ = value;
+        return f;
+    }
+
+    /**
+     * @brief block until the request has completed and return its result
+     *
+     * The handle is released afterwards.
+     */
+    T get() {
+        if (!valid()) {
+            return value_;
+        }
+        wait();
+        T r = DrvAPIThread::current()->getAsyncState(slot_).template result<T>();
+        release();
+        return r;
+    }
+
+private:
+    T value_; //!< result of a request issued blocking
+};
+
 /**
  * @brief read from a memory address
  * 
@@ -16,14 +200,12 @@ namespace DrvAPI
 template <typename T>
 T read(DrvAPIAddress address)
 {
-    T result{};
-    DrvAPIThread::current()->setState(std::make_shared<DrvAPIMemReadConcrete<T>>(address));
-    DrvAPIThread::current()->yield();
-    auto read_req = std::dynamic_pointer_cast<DrvAPIMemRead>(DrvAPIThread::current()->getState());
-    if (read_req) {
-        read_req->getResult(&result);
-    }
-    return result;
+    static_assert(sizeof(T) <= DrvAPIThreadState::MAX_PAYLOAD_SIZE, "read: type too large");
+    DrvAPIThread *thread = DrvAPIThread::current();
+    DrvAPIThreadState &state = thread->getState();
+    state.setRead(detail::to_absolute(thread, address), sizeof(T));
+    thread->yield();
+    return state.result<T>();
 }
 
 /**
@@ -33,8 +215,10 @@ T read(DrvAPIAddress address)
 template <typename T>
 void write(DrvAPIAddress address, T value)
 {
-    DrvAPIThread::current()->setState(std::make_shared<DrvAPIMemWriteConcrete<T>>(address, value));
-    DrvAPIThread::current()->yield();
+    static_assert(sizeof(T) <= DrvAPIThreadState::MAX_PAYLOAD_SIZE, "write: type too large");
+    DrvAPIThread *thread = DrvAPIThread::current();
+    thread->getState().setWrite(detail::to_absolute(thread, address), &value, sizeof(T));
+    thread->yield();
 }
 
 /**
@@ -44,46 +228,69 @@ void write(DrvAPIAddress address, T value)
 template <typename T>
 T atomic_swap(DrvAPIAddress address, T value)
 {
-    T result = 0;
-    DrvAPIThread::current()->setState(std::make_shared<DrvAPIMemAtomicConcrete<T, DrvAPIMemAtomicSWAP>>(address, value));
-    DrvAPIThread::current()->yield();
-    auto atomic_req = std::dynamic_pointer_cast<DrvAPIMemAtomic>(DrvAPIThread::current()->getState());
-    if (atomic_req) {
-        atomic_req->getResult(&result);
-    }
-    return result;
+    return detail::atomic_rmw<T, DrvAPIMemAtomicSWAP>(address, value);
 }
 
 /**
  * @brief atomic add to a memory address
+ *
+ * float and double are added as floating point values
  */
 template <typename T>
 T atomic_add(DrvAPIAddress address, T value)
 {
-    T result = 0;
-    DrvAPIThread::current()->setState(std::make_shared<DrvAPIMemAtomicConcrete<T, DrvAPIMemAtomicADD>>(address, value));
-    DrvAPIThread::current()->yield();
-    auto atomic_req = std::dynamic_pointer_cast<DrvAPIMemAtomic>(DrvAPIThread::current()->getState());
-    if (atomic_req) {
-        atomic_req->getResult(&result);
-    }
-    return result;
+    return detail::atomic_rmw<T, detail::add_op<T>()>(address, value);
 }
 
 /**
- * @brief atomic add to a memory address
+ * @brief atomic or to a memory address
  */
 template <typename T>
 T atomic_or(DrvAPIAddress address, T value)
 {
-    T result = 0;
-    DrvAPIThread::current()->setState(std::make_shared<DrvAPIMemAtomicConcrete<T, DrvAPIMemAtomicOR>>(address, value));
-    DrvAPIThread::current()->yield();
-    auto atomic_req = std::dynamic_pointer_cast<DrvAPIMemAtomic>(DrvAPIThread::current()->getState());
-    if (atomic_req) {
-        atomic_req->getResult(&result);
-    }
-    return result;
+    return detail::atomic_rmw<T, DrvAPIMemAtomicOR>(address, value);
+}
+
+/**
+ * @brief atomic and to a memory address
+ */
+template <typename T>
+T atomic_and(DrvAPIAddress address, T value)
+{
+    return detail::atomic_rmw<T, DrvAPIMemAtomicAND>(address, value);
+}
+
+/**
+ * @brief atomic xor to a memory address
+ */
+template <typename T>
+T atomic_xor(DrvAPIAddress address, T value)
+{
+    return detail::atomic_rmw<T, DrvAPIMemAtomicXOR>(address, value);
+}
+
+/**
+ * @brief atomic minimum to a memory address
+ *
+ * compares as signed or unsigned according to T
+ */
+template <typename T>
+T atomic_min(DrvAPIAddress address, T value)
+{
+    static_assert(std::is_integral<T>::value, "atomic_min: integral types only");
+    return detail::atomic_rmw<T, detail::min_op<T>()>(address, value);
+}
+
+/**
+ * @brief atomic maximum to a memory address
+ *
+ * compares as signed or unsigned according to T
+ */
+template <typename T>
+T atomic_max(DrvAPIAddress address, T value)
+{
+    static_assert(std::is_integral<T>::value, "atomic_max: integral types only");
+    return detail::atomic_rmw<T, detail::max_op<T>()>(address, value);
 }
 
 /**
@@ -92,14 +299,307 @@ T atomic_or(DrvAPIAddress address, T value)
 template <typename T>
 T atomic_cas(DrvAPIAddress address, T compare, T value)
 {
-    T result = 0;
-    DrvAPIThread::current()->setState(std::make_shared<DrvAPIMemAtomicConcreteExt<T, DrvAPIMemAtomicCAS>>(address, value, compare));
-    DrvAPIThread::current()->yield();
-    auto atomic_req = std::dynamic_pointer_cast<DrvAPIMemAtomic>(DrvAPIThread::current()->getState());
-    if (atomic_req) {
-        atomic_req->getResult(&result);
+    static_assert(sizeof(T) <= DrvAPIThreadState::MAX_ATOMIC_SIZE, "atomic_cas: type too large");
+    DrvAPIThread *thread = DrvAPIThread::current();
+    DrvAPIThreadState &state = thread->getState();
+    state.setAtomic(detail::to_absolute(thread, address), DrvAPIMemAtomicCAS, &value, &compare, sizeof(T));
+    thread->yield();
+    return state.result<T>();
+}
+
+/**
+ * @brief block until the word at address equals expected
+ *
+ * The thread is parked at the memory that owns address, and is woken
+ * when a write, atomic or active message touches that word's block. It
+ * then re-reads the word and parks again if it still differs, so wakeups
+ * may be spurious. Returns the value read.
+ *
+ * Only updates that reach the memory controller wake a waiter: a plain
+ * write held in a write-back dram cache does not, so release a waited-on
+ * word with an atomic. Memories that do not park waits (ramulator) answer
+ * with the current value and the thread polls.
+ */
+template <typename T>
+T wait_until(DrvAPIAddress address, T expected)
+{
+    static_assert(sizeof(T) <= DrvAPIThreadState::MAX_ATOMIC_SIZE, "wait_until: type too large");
+    DrvAPIThread *thread = DrvAPIThread::current();
+    DrvAPIThreadState &state = thread->getState();
+    DrvAPIAddress absolute = detail::to_absolute(thread, address);
+    T value;
+    do {
+        state.setWait(absolute, &expected, sizeof(T));
+        thread->yield();
+        value = state.result<T>();
+    } while (value != expected);
+    return value;
+}
+
+/**
+ * @brief non-blocking read from a memory address
+ */
+template <typename T>
+DrvAPIMemFuture<T> read_async(DrvAPIAddress address)
+{
+    static_assert(sizeof(T) <= DrvAPIThreadState::MAX_PAYLOAD_SIZE, "read_async: type too large");
+    DrvAPIThread *thread = DrvAPIThread::current();
+    int slot = detail::async_alloc(thread);
+    if (slot < 0) {
+        return DrvAPIMemFuture<T>::ready(read<T>(address));
     }
-    return result;
+    thread->getAsyncState(slot).setRead(detail::to_absolute(thread, address), sizeof(T));
+    detail::async_issue(thread, slot);
+    return DrvAPIMemFuture<T>(slot);
+}
+
+/**
+ * @brief non-blocking write to a memory address
+ */
+template <typename T>
+DrvAPIMemHandle write_async(DrvAPIAddress address, T value)
+{
+    static_assert(sizeof(T) <= DrvAPIThreadState::MAX_PAYLOAD_SIZE, "write_async: type too large");
+    DrvAPIThread *thread = DrvAPIThread::current();
+    int slot = detail::async_alloc(thread);
+    if (slot < 0) {
+        write<T>(address, value);
+        return DrvAPIMemHandle();
+    }
+    thread->getAsyncState(slot).setWrite(detail::to_absolute(thread, address), &value, sizeof(T));
+    detail::async_issue(thread, slot);
+    return DrvAPIMemHandle(slot);
+}
+
+namespace detail
+{
+/**
+ * @brief non-blocking atomic operation on a memory address
+ */
+template <typename T, DrvAPIMemAtomicType OP>
+DrvAPIMemFuture<T> atomic_rmw_async(DrvAPIAddress address, T value)
+{
+    static_assert(sizeof(T) <= DrvAPIThreadState::MAX_ATOMIC_SIZE, "atomic: type too large");
+    DrvAPIThread *thread = DrvAPIThread::current();
+    int slot = detail::async_alloc(thread);
+    if (slot < 0) {
+        return DrvAPIMemFuture<T>::ready(atomic_rmw<T, OP>(address, value));
+    }
+    thread->getAsyncState(slot).setAtomic(detail::to_absolute(thread, address), OP, &value, sizeof(T));
+    detail::async_issue(thread, slot);
+    return DrvAPIMemFuture<T>(slot);
+}
+} // namespace detail
+
+/**
+ * @brief non-blocking atomic swap to a memory address
+ */
+template <typename T>
+DrvAPIMemFuture<T> atomic_swap_async(DrvAPIAddress address, T value)
+{
+    return detail::atomic_rmw_async<T, DrvAPIMemAtomicSWAP>(address, value);
+}
+
+/**
+ * @brief non-blocking atomic add to a memory address
+ */
+template <typename T>
+DrvAPIMemFuture<T> atomic_add_async(DrvAPIAddress address, T value)
+{
+    return detail::atomic_rmw_async<T, detail::add_op<T>()>(address, value);
+}
+
+/**
+ * @brief non-blocking atomic or to a memory address
+ */
+template <typename T>
+DrvAPIMemFuture<T> atomic_or_async(DrvAPIAddress address, T value)
+{
+    return detail::atomic_rmw_async<T, DrvAPIMemAtomicOR>(address, value);
+}
+
+/**
+ * @brief non-blocking atomic and to a memory address
+ */
+template <typename T>
+DrvAPIMemFuture<T> atomic_and_async(DrvAPIAddress address, T value)
+{
+    return detail::atomic_rmw_async<T, DrvAPIMemAtomicAND>(address, value);
+}
+
+/**
+ * @brief non-blocking atomic xor to a memory address
+ */
+template <typename T>
+DrvAPIMemFuture<T> atomic_xor_async(DrvAPIAddress address, T value)
+{
+    return detail::atomic_rmw_async<T, DrvAPIMemAtomicXOR>(address, value);
+}
+
+/**
+ * @brief non-blocking atomic minimum to a memory address
+ */
+template <typename T>
+DrvAPIMemFuture<T> atomic_min_async(DrvAPIAddress address, T value)
+{
+    static_assert(std::is_integral<T>::value, "atomic_min_async: integral types only");
+    return detail::atomic_rmw_async<T, detail::min_op<T>()>(address, value);
+}
+
+/**
+ * @brief non-blocking atomic maximum to a memory address
+ */
+template <typename T>
+DrvAPIMemFuture<T> atomic_max_async(DrvAPIAddress address, T value)
+{
+    static_assert(std::is_integral<T>::value, "atomic_max_async: integral types only");
+    return detail::atomic_rmw_async<T, detail::max_op<T>()>(address, value);
+}
+
+/**
+ * @brief non-blocking atomic compare and swap to a memory address
+ */
+template <typename T>
+DrvAPIMemFuture<T> atomic_cas_async(DrvAPIAddress address, T compare, T value)
+{
+    static_assert(sizeof(T) <= DrvAPIThreadState::MAX_ATOMIC_SIZE, "atomic_cas_async: type too large");
+    DrvAPIThread *thread = DrvAPIThread::current();
+    int slot = detail::async_alloc(thread);
+    if (slot < 0) {
+        return DrvAPIMemFuture<T>::ready(atomic_cas<T>(address, compare, value));
+    }
+    thread->getAsyncState(slot).setAtomic(detail::to_absolute(thread, address), DrvAPIMemAtomicCAS, &value, &compare, sizeof(T));
+    detail::async_issue(thread, slot);
+    return DrvAPIMemFuture<T>(slot);
+}
+
+/**
+ * @brief read a block of memory into a native buffer
+ *
+ * The memory model splits the block into line-sized requests and keeps
+ * several of them in flight; the thread resumes once all have completed.
+ */
+inline void read_block(DrvAPIAddress address, void *buffer, std::size_t size)
+{
+    if (size == 0) {
+        return;
+    }
+    DrvAPIThread *thread = DrvAPIThread::current();
+    thread->getState().setReadBlock(detail::to_absolute(thread, address), buffer, size);
+    thread->yield();
+}
+
+/**
+ * @brief read count objects of type T starting at address
+ */
+template <typename T>
+void read_block(DrvAPIAddress address, T *values, std::size_t count)
+{
+    read_block(address, static_cast<void*>(values), count * sizeof(T));
+}
+
+/**
+ * @brief write a block of memory from a native buffer
+ *
+ * The memory model splits the block into line-sized requests and keeps
+ * several of them in flight; the thread resumes once all have completed.
+ */
+inline void write_block(DrvAPIAddress address, const void *buffer, std::size_t size)
+{
+    if (size == 0) {
+        return;
+    }
+    DrvAPIThread *thread = DrvAPIThread::current();
+    thread->getState().setWriteBlock(detail::to_absolute(thread, address), buffer, size);
+    thread->yield();
+}
+
+/**
+ * @brief write count objects of type T starting at address
+ */
+template <typename T>
+void write_block(DrvAPIAddress address, const T *values, std::size_t count)
+{
+    write_block(address, static_cast<const void*>(values), count * sizeof(T));
+}
+
+/**
+ * @brief set size bytes starting at address to value
+ */
+inline void memset(DrvAPIAddress address, int value, std::size_t size)
+{
+    if (size == 0) {
+        return;
+    }
+    DrvAPIThread *thread = DrvAPIThread::current();
+    thread->getState().setFillBlock(detail::to_absolute(thread, address), static_cast<uint8_t>(value), size);
+    thread->yield();
+}
+
+/**
+ * @brief copy size bytes from src to dst
+ *
+ * Data is staged through a native buffer of at most MEMCPY_CHUNK_SIZE bytes.
+ * The regions must not overlap.
+ */
+inline void memcpy(DrvAPIAddress dst, DrvAPIAddress src, std::size_t size)
+{
+    static constexpr std::size_t MEMCPY_CHUNK_SIZE = 4096;
+    std::vector<uint8_t> buffer(std::min(size, MEMCPY_CHUNK_SIZE));
+    while (size > 0) {
+        std::size_t chunk = std::min(size, MEMCPY_CHUNK_SIZE);
+        read_block(src, buffer.data(), chunk);
+        write_block(dst, buffer.data(), chunk);
+        src += chunk;
+        dst += chunk;
+        size -= chunk;
+    }
+}
+
+/**
+ * @brief read values[i] = base[idx[i]] for i in [0, count)
+ *
+ * Elements sharing a line are read with one request, and the memory keeps
+ * a bounded number of requests in flight; the thread resumes once the last
+ * response arrives. idx and values are native buffers.
+ */
+template <typename T, typename IDX>
+void gather(DrvAPIAddress base, const IDX *idx, std::size_t count, T *values)
+{
+    if (count == 0) {
+        return;
+    }
+    DrvAPIThread *thread = DrvAPIThread::current();
+    DrvAPIAddress abs_base = detail::to_absolute(thread, base);
+    std::vector<DrvAPIAddress> addresses(count);
+    for (std::size_t i = 0; i < count; i++) {
+        addresses[i] = abs_base + static_cast<DrvAPIAddress>(idx[i]) * sizeof(T);
+    }
+    thread->getState().setGather(addresses.data(), count, sizeof(T), values);
+    thread->yield();
+}
+
+/**
+ * @brief write base[idx[i]] = values[i] for i in [0, count)
+ *
+ * Contiguous elements sharing a line are written with one request, and the
+ * memory keeps a bounded number of requests in flight; the thread resumes
+ * once the last response arrives. If an index repeats, the last value wins.
+ */
+template <typename T, typename IDX>
+void scatter(DrvAPIAddress base, const IDX *idx, std::size_t count, const T *values)
+{
+    if (count == 0) {
+        return;
+    }
+    DrvAPIThread *thread = DrvAPIThread::current();
+    DrvAPIAddress abs_base = detail::to_absolute(thread, base);
+    std::vector<DrvAPIAddress> addresses(count);
+    for (std::size_t i = 0; i < count; i++) {
+        addresses[i] = abs_base + static_cast<DrvAPIAddress>(idx[i]) * sizeof(T);
+    }
+    thread->getState().setScatter(addresses.data(), count, sizeof(T), values);
+    thread->yield();
 }
 
 /**
@@ -107,8 +607,9 @@ T atomic_cas(DrvAPIAddress address, T compare, T value)
  */
 static inline void flush_cache(DrvAPIAddress cacheAddress, DrvAPIAddress line)
 {
-    DrvAPIThread::current()->setState(std::make_shared<DrvAPIFlushLine>(cacheAddress, line));
-    DrvAPIThread::current()->yield();
+    DrvAPIThread *thread = DrvAPIThread::current();
+    thread->getState().setFlushLine(detail::to_absolute(thread, cacheAddress), line);
+    thread->yield();
 }
 
 /**
@@ -116,12 +617,15 @@ static inline void flush_cache(DrvAPIAddress cacheAddress, DrvAPIAddress line)
  */
 static inline void invalidate_cache(DrvAPIAddress cacheAddress, DrvAPIAddress line)
 {
-    DrvAPIThread::current()->setState(std::make_shared<DrvAPIInvLine>(cacheAddress, line));
-    DrvAPIThread::current()->yield();
+    DrvAPIThread *thread = DrvAPIThread::current();
+    thread->getState().setInvLine(detail::to_absolute(thread, cacheAddress), line);
+    thread->yield();
 }
 
 /**
  * @brief flush entire dram cache on pxn
+ *
+ * one request; the memory system walks every line of every bank
  */
 void pxn_flush_cache(int pxn);
 
@@ -130,14 +634,33 @@ void pxn_flush_cache(int pxn);
  */
 void pxn_invalidate_cache(int pxn);
 
+/**
+ * @brief flush the dram cache lines holding [address, address+size)
+ *
+ * no-op for non-dram addresses or if dram is not cached
+ */
+void flush_range(DrvAPIAddress address, std::size_t size);
+
+/**
+ * @brief flush and invalidate the dram cache lines holding [address, address+size)
+ *
+ * no-op for non-dram addresses or if dram is not cached
+ */
+void invalidate_range(DrvAPIAddress address, std::size_t size);
+
 /**
  * @brief memory fence
  *
+ * blocks until all non-blocking memory operations issued by this thread have completed
  */
 inline void fence()
 {
-    // TODO: change when we add non-blocking memory ops
-    return;
+    DrvAPIThread *thread = DrvAPIThread::current();
+    if (thread->asyncPending() == 0) {
+        return;
+    }
+    thread->getState().setFence();
+    thread->yield();
 }
 
 } // namespace DrvAPI
@@ -10,9 +10,9 @@ namespace DrvAPI
 
 inline void nop(int cycles)
 {
-    DrvAPIThread::current()->setState
-        (std::make_shared<DrvAPINop>(cycles));
-    DrvAPIThread::current()->yield();
+    DrvAPIThread *thread = DrvAPIThread::current();
+    thread->getState().setNop(cycles);
+    thread->yield();
 }
 
 inline void wait(int cycles)
@@ -5,6 +5,8 @@
 #define DRV_API_READ_MODIFY_WRITE_H
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <type_traits>
 #include <cassert>
 #include <utility>
 #include <tuple>
@@ -16,6 +18,13 @@ typedef enum  {
     DrvAPIMemAtomicSWAP,
     DrvAPIMemAtomicADD,
     DrvAPIMemAtomicOR,
+    DrvAPIMemAtomicAND,
+    DrvAPIMemAtomicXOR,
+    DrvAPIMemAtomicMIN,  //!< signed minimum
+    DrvAPIMemAtomicMAX,  //!< signed maximum
+    DrvAPIMemAtomicMINU, //!< unsigned minimum
+    DrvAPIMemAtomicMAXU, //!< unsigned maximum
+    DrvAPIMemAtomicFADD, //!< floating point add; 4 bytes is float, 8 bytes is double
 } DrvAPIMemAtomicType;
 
 /**
@@ -33,6 +42,26 @@ inline bool DrvAPIMemAtomicTypeHasExt(DrvAPIMemAtomicType op)
     }
 }
 
+/**
+ * @brief add w and r as the floating point type of the same size as IntType
+ */
+template <typename IntType>
+IntType atomic_fadd(IntType w, IntType r) {
+    typedef typename std::conditional<sizeof(IntType) == sizeof(double), double, float>::type FloatType;
+    static_assert(sizeof(IntType) <= sizeof(double), "atomic_fadd: type too large");
+    if (sizeof(IntType) != sizeof(FloatType)) {
+        assert(false && "FADD requires a 4 or 8 byte operand");
+        return 0;
+    }
+    FloatType wf, rf;
+    std::memcpy(&wf, &w, sizeof(FloatType));
+    std::memcpy(&rf, &r, sizeof(FloatType));
+    FloatType of = wf + rf;
+    IntType o;
+    std::memcpy(&o, &of, sizeof(FloatType));
+    return o;
+}
+
 /**
  * @param w the write operand
  * @param r the value read from memory
@@ -42,6 +71,8 @@ inline bool DrvAPIMemAtomicTypeHasExt(DrvAPIMemAtomicType op)
 template <typename IntType>
 std::pair<IntType,IntType>
 atomic_modify(IntType w, IntType r, DrvAPIMemAtomicType op) {
+    typedef typename std::make_signed<IntType>::type SignedType;
+    typedef typename std::make_unsigned<IntType>::type UnsignedType;
     switch (op) {
     case DrvAPIMemAtomicSWAP:
         return {w, r};
@@ -49,6 +80,20 @@ atomic_modify(IntType w, IntType r, DrvAPIMemAtomicType op) {
         return {w + r, r};
     case DrvAPIMemAtomicOR:
         return {w | r, r};
+    case DrvAPIMemAtomicAND:
+        return {w & r, r};
+    case DrvAPIMemAtomicXOR:
+        return {w ^ r, r};
+    case DrvAPIMemAtomicMIN:
+        return {static_cast<SignedType>(w) < static_cast<SignedType>(r) ? w : r, r};
+    case DrvAPIMemAtomicMAX:
+        return {static_cast<SignedType>(w) > static_cast<SignedType>(r) ? w : r, r};
+    case DrvAPIMemAtomicMINU:
+        return {static_cast<UnsignedType>(w) < static_cast<UnsignedType>(r) ? w : r, r};
+    case DrvAPIMemAtomicMAXU:
+        return {static_cast<UnsignedType>(w) > static_cast<UnsignedType>(r) ? w : r, r};
+    case DrvAPIMemAtomicFADD:
+        return {atomic_fadd(w, r), r};
     default:
         assert(false && "Something went wrong");
     }
@@ -68,7 +68,6 @@ public:
 
 DrvAPIThread::DrvAPIThread()
     : thread_context_(nullptr)
-    , state_(new DrvAPIThreadIdle)
     , main_(nullptr)
     , argc_(0)
     , argv_(nullptr) {
@@ -83,7 +82,7 @@ void DrvAPIThread::start() {
             if (this->main_) {
                 this->main_(argc_, argv_);
                 this->main_ = nullptr;
-                this->state_ = std::make_shared<DrvAPITerminate>();
+                this->state_.setTerminate();
             }
             this->yield();
         }
@@ -96,12 +95,6 @@ void DrvAPIThread::start() {
     }
 }
 
-/* should only be called from the thread context */
-void DrvAPIThread::yield(DrvAPIThreadState *state) {
-    state_ = std::make_shared<DrvAPIThreadState>(*state);
-    yield();
-}
-
 /* should only be called from the thread context */
 void DrvAPIThread::yield() {
     (*main_context_)();
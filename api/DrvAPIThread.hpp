@@ -11,6 +11,7 @@
 #include <DrvAPIBits.hpp>
 #include <boost/coroutine2/all.hpp>
 #include <memory>
+#include <array>
 namespace DrvAPI
 {
 class DrvAPIThread
@@ -33,13 +34,6 @@ public:
    */
   void start();
 
-  /**
-   * @brief Yield back to the main context
-   *
-   * @param state
-   */
-  void yield(DrvAPIThreadState *state);
-
   /**
    * @brief Yield back to the main context
    */
@@ -51,18 +45,97 @@ public:
   void resume();
 
   /**
-   * @brief Set the state object
-   * 
-   * @param state 
+   * @brief Get the state object
+   *
+   * The state is a fixed request slot owned by this thread;
+   * fill it in and then yield to issue a request.
+   *
+   * @return DrvAPIThreadState&
    */
-  void setState(const std::shared_ptr<DrvAPIThreadState> &state) { state_ = state; }
+  DrvAPIThreadState &getState() { return state_; }
 
   /**
    * @brief Get the state object
-   * 
-   * @return std::shared_ptr<DrvAPIThreadState> 
+   *
+   * @return const DrvAPIThreadState&
+   */
+  const DrvAPIThreadState &getState() const { return state_; }
+
+  /**
+   * @brief Maximum number of non-blocking requests a thread can hold
+   */
+  static constexpr int MAX_ASYNC_STATES = 64;
+
+  /**
+   * @brief Allocate a slot for a non-blocking request
+   *
+   * @return the slot index, or -1 if all slots are in use
+   */
+  int allocAsyncState() {
+      if (~async_used_ == 0) {
+          return -1;
+      }
+      int slot = __builtin_ctzll(~async_used_);
+      async_used_ |= (1ull << slot);
+      async_states_[slot].setIdle();
+      return slot;
+  }
+
+  /**
+   * @brief Get the state for a non-blocking request
+   */
+  DrvAPIThreadState &getAsyncState(int slot) { return async_states_[slot]; }
+
+  /**
+   * @brief Get the slot index of a non-blocking request state
+   *
+   * @return the slot index, or -1 if state is not an async state
+   */
+  int getAsyncSlot(const DrvAPIThreadState &state) const {
+      if (&state < &async_states_[0] || &state >= &async_states_[0] + MAX_ASYNC_STATES) {
+          return -1;
+      }
+      return static_cast<int>(&state - &async_states_[0]);
+  }
+
+  /**
+   * @brief Mark a non-blocking request as issued to the memory system
+   */
+  void issueAsyncState() {
+      async_pending_++;
+  }
+
+  /**
+   * @brief Mark a non-blocking request as completed by the memory system
+   *
+   * Frees the slot if its handle has already been released.
+   */
+  void completeAsyncState(int slot) {
+      async_states_[slot].complete();
+      async_pending_--;
+      if (async_orphaned_ & (1ull << slot)) {
+          async_orphaned_ &= ~(1ull << slot);
+          async_used_ &= ~(1ull << slot);
+      }
+  }
+
+  /**
+   * @brief Release a non-blocking request slot
+   *
+   * If the request is still in flight the slot is freed when it completes.
+   */
+  void releaseAsyncState(int slot) {
+      if (async_states_[slot].canResume()) {
+          async_used_ &= ~(1ull << slot);
+      } else {
+          async_orphaned_ |= (1ull << slot);
+      }
+  }
+
+  /**
+   * @brief Number of non-blocking requests in flight
    */
-  std::shared_ptr<DrvAPIThreadState> &getState() { return state_; }
+  int asyncPending() const { return async_pending_; }
 
   /**
    * @brief Set the main function
@@ -209,7 +282,11 @@ private:
   std::shared_ptr<DrvAPISystem> system_ = nullptr; //!< System object
   std::unique_ptr<coro_t::pull_type> thread_context_; //!< Thread context, coroutine that can be resumed
   coro_t::push_type *main_context_; //!< Main context, can be yielded back to
-  std::shared_ptr<DrvAPIThreadState> state_; //!< Thread state
+  DrvAPIThreadState state_; //!< Thread state
+  std::array<DrvAPIThreadState, MAX_ASYNC_STATES> async_states_; //!< Non-blocking request states
+  uint64_t async_used_ = 0; //!< Bitmap of allocated async states
+  uint64_t async_orphaned_ = 0; //!< Bitmap of in-flight async states with no handle
+  int async_pending_ = 0; //!< Number of async states in flight
   drv_api_main_t main_; //!< Main function
   int argc_;
   char **argv_;
@@ -6,352 +6,477 @@
 #include <DrvAPIAddress.hpp>
 #include <DrvAPIReadModifyWrite.hpp>
 #include <DrvAPISystem.hpp>
+#include <cstdint>
+#include <cstring>
 #include <utility>
 #include <stdlib.h>
 namespace DrvAPI
 {
-/**
- * @brief The thread state
- * 
- */
-class DrvAPIThreadState
-{
-public:
-  DrvAPIThreadState() {}
-  virtual ~DrvAPIThreadState() {}
-  virtual bool canResume() const { return true; }
-};
 
 /**
- * @brief The thread state for an idle thread
- * 
+ * @brief The kind of request held in a thread's state slot
  */
-class DrvAPIThreadIdle : public DrvAPIThreadState
-{
-public:
-  DrvAPIThreadIdle() {}
-};
+typedef enum {
+    DrvAPIThreadStateIdle,          //!< thread is idle, can resume
+    DrvAPIThreadStateTerminate,     //!< thread has returned from main
+    DrvAPIThreadStateNop,           //!< thread is waiting for a number of cycles
+    DrvAPIThreadStateMemRead,       //!< memory read
+    DrvAPIThreadStateMemWrite,      //!< memory write
+    DrvAPIThreadStateMemAtomic,     //!< atomic read-modify-write
+    DrvAPIThreadStateFlushLine,     //!< flush a cache line
+    DrvAPIThreadStateInvLine,       //!< invalidate a cache line
+    DrvAPIThreadStateFlushRange,    //!< flush the cache lines holding a range of addresses
+    DrvAPIThreadStateInvRange,      //!< flush and invalidate the cache lines holding a range of addresses
+    DrvAPIThreadStateFlushCache,    //!< flush every line of a pxn's dram cache
+    DrvAPIThreadStateInvCache,      //!< invalidate every line of a pxn's dram cache
+    DrvAPIThreadStateToNativePointer, //!< translate an address to a native pointer
+    DrvAPIThreadStateAsyncIssue,    //!< issue a non-blocking request held in an async slot
+    DrvAPIThreadStateAsyncWait,     //!< wait for a non-blocking request to complete
+    DrvAPIThreadStateFence,         //!< wait for all non-blocking requests to complete
+    DrvAPIThreadStateMemReadBlock,  //!< read a block of memory into a native buffer
+    DrvAPIThreadStateMemWriteBlock, //!< write a block of memory from a native buffer
+    DrvAPIThreadStateMemFillBlock,  //!< fill a block of memory with a byte value
+    DrvAPIThreadStateMemGather,     //!< read elements at a list of addresses into a native buffer
+    DrvAPIThreadStateMemScatter,    //!< write elements from a native buffer to a list of addresses
+    DrvAPIThreadStateActiveMessage, //!< run a function at the memory that owns an address
+    DrvAPIThreadStateMemWait,       //!< park until a word equals a value
+    DrvAPIThreadStateBarrier,       //!< wait at the barrier network, summing a value across all threads
+    DrvAPIThreadStateDMAStart,      //!< queue a copy on the core's dma engine
+    DrvAPIThreadStateDMAWait,       //!< wait for a queued dma copy to complete
+} DrvAPIThreadStateType;
 
 /**
- * @brief Terminated thread state
+ * @brief The thread state
+ *
+ * A fixed-size, tagged request slot. Each DrvAPIThread owns exactly one
+ * of these; the API functions fill it in before yielding and the simulator
+ * switches on type() to service it. Payloads are stored inline so that no
+ * heap allocation is done per operation.
  */
-class DrvAPITerminate : public DrvAPIThreadState
+class DrvAPIThreadState
 {
 public:
-  DrvAPITerminate() {}
-  bool canResume() const override { return false; }
-};
+  static constexpr std::size_t MAX_PAYLOAD_SIZE = 64; //!< largest read/write payload in bytes
+  static constexpr std::size_t MAX_ATOMIC_SIZE = sizeof(uint64_t); //!< largest atomic operand in bytes
 
-/**
- * @brief No-op thread state
- */
-class DrvAPINop : public DrvAPIThreadState
-{
-public:
-    DrvAPINop(int count) : can_resume_(false), count_(count) {}
-    bool canResume() const override { return can_resume_; }
-    int count() const { return count_; }
-    void complete(){ can_resume_ = true; }
-private:
-    bool can_resume_;
-    int  count_;
-};
+  DrvAPIThreadState() {}
 
-/**
- * @brief Base thread state for a memory operation
- * 
- */
-class DrvAPIMem : public DrvAPIThreadState
-{
-public:
-  DrvAPIMem(DrvAPIAddress address);
-    
-  virtual bool canResume() const  { return can_resume_; }
-  
+  /**
+   * @brief the kind of request in this slot
+   */
+  DrvAPIThreadStateType type() const { return type_; }
+
+  bool canResume() const { return can_resume_; }
   void complete() { can_resume_ = true; }
-  DrvAPIAddress getAddress() const { return address_; }
 
-protected:
-  bool can_resume_ = false;
-  DrvAPIAddress address_;
-};
+  ///////////////////////////
+  // request constructors  //
+  ///////////////////////////
+  void setIdle() {
+      type_ = DrvAPIThreadStateIdle;
+      can_resume_ = true;
+  }
 
+  void setTerminate() {
+      type_ = DrvAPIThreadStateTerminate;
+      can_resume_ = false;
+  }
 
-/**
- * @brief flush cache line thread state
- */
-class DrvAPIFlushLine : public DrvAPIMem
-{
-public:
-    DrvAPIFlushLine(DrvAPIAddress address, DrvAPIAddress line) : DrvAPIMem(address), line_(line) {}
-    DrvAPIAddress getLine() const { return line_; }
-    void setLine(DrvAPIAddress line) { line_ = line; }
-    DrvAPIAddress line_ = 0;    
-};
+  void setNop(int count) {
+      type_ = DrvAPIThreadStateNop;
+      can_resume_ = false;
+      count_ = count;
+  }
 
-/**
- * @brief invalidate cache line thread state
- */
-class DrvAPIInvLine : public DrvAPIMem
-{
-public:
-    DrvAPIInvLine(DrvAPIAddress address, DrvAPIAddress line) : DrvAPIMem(address), line_(line) {}
-    DrvAPIAddress getLine() const { return line_; }
-    void setLine(DrvAPIAddress line) { line_ = line; }
-    DrvAPIAddress line_ = 0;    
-};
+  void setRead(DrvAPIAddress address, std::size_t size) {
+      setMem(DrvAPIThreadStateMemRead, address, size);
+  }
 
-/**
- * @brief Base thread state for a memory read
- * 
- * @tparam T 
- */
-class DrvAPIMemRead : public DrvAPIMem
-{
-public:
-  DrvAPIMemRead(DrvAPIAddress address)
-    : DrvAPIMem(address){}
+  void setWrite(DrvAPIAddress address, const void *payload, std::size_t size) {
+      setMem(DrvAPIThreadStateMemWrite, address, size);
+      std::memcpy(payload_, payload, size);
+  }
 
+  void setAtomic(DrvAPIAddress address, DrvAPIMemAtomicType op, const void *payload, std::size_t size) {
+      setMem(DrvAPIThreadStateMemAtomic, address, size);
+      op_ = op;
+      has_ext_ = false;
+      std::memcpy(&wdata_, payload, size);
+  }
 
-  virtual void getResult(void *p) = 0;
-  virtual void setResult(void *p) = 0;
-  virtual size_t getSize() const { return 0; }
-};
+  void setAtomic(DrvAPIAddress address, DrvAPIMemAtomicType op, const void *payload, const void *ext, std::size_t size) {
+      setAtomic(address, op, payload, size);
+      has_ext_ = true;
+      std::memcpy(&ext_, ext, size);
+  }
 
-/**
- * @brief Concrete thread state for a memory read
- * 
- * @tparam T 
- */
-template <typename T>
-class DrvAPIMemReadConcrete : public DrvAPIMemRead
-{
-public:
-  DrvAPIMemReadConcrete(DrvAPIAddress address)
-      : DrvAPIMemRead(address) {}
+  void setWait(DrvAPIAddress address, const void *expected, std::size_t size) {
+      setMem(DrvAPIThreadStateMemWait, address, size);
+      std::memcpy(payload_, expected, size);
+  }
 
-  virtual void getResult(void *p) override {
-    *static_cast<T*>(p) = value_;
+  void setFlushLine(DrvAPIAddress address, DrvAPIAddress line) {
+      setMem(DrvAPIThreadStateFlushLine, address, 0);
+      line_ = line;
   }
 
-  virtual void setResult(void *p) override {
-    value_ = *static_cast<T*>(p);
+  void setInvLine(DrvAPIAddress address, DrvAPIAddress line) {
+      setMem(DrvAPIThreadStateInvLine, address, 0);
+      line_ = line;
   }
 
-  virtual size_t getSize() const override {
-    return sizeof(T);
+  void setFlushRange(DrvAPIAddress address, std::size_t size) {
+      setBlock(DrvAPIThreadStateFlushRange, address, size);
   }
-  
-private:
-  T value_;
-};
 
-/**
- * @brief Base thread state for a memory write
- * 
- * @tparam T 
- */
-class DrvAPIMemWrite : public DrvAPIMem
-{
-public:
-  DrvAPIMemWrite(DrvAPIAddress address)
-    : DrvAPIMem(address) {}
-  virtual void getPayload(void *p) = 0;
-  virtual void setPayload(void *p)  = 0;
-  virtual size_t getSize() const { return 0; }
-};
+  void setInvRange(DrvAPIAddress address, std::size_t size) {
+      setBlock(DrvAPIThreadStateInvRange, address, size);
+  }
 
-/**
- * @brief Concrete thread state for a memory write
- * 
- * @tparam T 
- */
-template <typename T>
-class DrvAPIMemWriteConcrete : public DrvAPIMemWrite
-{
-public:
-  DrvAPIMemWriteConcrete(DrvAPIAddress address, T value)
-      : DrvAPIMemWrite(address), value_(value) {}
-  
-  virtual void getPayload(void *p) override {
-    *static_cast<T*>(p) = value_;
+  /**
+   * address is the pxn's dram base, lines counts every line of every bank
+   */
+  void setFlushCache(DrvAPIAddress address, std::size_t lines) {
+      setBlock(DrvAPIThreadStateFlushCache, address, lines);
   }
 
-  virtual void setPayload(void *p) override {
-    value_ = *static_cast<T*>(p);
+  void setInvCache(DrvAPIAddress address, std::size_t lines) {
+      setBlock(DrvAPIThreadStateInvCache, address, lines);
   }
 
-  virtual size_t getSize() const override {
-    return sizeof(T);
+  void setReadBlock(DrvAPIAddress address, void *buffer, std::size_t size) {
+      setBlock(DrvAPIThreadStateMemReadBlock, address, size);
+      block_ = static_cast<uint8_t*>(buffer);
   }
-  
-private:
-  T value_;
-};
 
+  void setWriteBlock(DrvAPIAddress address, const void *buffer, std::size_t size) {
+      setBlock(DrvAPIThreadStateMemWriteBlock, address, size);
+      block_ = static_cast<uint8_t*>(const_cast<void*>(buffer));
+  }
 
-/**
- * @brief Base thread state for an atomic read-modify-write
- */
-class DrvAPIMemAtomic : public DrvAPIMem {
-public:
-  DrvAPIMemAtomic(DrvAPIAddress address)
-    : DrvAPIMem(address) {}
-  virtual void getPayload(void *p) = 0;
-  virtual void setPayload(void *p)  = 0;
-  virtual void getResult(void *p) = 0;
-  virtual void setResult(void *p) = 0;
-  /*
-   * Extended payload for atomic operations with two operands
-   */
-  virtual void getPayloadExt(void *p) {}
-  virtual void setPayloadExt(void *p) {}
-  virtual bool hasExt() const { return false; }
-  virtual void modify() = 0;
-  virtual size_t getSize() const { return 0; }
-  virtual DrvAPIMemAtomicType getOp() const = 0;
-};
+  void setFillBlock(DrvAPIAddress address, uint8_t value, std::size_t size) {
+      setBlock(DrvAPIThreadStateMemFillBlock, address, size);
+      block_ = nullptr;
+      fill_ = value;
+  }
 
-/**
- * @brief Concrete thread state for an atomic read-modify-write
- * 
- * @tparam T The data type.
- * @tparam op The operation.
- */
-template <typename T, DrvAPIMemAtomicType OP>
-class DrvAPIMemAtomicConcrete : public DrvAPIMemAtomic {
-public:
-  DrvAPIMemAtomicConcrete(DrvAPIAddress address, T value)
-    : DrvAPIMemAtomic(address), w_value_(value) {}
-  void getPayload(void *p) override {
-    *static_cast<T*>(p) = w_value_;
+  void setGather(const DrvAPIAddress *addresses, std::size_t count, std::size_t size, void *buffer) {
+      setMem(DrvAPIThreadStateMemGather, addresses[0], size);
+      addresses_ = addresses;
+      elements_ = count;
+      block_ = static_cast<uint8_t*>(buffer);
   }
-  void setPayload(void *p) override {
-    w_value_ = *static_cast<T*>(p);
+
+  void setScatter(const DrvAPIAddress *addresses, std::size_t count, std::size_t size, const void *buffer) {
+      setMem(DrvAPIThreadStateMemScatter, addresses[0], size);
+      addresses_ = addresses;
+      elements_ = count;
+      block_ = static_cast<uint8_t*>(const_cast<void*>(buffer));
   }
-  void getResult(void *p) override {
-    *static_cast<T*>(p) = r_value_;
+
+  void setActiveMessage(DrvAPIAddress address, int function_id, const void *data, std::size_t size, std::size_t result_size) {
+      setMem(DrvAPIThreadStateActiveMessage, address, size);
+      function_id_ = function_id;
+      result_size_ = result_size;
+      std::memcpy(payload_, data, size);
   }
-  void setResult(void *p) override {
-    r_value_  = *static_cast<T*>(p);
+
+  void setToNativePointer(DrvAPIAddress address) {
+      setMem(DrvAPIThreadStateToNativePointer, address, 0);
+      native_pointer_ = nullptr;
+      region_size_ = 0;
   }
-  void modify() override {
-    std::tie(w_value_, r_value_) = atomic_modify<T>(w_value_, r_value_, OP);
+
+  void setAsyncIssue(int slot) {
+      type_ = DrvAPIThreadStateAsyncIssue;
+      can_resume_ = false;
+      async_slot_ = slot;
   }
-  size_t getSize() const override { return sizeof(T); }
-  DrvAPIMemAtomicType getOp() const override { return OP; }
-private:
-  T r_value_;
-  T w_value_;
-};
 
-/**
- * @brief Concrete thread state for an atomic read-modify-write
- *
- * @tparam T The data type.
- * @tparam op The operation.
- */
-template <typename T, DrvAPIMemAtomicType OP>
-class DrvAPIMemAtomicConcreteExt : public DrvAPIMemAtomic {
-public:
-  DrvAPIMemAtomicConcreteExt(DrvAPIAddress address, T value, T ext)
-      : DrvAPIMemAtomic(address), w_value_(value), ext_value_(ext) {}
+  void setAsyncWait(int slot) {
+      type_ = DrvAPIThreadStateAsyncWait;
+      can_resume_ = false;
+      async_slot_ = slot;
+  }
 
-  void getPayload(void *p) override {
-    *static_cast<T*>(p) = w_value_;
+  void setFence() {
+      type_ = DrvAPIThreadStateFence;
+      can_resume_ = false;
   }
-  void setPayload(void *p) override {
-    w_value_ = *static_cast<T*>(p);
+
+  void setBarrier(int64_t value) {
+      type_ = DrvAPIThreadStateBarrier;
+      can_resume_ = false;
+      size_ = sizeof(value);
+      std::memcpy(payload_, &value, sizeof(value));
   }
-  void getResult(void *p) override {
-    *static_cast<T*>(p) = r_value_;
+
+  void setDMAStart(DrvAPIAddress dst, DrvAPIAddress src, std::size_t size) {
+      setMem(DrvAPIThreadStateDMAStart, dst, size);
+      src_ = src;
   }
-  void setResult(void *p) override {
-    r_value_  = *static_cast<T*>(p);
+
+  void setDMAWait(int64_t handle) {
+      type_ = DrvAPIThreadStateDMAWait;
+      can_resume_ = false;
+      size_ = sizeof(handle);
+      std::memcpy(payload_, &handle, sizeof(handle));
   }
-  void getPayloadExt(void *p) override {
-    *static_cast<T*>(p) = ext_value_;
+
+  ///////////////////////////
+  // nop                   //
+  ///////////////////////////
+  int count() const { return count_; }
+
+  ///////////////////////////
+  // async issue/wait      //
+  ///////////////////////////
+  static constexpr int ASYNC_SLOT_ANY = -1; //!< wait for any async slot
+
+  /**
+   * @brief the async slot to issue or wait on
+   */
+  int asyncSlot() const { return async_slot_; }
+
+  ///////////////////////////
+  // memory requests       //
+  ///////////////////////////
+  DrvAPIAddress getAddress() const { return address_; }
+  std::size_t getSize() const { return size_; }
+
+  /**
+   * @brief copy the write payload to p
+   */
+  void getPayload(void *p) const {
+      std::memcpy(p, type_ == DrvAPIThreadStateMemAtomic ? (const void*)&wdata_ : payload_, size_);
   }
-  void setPayloadExt(void *p) override {
-    ext_value_ = *static_cast<T*>(p);
+
+  /**
+   * @brief copy the read result to p
+   */
+  void getResult(void *p) const {
+      std::memcpy(p, type_ == DrvAPIThreadStateMemAtomic ? (const void*)&rdata_ : payload_, size_);
   }
-  bool hasExt() const override {
-    return true;
+
+  /**
+   * @brief set the read result from p
+   */
+  void setResult(const void *p) {
+      std::memcpy(type_ == DrvAPIThreadStateMemAtomic ? (void*)&rdata_ : payload_, p, size_);
   }
-  void modify() override {
-      std::tie(w_value_,r_value_) = atomic_modify<T>(w_value_, r_value_, ext_value_, OP);
+
+  /**
+   * @brief get the read result as a T
+   */
+  template <typename T>
+  T result() const {
+      T r;
+      getResult(&r);
+      return r;
   }
-  size_t getSize() const override { return sizeof(T); }
-  DrvAPIMemAtomicType getOp() const override { return OP; }
-private:
-  T r_value_;
-  T w_value_;
-  T ext_value_;
-};
 
+  ///////////////////////////
+  // atomics               //
+  ///////////////////////////
+  DrvAPIMemAtomicType getOp() const { return op_; }
+  bool hasExt() const { return has_ext_; }
+  void getPayloadExt(void *p) const { std::memcpy(p, &ext_, size_); }
+
+  /**
+   * @brief apply the atomic operation
+   *
+   * Expects the value read from memory to have been set with setResult().
+   * Afterwards getPayload() returns the value to write back to memory.
+   */
+  void modify() {
+      uint64_t o = 0;
+      if (has_ext_) {
+          atomic_modify(&wdata_, &rdata_, &ext_, &o, op_, size_);
+      } else {
+          atomic_modify(&wdata_, &rdata_, &o, op_, size_);
+      }
+      wdata_ = o;
+  }
+
+  ///////////////////////////
+  // block requests        //
+  ///////////////////////////
+  /**
+   * @brief is this a block request
+   */
+  bool isBlock() const {
+      return type_ == DrvAPIThreadStateMemReadBlock
+          || type_ == DrvAPIThreadStateMemWriteBlock
+          || type_ == DrvAPIThreadStateMemFillBlock;
+  }
+
+  /**
+   * @brief the native buffer for a read/write block request
+   */
+  uint8_t *getBlock() const { return block_; }
+
+  /**
+   * @brief the byte value for a fill block request
+   */
+  uint8_t getFill() const { return fill_; }
+
+  /**
+   * @brief bytes of the block not yet sent to memory
+   */
+  std::size_t blockRemaining() const { return size_ - block_issued_; }
+
+  /**
+   * @brief chunks of the block in flight
+   */
+  std::size_t blockPending() const { return block_pending_; }
+
+  /**
+   * @brief claim the next chunk of the block to send to memory
+   *
+   * The chunk never crosses a multiple of max_size.
+   *
+   * @return the offset of the chunk within the block
+   */
+  std::size_t issueBlock(std::size_t max_size, std::size_t *chunk_size) {
+      std::size_t offset = block_issued_;
+      std::size_t chunk = max_size - ((address_ + offset) % max_size);
+      if (chunk > size_ - offset) {
+          chunk = size_ - offset;
+      }
+      block_issued_ += chunk;
+      block_pending_++;
+      *chunk_size = chunk;
+      return offset;
+  }
+
+  /**
+   * @brief retire a chunk of the block
+   *
+   * @return true if the whole block has completed
+   */
+  bool completeBlock() {
+      block_pending_--;
+      return block_pending_ == 0 && block_issued_ == size_;
+  }
+
+  ///////////////////////////
+  // gather/scatter        //
+  ///////////////////////////
+  /**
+   * @brief the absolute address of each element; getSize() is the element size
+   */
+  const DrvAPIAddress *getAddresses() const { return addresses_; }
+
+  /**
+   * @brief the number of elements
+   */
+  std::size_t getElements() const { return elements_; }
+
+  ///////////////////////////
+  // active messages       //
+  ///////////////////////////
+  /**
+   * @brief the registered DrvAPIFunction type id; getPayload() returns the function data
+   */
+  int getFunctionId() const { return function_id_; }
+
+  /**
+   * @brief the size of the value the function returns
+   */
+  std::size_t getResultSize() const { return result_size_; }
+
+  /**
+   * @brief set the value the function returned
+   *
+   * Afterwards getResult()/result<T>() return it.
+   */
+  void setActiveMessageResult(const void *p) {
+      size_ = result_size_;
+      std::memcpy(payload_, p, size_);
+  }
+
+  ///////////////////////////
+  // flush/invalidate      //
+  ///////////////////////////
+  DrvAPIAddress getLine() const { return line_; }
+
+  /**
+   * @brief is this a range or whole-cache flush/invalidate
+   *
+   * These are issued like block requests: a range in line-sized chunks,
+   * a whole cache one line index at a time.
+   */
+  bool isFlushBlock() const {
+      return type_ == DrvAPIThreadStateFlushRange
+          || type_ == DrvAPIThreadStateInvRange
+          || type_ == DrvAPIThreadStateFlushCache
+          || type_ == DrvAPIThreadStateInvCache;
+  }
+
+  ///////////////////////////
+  // dma                   //
+  ///////////////////////////
+  /**
+   * @brief the source of a dma copy; getAddress() is the destination and getSize() the size
+   */
+  DrvAPIAddress getDMASource() const { return src_; }
+
+  /**
+   * @brief set the handle of a queued dma copy
+   *
+   * Afterwards getResult()/result<T>() return it.
+   */
+  void setDMAHandle(int64_t handle) {
+      size_ = sizeof(handle);
+      std::memcpy(payload_, &handle, sizeof(handle));
+  }
+
+  ///////////////////////////
+  // to native pointer     //
+  ///////////////////////////
+  void *getNativePointer() const { return native_pointer_; }
+  void setNativePointer(void *p) { native_pointer_ = p; }
+  std::size_t getRegionSize() const { return region_size_; }
+  void setRegionSize(std::size_t size) { region_size_ = size; }
 
-/**
- * @brief Request to the simulator to convert a DrvAPIAddress to a native pointer
- *
- * WARNING:
- * This state type will not work in multi-rank simulations.
- * This state type may not work depending on the memory model used.
- * This state type may not work depending on the memory controller used.
- *
- * Avoid using this function if possible. But if you need to use it, it's here.
- * But use it at your own risk, and don't expect it to work for all memory models
- * and simulation configurations.
- */
-class DrvAPIToNativePointer : public DrvAPIMem
-{
-public:
-    /**
-     * @brief Construct a new DrvAPI To Native Pointer object
-     */
-    DrvAPIToNativePointer(DrvAPIAddress address)
-        : DrvAPIMem(address)
-        , native_pointer_(nullptr)
-        , region_size_(0) {
-    }
-
-    /**
-     * @brief Get the native pointer
-     *
-     * @return void*
-     */
-    void *getNativePointer() const {
-        return native_pointer_;
-    }
-
-    /**
-     * @brief Set the native pointer
-     *
-     * @param p
-     */
-    void setNativePointer(void *p) {
-        native_pointer_ = p;
-    }
-
-    /**
-     * @brief Get the size of the memory region
-     *
-     * @return std::size_t
-     */
-    std::size_t getRegionSize() const {
-        return region_size_;
-    }
-
-    /**
-     * @brief Set the size of the memory region
-     *
-     * @param size
-     */
-    void setRegionSize(std::size_t size) {
-        region_size_ = size;
-    }
 private:
-    void *native_pointer_;  //!< the native pointer
-    std::size_t region_size_;      //!< the size of the memory region
+  void setBlock(DrvAPIThreadStateType type, DrvAPIAddress address, std::size_t size) {
+      setMem(type, address, size);
+      block_issued_ = 0;
+      block_pending_ = 0;
+  }
+
+  void setMem(DrvAPIThreadStateType type, DrvAPIAddress address, std::size_t size) {
+      type_ = type;
+      can_resume_ = false;
+      address_ = address;
+      size_ = size;
+  }
+
+  DrvAPIThreadStateType type_ = DrvAPIThreadStateIdle; //!< the kind of request
+  bool can_resume_ = true; //!< the request has completed
+  bool has_ext_ = false; //!< atomic has an extended operand
+  DrvAPIMemAtomicType op_ = DrvAPIMemAtomicSWAP; //!< atomic operation
+  int count_ = 0; //!< nop cycles
+  int async_slot_ = 0; //!< async slot to issue or wait on
+  std::size_t size_ = 0; //!< size of the memory access
+  DrvAPIAddress address_ = 0; //!< absolute address of the memory access
+  DrvAPIAddress line_ = 0; //!< line for flush/invalidate
+  DrvAPIAddress src_ = 0; //!< absolute source address of a dma copy
+  void *native_pointer_ = nullptr; //!< result of a to native pointer request
+  std::size_t region_size_ = 0; //!< size of the region at native_pointer_
+  uint64_t wdata_ = 0; //!< atomic write operand
+  uint64_t rdata_ = 0; //!< atomic read result
+  uint64_t ext_ = 0; //!< atomic extended operand
+  uint8_t *block_ = nullptr; //!< native buffer of a block request
+  const DrvAPIAddress *addresses_ = nullptr; //!< element addresses of a gather/scatter
+  std::size_t elements_ = 0; //!< element count of a gather/scatter
+  int function_id_ = 0; //!< function type id of an active message
+  std::size_t result_size_ = 0; //!< result size of an active message
+  uint8_t fill_ = 0; //!< byte value of a fill block request
+  std::size_t block_issued_ = 0; //!< bytes of the block sent to memory
+  std::size_t block_pending_ = 0; //!< chunks of the block in flight
+  alignas(uint64_t) uint8_t payload_[MAX_PAYLOAD_SIZE]; //!< read result or write payload
 };
 
 }
@@ -111,7 +111,7 @@ function (drvx_add_executable name)
     set(SOURCES ${ARGV})
     list(POP_FRONT SOURCES)
     add_library(${name} SHARED ${SOURCES})
-    target_link_libraries(${name} PRIVATE drvapi)
+    target_link_libraries(${name} PRIVATE drvapi drvapiapp)
   endif()
 endfunction()
 
@@ -416,6 +416,7 @@ macro (drvr_rv64_build)
       CONFIGURE_COMMAND
       ${CMAKE_COMMAND}
       -DARCH_RV64=1
+      -DDRV_RV64_COMPRESSED=${DRV_RV64_COMPRESSED}
       -DCMAKE_MODULE_PATH=${CMAKE_MODULE_PATH}
       -DCMAKE_C_COMPILER=${GNU_RISCV_TOOLCHAIN_PREFIX}/bin/riscv64-unknown-elfpandodrvsim-gcc
       -DCMAKE_CXX_COMPILER=${GNU_RISCV_TOOLCHAIN_PREFIX}/bin/riscv64-unknown-elfpandodrvsim-g++
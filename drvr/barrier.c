@@ -0,0 +1,28 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+
+#include <stdint.h>
+#include <stdio.h>
+#include <pandohammer/cpuinfo.h>
+#include <pandohammer/hartbarrier.h>
+
+#define ROUNDS 4
+
+int main()
+{
+    int64_t harts = numPXN() * numPXNPods() * numPodCores() * myCoreThreads();
+    int64_t id = ((myPXNId() * numPXNPods() + myPodId()) * numPodCores() + myCoreId()) * myCoreThreads() + myThreadId();
+    int64_t expect = harts * (harts - 1) / 2;
+    for (int round = 0; round < ROUNDS; round++) {
+        int64_t sum = hartallreduce_add(id);
+        if (sum != expect) {
+            printf("hart %ld: round %d: sum = %ld, expected %ld\n", id, round, sum, expect);
+            return 1;
+        }
+        hartbarrier();
+    }
+    if (id == 0) {
+        printf("barrier: %ld harts passed %d rounds\n", harts, ROUNDS);
+    }
+    return 0;
+}
@@ -27,6 +27,7 @@
 #include <pandohammer/cpuinfo.h>
 #include <pandohammer/atomic.h>
 #include <pandohammer/hartsleep.h>
+#include <pandohammer/hartwait.h>
 
 static constexpr int HARTS = 16;
 
@@ -44,12 +45,8 @@ static inline void barrier(int total_harts) {
         atomic_swap_i64(&global_barrier_count, 0);
         atomic_fetch_add_i64(&global_barrier_phase, 1);
     } else {
-        long w = 1;
-        long wmax = 8 * 1024;
-        while (global_barrier_phase == cur) {
-            if (w < wmax) w <<= 1;
-            hartsleep(w);
-        }
+        // park until the last hart bumps the phase
+        hartwait_i64(&global_barrier_phase, cur + 1);
     }
 
     thread_phase_counter[hid] = cur + 1;
@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+#include <DrvAPI.hpp>
+#include <DrvAPIActiveMessage.hpp>
+#include <cstdio>
+#include <cstdint>
+
+using namespace DrvAPI;
+
+#define SLOTS 64
+
+DrvAPIGlobalL2SP<int64_t> count;
+DrvAPIGlobalL2SP<int64_t> slots[SLOTS];
+DrvAPIGlobalL2SP<int64_t> ready;
+DrvAPIGlobalL2SP<int64_t> done;
+
+int ActiveMessageMain(int argc, char *argv[])
+{
+    int tid = myThreadId();
+    int threads = myCoreThreads();
+    if (tid == 0) {
+        count = 0;
+        ready = 1;
+    }
+    while (ready != 1) {
+        nop(100);
+    }
+
+    // append to a list in one round trip: read the count,
+    // write the slot, bump the count, return the slot index
+    DrvAPIAddress count_addr = &count;
+    DrvAPIAddress slots_addr = &slots[0];
+    int per_thread = SLOTS / threads;
+    for (int i = 0; i < per_thread; i++) {
+        int64_t value = tid * SLOTS + i;
+        int64_t slot = execute_at(count_addr, [count_addr, slots_addr, value](DrvAPIActiveMessageContext &ctx) {
+            int64_t n = ctx.load<int64_t>(count_addr);
+            ctx.store<int64_t>(slots_addr + n * sizeof(int64_t), value);
+            ctx.store<int64_t>(count_addr, n + 1);
+            return n;
+        });
+        if (slot < 0 || slot >= SLOTS) {
+            printf("FAIL: thread %d got slot %ld\n", tid, slot);
+            return 1;
+        }
+    }
+
+    // no result
+    DrvAPIAddress done_addr = &done;
+    execute_at(done_addr, [done_addr](DrvAPIActiveMessageContext &ctx) {
+        ctx.store<int64_t>(done_addr, ctx.load<int64_t>(done_addr) + 1);
+    });
+
+    if (tid != 0)
+        return 0;
+
+    while (done != threads) {
+        nop(100);
+    }
+    int64_t n = count;
+    if (n != per_thread * threads) {
+        printf("FAIL: count = %ld, expected %d\n", n, per_thread * threads);
+        return 1;
+    }
+    // every value should appear exactly once
+    for (int t = 0; t < threads; t++) {
+        for (int i = 0; i < per_thread; i++) {
+            int64_t value = t * SLOTS + i;
+            int found = 0;
+            for (int64_t s = 0; s < n; s++) {
+                if (slots[s] == value)
+                    found++;
+            }
+            if (found != 1) {
+                printf("FAIL: value %ld found %d times\n", value, found);
+                return 1;
+            }
+        }
+    }
+    printf("PASS: %ld active messages appended\n", n);
+    return 0;
+}
+
+declare_drv_api_main(ActiveMessageMain);
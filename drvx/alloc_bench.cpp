@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+#include <DrvAPI.hpp>
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <array>
+#include <inttypes.h>
+
+using namespace DrvAPI;
+
+#define BATCH 8
+#define MAX_THREADS 1024
+
+// pointers handed from one thread to the next for the cross-thread free phase
+DrvAPIGlobalDRAM<std::array<uint64_t, MAX_THREADS * BATCH>> handoff;
+
+static int64_t my_id() {
+    return ((myPXNId() * numPXNPods() + myPodId()) * numPodCores() + myCoreId()) * myCoreThreads() + myThreadId();
+}
+
+/**
+ * allocate BATCH objects, check nobody else got them, free them; repeat
+ */
+static bool alloc_free(DrvAPIMemoryType type, size_t size, int64_t rounds, int64_t id) {
+    DrvAPIPointer<int64_t> p[BATCH];
+    for (int64_t r = 0; r < rounds; r++) {
+        for (int i = 0; i < BATCH; i++) {
+            p[i] = DrvAPIMemoryAlloc(type, size);
+            *p[i] = id * BATCH + i;
+        }
+        for (int i = 0; i < BATCH; i++) {
+            if (*p[i] != id * BATCH + i) {
+                printf("FAIL: thread %" PRId64 ": object %" PRIx64 " of size %zu handed out twice\n",
+                       id, (uint64_t)p[i], size);
+                return false;
+            }
+            DrvAPIMemoryFree(p[i], size);
+        }
+    }
+    return true;
+}
+
+static void report(const char *phase, size_t size, int64_t ops, uint64_t start) {
+    uint64_t cycles = cycle() - start;
+    printf("%-8s size %6zu: %8" PRId64 " ops in %10" PRIu64 " cycles: %8.3f ops/kcycle\n",
+           phase, size, ops, cycles, 1000.0 * ops / cycles);
+}
+
+int AllocBenchMain(int argc, char *argv[])
+{
+    int64_t rounds = 64;
+    if (argc > 1) {
+        rounds = std::stoll(argv[1]);
+    }
+    int64_t threads = numPXNs() * numPXNPods() * numPodCores() * myCoreThreads();
+    int64_t id = my_id();
+    bool ok = true;
+
+    DrvAPIMemoryAllocatorInit();
+    if (id == 0) {
+        printf("alloc_bench: %" PRId64 " threads, %" PRId64 " rounds of %d\n", threads, rounds, BATCH);
+    }
+
+    // local alloc/free from each size range
+    struct { DrvAPIMemoryType type; size_t size; const char *name; } phases[] = {
+        {DrvAPIMemoryL2SP, 16, "l2sp"},
+        {DrvAPIMemoryDRAM, 16, "dram"},
+        {DrvAPIMemoryDRAM, 256, "dram"},
+        {DrvAPIMemoryDRAM, 4096, "dram"},
+    };
+    for (auto &phase : phases) {
+        barrier();
+        uint64_t start = cycle();
+        ok = alloc_free(phase.type, phase.size, rounds, id) && ok;
+        barrier();
+        if (id == 0) {
+            report(phase.name, phase.size, 2 * BATCH * rounds * threads, start);
+        }
+    }
+
+    // each thread frees what its neighbour allocated
+    if (threads <= MAX_THREADS) {
+        DrvAPIPointer<uint64_t> slots = handoff.address();
+        barrier();
+        uint64_t start = cycle();
+        for (int64_t r = 0; r < rounds; r++) {
+            for (int i = 0; i < BATCH; i++) {
+                slots[id * BATCH + i] = DrvAPIMemoryAlloc(DrvAPIMemoryDRAM, 64);
+            }
+            barrier();
+            int64_t from = (id + 1) % threads;
+            for (int i = 0; i < BATCH; i++) {
+                DrvAPIMemoryFree(DrvAPIPointer<void>(slots[from * BATCH + i]), 64);
+            }
+            barrier();
+        }
+        if (id == 0) {
+            report("handoff", 64, 2 * BATCH * rounds * threads, start);
+        }
+    }
+
+    int64_t failed = allreduce_add(ok ? 0 : 1);
+    if (id == 0) {
+        if (failed == 0) {
+            printf("PASS: %" PRId64 " threads\n", threads);
+        } else {
+            printf("FAIL: %" PRId64 " threads failed\n", failed);
+        }
+    }
+    return failed == 0 ? 0 : 1;
+}
+
+declare_drv_api_main(AllocBenchMain);
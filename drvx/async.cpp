@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+#include <DrvAPI.hpp>
+#include <cstdio>
+#include <vector>
+
+using namespace DrvAPI;
+
+#define N 16
+
+DrvAPI::DrvAPIGlobalL2SP<long> data[N];
+DrvAPI::DrvAPIGlobalL2SP<long> sum;
+
+int AsyncMain(int argc, char *argv[])
+{
+    if (myThreadId() != 0)
+        return 0;
+
+    // issue all writes, then wait for them to drain
+    for (int i = 0; i < N; i++) {
+        write_async<long>(&data[i], i);
+    }
+    fence();
+
+    // issue all reads before waiting on any of them
+    std::vector<DrvAPIMemFuture<long>> reads;
+    for (int i = 0; i < N; i++) {
+        reads.push_back(read_async<long>(&data[i]));
+    }
+    long expect = 0;
+    for (int i = 0; i < N; i++) {
+        long v = reads[i].get();
+        if (v != i) {
+            printf("FAIL: data[%d] = %ld, expected %d\n", i, v, i);
+            return 1;
+        }
+        expect += i;
+    }
+
+    // atomics in flight together
+    std::vector<DrvAPIMemFuture<long>> adds;
+    for (int i = 0; i < N; i++) {
+        adds.push_back(atomic_add_async<long>(&sum, i));
+    }
+    for (auto &f : adds) {
+        f.wait();
+    }
+    long s = sum;
+    if (s != expect) {
+        printf("FAIL: sum = %ld, expected %ld\n", s, expect);
+        return 1;
+    }
+    printf("PASS: async reads, writes, and atomics\n");
+    return 0;
+}
+
+declare_drv_api_main(AsyncMain);
@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+#include <DrvAPI.hpp>
+#include <cstdio>
+#include <cstdint>
+
+using namespace DrvAPI;
+
+DrvAPIGlobalL2SP<int64_t>  and_var;
+DrvAPIGlobalL2SP<int64_t>  xor_var;
+DrvAPIGlobalL2SP<int64_t>  min_var;
+DrvAPIGlobalL2SP<int64_t>  max_var;
+DrvAPIGlobalL2SP<uint64_t> minu_var;
+DrvAPIGlobalL2SP<uint64_t> maxu_var;
+DrvAPIGlobalL2SP<double>   fadd_var;
+DrvAPIGlobalL2SP<int64_t>  ready;
+DrvAPIGlobalL2SP<int64_t>  done;
+
+#define CHECK(cond, ...)                        \
+    do {                                        \
+        if (!(cond)) {                          \
+            printf("FAIL: " __VA_ARGS__);       \
+            return 1;                           \
+        }                                       \
+    } while (0)
+
+int AtomicsMain(int argc, char *argv[])
+{
+    int tid = myThreadId();
+    int threads = myCoreThreads();
+    if (tid == 0) {
+        and_var = -1;
+        xor_var = 0;
+        min_var = INT64_MAX;
+        max_var = INT64_MIN;
+        minu_var = UINT64_MAX;
+        maxu_var = 0;
+        fadd_var = 0.0;
+        done = 0;
+        ready = 1;
+    }
+    while (static_cast<int64_t>(ready) == 0) {}
+
+    // each of the first 64 threads clears its own bit and flips its own
+    // bit; every thread offers (tid - threads/2) as a signed candidate
+    if (tid < 64) {
+        int64_t bit = static_cast<int64_t>(uint64_t(1) << tid);
+        atomic_and<int64_t>(&and_var, ~bit);
+        atomic_xor<int64_t>(&xor_var, bit);
+    }
+    atomic_min<int64_t>(&min_var, tid - threads / 2);
+    atomic_max<int64_t>(&max_var, tid - threads / 2);
+    atomic_min<uint64_t>(&minu_var, static_cast<uint64_t>(tid - threads / 2));
+    atomic_max<uint64_t>(&maxu_var, static_cast<uint64_t>(tid - threads / 2));
+    atomic_add<double>(&fadd_var, 0.5);
+    atomic_add<int64_t>(&done, 1);
+
+    if (tid != 0) {
+        return 0;
+    }
+    while (static_cast<int64_t>(done) != threads) {}
+
+    int64_t mask = (threads >= 64) ? -1 : static_cast<int64_t>((uint64_t(1) << threads) - 1);
+    CHECK(static_cast<int64_t>(and_var) == ~mask, "and = %lx\n", static_cast<int64_t>(and_var));
+    CHECK(static_cast<int64_t>(xor_var) == mask, "xor = %lx\n", static_cast<int64_t>(xor_var));
+    CHECK(static_cast<int64_t>(min_var) == -(threads / 2), "min = %ld\n", static_cast<int64_t>(min_var));
+    CHECK(static_cast<int64_t>(max_var) == threads - 1 - threads / 2, "max = %ld\n", static_cast<int64_t>(max_var));
+    // as unsigned, 0 is the smallest candidate and -1 is the largest when threads > 1
+    uint64_t expect_minu = 0;
+    uint64_t expect_maxu = static_cast<uint64_t>(threads > 1 ? -1 : 0);
+    CHECK(static_cast<uint64_t>(minu_var) == expect_minu, "minu = %lu\n", static_cast<uint64_t>(minu_var));
+    CHECK(static_cast<uint64_t>(maxu_var) == expect_maxu, "maxu = %lu\n", static_cast<uint64_t>(maxu_var));
+    CHECK(static_cast<double>(fadd_var) == 0.5 * threads, "fadd = %f\n", static_cast<double>(fadd_var));
+    printf("PASS: and, xor, min, max, minu, maxu, fadd\n");
+    return 0;
+}
+
+declare_drv_api_main(AtomicsMain);
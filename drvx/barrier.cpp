@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+#include <DrvAPI.hpp>
+#include <cstdio>
+#include <cstdint>
+
+using namespace DrvAPI;
+
+#define ROUNDS 4
+
+DrvAPIGlobalL2SP<int64_t> arrived;
+
+int BarrierMain(int argc, char *argv[])
+{
+    int64_t threads = numPXNs() * numPXNPods() * numPodCores() * myCoreThreads();
+    int64_t id = ((myPXNId() * numPXNPods() + myPodId()) * numPodCores() + myCoreId()) * myCoreThreads() + myThreadId();
+    int64_t expect = threads * (threads - 1) / 2;
+
+    for (int r = 0; r < ROUNDS; r++) {
+        // nobody leaves the barrier before everyone has counted themselves
+        atomic_add<int64_t>(&arrived, 1);
+        barrier();
+        int64_t count = arrived;
+        if (count < (r + 1) * threads) {
+            printf("FAIL: thread %ld: round %d: %ld arrived before the barrier released\n", id, r, count);
+            return 1;
+        }
+        barrier();
+
+        int64_t sum = allreduce_add(id);
+        if (sum != expect) {
+            printf("FAIL: thread %ld: round %d: sum = %ld, expected %ld\n", id, r, sum, expect);
+            return 1;
+        }
+    }
+
+    if (id == 0) {
+        printf("PASS: %ld threads passed %d barriers\n", threads, ROUNDS);
+    }
+    return 0;
+}
+
+declare_drv_api_main(BarrierMain);
@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+#include <DrvAPI.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace DrvAPI;
+
+int BlockMain(int argc, char *argv[])
+{
+    if (myThreadId() != 0 || myCoreId() != 0)
+        return 0;
+
+    size_t n = 1024;
+    if (argc > 1) {
+        n = strtoull(argv[1], nullptr, 0);
+    }
+
+    DrvAPIAddress src = myAbsoluteDRAMBase();
+    DrvAPIAddress dst = src + n * sizeof(uint64_t);
+    DrvAPIAddress l1sp = myAbsoluteL1SPBase();
+
+    std::vector<uint64_t> host(n);
+    for (size_t i = 0; i < n; i++) {
+        host[i] = i * 3 + 1;
+    }
+
+    // write_block/read_block round trip
+    write_block(src, host.data(), n);
+    std::vector<uint64_t> back(n, 0);
+    read_block(src, back.data(), n);
+    for (size_t i = 0; i < n; i++) {
+        if (back[i] != host[i]) {
+            printf("FAIL: read_block[%zu] = %lu, expected %lu\n", i, back[i], host[i]);
+            return 1;
+        }
+    }
+
+    // memcpy dram to dram at an unaligned offset
+    memcpy(dst + 3, src, n * sizeof(uint64_t) - 3);
+    std::vector<uint8_t> bytes(n * sizeof(uint64_t) - 3);
+    read_block(dst + 3, bytes.data(), bytes.size());
+    const uint8_t *expect = reinterpret_cast<const uint8_t*>(host.data());
+    for (size_t i = 0; i < bytes.size(); i++) {
+        if (bytes[i] != expect[i]) {
+            printf("FAIL: memcpy byte %zu = %u, expected %u\n", i, bytes[i], expect[i]);
+            return 1;
+        }
+    }
+
+    // memset l1sp tile
+    size_t tile = std::min<size_t>(n, 256);
+    memset(l1sp, 0xab, tile);
+    for (size_t i = 0; i < tile; i++) {
+        uint8_t b = read<uint8_t>(l1sp + i);
+        if (b != 0xab) {
+            printf("FAIL: memset byte %zu = %u\n", i, b);
+            return 1;
+        }
+    }
+
+    // compare against scalar copy
+    uint64_t t0 = DrvAPI::cycle();
+    for (size_t i = 0; i < n; i++) {
+        write<uint64_t>(dst + i * sizeof(uint64_t), read<uint64_t>(src + i * sizeof(uint64_t)));
+    }
+    uint64_t t1 = DrvAPI::cycle();
+    memcpy(dst, src, n * sizeof(uint64_t));
+    uint64_t t2 = DrvAPI::cycle();
+    printf("PASS: copied %zu words: scalar %lu cycles, memcpy %lu cycles\n", n, t1 - t0, t2 - t1);
+    return 0;
+}
+
+declare_drv_api_main(BlockMain);
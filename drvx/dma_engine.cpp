@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+#include <DrvAPI.hpp>
+#include <cstdio>
+#include <cstdint>
+#include <array>
+#include <inttypes.h>
+
+using namespace DrvAPI;
+
+#define WORDS 128
+
+DrvAPIGlobalL1SP<std::array<uint64_t, WORDS>> l1sp_buf;
+DrvAPIGlobalL2SP<std::array<uint64_t, WORDS>> l2sp_buf;
+DrvAPIGlobalDRAM<std::array<uint64_t, WORDS>> dram_buf;
+
+static uint64_t pattern(int i) {
+    return 0x0123456789abcdefull ^ (i * 0x9e3779b97f4a7c15ull);
+}
+
+/**
+ * check that words [first, last) of dst hold the pattern
+ */
+static bool check(const char *name, DrvAPIPointer<uint64_t> dst, int first, int last) {
+    for (int i = first; i < last; i++) {
+        uint64_t v = dst[i];
+        if (v != pattern(i)) {
+            printf("FAIL: %s: word %d: expected %016" PRIx64 ", got %016" PRIx64 "\n",
+                   name, i, pattern(i), v);
+            return false;
+        }
+    }
+    return true;
+}
+
+int DMAEngineMain(int argc, char *argv[])
+{
+    DrvAPIPointer<uint64_t> l1sp = l1sp_buf.address();
+    DrvAPIPointer<uint64_t> l2sp = l2sp_buf.address();
+    DrvAPIPointer<uint64_t> dram = dram_buf.address();
+    size_t bytes = WORDS * sizeof(uint64_t);
+    bool ok = true;
+
+    for (int i = 0; i < WORDS; i++) {
+        l2sp[i] = pattern(i);
+    }
+
+    // l2sp => dram, overlapped with compute
+    uint64_t start = cycle();
+    DrvAPIDMAHandle h = dma_start(dram, l2sp, bytes);
+    nop(100);
+    uint64_t overlap = cycle() - start;
+    dma_wait(h);
+    printf("l2sp => dram: %zu bytes in %" PRIu64 " cycles (%" PRIu64 " overlapped)\n",
+           bytes, cycle() - start, overlap);
+    ok = check("l2sp => dram", dram, 0, WORDS) && ok;
+
+    // dram => l1sp, in two descriptors, the second not line aligned
+    start = cycle();
+    size_t half = bytes / 2 + sizeof(uint64_t);
+    DrvAPIDMAHandle lo = dma_start(l1sp, dram, half);
+    DrvAPIDMAHandle hi = dma_start(&l1sp[half / sizeof(uint64_t)], &dram[half / sizeof(uint64_t)], bytes - half);
+    dma_wait(hi);
+    dma_wait(lo);
+    printf("dram => l1sp: %zu bytes in %" PRIu64 " cycles\n", bytes, cycle() - start);
+    ok = check("dram => l1sp", l1sp, 0, WORDS) && ok;
+
+    // waiting again and empty copies return at once
+    dma_wait(h);
+    dma_wait(dma_start(l1sp, l2sp, 0));
+
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
+
+declare_drv_api_main(DMAEngineMain);
@@ -2,8 +2,17 @@
 
 using namespace DrvAPI;
 
+DrvAPIGlobalDRAM<uint64_t> word;
+
 int Main(int argc, char *argv[])
 {
+    word = 0xdeadbeef;
+    flush_range(word.address(), sizeof(uint64_t));
+    invalidate_range(word.address(), sizeof(uint64_t));
+    if (word != 0xdeadbeef) {
+        printf("FAIL: word = %lx after flush/invalidate\n", (uint64_t)word);
+        return 1;
+    }
     pxn_flush_cache(myPXNId());
     pxn_invalidate_cache(myPXNId());
     return 0;
@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+#include <DrvAPI.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace DrvAPI;
+
+int GatherMain(int argc, char *argv[])
+{
+    if (myThreadId() != 0 || myCoreId() != 0)
+        return 0;
+
+    size_t n = 256;
+    if (argc > 1) {
+        n = strtoull(argv[1], nullptr, 0);
+    }
+
+    DrvAPIAddress table = myAbsoluteDRAMBase();
+    std::vector<int64_t> host(n);
+    for (size_t i = 0; i < n; i++) {
+        host[i] = -static_cast<int64_t>(i);
+    }
+    write_block(table, host.data(), n);
+
+    // a permutation with clustered runs so some requests merge
+    std::vector<uint32_t> idx(n);
+    for (size_t i = 0; i < n; i++) {
+        idx[i] = static_cast<uint32_t>((i * 7) % n);
+    }
+
+    // gather vs. dependent scalar loads
+    std::vector<int64_t> out(n, 1);
+    uint64_t t0 = DrvAPI::cycle();
+    for (size_t i = 0; i < n; i++) {
+        out[i] = read<int64_t>(table + idx[i] * sizeof(int64_t));
+    }
+    uint64_t t1 = DrvAPI::cycle();
+    gather(table, idx.data(), n, out.data());
+    uint64_t t2 = DrvAPI::cycle();
+    for (size_t i = 0; i < n; i++) {
+        if (out[i] != host[idx[i]]) {
+            printf("FAIL: gather[%zu] = %ld, expected %ld\n", i, out[i], host[idx[i]]);
+            return 1;
+        }
+    }
+
+    // scatter with a repeated index: the last value wins
+    std::vector<uint32_t> sidx = {3, 1, 3, 2};
+    std::vector<int64_t> svals = {10, 11, 12, 13};
+    scatter(table, sidx.data(), sidx.size(), svals.data());
+    int64_t expect[4] = {host[0], 11, 13, 12};
+    for (int i = 0; i < 4; i++) {
+        int64_t v = read<int64_t>(table + i * sizeof(int64_t));
+        if (v != expect[i]) {
+            printf("FAIL: scatter[%d] = %ld, expected %ld\n", i, v, expect[i]);
+            return 1;
+        }
+    }
+    printf("PASS: %zu elements: scalar %lu cycles, gather %lu cycles\n", n, t1 - t0, t2 - t1);
+    return 0;
+}
+
+declare_drv_api_main(GatherMain);
@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+
+#include <DrvAPI.hpp>
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include <inttypes.h>
+
+using namespace DrvAPI;
+
+DrvAPIGlobalL1SP<int64_t> g_done; //!< set by thread 0 when it has finished measuring
+
+static constexpr int PARK_CYCLES = 1000;
+
+/**
+ * Measures host time spent per simulated cycle while one thread on the core
+ * is busy and the rest are parked on long nops until it is done.
+ *
+ * Run with different values of --core-threads; the reported host ns/cycle
+ * should stay flat as the number of parked threads grows.
+ */
+int ReadyThreadsMain(int argc, char *argv[])
+{
+    std::string n_reads_str = "100000";
+    if (argc > 1) {
+        n_reads_str = argv[1];
+    }
+    int64_t n_reads = std::stoll(n_reads_str);
+
+    if (myThreadId() != 0) {
+        // stay parked for the whole measurement, however long it takes
+        while (g_done == 0) {
+            nop(PARK_CYCLES);
+        }
+        return 0;
+    }
+
+    DrvAPIAddress addr = myAbsoluteL1SPBase();
+    auto host_start = std::chrono::steady_clock::now();
+    uint64_t cycle_start = cycle();
+    for (int64_t i = 0; i < n_reads; i++) {
+        read<int64_t>(addr);
+    }
+    uint64_t cycle_end = cycle();
+    auto host_end = std::chrono::steady_clock::now();
+    g_done = 1;
+
+    uint64_t cycles = cycle_end - cycle_start;
+    int64_t host_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(host_end - host_start).count();
+    printf("Core %4d: threads = %4d, reads = %" PRId64 ", cycles = %" PRIu64
+           ", host ns/cycle = %.2f, cycles/read = %.2f\n",
+           myCoreId(),
+           myCoreThreads(),
+           n_reads,
+           cycles,
+           cycles ? static_cast<double>(host_ns) / cycles : 0.0,
+           n_reads ? static_cast<double>(cycles) / n_reads : 0.0);
+    return 0;
+}
+
+declare_drv_api_main(ReadyThreadsMain);
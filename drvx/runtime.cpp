@@ -5,7 +5,6 @@
 #include <string>
 #include <cstdint>
 #include <inttypes.h>
-#include <deque>
 #include "runtime_common.h"
 #include "runtime_task.h"
 
@@ -23,50 +22,78 @@ using StaticL2SP = DrvAPIGlobalL2SP<T>;
 template <typename T>
 using StaticMainMem = DrvAPIGlobalDRAM<T>;
 
-/* a core's task queue */
-struct task_queue {
-    std::deque<task*> deque;
-    std::mutex mtx;
-    void push(task *t) {
-        std::lock_guard<std::mutex> lock(mtx);
-        deque.push_back(t);
-    }
-    task *pop() {
-        std::lock_guard<std::mutex> lock(mtx);
-        if (deque.empty()) {
-            return nullptr;
-        }
-        task *t = deque.front();
-        deque.pop_front();
-        return t;
-    }
-};
+/*
+ * Every worker thread owns a Chase-Lev deque in its core's L1SP.
+ * The owner pushes and pops at the bottom; thieves take from the top
+ * with a compare-and-swap. Deques have a fixed capacity; a spawn that
+ * finds its deque full runs the task inline.
+ *
+ * Tasks sent to a specific core with execute_on() go through the core's
+ * inbox, a lock-free stack whose head is in the core's L1SP. A worker that
+ * drains the inbox keeps the tasks on a private list; they are never put
+ * on the deque, where a thief could move them off the core.
+ */
+static constexpr int MAX_CORE_THREADS = 16;
+static constexpr int64_t DEQUE_CAPACITY = 64;
+
+/* task_groups nested deeper than this use a dram counter */
+static constexpr int MAX_GROUP_DEPTH = 16;
+
+/* escalate to a wider steal scope after this many failed attempts */
+static constexpr int STEAL_ESCALATE = 4;
+
+/* the longest an idle worker waits between steal attempts */
+static constexpr int MAX_BACKOFF = 1000;
 
 static constexpr int64_t QUEUE_UNINIT = 0;
 static constexpr int64_t QUEUE_INIT_IN_PROGRESS = 1;
 static constexpr int64_t QUEUE_INIT = 2;
 
-/* allocate one of these pointers on every core's l1 scratchpad */
+/* allocate one of these on every core's l1 scratchpad */
 StaticL1SP<int64_t> queue_initialized; //!< set if initialized
-StaticL1SP<task_queue*> this_cores_task_queue; //!< pointer to this core's task queue
+StaticL1SP<int64_t> this_cores_terminate; //!< time for the threads to quit
+StaticL1SP<int64_t> this_cores_inbox; //!< head of the list of tasks sent to this core
+StaticL1SP<int64_t> deque_top[MAX_CORE_THREADS]; //!< next task to steal
+StaticL1SP<int64_t> deque_bottom[MAX_CORE_THREADS]; //!< next free slot
+StaticL1SP<int64_t> deque_buffer[MAX_CORE_THREADS * DEQUE_CAPACITY]; //!< task pointers
+StaticL1SP<int64_t> this_threads_worker[MAX_CORE_THREADS]; //!< each thread's worker
+StaticL1SP<int64_t> group_pending[MAX_CORE_THREADS * MAX_GROUP_DEPTH]; //!< task_group counters
 
 /* allocate on of these per pxn */
-StaticMainMem<int64_t> this_pxns_terminate; //!< time for the thread to quit
 StaticMainMem<int64_t> this_pxns_num_cores_ready; //!< number of cores ready to run
+StaticMainMem<int64_t> this_pxns_next_core; //!< where the command processor places tasks next
+
+/* statistics, summed on pxn 0 as workers exit */
+StaticMainMem<int64_t> this_pxns_workers_done; //!< number of workers that have exited
+StaticMainMem<int64_t> this_pxns_tasks; //!< tasks executed
+StaticMainMem<int64_t> this_pxns_steals; //!< successful steals
+StaticMainMem<int64_t> this_pxns_steal_attempts; //!< steal attempts
+StaticMainMem<int64_t> this_pxns_idle_cycles; //!< cycles spent without a task
 
-static DrvAPIPointer<int64_t> terminate_pointer()
+/* a task pointer in a deque slot or inbox */
+static task *to_task(int64_t v) { return reinterpret_cast<task*>(v); }
+static int64_t from_task(task *t) { return reinterpret_cast<int64_t>(t); }
+
+/**
+ * the address of a variable on pxn 0
+ */
+static DrvAPIAddress on_pxn0(DrvAPIAddress addr)
 {
-    /* pxn 0 holds the absolute */
-    DrvAPIAddressInfo info = decodeAddress(&this_pxns_terminate);
+    DrvAPIAddressInfo info = decodeAddress(addr);
     info.set_absolute(true).set_pxn(0);
     return encodeAddressInfo(info);
 }
 
-static DrvAPIPointer<int64_t> num_cores_ready_pointer()
+/**
+ * the address of an l1sp variable on another core
+ */
+static DrvAPIAddress on_core(DrvAPIAddress addr, int64_t pxn, int64_t pod, int64_t core)
 {
-    /* pxn 0 holds the absolute */
-    DrvAPIAddressInfo info = decodeAddress(&this_pxns_num_cores_ready);
-    info.set_absolute(true).set_pxn(0);
+    DrvAPIAddressInfo info = decodeAddress(addr);
+    info.set_absolute(true)
+        .set_pxn(pxn)
+        .set_pod(pod)
+        .set_core(core);
     return encodeAddressInfo(info);
 }
 
@@ -75,20 +102,284 @@ static int64_t num_cores()
     return DrvAPI::numPXNs() * DrvAPI::numPXNPods() * DrvAPI::numPodCores();
 }
 
+/**
+ * threads on each core that run as workers; the rest sit out
+ */
+static int core_workers()
+{
+    return std::min(myCoreThreads(), MAX_CORE_THREADS);
+}
+
+/**
+ * a worker's view of a Chase-Lev deque
+ */
+struct deque_ref {
+    DrvAPIAddress top;
+    DrvAPIAddress bottom;
+    DrvAPIAddress buffer;
+
+    DrvAPIAddress slot(int64_t i) const {
+        return buffer + (i % DEQUE_CAPACITY) * sizeof(int64_t);
+    }
+
+    /* owner: push at the bottom; false if full */
+    bool push(task *t) const {
+        int64_t b = read<int64_t>(bottom);
+        int64_t tp = read<int64_t>(top);
+        if (b - tp >= DEQUE_CAPACITY)
+            return false;
+        write<int64_t>(slot(b), from_task(t));
+        write<int64_t>(bottom, b + 1);
+        return true;
+    }
+
+    /* owner: pop from the bottom */
+    task *pop() const {
+        int64_t b = read<int64_t>(bottom) - 1;
+        write<int64_t>(bottom, b);
+        int64_t tp = read<int64_t>(top);
+        if (tp > b) {
+            write<int64_t>(bottom, b + 1);
+            return nullptr;
+        }
+        task *t = to_task(read<int64_t>(slot(b)));
+        if (tp == b) {
+            // last task: race thieves for it
+            if (atomic_cas<int64_t>(top, tp, tp + 1) != tp)
+                t = nullptr;
+            write<int64_t>(bottom, b + 1);
+        }
+        return t;
+    }
+
+    /* thief: take from the top */
+    task *steal() const {
+        int64_t tp = read<int64_t>(top);
+        int64_t b = read<int64_t>(bottom);
+        if (tp >= b)
+            return nullptr;
+        task *t = to_task(read<int64_t>(slot(tp)));
+        if (atomic_cas<int64_t>(top, tp, tp + 1) != tp)
+            return nullptr;
+        return t;
+    }
+};
+
+/**
+ * the deque of thread on a core
+ */
+static deque_ref deque_of(int64_t pxn, int64_t pod, int64_t core, int thread)
+{
+    deque_ref d;
+    d.top = on_core(&deque_top[thread], pxn, pod, core);
+    d.bottom = on_core(&deque_bottom[thread], pxn, pod, core);
+    d.buffer = on_core(&deque_buffer[thread * DEQUE_CAPACITY], pxn, pod, core);
+    return d;
+}
+
+/**
+ * per-worker state; lives on the worker's stack
+ */
+struct worker {
+    deque_ref deque;
+    task *local = nullptr; //!< tasks from the inbox; never stolen
+    uint64_t rng;
+    int group_depth = 0; //!< task_group counters in use
+    int failed_steals = 0;
+    int64_t tasks = 0;
+    int64_t steals = 0;
+    int64_t steal_attempts = 0;
+    int64_t idle_cycles = 0;
+
+    uint64_t random() {
+        // xorshift64
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        return rng;
+    }
+};
+
+/**
+ * this thread's worker; null on the command processor
+ */
+static worker *current_worker()
+{
+    if (isCommandProcessor())
+        return nullptr;
+    return reinterpret_cast<worker*>(read<int64_t>(&this_threads_worker[myThreadId()]));
+}
+
+/**
+ * run a task and count it
+ */
+static void run_task(worker *w, task *t)
+{
+    t->execute();
+    delete t;
+    w->tasks++;
+}
+
+/**
+ * take the next task off this worker's private list
+ */
+static task *pop_local(worker *w)
+{
+    task *t = w->local;
+    if (t)
+        w->local = t->next;
+    return t;
+}
+
+/**
+ * move tasks sent with execute_on() to this worker's private list
+ */
+static task *drain_inbox(worker *w)
+{
+    if (read<int64_t>(&this_cores_inbox) == 0)
+        return nullptr;
+    task *list = to_task(atomic_swap<int64_t>(&this_cores_inbox, 0));
+    if (!list)
+        return nullptr;
+    task *tail = list;
+    while (tail->next)
+        tail = tail->next;
+    tail->next = w->local;
+    w->local = list->next;
+    return list;
+}
+
+/**
+ * pick a victim and try to steal one task from it
+ *
+ * victims are chosen at random, first among threads on this core, then cores
+ * in this pod, pods in this pxn, and finally other pxns as attempts fail
+ */
+static task *try_steal(worker *w)
+{
+    int64_t pxn = myPXNId(), pod = myPodId(), core = myCoreId();
+    int thread = myThreadId();
+    int level = std::min(w->failed_steals / STEAL_ESCALATE, 3);
+    // skip levels that have no other victims
+    if (level == 0 && core_workers() == 1) level = 1;
+    if (level == 1 && numPodCores() == 1) level = 2;
+    if (level == 2 && numPXNPods() == 1) level = 3;
+    if (level == 3 && numPXNs() == 1) {
+        if (core_workers() > 1) level = 0;
+        else if (numPodCores() > 1) level = 1;
+        else if (numPXNPods() > 1) level = 2;
+        else return nullptr;
+    }
+    switch (level) {
+    case 3: pxn = (pxn + 1 + w->random() % (numPXNs() - 1)) % numPXNs();
+        pod = w->random() % numPXNPods();
+        core = w->random() % numPodCores();
+        break;
+    case 2: pod = (pod + 1 + w->random() % (numPXNPods() - 1)) % numPXNPods();
+        core = w->random() % numPodCores();
+        break;
+    case 1: core = (core + 1 + w->random() % (numPodCores() - 1)) % numPodCores();
+        break;
+    default:
+        break;
+    }
+    if (level == 0) {
+        thread = (thread + 1 + w->random() % (core_workers() - 1)) % core_workers();
+    } else {
+        thread = w->random() % core_workers();
+    }
+    w->steal_attempts++;
+    task *t = deque_of(pxn, pod, core, thread).steal();
+    if (t) {
+        w->steals++;
+        w->failed_steals = 0;
+    } else {
+        w->failed_steals++;
+    }
+    return t;
+}
+
 /**
  * execute this task on a specific core
  */
 void execute_on(uint32_t pxn, uint32_t pod, uint32_t core, task* t) {
-    DrvAPIAddressInfo info = decodeAddress(&this_cores_task_queue);
-    info.set_absolute(true)
-        .set_pxn(pxn)
-        .set_pod(pod)
-        .set_core(core);
-    DrvAPIPointer<task_queue*> queue_absolute_addr = encodeAddressInfo(info);
-    task_queue *tq = *queue_absolute_addr;
-    tq->push(t);
+    DrvAPIAddress inbox = on_core(&this_cores_inbox, pxn, pod, core);
+    int64_t head = read<int64_t>(inbox);
+    while (true) {
+        t->next = to_task(head);
+        int64_t prev = atomic_cas<int64_t>(inbox, head, from_task(t));
+        if (prev == head)
+            break;
+        head = prev;
+    }
+}
+
+/**
+ * push a task onto this worker's deque
+ */
+void spawn_task(task *t) {
+    worker *w = current_worker();
+    if (!w) {
+        // the command processor has no deque; deal tasks out to the cores in turn
+        uint64_t c = atomic_add<int64_t>(&this_pxns_next_core, 1) % num_cores();
+        uint64_t cores_per_pxn = numPXNPods() * numPodCores();
+        execute_on(c / cores_per_pxn
+                   ,(c % cores_per_pxn) / numPodCores()
+                   ,c % numPodCores()
+                   ,t);
+        return;
+    }
+    if (!w->deque.push(t))
+        run_task(w, t);
+}
+
+/**
+ * run one task from this worker's deque, inbox, or a victim's deque
+ */
+bool run_one_task() {
+    worker *w = current_worker();
+    if (!w)
+        return false;
+    task *t = pop_local(w);
+    if (!t) t = w->deque.pop();
+    if (!t) t = drain_inbox(w);
+    if (!t) t = try_steal(w);
+    if (!t)
+        return false;
+    run_task(w, t);
+    return true;
 }
 
+/**
+ * claim a zeroed pending counter for a task_group
+ */
+DrvAPIAddress task_group_counter_claim(DrvAPIPointer<void> &mem)
+{
+    worker *w = current_worker();
+    if (w && w->group_depth < MAX_GROUP_DEPTH) {
+        int slot = myThreadId() * MAX_GROUP_DEPTH + w->group_depth++;
+        DrvAPIAddress counter = on_core(&group_pending[slot], myPXNId(), myPodId(), myCoreId());
+        write<int64_t>(counter, 0);
+        return counter;
+    }
+    mem = DrvAPIMemoryAlloc(DrvAPIMemoryDRAM, sizeof(int64_t));
+    DrvAPIAddress counter = toAbsoluteAddress(mem);
+    write<int64_t>(counter, 0);
+    return counter;
+}
+
+/**
+ * release a counter from task_group_counter_claim()
+ */
+void task_group_counter_release(DrvAPIAddress counter, const DrvAPIPointer<void> &mem)
+{
+    if (toAbsoluteAddress(mem) == counter) {
+        DrvAPIMemoryFree(mem, sizeof(int64_t));
+        return;
+    }
+    // groups are scoped, so counters are released in the reverse order of claims
+    current_worker()->group_depth--;
+}
 
 /* every thread on every core in the system will call this function */
 int Start(int argc, char *argv[])
@@ -98,48 +389,89 @@ int Start(int argc, char *argv[])
 
     if (isCommandProcessor()) {
         // wait for all cores to be ready
-        int64_t x;
-        while ((x = *num_cores_ready_pointer()) != num_cores()) {
-            nop(1000);
-            //printf("CP: %ld/%ld cores ready\n", x, num_cores());
-        }
+        wait_until<int64_t>(on_pxn0(&this_pxns_num_cores_ready), num_cores());
         // only the command processor will run the main function
         pandoMain(argc, argv);
-        atomic_add(terminate_pointer(), 1);
+        // tell every core to quit
+        for (int64_t pxn = 0; pxn < numPXNs(); pxn++) {
+            for (int64_t pod = 0; pod < numPXNPods(); pod++) {
+                for (int64_t core = 0; core < numPodCores(); core++) {
+                    write<int64_t>(on_core(&this_cores_terminate, pxn, pod, core), 1);
+                }
+            }
+        }
+        // wait for the workers to report
+        int64_t workers = num_cores() * numCoreThreads();
+        wait_until<int64_t>(on_pxn0(&this_pxns_workers_done), workers);
+        int64_t tasks = read<int64_t>(on_pxn0(&this_pxns_tasks));
+        int64_t steals = read<int64_t>(on_pxn0(&this_pxns_steals));
+        int64_t attempts = read<int64_t>(on_pxn0(&this_pxns_steal_attempts));
+        int64_t idle = read<int64_t>(on_pxn0(&this_pxns_idle_cycles));
+        pr_info("runtime: workers=%" PRId64 " tasks=%" PRId64 " steals=%" PRId64
+                " steal_attempts=%" PRId64 " idle_cycles=%" PRId64 "\n"
+                ,workers, tasks, steals, attempts, idle);
         return 0;
     }
-    
+
+    if (myThreadId() >= MAX_CORE_THREADS) {
+        // threads below the limit set up the core and run its tasks;
+        // this one only reports so the command processor's count adds up
+        if (myThreadId() == MAX_CORE_THREADS) {
+            pr_info("runtime: WARNING: %d threads per core exceeds %d; the rest sit out\n"
+                    ,myCoreThreads(), MAX_CORE_THREADS);
+        }
+        atomic_add(on_pxn0(&this_pxns_workers_done), 1);
+        return 0;
+    }
+
+    // set up this worker's deque
+    worker w;
+    w.deque = deque_of(myPXNId(), myPodId(), myCoreId(), myThreadId());
+    w.rng = 0x9e3779b97f4a7c15ull ^ (((uint64_t)myPXNId() << 48)
+                                     | ((uint64_t)myPodId() << 32)
+                                     | ((uint64_t)myCoreId() << 8)
+                                     | (uint64_t)myThreadId());
+    write<int64_t>(w.deque.top, 0);
+    write<int64_t>(w.deque.bottom, 0);
+    write<int64_t>(&this_threads_worker[myThreadId()], reinterpret_cast<int64_t>(&w));
+
     // check initialized
     if (atomic_cas(&queue_initialized,
                    QUEUE_UNINIT,
                    QUEUE_INIT_IN_PROGRESS) == QUEUE_UNINIT) {
-
-        // initialize
-        this_cores_task_queue = new task_queue;
+        this_cores_inbox = 0;
+        this_cores_terminate = 0;
 
         // indicate that initialization is complete
         queue_initialized = QUEUE_INIT;
 
         // only one thread on each core will reach this line of code
-        atomic_add(num_cores_ready_pointer(), 1);
-    }
-    
-    while (queue_initialized != QUEUE_INIT) {
-        // wait for initialization to complete
-        nop(1000);
+        atomic_add(on_pxn0(&this_pxns_num_cores_ready), 1);
     }
 
-    while (*terminate_pointer() != numPXNs()) {
-        task_queue *tq = this_cores_task_queue;
-        task *t = tq->pop();
-        if (t == nullptr) {
-            nop(1000);
+    // wait for initialization to complete
+    wait_until<int64_t>(&queue_initialized, QUEUE_INIT);
+
+    int backoff = 1;
+    while (read<int64_t>(&this_cores_terminate) == 0) {
+        if (run_one_task()) {
+            backoff = 1;
             continue;
         }
-        t->execute();
-        delete t;
+        uint64_t t0 = cycle();
+        nop(backoff);
+        backoff = std::min(backoff * 2, MAX_BACKOFF);
+        w.idle_cycles += cycle() - t0;
     }
-    return 0;    
+
+    // report statistics
+    atomic_add(on_pxn0(&this_pxns_tasks), w.tasks);
+    atomic_add(on_pxn0(&this_pxns_steals), w.steals);
+    atomic_add(on_pxn0(&this_pxns_steal_attempts), w.steal_attempts);
+    atomic_add(on_pxn0(&this_pxns_idle_cycles), w.idle_cycles);
+    write<int64_t>(&this_threads_worker[myThreadId()], 0);
+    atomic_add(on_pxn0(&this_pxns_workers_done), 1);
+    return 0;
 }
 
 declare_drv_api_main(Start);
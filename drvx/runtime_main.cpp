@@ -9,6 +9,21 @@
 
 using namespace DrvAPI;
 
+/**
+ * fib(n) with a task per recursive call
+ */
+static void fib(int64_t n, DrvAPIAddress result)
+{
+    if (n < 2) {
+        atomic_add<int64_t>(result, n);
+        return;
+    }
+    task_group g;
+    g.spawn([n, result]() { fib(n - 1, result); });
+    g.spawn([n, result]() { fib(n - 2, result); });
+    g.sync();
+}
+
 int pandoMain(int argc, char *argv[])
 {
     // in this test just demonastrate that
@@ -43,6 +58,21 @@ int pandoMain(int argc, char *argv[])
     while (*done != places.size()) {
         DrvAPI::wait(1000);
     }
-    
+
+    // spawn from the command processor and steal among the cores
+    DrvAPIPointer<int64_t> result = DrvAPIMemoryAlloc(DrvAPIMemoryDRAM, sizeof(int64_t));
+    *result = 0;
+    DrvAPIAddress result_addr = toAbsoluteAddress(result);
+    {
+        task_group g;
+        g.spawn([result_addr]() { fib(10, result_addr); });
+        g.sync();
+    }
+    int64_t f = *result;
+    if (f != 55) {
+        pr_info("FAIL: fib(10) = %" PRId64 ", expected 55\n", f);
+        return 1;
+    }
+    pr_info("fib(10) = %" PRId64 "\n", f);
     return 0;
 }
@@ -1,6 +1,8 @@
 // SPDX-License-Identifier: MIT
 // Copyright (c) 2023 University of Washington
 #pragma once
+#include <DrvAPI.hpp>
+#include <algorithm>
 #include <cstdint>
 
 /**
@@ -22,6 +24,8 @@ public:
      * subclass must override
      */
     virtual void execute() = 0;
+
+    task *next = nullptr; //!< link in a core's inbox
 };
 
 
@@ -60,3 +64,81 @@ static inline task* newTask(F f) {
  * execute this task on a specific core
  */
 void execute_on(uint32_t pxn, uint32_t pod, uint32_t core, task* t);
+
+/**
+ * push a task onto this worker's deque
+ *
+ * idle workers steal it if this worker does not get to it first
+ */
+void spawn_task(task *t);
+
+/**
+ * run one task from this worker's deque, inbox, or a victim's deque
+ *
+ * returns false if no task was found
+ */
+bool run_one_task();
+
+/**
+ * claim a zeroed pending counter for a task_group
+ *
+ * the counter is a slot in this thread's l1sp; the command processor and
+ * deeply nested groups get a dram allocation, returned in mem
+ */
+DrvAPI::DrvAPIAddress task_group_counter_claim(DrvAPI::DrvAPIPointer<void> &mem);
+
+/**
+ * release a counter from task_group_counter_claim()
+ */
+void task_group_counter_release(DrvAPI::DrvAPIAddress counter, const DrvAPI::DrvAPIPointer<void> &mem);
+
+/**
+ * a set of spawned tasks that can be waited on
+ */
+class task_group {
+public:
+    /**
+     * constructor; claims the pending counter
+     */
+    task_group() {
+        pending_ = task_group_counter_claim(mem_);
+    }
+    task_group(const task_group &) = delete;
+    task_group &operator=(const task_group &) = delete;
+    /**
+     * destructor; waits for all tasks
+     */
+    ~task_group() {
+        sync();
+        task_group_counter_release(pending_, mem_);
+    }
+    /**
+     * spawn f() as a task in this group
+     */
+    template <typename F>
+    void spawn(F f) {
+        DrvAPI::DrvAPIAddress pending = pending_;
+        DrvAPI::atomic_add<int64_t>(pending, 1);
+        spawn_task(newTask([f, pending]() mutable {
+            f();
+            DrvAPI::atomic_add<int64_t>(pending, -1);
+        }));
+    }
+    /**
+     * wait for all tasks in this group, running other tasks meanwhile
+     */
+    void sync() {
+        int backoff = 1;
+        while (DrvAPI::read<int64_t>(pending_) != 0) {
+            if (run_one_task()) {
+                backoff = 1;
+                continue;
+            }
+            DrvAPI::nop(backoff);
+            backoff = std::min(backoff * 2, 1000);
+        }
+    }
+private:
+    DrvAPI::DrvAPIPointer<void> mem_; //!< allocation holding the counter, if not in l1sp
+    DrvAPI::DrvAPIAddress pending_; //!< number of tasks not yet done
+};
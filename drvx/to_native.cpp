@@ -112,6 +112,27 @@ int ToNativeMain(int argc, char *argv[])
         }
     }
 
+    // write a range spanning several dram banks through native runs, read it back
+    DrvAPIPointer<uint64_t> span_base = myRelativeDRAMBase() + 1024;
+    std::size_t span_words = 256;
+    std::size_t runs = 0;
+    pxn_flush_cache(myPXNId());
+    for (const native_run &run : native_span(span_base, span_words * sizeof(uint64_t))) {
+        uint64_t *words = reinterpret_cast<uint64_t*>(run.data);
+        uint64_t first = (run.address - span_base) / sizeof(uint64_t);
+        for (std::size_t i = 0; i < run.size / sizeof(uint64_t); i++) {
+            words[i] = first + i;
+        }
+        runs++;
+    }
+    pxn_invalidate_cache(myPXNId());
+    pr_info("Wrote %zu words in %zu native runs\n", span_words, runs);
+    for (std::size_t i = 0; i < span_words; i++) {
+        uint64_t rvalue = span_base[i];
+        if (rvalue != i) {
+            pr_error("MISMATCH: native_span word %zu: Read %16" PRIx64 "\n", i, rvalue);
+        }
+    }
 
     return 0;
 }
@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+#include <DrvAPI.hpp>
+#include <cstdio>
+#include <cstdint>
+
+using namespace DrvAPI;
+
+#define ROUNDS 8
+
+DrvAPIGlobalL2SP<int64_t> flag;
+DrvAPIGlobalL2SP<int64_t> arrived;
+DrvAPIGlobalL1SP<int64_t> turn;
+
+int WaitMain(int argc, char *argv[])
+{
+    int tid = myThreadId();
+    int threads = myCoreThreads();
+
+    // everyone parks on flag until thread 0 sets it
+    if (tid == 0) {
+        nop(10000);
+        flag = 1;
+    } else {
+        wait_until<int64_t>(&flag, 1);
+    }
+    atomic_add<int64_t>(&arrived, 1);
+    wait_until<int64_t>(&arrived, threads);
+
+    // pass a token around the threads
+    for (int r = 0; r < ROUNDS; r++) {
+        int64_t mine = r * threads + tid;
+        wait_until<int64_t>(&turn, mine);
+        atomic_add<int64_t>(&turn, 1);
+    }
+
+    if (tid == 0) {
+        wait_until<int64_t>(&turn, ROUNDS * threads);
+        printf("PASS: %d threads passed the token %d times\n", threads, ROUNDS);
+    }
+    return 0;
+}
+
+declare_drv_api_main(WaitMain);
@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+
+#include "DrvBarrier.hpp"
+#include <string>
+
+using namespace SST;
+using namespace Drv;
+
+DrvBarrier::DrvBarrier(SST::ComponentId_t id, SST::Params &params)
+    : SST::Component(id)
+    , parent_(nullptr)
+    , participants_(0)
+    , arrived_(0)
+    , sum_(0)
+    , first_arrival_(0) {
+    int verbose_level = params.find<int>("verbose", 0);
+    output_.init("[DrvBarrier @t] ", verbose_level, 0, Output::STDOUT);
+
+    int children = params.find<int>("children", 1);
+    std::string latency = params.find<std::string>("latency", "1ns");
+    for (int child = 0; child < children; child++) {
+        std::string port = "child" + std::to_string(child);
+        SST::Link *link = configureLink(port, new Event::Handler<DrvBarrier, int>(this, &DrvBarrier::handleChild, child));
+        if (!link) {
+            output_.fatal(CALL_INFO, -1, "port %s is not connected\n", port.c_str());
+        }
+        link->addSendLatency(1, latency);
+        children_.push_back(link);
+    }
+    departed_.assign(children, false);
+    participants_ = children;
+
+    parent_ = configureLink("parent", new Event::Handler<DrvBarrier>(this, &DrvBarrier::handleParent));
+    if (parent_) {
+        parent_->addSendLatency(1, latency);
+    }
+
+    barriers_ = registerStatistic<uint64_t>("barriers");
+    arrival_skew_ = registerStatistic<uint64_t>("arrival_skew");
+}
+
+void DrvBarrier::handleChild(SST::Event *event, int child) {
+    DrvBarrierEvent *arrive = dynamic_cast<DrvBarrierEvent*>(event);
+    if (!arrive || arrive->type == DrvBarrierEvent::RELEASE) {
+        output_.fatal(CALL_INFO, -1, "expected an arrival or departure from a child\n");
+    }
+    if (departed_[child]) {
+        output_.fatal(CALL_INFO, -1, "child %d sent an event after departing\n", child);
+    }
+    if (arrive->type == DrvBarrierEvent::DEPART) {
+        delete event;
+        departed_[child] = true;
+        output_.verbose(CALL_INFO, 2, 0, "child %d departed\n", child);
+        if (--participants_ == 0) {
+            if (parent_) {
+                parent_->send(new DrvBarrierEvent(DrvBarrierEvent::DEPART, 0));
+            }
+            return;
+        }
+        tryComplete();
+        return;
+    }
+    if (arrived_ == 0) {
+        first_arrival_ = getCurrentSimTime("1 ns");
+    }
+    sum_ += arrive->value;
+    delete event;
+    arrived_++;
+    tryComplete();
+}
+
+void DrvBarrier::tryComplete() {
+    if (arrived_ == 0 || arrived_ < participants_) {
+        return;
+    }
+
+    // every remaining child has arrived
+    barriers_->addData(1);
+    arrival_skew_->addData(getCurrentSimTime("1 ns") - first_arrival_);
+    int64_t sum = sum_;
+    arrived_ = 0;
+    sum_ = 0;
+    output_.verbose(CALL_INFO, 2, 0, "all %d children arrived: sum = %ld\n", participants_, sum);
+    if (parent_) {
+        parent_->send(new DrvBarrierEvent(DrvBarrierEvent::ARRIVE, sum));
+    } else {
+        release(sum);
+    }
+}
+
+void DrvBarrier::handleParent(SST::Event *event) {
+    DrvBarrierEvent *rel = dynamic_cast<DrvBarrierEvent*>(event);
+    if (!rel || rel->type != DrvBarrierEvent::RELEASE) {
+        output_.fatal(CALL_INFO, -1, "expected a release from the parent\n");
+    }
+    release(rel->value);
+    delete event;
+}
+
+void DrvBarrier::release(int64_t value) {
+    for (size_t child = 0; child < children_.size(); child++) {
+        if (!departed_[child]) {
+            children_[child]->send(new DrvBarrierEvent(DrvBarrierEvent::RELEASE, value));
+        }
+    }
+}
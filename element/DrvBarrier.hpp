@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+
+#pragma once
+#include <sst/core/component.h>
+#include <sst/core/link.h>
+#include <vector>
+#include "DrvBarrierEvent.hpp"
+
+namespace SST {
+namespace Drv {
+
+/**
+ * @brief One level of the barrier and reduction network
+ *
+ * A unit waits for an arrival from each of its children, summing their
+ * values, then forwards a single arrival to its parent. The root (a unit
+ * with no parent) turns the last arrival into a release, which each unit
+ * broadcasts back down to its children. Pods use one unit for their
+ * cores; PXNs and the system stack units on top of those.
+ *
+ * A child that departs is no longer waited for or released; once every
+ * child has departed the unit departs from its parent.
+ */
+class DrvBarrier : public SST::Component {
+public:
+    // register this component into the element library
+    SST_ELI_REGISTER_COMPONENT(
+        DrvBarrier,
+        "Drv",
+        "DrvBarrier",
+        SST_ELI_ELEMENT_VERSION(1,0,0),
+        "Barrier and reduction network unit",
+        COMPONENT_CATEGORY_UNCATEGORIZED
+    )
+    // document the parameters that this component accepts
+    SST_ELI_DOCUMENT_PARAMS(
+        {"children", "Number of children (cores or lower level units)", "1"},
+        {"latency", "Latency to forward an arrival up or a release down from this unit", "1ns"},
+        {"verbose", "Verbosity of logging", "0"},
+    )
+    // document the ports that this component accepts
+    SST_ELI_DOCUMENT_PORTS(
+        {"child%(children)d", "Link to a core or a lower level unit", {"Drv.DrvBarrierEvent", ""}},
+        {"parent", "Link to the next level unit; left unconnected at the root", {"Drv.DrvBarrierEvent", ""}},
+    )
+    // document the statistics that this component provides
+    SST_ELI_DOCUMENT_STATISTICS(
+        {"barriers", "Number of barriers completed at this unit", "count", 1},
+        {"arrival_skew", "Time from the first to the last child arriving", "ns", 1},
+    )
+
+    /**
+     * @brief Construct a new DrvBarrier object
+     */
+    DrvBarrier(SST::ComponentId_t id, SST::Params &params);
+
+    /**
+     * @brief Destroy the DrvBarrier object
+     */
+    ~DrvBarrier() {}
+
+private:
+    /**
+     * @brief handle an arrival or departure from a child
+     */
+    void handleChild(SST::Event *event, int child);
+
+    /**
+     * @brief forward the sum once every remaining child has arrived
+     */
+    void tryComplete();
+
+    /**
+     * @brief handle a release from the parent
+     */
+    void handleParent(SST::Event *event);
+
+    /**
+     * @brief send a release to every child
+     */
+    void release(int64_t value);
+
+    SST::Output output_; //!< for logging
+    std::vector<SST::Link*> children_; //!< links to children
+    std::vector<bool> departed_; //!< children that have departed
+    SST::Link *parent_; //!< link to parent, null at the root
+    int participants_; //!< children that have not departed
+    int arrived_; //!< children arrived at the current barrier
+    int64_t sum_; //!< sum of the values of children arrived
+    SimTime_t first_arrival_; //!< time of the first arrival (ns)
+    Statistic<uint64_t> *barriers_; //!< barriers completed
+    Statistic<uint64_t> *arrival_skew_; //!< first to last arrival time
+};
+
+}
+}
@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+
+#pragma once
+#include <cstdint>
+#include <DrvEvent.hpp>
+
+namespace SST {
+namespace Drv {
+
+/**
+ * @brief An event on the barrier network
+ *
+ * Arrivals travel from cores up to the root unit, carrying the partial
+ * sum of their subtree. Releases travel from the root back down to the
+ * cores, carrying the total. A child whose threads have all exited sends
+ * a departure so later barriers no longer wait for it.
+ */
+class DrvBarrierEvent : public DrvEvent {
+public:
+    typedef enum {
+        ARRIVE,  //!< every thread below the sender has arrived
+        RELEASE, //!< every thread has arrived; resume
+        DEPART,  //!< every thread below the sender has exited
+    } Type;
+
+    /**
+     * @brief Construct a new DrvBarrierEvent object
+     *
+     * @param _type Arrival, release or departure.
+     * @param _value Partial sum (arrival) or total (release).
+     */
+    DrvBarrierEvent(Type _type = ARRIVE, int64_t _value = 0)
+        : DrvEvent(), type(_type), value(_value) {}
+
+    void serialize_order(SST::Core::Serialization::serializer &ser) override {
+        DrvEvent::serialize_order(ser);
+        ser & type;
+        ser & value;
+    }
+
+    Type type; //!< arrival, release or departure
+    int64_t value; //!< reduction value
+
+    ImplementSerializable(SST::Drv::DrvBarrierEvent);
+};
+
+}
+}
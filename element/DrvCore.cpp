@@ -11,6 +11,8 @@
 #include "DrvSelfLinkMemory.hpp"
 #include "DrvStdMemory.hpp"
 #include "DrvNopEvent.hpp"
+#include "DrvBarrierEvent.hpp"
+#include "DrvCustomStdMem.hpp"
 #include <cstdio>
 #include <dlfcn.h>
 #include <cstring>
@@ -101,6 +103,13 @@ void DrvCore::configureExecutable(SST::Params &params) {
   if (!set_sys_config_app_) {
       output_->fatal(CALL_INFO, -1, "unable to find DrvAPISetSysConfig in executable: %s\n", dlerror());
   }
+
+  // optional: only executables that use execute_at() define this
+  execute_active_message_ = (DrvAPI::DrvAPIActiveMessageExecute_t)dlsym(executable_, "DrvAPIActiveMessageExecute");
+  executable_key_ = std::hash<std::string>()(executable);
+  if (execute_active_message_) {
+      ActiveMessageReqData::RegisterExecutor(executable_key_, execute_active_message_);
+  }
   
   output_->verbose(CALL_INFO, 1, DEBUG_INIT, "configured executable\n");  
 }
@@ -155,6 +164,11 @@ void DrvCore::configureThreads(SST::Params &params) {
     configureThread(thread, threads);
   done_ = threads;
   last_thread_ = threads - 1;
+  // all threads start out idle and ready to resume
+  ready_.assign((threads + 63) / 64, 0);
+  for (int thread = 0; thread < threads; thread++)
+    setThreadReady(thread);
+  barrier_start_.assign(threads, 0);
 }
 
 void DrvCore::startThreads() {
@@ -201,6 +215,7 @@ void DrvCore::configureMemory(SST::Params &params) {
 void DrvCore::configureOtherLinks(SST::Params &params) {
     loopback_ = configureSelfLink("loopback", new Event::Handler<DrvCore>(this, &DrvCore::handleLoopback));
     loopback_->addSendLatency(1, "ns");
+    barrier_ = configureLink("barrier", new Event::Handler<DrvCore>(this, &DrvCore::handleBarrier));
 }
 
 /**
@@ -233,6 +248,7 @@ void DrvCore::configureStatistics(Params &params) {
     }
     busy_cycles_ = registerStatistic<uint64_t>("busy_cycles");
     stall_cycles_ = registerStatistic<uint64_t>("stall_cycles");
+    barrier_wait_cycles_ = registerStatistic<uint64_t>("barrier_wait_cycles");
 }
 
 /**
@@ -272,7 +288,12 @@ void DrvCore::parseArgv(SST::Params &params) {
 DrvCore::DrvCore(SST::ComponentId_t id, SST::Params& params)
   : SST::Component(id)
   , executable_(nullptr)
+  , execute_active_message_(nullptr)
+  , executable_key_(0)
   , loopback_(nullptr)
+  , barrier_(nullptr)
+  , barrier_arrived_(0)
+  , barrier_sum_(0)
   , idle_cycles_(0)
   , core_on_(false)
   , system_callbacks_(std::make_shared<DrvSystem>(*this)) {
@@ -351,15 +372,21 @@ void DrvCore::finish() {
 static constexpr int NO_THREAD_READY = -1;
 
 int DrvCore::selectReadyThread() {
-  // select a ready thread to execute
-  for (int t = 0; t < numThreads(); t++) {
-    int thread_id = (last_thread_ + t + 1) % numThreads();
-    DrvThread *thread = getThread(thread_id);
-    auto & state = thread->getAPIThread().getState();
-    if (state->canResume()) {
+  // select the first ready thread after the last one executed
+  // threads are marked ready as their requests complete, so this
+  // only has to scan the ready bitmap a word at a time
+  int words = static_cast<int>(ready_.size());
+  int start = (last_thread_ + 1) % numThreads();
+  int w = start >> 6;
+  uint64_t word = ready_[w] & (~0ull << (start & 63));
+  for (int i = 0; i <= words; i++) {
+    if (word) {
+      int thread_id = (w << 6) + __builtin_ctzll(word);
       output_->verbose(CALL_INFO, 2, DEBUG_CLK, "thread %d is ready\n", thread_id);
       return thread_id;
     }
+    w = (w + 1) % words;
+    word = ready_[w];
   }
   output_->verbose(CALL_INFO, 2, DEBUG_CLK, "no thread is ready\n");
   return NO_THREAD_READY;
@@ -377,6 +404,7 @@ void DrvCore::executeReadyThread() {
   idle_cycles_ = 0;
 
   // execute the ready thread
+  clearThreadReady(thread_id);
   threads_[thread_id].execute(this);
   last_thread_ = thread_id;
 
@@ -384,31 +412,65 @@ void DrvCore::executeReadyThread() {
 }
 
 void DrvCore::handleThreadStateAfterYield(DrvThread *thread) {
-  std::shared_ptr<DrvAPI::DrvAPIThreadState> &state = thread->getAPIThread().getState();
-  std::shared_ptr<DrvAPI::DrvAPIMem> mem_req = std::dynamic_pointer_cast<DrvAPI::DrvAPIMem>(state);
-
+  DrvAPI::DrvAPIThreadState &state = thread->getAPIThread().getState();
+  switch (state.type()) {
   // handle memory requests
-  if (mem_req) {
-    // for now; do nothing
-    memory_->sendRequest(this, thread, mem_req);
+  case DrvAPI::DrvAPIThreadStateMemRead:
+  case DrvAPI::DrvAPIThreadStateMemWrite:
+  case DrvAPI::DrvAPIThreadStateMemAtomic:
+  case DrvAPI::DrvAPIThreadStateFlushLine:
+  case DrvAPI::DrvAPIThreadStateInvLine:
+  case DrvAPI::DrvAPIThreadStateFlushRange:
+  case DrvAPI::DrvAPIThreadStateInvRange:
+  case DrvAPI::DrvAPIThreadStateFlushCache:
+  case DrvAPI::DrvAPIThreadStateInvCache:
+  case DrvAPI::DrvAPIThreadStateToNativePointer:
+  case DrvAPI::DrvAPIThreadStateMemReadBlock:
+  case DrvAPI::DrvAPIThreadStateMemWriteBlock:
+  case DrvAPI::DrvAPIThreadStateMemFillBlock:
+  case DrvAPI::DrvAPIThreadStateMemGather:
+  case DrvAPI::DrvAPIThreadStateMemScatter:
+  case DrvAPI::DrvAPIThreadStateActiveMessage:
+  case DrvAPI::DrvAPIThreadStateMemWait:
+  case DrvAPI::DrvAPIThreadStateDMAStart:
+  case DrvAPI::DrvAPIThreadStateDMAWait:
+    memory_->sendRequest(this, thread, state);
+    return;
+  // handle non-blocking requests
+  case DrvAPI::DrvAPIThreadStateAsyncIssue:
+    memory_->sendRequest(this, thread, thread->getAPIThread().getAsyncState(state.asyncSlot()));
+    completeThreadState(thread);
+    return;
+  case DrvAPI::DrvAPIThreadStateAsyncWait:
+    if (state.asyncSlot() != DrvAPI::DrvAPIThreadState::ASYNC_SLOT_ANY &&
+        thread->getAPIThread().getAsyncState(state.asyncSlot()).canResume()) {
+      completeThreadState(thread);
+    }
+    return;
+  case DrvAPI::DrvAPIThreadStateFence:
+    output_->verbose(CALL_INFO, 2, DEBUG_CLK, "thread %d fence with %d pending\n", getThreadID(thread), thread->getAPIThread().asyncPending());
+    if (thread->getAPIThread().asyncPending() == 0) {
+      completeThreadState(thread);
+    }
     return;
-  }
-
   // handle nop
-  std::shared_ptr<DrvAPI::DrvAPINop> nop_req = std::dynamic_pointer_cast<DrvAPI::DrvAPINop>(state);
-  if (nop_req) {
-    output_->verbose(CALL_INFO, 1, DEBUG_CLK, "thread %d nop for %d cycles\n", getThreadID(thread), nop_req->count());
-    //TimeConverter *tc = getTimeConverter("1ns");
-    loopback_->send(nop_req->count(), clocktc_, new DrvNopEvent(getThreadID(thread)));
+  case DrvAPI::DrvAPIThreadStateNop:
+    output_->verbose(CALL_INFO, 1, DEBUG_CLK, "thread %d nop for %d cycles\n", getThreadID(thread), state.count());
+    loopback_->send(state.count(), clocktc_, new DrvNopEvent(getThreadID(thread)));
+    return;
+  // handle barrier
+  case DrvAPI::DrvAPIThreadStateBarrier:
+    output_->verbose(CALL_INFO, 1, DEBUG_CLK, "thread %d arrived at barrier\n", getThreadID(thread));
+    barrierArrive(thread);
     return;
-  }
-  
   // handle termination
-  std::shared_ptr<DrvAPI::DrvAPITerminate> term_req = std::dynamic_pointer_cast<DrvAPI::DrvAPITerminate>(state);
-  if (term_req) {
+  case DrvAPI::DrvAPIThreadStateTerminate:
     output_->verbose(CALL_INFO, 1, DEBUG_CLK, "thread %d terminated\n", getThreadID(thread));
     done_--;
+    barrierDepart();
     return;
+  default:
+    break;
   }
 
   // fatal - unknown state
@@ -416,6 +478,33 @@ void DrvCore::handleThreadStateAfterYield(DrvThread *thread) {
   return;
 }
     
+void DrvCore::completeThreadState(DrvThread *thread, DrvAPI::DrvAPIThreadState &state) {
+  DrvAPI::DrvAPIThread &api_thread = thread->getAPIThread();
+  int slot = api_thread.getAsyncSlot(state);
+  if (slot < 0) {
+    completeThreadState(thread);
+    return;
+  }
+  api_thread.completeAsyncState(slot);
+  // wake the thread if it is waiting on this request
+  DrvAPI::DrvAPIThreadState &thread_state = api_thread.getState();
+  switch (thread_state.type()) {
+  case DrvAPI::DrvAPIThreadStateAsyncWait:
+    if (thread_state.asyncSlot() == DrvAPI::DrvAPIThreadState::ASYNC_SLOT_ANY ||
+        thread_state.asyncSlot() == slot) {
+      completeThreadState(thread);
+    }
+    break;
+  case DrvAPI::DrvAPIThreadStateFence:
+    if (api_thread.asyncPending() == 0) {
+      completeThreadState(thread);
+    }
+    break;
+  default:
+    break;
+  }
+}
+
 bool DrvCore::allDone() {
   return done_ == 0;
 }
@@ -437,6 +526,8 @@ bool DrvCore::clockTick(SST::Cycle_t cycle) {
   output_->verbose(CALL_INFO, 20, DEBUG_CLK, "tick!\n");
   // execute a ready thread
   executeReadyThread();
+  // advance background work in the memory (e.g. dma copies)
+  memory_->tick();
   if (allDone()) {
       primaryComponentOKToEndSim();
   }
@@ -461,17 +552,75 @@ void DrvCore::handleLoopback(SST::Event *event) {
   if (nop_event) {
     output_->verbose(CALL_INFO, 2, DEBUG_LOOPBACK, "loopback event is a nop\n");
     DrvThread *thread = getThread(nop_event->tid);
-    auto nop = std::dynamic_pointer_cast<DrvAPI::DrvAPINop>(thread->getAPIThread().getState());
-    if (!nop) {
+    DrvAPI::DrvAPIThreadState &nop = thread->getAPIThread().getState();
+    if (nop.type() != DrvAPI::DrvAPIThreadStateNop) {
       output_->fatal(CALL_INFO, -1, "loopback event is not a nop\n");
     }
-    nop->complete();
+    completeThreadState(thread);
     assertCoreOn();
     delete event;
     return;
   }
 }
 
+void DrvCore::handleBarrier(SST::Event *event) {
+  DrvBarrierEvent *release = dynamic_cast<DrvBarrierEvent*>(event);
+  if (!release || release->type != DrvBarrierEvent::RELEASE) {
+    output_->fatal(CALL_INFO, -1, "barrier event is not a release\n");
+  }
+  barrierRelease(release->value);
+  assertCoreOn();
+  delete event;
+}
+
+void DrvCore::barrierArrive(DrvThread *thread) {
+  int64_t value = 0;
+  thread->getAPIThread().getState().getPayload(&value);
+  barrier_start_[getThreadID(thread)] = system_callbacks_->getCycleCount();
+  barrier_sum_ += value;
+  barrier_arrived_++;
+  barrierTryComplete();
+}
+
+void DrvCore::barrierDepart() {
+  if (done_ == 0) {
+    if (barrier_) {
+      barrier_->send(new DrvBarrierEvent(DrvBarrierEvent::DEPART, 0));
+    }
+    return;
+  }
+  barrierTryComplete();
+}
+
+void DrvCore::barrierTryComplete() {
+  // threads that have not terminated are the barrier's participants
+  if (barrier_arrived_ == 0 || barrier_arrived_ < done_) {
+    return;
+  }
+  // every remaining thread on this core has arrived
+  int64_t sum = barrier_sum_;
+  barrier_arrived_ = 0;
+  barrier_sum_ = 0;
+  if (barrier_) {
+    barrier_->send(new DrvBarrierEvent(DrvBarrierEvent::ARRIVE, sum));
+  } else {
+    barrierRelease(sum);
+  }
+}
+
+void DrvCore::barrierRelease(int64_t total) {
+  uint64_t now = system_callbacks_->getCycleCount();
+  for (auto &drv_thread : threads_) {
+    DrvAPI::DrvAPIThreadState &state = drv_thread.getAPIThread().getState();
+    if (state.type() != DrvAPI::DrvAPIThreadStateBarrier || state.canResume()) {
+      continue;
+    }
+    state.setResult(&total);
+    barrier_wait_cycles_->addData(now - barrier_start_[getThreadID(&drv_thread)]);
+    completeThreadState(&drv_thread);
+  }
+}
+
 /**
  * handle a memory request to control registers
  * the request is deleted by the caller
@@ -16,6 +16,7 @@
 #include "DrvStats.hpp"
 #include <DrvAPI.hpp>
 #include <DrvAPIThread.hpp>
+#include <DrvAPIActiveMessage.hpp>
 
 namespace SST {
 namespace Drv {
@@ -65,6 +66,7 @@ public:
   // Document the ports that this component accepts
   SST_ELI_DOCUMENT_PORTS(
       {"loopback", "A loopback link", {"Drv.DrvEvent", ""}},
+      {"barrier", "Link to the barrier network; optional", {"Drv.DrvBarrierEvent", ""}},
   )
 
   // Document the subcomponents that this component has
@@ -107,6 +109,7 @@ public:
       {"tag_cycles", "number of cycles spent executing with a tag", "count", 1},
       {"stall_cycles", "Number of stalled cycles", "count", 1},
       {"busy_cycles", "Number of busy cycles", "count", 1},
+      {"barrier_wait_cycles", "Number of cycles threads spent waiting at a barrier", "count", 1},
     )
 
   /**
@@ -216,6 +219,38 @@ public:
    */
   void handleLoopback(SST::Event *event);
 
+  /**
+   * handle a release from the barrier network
+   * @param[in] event The event to handle
+   */
+  void handleBarrier(SST::Event *event);
+
+  /**
+   * a thread has arrived at the barrier
+   *
+   * once every thread on this core has arrived, their summed values are
+   * sent up the barrier network, or released directly if there is none
+   */
+  void barrierArrive(DrvThread *thread);
+
+  /**
+   * a thread has terminated and no longer takes part in barriers
+   *
+   * threads already waiting are released if they were only waiting on it;
+   * once every thread has terminated the core departs the barrier network
+   */
+  void barrierDepart();
+
+  /**
+   * send the summed values up once every remaining thread has arrived
+   */
+  void barrierTryComplete();
+
+  /**
+   * release every thread waiting at the barrier with the total
+   */
+  void barrierRelease(int64_t total);
+
   /**
    * handle a mmio request event
    */
@@ -311,6 +346,36 @@ public:
     return &threads_[tid];
   }
 
+  /**
+   * mark a thread as ready to resume
+   */
+  void setThreadReady(int tid) {
+    ready_[tid >> 6] |= (1ull << (tid & 63));
+  }
+
+  /**
+   * mark a thread as not ready to resume
+   */
+  void clearThreadReady(int tid) {
+    ready_[tid >> 6] &= ~(1ull << (tid & 63));
+  }
+
+  /**
+   * complete the request in a thread's state and mark the thread ready
+   */
+  void completeThreadState(DrvThread *thread) {
+    thread->getAPIThread().getState().complete();
+    setThreadReady(getThreadID(thread));
+  }
+
+  /**
+   * complete a request issued by a thread
+   *
+   * state is either the thread's state or one of its non-blocking
+   * request states; the thread is marked ready if it was waiting on it
+   */
+  void completeThreadState(DrvThread *thread, DrvAPI::DrvAPIThreadState &state);
+
   /**
    * return the number of threads on this core
    */
@@ -329,7 +394,7 @@ public:
    * return true if we should unregister the clock
    */
   bool shouldUnregisterClock() {    
-    return allDone() || (idle_cycles_ >= max_idle_cycles_);
+    return !memory_->busy() && (allDone() || (idle_cycles_ >= max_idle_cycles_));
   }
 
   /**
@@ -464,6 +529,25 @@ public:
         return decoder_;
     }
 
+    /**
+     * @brief key identifying the executable for active messages
+     */
+    uint64_t executableKey() const {
+        return executable_key_;
+    }
+
+    /**
+     * @brief run an active message in the executable
+     */
+    void executeActiveMessage(DrvAPI::DrvAPIThreadState &state, DrvAPI::DrvAPIActiveMessageContext *ctx) {
+        if (!execute_active_message_) {
+            output_->fatal(CALL_INFO, -1, "executable does not define DrvAPIActiveMessageExecute\n");
+        }
+        uint8_t data[DrvAPI::DrvAPIThreadState::MAX_PAYLOAD_SIZE];
+        state.getPayload(data);
+        execute_active_message_(state.getFunctionId(), data, ctx);
+    }
+
 private:  
   std::unique_ptr<SST::Output> output_; //!< for logging
   SST::Output tag_; //!< for stats collection
@@ -475,10 +559,17 @@ private:
   drv_api_set_thread_context_t set_thread_context_; //!< the set_thread_context function in the executable
   DrvAPIGetSysConfig_t get_sys_config_app_; //!< the get_sys_config function in the executable
   DrvAPISetSysConfig_t set_sys_config_app_; //!< the set_sys_config function in the executable
+  DrvAPI::DrvAPIActiveMessageExecute_t execute_active_message_; //!< the active message executor in the executable
+  uint64_t executable_key_; //!< key identifying the executable for active messages
   int done_; //!< number of threads that are done
   int last_thread_; //!< last thread that was executed
+  std::vector<uint64_t> ready_; //!< bitmap of threads that can resume
   std::vector<char*> argv_; //!< the command line arguments
   SST::Link *loopback_; //!< the loopback link
+  SST::Link *barrier_; //!< link to the barrier network, null if not connected
+  int barrier_arrived_; //!< threads waiting at the barrier
+  int64_t barrier_sum_; //!< sum of the values of threads waiting at the barrier
+  std::vector<uint64_t> barrier_start_; //!< cycle each thread arrived at the barrier
   uint64_t max_idle_cycles_; //!< maximum number of idle cycles
   uint64_t idle_cycles_; //!< number of idle cycles
   SimTime_t unregister_cycle_; //!< cycle when the clock handler was last unregistered
@@ -492,6 +583,7 @@ private:
   std::vector<ThreadStat> thread_stats_; //!< the thread statistics
   Statistic<uint64_t> *busy_cycles_; //!< busy cycles
   Statistic<uint64_t> *stall_cycles_; //!< stall cycles
+  Statistic<uint64_t> *barrier_wait_cycles_; //!< cycles spent waiting at a barrier
 public:
   DrvMemory* memory_;  //!< the memory hierarchy
   SST::TimeConverter *clocktc_; //!< the clock time converter
@@ -49,6 +49,38 @@ bool DrvRamulatorMemBackend::issueCustomRequest(ReqId req_id, Interfaces::Standa
         dramReqs[addr].push_back(req_id);
         return true;
     }
+    WaitReqData *wait_data = dynamic_cast<WaitReqData*>(data);
+    if (wait_data) {
+        output_.verbose(CALL_INFO, 1, 0, "Received wait request\n");
+        // waits are not parked here; model a read and let the requester check again
+        Addr addr = wait_data->pAddr;
+        ramulator::Request request
+            (addr
+             ,ramulator::Request::Type::READ
+             ,callBackFunc
+             ,0 // context or core id
+             );
+        bool ok = memSystem->send(request);
+        if (!ok) return false;
+        dramReqs[addr].push_back(req_id);
+        return true;
+    }
+    ActiveMessageReqData *am_data = dynamic_cast<ActiveMessageReqData*>(data);
+    if (am_data) {
+        output_.verbose(CALL_INFO, 1, 0, "Received active message request\n");
+        // model the active message as a read of its target
+        Addr addr = am_data->pAddr;
+        ramulator::Request request
+            (addr
+             ,ramulator::Request::Type::READ
+             ,callBackFunc
+             ,0 // context or core id
+             );
+        bool ok = memSystem->send(request);
+        if (!ok) return false;
+        dramReqs[addr].push_back(req_id);
+        return true;
+    }
     output_.fatal(CALL_INFO, -1, "Error: unknown custom request type\n");
     return false;
 }
@@ -3,12 +3,41 @@
 
 #include <DrvAPIReadModifyWrite.hpp>
 #include "DrvCustomStdMem.hpp"
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
 
 using namespace SST;
 using namespace Drv;
 using namespace Interfaces;
 using namespace MemHierarchy;
 
+namespace {
+std::mutex active_message_executors_lock;
+std::map<uint64_t, DrvAPI::DrvAPIActiveMessageExecute_t> active_message_executors;
+}
+
+/**
+ * register the executor of an application
+ */
+void
+ActiveMessageReqData::RegisterExecutor(uint64_t executable, DrvAPI::DrvAPIActiveMessageExecute_t execute) {
+  std::lock_guard<std::mutex> guard(active_message_executors_lock);
+  active_message_executors[executable] = execute;
+}
+
+/**
+ * find the executor of an application
+ */
+DrvAPI::DrvAPIActiveMessageExecute_t
+ActiveMessageReqData::FindExecutor(uint64_t executable) {
+  std::lock_guard<std::mutex> guard(active_message_executors_lock);
+  auto it = active_message_executors.find(executable);
+  if (it == active_message_executors.end())
+    return nullptr;
+  return it->second;
+}
+
 /* constructor
  *
  * should register a read and write handler
@@ -23,6 +52,27 @@ DrvCmdMemHandler::DrvCmdMemHandler(SST::ComponentId_t id, SST::Params& params,
   output.verbose(CALL_INFO, 1, 0, "%s\n", __PRETTY_FUNCTION__);
   lineSize_ = params.find<MemHierarchy::Addr>("cache_line_size", 0);
   shootdowns_ = params.find<bool>("shootdowns", false);
+  rangeStart_ = params.find<MemHierarchy::Addr>("addr_range_start", 0);
+  rangeEnd_ = params.find<MemHierarchy::Addr>("addr_range_end", ~static_cast<MemHierarchy::Addr>(0));
+  interleaveSize_ = params.find<SST::UnitAlgebra>("interleave_size", "0B").getRoundedValue();
+  interleaveStep_ = params.find<SST::UnitAlgebra>("interleave_step", "0B").getRoundedValue();
+  if (interleaveSize_ != 0 && interleaveStep_ < interleaveSize_) {
+    output.fatal(CALL_INFO, -1, "Error: interleave_step must be at least interleave_size\n");
+  }
+}
+
+/* true if every byte of [addr, addr+size) is owned by this controller */
+bool
+DrvCmdMemHandler::owns(Addr addr, size_t size) const {
+  Addr last = addr + std::max<size_t>(size, 1) - 1;
+  if (last < addr || addr < rangeStart_ || last > rangeEnd_)
+    return false;
+  if (interleaveSize_ == 0)
+    return true;
+  // both ends in the same owned chunk
+  Addr first_step = (addr - rangeStart_) / interleaveStep_;
+  Addr last_step = (last - rangeStart_) / interleaveStep_;
+  return first_step == last_step && (last - rangeStart_) % interleaveStep_ < interleaveSize_;
 }
 
 /* destructor */
@@ -53,6 +103,15 @@ Interfaces::StandardMem::CustomData*
 DrvCmdMemHandler::ready(MemEventBase* ev) {
   output.verbose(CALL_INFO, 1, 0,"%s\n", __PRETTY_FUNCTION__);
   CustomMemEvent * cme = static_cast<CustomMemEvent*>(ev);
+  // tell the backend which local address atomics and waits touch
+  if (AtomicReqData *ard = dynamic_cast<AtomicReqData*>(cme->getCustomData())) {
+    ard->localAddr = translateGlobalToLocal(ard->getRoutingAddress());
+  } else if (WaitReqData *wrd = dynamic_cast<WaitReqData*>(cme->getCustomData())) {
+    wrd->localAddr = translateGlobalToLocal(wrd->getRoutingAddress());
+    std::vector<uint8_t> current(wrd->getSize());
+    readData(wrd->localAddr, wrd->getSize(), current);
+    wrd->satisfied = (current == wrd->expected);
+  }
   // We don't need to modify the data structure sent by the CPU, so just 
   // pass it on to the backend
   return cme->getCustomData();
@@ -80,10 +139,24 @@ DrvCmdMemHandler::finish(MemEventBase *ev, uint32_t flags) {
   }
   // get the custom data and make sure it's something we support
   CustomMemEvent * cme = static_cast<CustomMemEvent*>(ev);
-  AtomicReqData *ard = dynamic_cast<AtomicReqData*>(cme->getCustomData());
-  if (!ard) {
+  if (AtomicReqData *ard = dynamic_cast<AtomicReqData*>(cme->getCustomData())) {
+    finishAtomic(ard);
+  } else if (ActiveMessageReqData *amd = dynamic_cast<ActiveMessageReqData*>(cme->getCustomData())) {
+    executeActiveMessage(amd);
+  } else if (WaitReqData *wrd = dynamic_cast<WaitReqData*>(cme->getCustomData())) {
+    // return the current value; the requester decides whether to wait again
+    wrd->rdata.resize(wrd->getSize());
+    readData(translateGlobalToLocal(wrd->getRoutingAddress()), wrd->getSize(), wrd->rdata);
+  } else {
     output.fatal(CALL_INFO, -1, "Error: unknown custom request type\n");
   }
+  MemEventBase *MEB = ev->makeResponse();
+  return MEB;
+}
+
+/* finish an atomic memory op */
+void
+DrvCmdMemHandler::finishAtomic(AtomicReqData *ard) {
   output.verbose(CALL_INFO, 1, 0, "Formatting response to atomic memory op\n");
   // here's where we should update backing store
   // and the response payload
@@ -112,8 +185,67 @@ DrvCmdMemHandler::finish(MemEventBase *ev, uint32_t flags) {
   }
   // write-back
   writeData(localAddr, &(ard->wdata));
-  MemEventBase *MEB = ev->makeResponse();
-  return MEB;
+}
+
+namespace {
+/* active message context over the memory controller's backing store */
+class CmdMemActiveMessageContext : public DrvAPI::DrvAPIActiveMessageContext {
+public:
+  CmdMemActiveMessageContext(ActiveMessageReqData *amd
+                             ,std::function<void(Addr,size_t,std::vector<uint8_t>&)> read
+                             ,std::function<void(Addr,std::vector<uint8_t>*)> write
+                             ,std::function<Addr(Addr)> globalToLocal
+                             ,std::function<void(Addr,size_t)> check)
+    : amd_(amd), read_(read), write_(write), globalToLocal_(globalToLocal), check_(check) {}
+
+  DrvAPI::DrvAPIAddress address() const override { return amd_->pAddr; }
+  void read(DrvAPI::DrvAPIAddress address, void *p, std::size_t size) override {
+    check_(address, size);
+    std::vector<uint8_t> data(size);
+    read_(globalToLocal_(address), size, data);
+    std::memcpy(p, data.data(), size);
+  }
+  void write(DrvAPI::DrvAPIAddress address, const void *p, std::size_t size) override {
+    check_(address, size);
+    const uint8_t *bytes = static_cast<const uint8_t*>(p);
+    std::vector<uint8_t> data(bytes, bytes + size);
+    Addr local = globalToLocal_(address);
+    write_(local, &data);
+    // the backend wakes waiters on these once the message completes
+    amd_->write_addrs.push_back(local);
+    amd_->write_sizes.push_back(size);
+  }
+  void setResult(const void *p, std::size_t size) override {
+    const uint8_t *bytes = static_cast<const uint8_t*>(p);
+    amd_->rdata.assign(bytes, bytes + size);
+  }
+
+private:
+  ActiveMessageReqData *amd_;
+  std::function<void(Addr,size_t,std::vector<uint8_t>&)> read_;
+  std::function<void(Addr,std::vector<uint8_t>*)> write_;
+  std::function<Addr(Addr)> globalToLocal_;
+  std::function<void(Addr,size_t)> check_;
+};
+}
+
+/* run an active message against the backing store */
+void
+DrvCmdMemHandler::executeActiveMessage(ActiveMessageReqData *amd) {
+  output.verbose(CALL_INFO, 1, 0, "Executing active message function %d\n", amd->function_id);
+  DrvAPI::DrvAPIActiveMessageExecute_t execute = ActiveMessageReqData::FindExecutor(amd->executable);
+  if (!execute) {
+    output.fatal(CALL_INFO, -1, "Error: no active message executor for executable %" PRIx64 "\n", amd->executable);
+  }
+  // an access this controller does not own would silently hit the wrong backing store
+  auto check = [this, amd](Addr addr, size_t size) {
+    if (!owns(addr, size)) {
+      output.fatal(CALL_INFO, -1, "Error: active message sent to %" PRIx64 " accessed %zu bytes at %" PRIx64
+                   ", which this memory controller does not own\n", amd->pAddr, size, addr);
+    }
+  };
+  CmdMemActiveMessageContext ctx(amd, readData, writeData, translateGlobalToLocal, check);
+  execute(amd->function_id, amd->data.data(), &ctx);
 }
 
 
@@ -121,10 +253,14 @@ DrvCmdMemHandler::finish(MemEventBase *ev, uint32_t flags) {
  * constructor of our simple memory backend
  */
 DrvSimpleMemBackend::DrvSimpleMemBackend(ComponentId_t id, Params &params)
-  : SimpleMemory(id, params) {
+  : SimpleMemory(id, params)
+  , recent_writes_(WAIT_RECENT_BUCKETS, 0) {
   int verbose_level = params.find<int>("verbose_level", 0);
   output_ = SST::Output("[@f:@l:@p]: ", verbose_level, 0, SST::Output::STDOUT);
   output_.verbose(CALL_INFO, 1, 0, "%s\n", __PRETTY_FUNCTION__);
+  // a request completes two access times after it is issued
+  std::string access_time = params.find<std::string>("access_time", "100 ns");
+  recent_window_ = 3 * getTimeConverter(access_time)->getFactor();
 }
 
 /**
@@ -135,6 +271,52 @@ DrvSimpleMemBackend::~DrvSimpleMemBackend() {
 }
 
 
+/**
+ * wake waiters on the blocks touched by a write
+ *
+ * waiters complete one access time after the write, so that
+ * the write has updated the backing store when they read it
+ */
+void
+DrvSimpleMemBackend::wakeWaiters(Addr addr, uint64_t size) {
+  Addr first = addr & ~(WAIT_BLOCK - 1);
+  Addr last = (addr + std::max<uint64_t>(size, 1) - 1) & ~(WAIT_BLOCK - 1);
+  for (Addr block = first; block <= last; block += WAIT_BLOCK) {
+    recent_writes_[(block / WAIT_BLOCK) % WAIT_RECENT_BUCKETS] = getCurrentSimCycle();
+    auto it = waiters_.find(block);
+    if (it == waiters_.end())
+      continue;
+    for (ReqId waiter : it->second) {
+      output_.verbose(CALL_INFO, 1, 0, "Waking wait request on block %" PRIx64 "\n", block);
+      self_link->send(2, new MemCtrlEvent(waiter));
+    }
+    waiters_.erase(it);
+  }
+}
+
+/**
+ * true if a write to addr's block may still be in flight
+ *
+ * the handler checked the word before such a write reached the backing store,
+ * so the wait must not be parked; buckets are shared, so this can be a false positive
+ */
+bool
+DrvSimpleMemBackend::recentlyWritten(Addr addr) {
+  SimTime_t when = recent_writes_[(addr / WAIT_BLOCK) % WAIT_RECENT_BUCKETS];
+  return when != 0 && getCurrentSimCycle() - when <= recent_window_;
+}
+
+/**
+ * handle reads and writes; writes wake waiters
+ */
+bool
+DrvSimpleMemBackend::issueRequest(ReqId req_id, Addr addr, bool isWrite, unsigned numBytes) {
+  if (isWrite) {
+    wakeWaiters(addr, numBytes);
+  }
+  return SimpleMemory::issueRequest(req_id, addr, isWrite, numBytes);
+}
+
 /**
  * handle custom requests for drv componenets
  */
@@ -144,6 +326,27 @@ DrvSimpleMemBackend::issueCustomRequest(ReqId req_id, Interfaces::StandardMem::C
   AtomicReqData *atomic_data = dynamic_cast<AtomicReqData*>(data);
   if (atomic_data) {
     output_.verbose(CALL_INFO, 1, 0, "Received atomic request\n");
+    wakeWaiters(atomic_data->localAddr, atomic_data->size);
+    self_link->send(1, new MemCtrlEvent(req_id));
+    return true;
+  }
+  WaitReqData *wait_data = dynamic_cast<WaitReqData*>(data);
+  if (wait_data) {
+    if (wait_data->satisfied || recentlyWritten(wait_data->localAddr)) {
+      output_.verbose(CALL_INFO, 1, 0, "Received wait request; completing\n");
+      self_link->send(1, new MemCtrlEvent(req_id));
+    } else {
+      output_.verbose(CALL_INFO, 1, 0, "Received wait request; parking\n");
+      waiters_[wait_data->localAddr & ~(WAIT_BLOCK - 1)].push_back(req_id);
+    }
+    return true;
+  }
+  ActiveMessageReqData *am_data = dynamic_cast<ActiveMessageReqData*>(data);
+  if (am_data) {
+    output_.verbose(CALL_INFO, 1, 0, "Received active message request\n");
+    for (size_t w = 0; w < am_data->write_addrs.size(); w++) {
+      wakeWaiters(am_data->write_addrs[w], am_data->write_sizes[w]);
+    }
     self_link->send(1, new MemCtrlEvent(req_id));
     return true;
   }
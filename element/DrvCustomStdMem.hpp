@@ -13,6 +13,9 @@
 #include <sst/elements/memHierarchy/membackend/simpleMemBackend.h>
 #include "DrvAPIReadModifyWrite.hpp"
 #include "DrvAPIThreadState.hpp"
+#include "DrvAPIActiveMessage.hpp"
+#include <map>
+#include <mutex>
 
 namespace SST {
 namespace Drv {
@@ -62,6 +65,7 @@ public:
     ser & extdata;
     ser & size;
     ser & pAddr;
+    ser & localAddr;
   }
   ImplementSerializable(SST::Drv::AtomicReqData);
 
@@ -72,9 +76,166 @@ public:
   int64_t size;
   DrvAPI::DrvAPIMemAtomicType opcode;
   Interfaces::StandardMem::Addr pAddr;
-  
+  Interfaces::StandardMem::Addr localAddr = 0; //!< set by DrvCmdMemHandler; wakes waiters in the backend
 };
 
+/**
+ * @brief Custom data for waiting on a memory word
+ *
+ * DrvCmdMemHandler checks the word when the request is ready. If it already
+ * equals expected the backend completes the request at once. Otherwise the
+ * backend parks it until a write or atomic touches the word. The response
+ * carries the word's value, which the requester checks again.
+ */
+class WaitReqData : public Interfaces::StandardMem::CustomData {
+public:
+  /* constructor */
+  WaitReqData() {}
+
+  /* return address to use for routing this event to its destination */
+  Interfaces::StandardMem::Addr
+  getRoutingAddress() override { return pAddr; }
+
+  /* return size of to use when accounting for bandwidth used by this event */
+  uint64_t getSize() override { return size; }
+
+  /* return a CustomData* objected formatted as a response */
+  Interfaces::StandardMem::CustomData*
+  makeResponse() override { return this; }
+
+  /* return wheter a response is needed */
+  bool needsResponse() override { return true; }
+
+  /* string representation for debugging */
+  std::string getString() override {
+    std::stringstream ss;
+    ss << "{Type: WaitReqData, pAddr: ";
+    ss << std::hex;
+    ss << pAddr << ", size: ";
+    ss << std::dec;
+    ss << size << "} ";
+    return ss.str();
+  }
+
+  /* serialize this data for parallel sims */
+  void serialize_order(SST::Core::Serialization::serializer &ser) override {
+    CustomData::serialize_order(ser);
+    ser & expected;
+    ser & rdata;
+    ser & size;
+    ser & pAddr;
+    ser & localAddr;
+    ser & satisfied;
+  }
+  ImplementSerializable(SST::Drv::WaitReqData);
+
+public:
+  std::vector<uint8_t> expected;
+  std::vector<uint8_t> rdata;
+  int64_t size;
+  Interfaces::StandardMem::Addr pAddr;
+  Interfaces::StandardMem::Addr localAddr = 0; //!< set by DrvCmdMemHandler
+  bool satisfied = false; //!< set by DrvCmdMemHandler if the word already equals expected
+};
+
+/**
+ * @brief Custom data for active messages
+ *
+ * Carries a registered DrvAPIFunction to the memory controller that owns pAddr.
+ * The controller looks up the executor of the application by the executable key
+ * and runs the function against its backing store.
+ */
+class ActiveMessageReqData : public Interfaces::StandardMem::CustomData {
+public:
+  /* constructor */
+  ActiveMessageReqData() {}
+
+  /* return address to use for routing this event to its destination */
+  Interfaces::StandardMem::Addr
+  getRoutingAddress() override { return pAddr; }
+
+  /* return size of to use when accounting for bandwidth used by this event */
+  uint64_t getSize() override { return data.size(); }
+
+  /* return a CustomData* objected formatted as a response */
+  Interfaces::StandardMem::CustomData*
+  makeResponse() override { return this; }
+
+  /* return wheter a response is needed */
+  bool needsResponse() override { return true; }
+
+  /* string representation for debugging */
+  std::string getString() override {
+    std::stringstream ss;
+    ss << "{Type: ActiveMessageReqData, pAddr: ";
+    ss << std::hex;
+    ss << pAddr << ", function: ";
+    ss << std::dec;
+    ss << function_id << ", size: ";
+    ss << data.size() << "} ";
+    return ss.str();
+  }
+
+  /* serialize this data for parallel sims */
+  void serialize_order(SST::Core::Serialization::serializer &ser) override {
+    CustomData::serialize_order(ser);
+    ser & data;
+    ser & rdata;
+    ser & executable;
+    ser & function_id;
+    ser & result_size;
+    ser & pAddr;
+    ser & write_addrs;
+    ser & write_sizes;
+  }
+  ImplementSerializable(SST::Drv::ActiveMessageReqData);
+
+  /**
+   * @brief register the executor of an application
+   */
+  static void RegisterExecutor(uint64_t executable, DrvAPI::DrvAPIActiveMessageExecute_t execute);
+
+  /**
+   * @brief find the executor of an application, or nullptr
+   */
+  static DrvAPI::DrvAPIActiveMessageExecute_t FindExecutor(uint64_t executable);
+
+public:
+  std::vector<uint8_t> data;
+  std::vector<uint8_t> rdata;
+  uint64_t executable;
+  int function_id;
+  uint64_t result_size;
+  Interfaces::StandardMem::Addr pAddr;
+  std::vector<uint64_t> write_addrs; //!< local address of each write the handler made
+  std::vector<uint64_t> write_sizes; //!< size of each write the handler made
+};
+
+/**
+ * @brief active message context over a flat data store
+ *
+ * used by memories that keep their own data, where an address is an offset
+ */
+class DrvBufferActiveMessageContext : public DrvAPI::DrvAPIActiveMessageContext {
+public:
+  DrvBufferActiveMessageContext(DrvAPI::DrvAPIThreadState &req, std::vector<uint8_t> &data)
+    : req_(req), data_(data) {}
+
+  DrvAPI::DrvAPIAddress address() const override { return req_.getAddress(); }
+  void read(DrvAPI::DrvAPIAddress address, void *p, std::size_t size) override {
+    std::memcpy(p, &data_[address], size);
+  }
+  void write(DrvAPI::DrvAPIAddress address, const void *p, std::size_t size) override {
+    std::memcpy(&data_[address], p, size);
+  }
+  void setResult(const void *p, std::size_t) override {
+    req_.setActiveMessageResult(p);
+  }
+
+private:
+  DrvAPI::DrvAPIThreadState &req_;
+  std::vector<uint8_t> &data_;
+};
 
 /**
  * @brief a handler for drv custom memory operartions
@@ -88,6 +249,16 @@ public:
   SST_ELI_REGISTER_SUBCOMPONENT(DrvCmdMemHandler, "Drv", "DrvCmdMemHandler", SST_ELI_ELEMENT_VERSION(1,0,0),
                                 "custom command handler for drv element", SST::Drv::DrvCmdMemHandler)
 
+  SST_ELI_DOCUMENT_PARAMS(
+                          {"verbose_level", "Sets the verbosity of the handler output", "0"},
+                          {"cache_line_size", "Line size of the caches in front of the controller, 0 if none", "0"},
+                          {"shootdowns", "Invalidate cached copies of lines a custom command touches", "false"},
+                          {"addr_range_start", "First address owned by the controller; match the controller's", "0"},
+                          {"addr_range_end", "Last address owned by the controller; match the controller's", "-1"},
+                          {"interleave_size", "Bytes owned per interleave step; match the controller's", "0B"},
+                          {"interleave_step", "Bytes between interleaved chunks; match the controller's", "0B"}
+                          )
+
   /* constructor
    *
    * should register a read and write handler
@@ -124,9 +295,22 @@ public:
   MemHierarchy::MemEventBase* finish(MemHierarchy::MemEventBase *ev, uint32_t flags);
 
 private:
+  /* run an active message against the backing store */
+  void executeActiveMessage(ActiveMessageReqData *amd);
+
+  /* true if every byte of [addr, addr+size) is owned by this controller */
+  bool owns(MemHierarchy::Addr addr, size_t size) const;
+
+  /* finish an atomic memory op */
+  void finishAtomic(AtomicReqData *ard);
+
   SST::Output output;
   bool shootdowns_;
   MemHierarchy::Addr lineSize_;
+  MemHierarchy::Addr rangeStart_; //!< first address owned by the controller
+  MemHierarchy::Addr rangeEnd_; //!< last address owned by the controller
+  uint64_t interleaveSize_; //!< bytes owned per interleave step, 0 if not interleaved
+  uint64_t interleaveStep_; //!< bytes between owned chunks
 };
 
 /**
@@ -151,9 +335,24 @@ public:
   /* destructor */
   ~DrvSimpleMemBackend() override;
 
+  bool issueRequest(ReqId, MemHierarchy::Addr, bool isWrite, unsigned numBytes) override;
   bool issueCustomRequest(ReqId, Interfaces::StandardMem::CustomData *) override;
 private:
+  /* granularity at which writes wake waiters */
+  static constexpr MemHierarchy::Addr WAIT_BLOCK = 64;
+  /* number of buckets remembering recent writes */
+  static constexpr size_t WAIT_RECENT_BUCKETS = 1024;
+
+  /* wake waiters on the blocks touched by a write of size bytes at addr */
+  void wakeWaiters(MemHierarchy::Addr addr, uint64_t size);
+
+  /* true if a write to addr's block may still be in flight */
+  bool recentlyWritten(MemHierarchy::Addr addr);
+
   SST::Output output_;
+  std::map<MemHierarchy::Addr, std::vector<ReqId>> waiters_; //!< parked wait requests by block
+  std::vector<SimTime_t> recent_writes_; //!< when a write to a block hashing here was last issued
+  SimTime_t recent_window_; //!< how long a write may be in flight
 };
 
 }
@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+
+#include "DrvDMAEngine.hpp"
+#include "DrvCore.hpp"
+#include <algorithm>
+
+using namespace SST;
+using namespace Drv;
+using namespace Interfaces;
+
+DrvDMAEngine::DrvDMAEngine(DrvCore *core
+                           ,StandardMem *mem
+                           ,SST::Output *output
+                           ,double bandwidth
+                           ,uint64_t max_requests
+                           ,uint64_t request_size
+                           ,uint64_t queue_depth
+                           ,completion_handler on_complete)
+    : core_(core)
+    , mem_(mem)
+    , output_(output)
+    , bandwidth_(bandwidth)
+    , max_requests_(max_requests)
+    , request_size_(request_size)
+    , queue_depth_(queue_depth)
+    , on_complete_(on_complete) {
+    if (bandwidth_ <= 0 || max_requests_ == 0 || request_size_ == 0 || queue_depth_ == 0) {
+        output_->fatal(CALL_INFO, -1, "dma_bandwidth, dma_max_requests, dma_request_size and dma_queue_depth must be positive\n");
+    }
+}
+
+bool DrvDMAEngine::noncacheable(DrvAPI::DrvAPIAddress addr) const {
+    return !core_->decoder().decode(addr).is_dram();
+}
+
+int64_t DrvDMAEngine::push(DrvAPI::DrvAPIAddress dst, DrvAPI::DrvAPIAddress src, uint64_t size) {
+    int64_t handle = next_handle_++;
+    output_->verbose(CALL_INFO, 10, 0,
+                     "dma %" PRId64 ": queued copy of %" PRIu64 " bytes from %" PRIx64 " to %" PRIx64 "\n",
+                     handle, size, src, dst);
+    if (size > 0) {
+        descriptors_[handle] = Descriptor{dst, src, size, 0, 0};
+    }
+    return handle;
+}
+
+void DrvDMAEngine::tick() {
+    if (!busy()) {
+        return;
+    }
+    // unused bandwidth does not carry over past one cycle's worth
+    credit_ = std::min(credit_ + bandwidth_, std::max(bandwidth_, (double)request_size_));
+    for (auto it = descriptors_.begin(); it != descriptors_.end() && in_flight_ < max_requests_;) {
+        Descriptor &d = it->second;
+        if (d.issued == d.size) {
+            ++it;
+            continue;
+        }
+        // a chunk crosses neither a source nor a destination line
+        uint64_t src = d.src + d.issued;
+        uint64_t dst = d.dst + d.issued;
+        uint64_t chunk = std::min({request_size_ - (src % request_size_)
+                                  ,request_size_ - (dst % request_size_)
+                                  ,d.size - d.issued});
+        if (credit_ < chunk) {
+            break;
+        }
+        credit_ -= chunk;
+        StandardMem::Read *read = new StandardMem::Read(src, chunk);
+        if (noncacheable(src)) read->setNoncacheable();
+        chunks_[read->getID()] = Chunk{it->first, dst, chunk, false};
+        d.issued += chunk;
+        in_flight_++;
+        mem_->send(read);
+    }
+}
+
+bool DrvDMAEngine::handleResponse(StandardMem::Request *rsp) {
+    auto it = chunks_.find(rsp->getID());
+    if (it == chunks_.end()) {
+        return false;
+    }
+    Chunk chunk = it->second;
+    chunks_.erase(it);
+
+    if (!chunk.write) {
+        // the read has returned; write the data to the destination
+        StandardMem::ReadResp *read_rsp = dynamic_cast<StandardMem::ReadResp*>(rsp);
+        if (!read_rsp) {
+            output_->fatal(CALL_INFO, -1, "dma %" PRId64 ": expected a read response\n", chunk.handle);
+        }
+        StandardMem::Write *write = new StandardMem::Write(chunk.dst, chunk.size, read_rsp->data);
+        if (noncacheable(chunk.dst)) write->setNoncacheable();
+        chunk.write = true;
+        chunks_[write->getID()] = chunk;
+        mem_->send(write);
+        return true;
+    }
+
+    in_flight_--;
+    Descriptor &d = descriptors_.at(chunk.handle);
+    d.done += chunk.size;
+    if (d.done == d.size) {
+        output_->verbose(CALL_INFO, 10, 0, "dma %" PRId64 ": complete\n", chunk.handle);
+        descriptors_.erase(chunk.handle);
+        on_complete_(chunk.handle);
+    }
+    return true;
+}
@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+
+#pragma once
+#include <sst/core/output.h>
+#include <sst/core/interfaces/stdMem.h>
+#include <DrvAPIAddress.hpp>
+#include <functional>
+#include <map>
+#include <unordered_map>
+namespace SST {
+namespace Drv {
+
+class DrvCore;
+
+/**
+ * @brief A dma engine that copies between simulated memories
+ *
+ * Descriptors are queued by the core's threads and copied in order of
+ * arrival, as line-sized reads each followed by a write of the same data.
+ * Reads are issued at no more than bandwidth bytes per cycle and no more
+ * than max_requests copies are in flight at once. Each descriptor is
+ * identified by a handle; the completion handler is called with the
+ * handle once all of its writes have been acknowledged.
+ */
+class DrvDMAEngine {
+public:
+    typedef std::function<void(int64_t)> completion_handler;
+
+    /**
+     * @brief constructor
+     *
+     * @param core the core that owns the engine
+     * @param mem the memory interface copies are sent on
+     * @param output output stream for debug messages
+     * @param bandwidth bytes read per cycle
+     * @param max_requests copies in flight at once
+     * @param request_size maximum size of each copy
+     * @param queue_depth maximum descriptors queued or in flight
+     * @param on_complete called with a descriptor's handle when it completes
+     */
+    DrvDMAEngine(DrvCore *core
+                 ,Interfaces::StandardMem *mem
+                 ,SST::Output *output
+                 ,double bandwidth
+                 ,uint64_t max_requests
+                 ,uint64_t request_size
+                 ,uint64_t queue_depth
+                 ,completion_handler on_complete);
+
+    /**
+     * @brief true if no more descriptors can be queued
+     */
+    bool full() const { return descriptors_.size() >= queue_depth_; }
+
+    /**
+     * @brief true if there are descriptors queued or in flight
+     */
+    bool busy() const { return !descriptors_.empty(); }
+
+    /**
+     * @brief true if the descriptor with this handle has completed
+     */
+    bool complete(int64_t handle) const {
+        return handle < next_handle_ && descriptors_.count(handle) == 0;
+    }
+
+    /**
+     * @brief queue a copy of size bytes from src to dst
+     *
+     * @return the descriptor's handle
+     */
+    int64_t push(DrvAPI::DrvAPIAddress dst, DrvAPI::DrvAPIAddress src, uint64_t size);
+
+    /**
+     * @brief issue reads for this cycle
+     */
+    void tick();
+
+    /**
+     * @brief handle a memory response
+     *
+     * @return true if the response belonged to the engine
+     */
+    bool handleResponse(Interfaces::StandardMem::Request *rsp);
+
+private:
+    /**
+     * @brief a queued copy
+     */
+    struct Descriptor {
+        DrvAPI::DrvAPIAddress dst; //!< destination of the copy
+        DrvAPI::DrvAPIAddress src; //!< source of the copy
+        uint64_t size;   //!< bytes to copy
+        uint64_t issued; //!< bytes read requests have been sent for
+        uint64_t done;   //!< bytes written
+    };
+
+    /**
+     * @brief one line of a copy in flight
+     */
+    struct Chunk {
+        int64_t handle; //!< descriptor the chunk belongs to
+        DrvAPI::DrvAPIAddress dst; //!< where the data is written
+        uint64_t size; //!< bytes in the chunk
+        bool write;    //!< true once the read has returned and the write was sent
+    };
+
+    bool noncacheable(DrvAPI::DrvAPIAddress addr) const;
+
+    DrvCore *core_; //!< the core that owns the engine
+    Interfaces::StandardMem *mem_; //!< the memory interface copies are sent on
+    SST::Output *output_; //!< output stream for debug messages
+    double bandwidth_; //!< bytes read per cycle
+    double credit_ = 0; //!< bytes that may be read this cycle
+    uint64_t max_requests_; //!< copies in flight at once
+    uint64_t request_size_; //!< maximum size of each copy
+    uint64_t queue_depth_; //!< maximum descriptors queued or in flight
+    uint64_t in_flight_ = 0; //!< copies in flight
+    int64_t next_handle_ = 0; //!< handle of the next descriptor
+    completion_handler on_complete_; //!< called when a descriptor completes
+    std::map<int64_t, Descriptor> descriptors_; //!< incomplete descriptors in order of arrival
+    std::unordered_map<Interfaces::StandardMem::id_t, Chunk> chunks_; //!< in-flight chunks by request id
+};
+
+}
+}
@@ -49,15 +49,25 @@ public:
     /**
      * @brief Send a memory request
      */
-    virtual void sendRequest(DrvCore *core, DrvThread *thread, const std::shared_ptr<DrvAPI::DrvAPIMem> & thread_mem_req) = 0;
+    virtual void sendRequest(DrvCore *core, DrvThread *thread, DrvAPI::DrvAPIThreadState & thread_mem_req) = 0;
 
     /**
      * @brief Send a flush/inv request
      */
-    virtual void sendFlushLine(DrvCore *core, DrvThread *thread, const std::shared_ptr<DrvAPI::DrvAPIFlushLine> & flush) {
+    virtual void sendFlushLine(DrvCore *core, DrvThread *thread, DrvAPI::DrvAPIThreadState & flush) {
         output_.fatal(CALL_INFO, -1, "sendFlushLine not implemented\n");
     }
 
+    /**
+     * @brief Advance background work by one core cycle
+     */
+    virtual void tick() {}
+
+    /**
+     * @brief True if there is background work that needs the core's clock
+     */
+    virtual bool busy() const { return false; }
+
 protected:
     SST::Output output_; //!< @brief The output stream for this component
     DrvCore *core_; //!< @brief The core this memory is attached to
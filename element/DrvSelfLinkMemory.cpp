@@ -3,8 +3,11 @@
 
 #include "DrvSelfLinkMemory.hpp"
 #include "DrvCore.hpp"
+#include "DrvCustomStdMem.hpp"
 #include "DrvEvent.hpp"
+#include "DrvThread.hpp"
 #include <cstdio>
+#include <cstring>
 
 using namespace SST;
 using namespace Drv;
@@ -30,29 +33,64 @@ void DrvSelfLinkMemory::handleEvent(SST::Event *ev) {
     return;
   }
   
-  std::shared_ptr<DrvAPI::DrvAPIMem> mem_req = mem_evt->req_;
-  
-  auto read = std::dynamic_pointer_cast<DrvAPI::DrvAPIMemRead>(mem_req);
-  if (read) {
-    read->setResult(&data_[read->getAddress()]);
-    read->complete();
-    return;
-  }
-  
-  auto write = std::dynamic_pointer_cast<DrvAPI::DrvAPIMemWrite>(mem_req);
-  if (write) {
-    write->getPayload(&data_[write->getAddress()]);
-    write->complete();
-    return;
+  DrvAPI::DrvAPIThreadState &mem_req = *mem_evt->req_;
+  switch (mem_req.type()) {
+  case DrvAPI::DrvAPIThreadStateMemRead:
+  case DrvAPI::DrvAPIThreadStateMemWait:
+    mem_req.setResult(&data_[mem_req.getAddress()]);
+    core_->completeThreadState(mem_evt->thread_, mem_req);
+    break;
+  case DrvAPI::DrvAPIThreadStateMemWrite:
+    mem_req.getPayload(&data_[mem_req.getAddress()]);
+    core_->completeThreadState(mem_evt->thread_, mem_req);
+    break;
+  case DrvAPI::DrvAPIThreadStateMemAtomic:
+    mem_req.setResult(&data_[mem_req.getAddress()]);
+    mem_req.modify();
+    mem_req.getPayload(&data_[mem_req.getAddress()]);
+    core_->completeThreadState(mem_evt->thread_, mem_req);
+    break;
+  case DrvAPI::DrvAPIThreadStateMemReadBlock:
+    std::memcpy(mem_req.getBlock(), &data_[mem_req.getAddress()], mem_req.getSize());
+    core_->completeThreadState(mem_evt->thread_, mem_req);
+    break;
+  case DrvAPI::DrvAPIThreadStateMemWriteBlock:
+    std::memcpy(&data_[mem_req.getAddress()], mem_req.getBlock(), mem_req.getSize());
+    core_->completeThreadState(mem_evt->thread_, mem_req);
+    break;
+  case DrvAPI::DrvAPIThreadStateMemFillBlock:
+    std::memset(&data_[mem_req.getAddress()], mem_req.getFill(), mem_req.getSize());
+    core_->completeThreadState(mem_evt->thread_, mem_req);
+    break;
+  case DrvAPI::DrvAPIThreadStateMemGather:
+    for (std::size_t i = 0; i < mem_req.getElements(); i++) {
+      std::memcpy(mem_req.getBlock() + i * mem_req.getSize(), &data_[mem_req.getAddresses()[i]], mem_req.getSize());
+    }
+    core_->completeThreadState(mem_evt->thread_, mem_req);
+    break;
+  case DrvAPI::DrvAPIThreadStateMemScatter:
+    for (std::size_t i = 0; i < mem_req.getElements(); i++) {
+      std::memcpy(&data_[mem_req.getAddresses()[i]], mem_req.getBlock() + i * mem_req.getSize(), mem_req.getSize());
+    }
+    core_->completeThreadState(mem_evt->thread_, mem_req);
+    break;
+  case DrvAPI::DrvAPIThreadStateActiveMessage: {
+    DrvBufferActiveMessageContext ctx(mem_req, data_);
+    core_->executeActiveMessage(mem_req, &ctx);
+    core_->completeThreadState(mem_evt->thread_, mem_req);
+    break;
   }
-  
-  auto atomic = std::dynamic_pointer_cast<DrvAPI::DrvAPIMemAtomic>(mem_req);
-  if (atomic) {
-    atomic->setResult(&data_[atomic->getAddress()]);
-    atomic->modify();
-    atomic->getPayload(&data_[atomic->getAddress()]);
-    atomic->complete();
-    return;
+  case DrvAPI::DrvAPIThreadStateDMAStart:
+    // copy now; the wait for it then completes immediately
+    std::memmove(&data_[mem_req.getAddress()], &data_[mem_req.getDMASource()], mem_req.getSize());
+    mem_req.setDMAHandle(0);
+    core_->completeThreadState(mem_evt->thread_, mem_req);
+    break;
+  case DrvAPI::DrvAPIThreadStateDMAWait:
+    core_->completeThreadState(mem_evt->thread_, mem_req);
+    break;
+  default:
+    break;
   }
   core_->assertCoreOn();
   delete ev;
@@ -61,9 +99,10 @@ void DrvSelfLinkMemory::handleEvent(SST::Event *ev) {
 
 void DrvSelfLinkMemory::sendRequest(DrvCore *core
                                     ,DrvThread *thread
-                                    ,const std::shared_ptr<DrvAPI::DrvAPIMem> &mem_req) {
+                                    ,DrvAPI::DrvAPIThreadState &mem_req) {
   core->output()->verbose(CALL_INFO, 2, DrvMemory::VERBOSE_REQ, "Sending request\n");
   auto ev = new DrvSelfLinkMemory::Event();
-  ev->req_ = mem_req;
+  ev->thread_ = thread;
+  ev->req_ = &mem_req;
   link_->send(0, ev);
 }
@@ -52,7 +52,7 @@ public:
      */
     void sendRequest(DrvCore *core
                      ,DrvThread *thread
-                     ,const std::shared_ptr<DrvAPI::DrvAPIMem> &mem_req);
+                     ,DrvAPI::DrvAPIThreadState &mem_req);
 
     /**
      * Event class for self-link
@@ -69,7 +69,8 @@ public:
          */
         virtual ~Event() {}
 
-        std::shared_ptr<DrvAPI::DrvAPIMem> req_; //!< The memory request
+        DrvThread *thread_ = nullptr; //!< The thread that issued the request
+        DrvAPI::DrvAPIThreadState *req_ = nullptr; //!< The memory request
         
         ImplementSerializable(SST::Drv::DrvSelfLinkMemory::Event);
     };
@@ -81,7 +82,6 @@ private:
     void handleEvent(SST::Event *ev);
     
     SST::Link  *link_; //!< A link
-    DrvCore    *core_; //!< The core
     std::vector<uint8_t> data_; //!< The data store
 };
 
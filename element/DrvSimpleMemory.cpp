@@ -3,6 +3,8 @@
 
 #include "DrvSimpleMemory.hpp"
 #include "DrvCore.hpp"
+#include "DrvCustomStdMem.hpp"
+#include <cstring>
 using namespace SST;
 using namespace Drv;
 
@@ -24,20 +26,20 @@ DrvSimpleMemory::DrvSimpleMemory(SST::ComponentId_t id, SST::Params& params, Drv
  * @brief Send a read request
  */
 void
-DrvSimpleMemory::sendReadRequest(DrvCore *core, DrvThread *thread, const std::shared_ptr<DrvAPI::DrvAPIMemRead> &read_req) {
+DrvSimpleMemory::sendReadRequest(DrvCore *core, DrvThread *thread, DrvAPI::DrvAPIThreadState &read_req) {
     output_.verbose(CALL_INFO, 1, DrvMemory::VERBOSE_REQ, "sending read request\n");
-    read_req->setResult(&data_[read_req->getAddress()]);
-    read_req->complete();
+    read_req.setResult(&data_[read_req.getAddress()]);
+    core->completeThreadState(thread, read_req);
 }
 
 /**
  * @brief Send a write request
  */
 void
-DrvSimpleMemory::sendWriteRequest(DrvCore *core, DrvThread *thread, const std::shared_ptr<DrvAPI::DrvAPIMemWrite> &write_req) {
+DrvSimpleMemory::sendWriteRequest(DrvCore *core, DrvThread *thread, DrvAPI::DrvAPIThreadState &write_req) {
     output_.verbose(CALL_INFO, 1, DrvMemory::VERBOSE_REQ, "sending write request\n");
-    write_req->getPayload(&data_[write_req->getAddress()]);
-    write_req->complete();
+    write_req.getPayload(&data_[write_req.getAddress()]);
+    core->completeThreadState(thread, write_req);
 }
 
 /**
@@ -46,37 +48,106 @@ DrvSimpleMemory::sendWriteRequest(DrvCore *core, DrvThread *thread, const std::s
 void
 DrvSimpleMemory::sendAtomicRequest(DrvCore *core
                                    ,DrvThread *thread
-                                   ,const std::shared_ptr<DrvAPI::DrvAPIMemAtomic> &atomic_req) {
+                                   ,DrvAPI::DrvAPIThreadState &atomic_req) {
     output_.verbose(CALL_INFO, 1, DrvMemory::VERBOSE_REQ, "sending atomic request\n");
-    atomic_req->setResult(&data_[atomic_req->getAddress()]);
-    atomic_req->modify();
-    atomic_req->getPayload(&data_[atomic_req->getAddress()]);
-    atomic_req->complete();
+    atomic_req.setResult(&data_[atomic_req.getAddress()]);
+    atomic_req.modify();
+    atomic_req.getPayload(&data_[atomic_req.getAddress()]);
+    core->completeThreadState(thread, atomic_req);
 }
 
 /**
- * @brief Send a memory request
+ * @brief Send a block request
  */
 void
-DrvSimpleMemory::sendRequest (DrvCore *core, DrvThread *thread, const std::shared_ptr<DrvAPI::DrvAPIMem> & thread_mem_req) {
-    auto read_req = std::dynamic_pointer_cast<DrvAPI::DrvAPIMemRead>(thread_mem_req);
-    if (read_req) {
-        return sendReadRequest(core, thread, read_req);
+DrvSimpleMemory::sendBlockRequest(DrvCore *core, DrvThread *thread, DrvAPI::DrvAPIThreadState &block_req) {
+    output_.verbose(CALL_INFO, 1, DrvMemory::VERBOSE_REQ, "sending block request\n");
+    uint8_t *data = &data_[block_req.getAddress()];
+    switch (block_req.type()) {
+    case DrvAPI::DrvAPIThreadStateMemReadBlock:
+        std::memcpy(block_req.getBlock(), data, block_req.getSize());
+        break;
+    case DrvAPI::DrvAPIThreadStateMemWriteBlock:
+        std::memcpy(data, block_req.getBlock(), block_req.getSize());
+        break;
+    default:
+        std::memset(data, block_req.getFill(), block_req.getSize());
+        break;
     }
+    core->completeThreadState(thread, block_req);
+}
 
-    auto write_req = std::dynamic_pointer_cast<DrvAPI::DrvAPIMemWrite>(thread_mem_req);
-    if (write_req) {
-        return sendWriteRequest(core, thread, write_req);
+/**
+ * @brief Send a gather/scatter request
+ */
+void
+DrvSimpleMemory::sendGatherScatterRequest(DrvCore *core, DrvThread *thread, DrvAPI::DrvAPIThreadState &gs_req) {
+    output_.verbose(CALL_INFO, 1, DrvMemory::VERBOSE_REQ, "sending gather/scatter request\n");
+    std::size_t size = gs_req.getSize();
+    for (std::size_t i = 0; i < gs_req.getElements(); i++) {
+        uint8_t *data = &data_[gs_req.getAddresses()[i]];
+        if (gs_req.type() == DrvAPI::DrvAPIThreadStateMemGather) {
+            std::memcpy(gs_req.getBlock() + i * size, data, size);
+        } else {
+            std::memcpy(data, gs_req.getBlock() + i * size, size);
+        }
     }
+    core->completeThreadState(thread, gs_req);
+}
 
-    auto atomic_req = std::dynamic_pointer_cast<DrvAPI::DrvAPIMemAtomic>(thread_mem_req);
-    if (atomic_req) {
-        return sendAtomicRequest(core, thread, atomic_req);
+/**
+ * @brief Send an active message
+ */
+void
+DrvSimpleMemory::sendActiveMessage(DrvCore *core, DrvThread *thread, DrvAPI::DrvAPIThreadState &am_req) {
+    output_.verbose(CALL_INFO, 1, DrvMemory::VERBOSE_REQ, "sending active message\n");
+    DrvBufferActiveMessageContext ctx(am_req, data_);
+    core->executeActiveMessage(am_req, &ctx);
+    core->completeThreadState(thread, am_req);
+}
+
+/**
+ * @brief Send a dma start or wait
+ */
+void
+DrvSimpleMemory::sendDMARequest(DrvCore *core, DrvThread *thread, DrvAPI::DrvAPIThreadState &dma_req) {
+    output_.verbose(CALL_INFO, 1, DrvMemory::VERBOSE_REQ, "sending dma request\n");
+    if (dma_req.type() == DrvAPI::DrvAPIThreadStateDMAStart) {
+        std::memmove(&data_[dma_req.getAddress()], &data_[dma_req.getDMASource()], dma_req.getSize());
+        dma_req.setDMAHandle(0);
+    }
+    core->completeThreadState(thread, dma_req);
+}
+
+/**
+ * @brief Send a memory request
+ */
+void
+DrvSimpleMemory::sendRequest (DrvCore *core, DrvThread *thread, DrvAPI::DrvAPIThreadState & thread_mem_req) {
+    switch (thread_mem_req.type()) {
+    case DrvAPI::DrvAPIThreadStateMemRead:
+    case DrvAPI::DrvAPIThreadStateMemWait:
+        // no other agents; a wait just returns the current value
+        return sendReadRequest(core, thread, thread_mem_req);
+    case DrvAPI::DrvAPIThreadStateMemWrite:
+        return sendWriteRequest(core, thread, thread_mem_req);
+    case DrvAPI::DrvAPIThreadStateMemAtomic:
+        return sendAtomicRequest(core, thread, thread_mem_req);
+    case DrvAPI::DrvAPIThreadStateMemReadBlock:
+    case DrvAPI::DrvAPIThreadStateMemWriteBlock:
+    case DrvAPI::DrvAPIThreadStateMemFillBlock:
+        return sendBlockRequest(core, thread, thread_mem_req);
+    case DrvAPI::DrvAPIThreadStateMemGather:
+    case DrvAPI::DrvAPIThreadStateMemScatter:
+        return sendGatherScatterRequest(core, thread, thread_mem_req);
+    case DrvAPI::DrvAPIThreadStateActiveMessage:
+        return sendActiveMessage(core, thread, thread_mem_req);
+    case DrvAPI::DrvAPIThreadStateDMAStart:
+    case DrvAPI::DrvAPIThreadStateDMAWait:
+        return sendDMARequest(core, thread, thread_mem_req);
+    default:
+        break;
     }
     core_->assertCoreOn();
     return;
 }
-
-
-
-
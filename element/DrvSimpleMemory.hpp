@@ -43,7 +43,7 @@ public:
     /**
      * @brief Send a memory request
      */
-    virtual void sendRequest(DrvCore *core, DrvThread *thread, const std::shared_ptr<DrvAPI::DrvAPIMem> & thread_mem_req) override;
+    virtual void sendRequest(DrvCore *core, DrvThread *thread, DrvAPI::DrvAPIThreadState & thread_mem_req) override;
 
 private:
     /**
@@ -51,21 +51,51 @@ private:
      */
     void sendWriteRequest(DrvCore *core
                           ,DrvThread *thread
-                          ,const std::shared_ptr<DrvAPI::DrvAPIMemWrite> &write_req);
+                          ,DrvAPI::DrvAPIThreadState &write_req);
 
     /**
      * @brief Send a write request
      */
     void sendReadRequest(DrvCore *core
                          ,DrvThread *thread
-                         ,const std::shared_ptr<DrvAPI::DrvAPIMemRead> &read_req);
+                         ,DrvAPI::DrvAPIThreadState &read_req);
 
     /**
      * @brief Send an atomic request
      */
     void sendAtomicRequest(DrvCore *core
                            ,DrvThread *thread
-                           ,const std::shared_ptr<DrvAPI::DrvAPIMemAtomic> &atomic_req);
+                           ,DrvAPI::DrvAPIThreadState &atomic_req);
+
+    /**
+     * @brief Send a read/write/fill block request
+     */
+    void sendBlockRequest(DrvCore *core
+                          ,DrvThread *thread
+                          ,DrvAPI::DrvAPIThreadState &block_req);
+
+    /**
+     * @brief Send a gather/scatter request
+     */
+    void sendGatherScatterRequest(DrvCore *core
+                                  ,DrvThread *thread
+                                  ,DrvAPI::DrvAPIThreadState &gs_req);
+
+    /**
+     * @brief Send an active message
+     */
+    void sendActiveMessage(DrvCore *core
+                           ,DrvThread *thread
+                           ,DrvAPI::DrvAPIThreadState &am_req);
+
+    /**
+     * @brief Send a dma start or wait
+     *
+     * The copy is done when it starts, so a wait always completes.
+     */
+    void sendDMARequest(DrvCore *core
+                        ,DrvThread *thread
+                        ,DrvAPI::DrvAPIThreadState &dma_req);
 
     // members
     std::vector<uint8_t> data_; //!< The data store
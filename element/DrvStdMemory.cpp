@@ -8,6 +8,8 @@
 #include "DrvAPIInfo.hpp"
 #include "DrvAPIAddressMap.hpp"
 #include <sst/elements/memHierarchy/memoryController.h>
+#include <algorithm>
+#include <cstring>
 
 using namespace SST;
 using namespace Drv;
@@ -73,6 +75,38 @@ void DrvStdMemory::ToNativeMetaData::init(DrvStdMemory *mem) {
 
     l2sp_interleave_decode = {cfg.podL2SPInterleaveSize(), cfg.podL2SPBankCount()};
     dram_interleave_decode = {cfg.pxnDRAMInterleaveSize(), cfg.pxnDRAMPortCount()};
+
+    // flatten into per-bank native pointers so translation is a table lookup
+    auto native_bank = [mem](const record_type &record) {
+        DrvAPI::DrvAPIAddress start, end;
+        SST::MemHierarchy::MemController *mc;
+        std::tie(start, end, mc) = record;
+        auto *backing = dynamic_cast<SST::MemHierarchy::Backend::BackingMMAP*>(mc->backing_);
+        if (!backing) {
+            mem->output_.fatal(CALL_INFO, -1, "Backing is not MMAP\n");
+        }
+        uint64_t laddr = mc->translateToLocal(start);
+        return NativeBank{start, &backing->m_buffer[laddr], backing->m_size - laddr};
+    };
+    pods = cfg.numPXNPods();
+    cores = cfg.numPodCores();
+    l2sp_banks_per_pod = cfg.podL2SPBankCount();
+    dram_banks_per_pxn = cfg.pxnDRAMPortCount();
+    l2sp_interleave = cfg.podL2SPInterleaveSize();
+    dram_interleave = cfg.pxnDRAMInterleaveSize();
+    for (int pxn = 0; pxn < cfg.numPXN(); pxn++) {
+        for (int pod = 0; pod < cfg.numPXNPods(); pod++) {
+            for (const record_type &record : l1sp_mcs[pxn][pod]) {
+                l1sp_banks.push_back(native_bank(record));
+            }
+            for (const record_type &record : l2sp_mcs[pxn][pod]) {
+                l2sp_banks.push_back(native_bank(record));
+            }
+        }
+        for (const record_type &record : dram_mcs[pxn]) {
+            dram_banks.push_back(native_bank(record));
+        }
+    }
 }
 
 /**
@@ -101,6 +135,18 @@ DrvStdMemory::DrvStdMemory(SST::ComponentId_t id, SST::Params& params, DrvCore *
     DrvAPI::DrvAPIAddress mmio_size  = params.find<DrvAPI::DrvAPIAddress>("memory_region_size", 0x1000);
     output_.verbose(CALL_INFO, 0, 10, "Setting memory-mapped region to start at 0x%" PRIx64 " and size 0x%" PRIx64 "\n", mmio_start, mmio_size);
     mem_->setMemoryMappedAddressRegion(mmio_start, 0x1000);
+    block_request_size_ = params.find<uint64_t>("block_request_size", 64);
+    block_max_requests_ = params.find<uint64_t>("block_max_requests", 8);
+    flush_depth_ = params.find<uint32_t>("flush_depth", 1);
+    if (block_request_size_ == 0 || block_max_requests_ == 0) {
+        output_.fatal(CALL_INFO, -1, "block_request_size and block_max_requests must be positive\n");
+    }
+    dma_.reset(new DrvDMAEngine(core, mem_, &output_
+                                ,params.find<double>("dma_bandwidth", 32.0)
+                                ,params.find<uint64_t>("dma_max_requests", 8)
+                                ,params.find<uint64_t>("dma_request_size", 64)
+                                ,params.find<uint64_t>("dma_queue_depth", 16)
+                                ,[this](int64_t handle) { completeDMA(handle); }));
 }
 
 /**
@@ -131,29 +177,12 @@ void DrvStdMemory::setup() {
  */
 void
 DrvStdMemory::toNativePointerDRAM(DrvAPI::DrvAPIAddress addr, const DrvAPI::DrvAPIAddressInfo &decode, void **ptr, size_t *size) {
-    DrvAPI::DrvAPISysConfig cfg = core_->sysConfig().config();
-    uint32_t interleave = cfg.pxnDRAMInterleaveSize();
-    int pxn = decode.pxn();
-    std::vector<record_type> &dram_mcs = to_native_meta_data_.dram_mcs[pxn];
-    uint64_t dram_offset = decode.offset();
+    const ToNativeMetaData &md = to_native_meta_data_;
     uint64_t bank, offset;
-    std::tie(bank, offset)
-        = to_native_meta_data_
-        .dram_interleave_decode
-        .getBankOffset(dram_offset);
-
-    DrvAPI::DrvAPIAddress start, stop;
-    SST::MemHierarchy::MemController *mc;
-    std::tie(start, stop, mc) = dram_mcs[bank];
-    uint64_t laddr = mc->translateToLocal(addr);
-    auto *backing = dynamic_cast<SST::MemHierarchy::Backend::BackingMMAP*>
-        (mc->backing_);
-    if (!backing) {
-        output_.fatal(CALL_INFO, -1, "L2SP backing is not a MMAP\n");
-    }
-    uint8_t *bptr = &backing->m_buffer[laddr];
-    *ptr = bptr;
-    *size = interleave - offset;
+    std::tie(bank, offset) = md.dram_interleave_decode.getBankOffset(decode.offset());
+    const ToNativeMetaData::NativeBank &b = md.dram_banks[decode.pxn() * md.dram_banks_per_pxn + bank];
+    *ptr = b.base + md.dram_interleave_decode.getLocal(addr - b.start);
+    *size = md.dram_interleave - offset;
 }
 
 /**
@@ -161,32 +190,13 @@ DrvStdMemory::toNativePointerDRAM(DrvAPI::DrvAPIAddress addr, const DrvAPI::DrvA
  */
 void
 DrvStdMemory::toNativePointerL2SP(DrvAPI::DrvAPIAddress addr, const DrvAPI::DrvAPIAddressInfo &decode, void **ptr, size_t *size) {
-    DrvAPI::DrvAPISysConfig cfg = core_->sysConfig().config();
-    uint32_t interleave = cfg.podL2SPInterleaveSize();
-    int pxn = decode.pxn();
-    int pod = decode.pod();
-    std::vector<record_type> &l2sp_mcs = to_native_meta_data_.l2sp_mcs[pxn][pod];
-
-    uint64_t l2_offset = decode.offset();
+    const ToNativeMetaData &md = to_native_meta_data_;
     uint64_t bank, offset;
-    std::tie(bank, offset)
-        = to_native_meta_data_
-        .l2sp_interleave_decode
-        .getBankOffset(l2_offset);
-
-
-    DrvAPI::DrvAPIAddress start, stop;
-    SST::MemHierarchy::MemController *mc;
-    std::tie(start, stop, mc) = l2sp_mcs[bank];
-    uint64_t laddr = mc->translateToLocal(addr);
-    auto *backing = dynamic_cast<SST::MemHierarchy::Backend::BackingMMAP*>
-        (mc->backing_);
-    if (!backing) {
-        output_.fatal(CALL_INFO, -1, "L2SP backing is not a MMAP\n");
-    }
-    uint8_t *bptr = &backing->m_buffer[laddr];
-    *ptr = bptr;
-    *size = interleave - offset;
+    std::tie(bank, offset) = md.l2sp_interleave_decode.getBankOffset(decode.offset());
+    int64_t pod = decode.pxn() * md.pods + decode.pod();
+    const ToNativeMetaData::NativeBank &b = md.l2sp_banks[pod * md.l2sp_banks_per_pod + bank];
+    *ptr = b.base + md.l2sp_interleave_decode.getLocal(addr - b.start);
+    *size = md.l2sp_interleave - offset;
 }
 
 /**
@@ -194,26 +204,15 @@ DrvStdMemory::toNativePointerL2SP(DrvAPI::DrvAPIAddress addr, const DrvAPI::DrvA
  */
 void
 DrvStdMemory::toNativePointerL1SP(DrvAPI::DrvAPIAddress addr, const DrvAPI::DrvAPIAddressInfo &decode, void **ptr, size_t *size) {
-    int pxn = decode.pxn();
-    int pod = decode.pod();
-    int core = decode.core();
-    // todo: we might not need a for loop here
-    DrvAPI::DrvAPIAddress start, end;
-    SST::MemHierarchy::MemController *mc;
-    std::tie(start, end, mc) = to_native_meta_data_.l1sp_mcs[pxn][pod][core];
-    if (start <= addr && addr < end) {
-        uint64_t laddr = mc->translateToLocal(addr);
-        auto *backing = dynamic_cast<SST::MemHierarchy::Backend::BackingMMAP*>
-            (mc->backing_);
-        if (!backing) {
-            output_.fatal(CALL_INFO, -1, "Backing is not MMAP\n");
-        }
-        uint8_t *bptr = &backing->m_buffer[laddr];
-        *ptr = bptr;
-        *size = backing->m_size - laddr;
-        return;
+    const ToNativeMetaData &md = to_native_meta_data_;
+    int64_t pod = decode.pxn() * md.pods + decode.pod();
+    const ToNativeMetaData::NativeBank &b = md.l1sp_banks[pod * md.cores + decode.core()];
+    uint64_t laddr = addr - b.start;
+    if (laddr >= b.size) {
+        output_.fatal(CALL_INFO, -1, "Address 0x%lx not found in L1SP\n", addr);
     }
-    output_.fatal(CALL_INFO, -1, "Address 0x%lx not found in L1SP\n", addr);
+    *ptr = b.base + laddr;
+    *size = b.size - laddr;
 }
 
 /**
@@ -246,64 +245,55 @@ DrvStdMemory::toNativePointer(DrvAPI::DrvAPIAddress paddr, void **ptr, size_t *s
 void
 DrvStdMemory::sendRequest(DrvCore *core
                           ,DrvThread *thread
-                          ,const std::shared_ptr<DrvAPI::DrvAPIMem> &mem_req) {
-    DrvAPI::DrvAPIAddressInfo paddr = core->decoder().decode(mem_req->getAddress());
+                          ,DrvAPI::DrvAPIThreadState &mem_req) {
+    DrvAPI::DrvAPIAddressInfo paddr = core->decoder().decode(mem_req.getAddress());
     bool noncacheable = !paddr.is_dram();
-    auto write_req = std::dynamic_pointer_cast<DrvAPI::DrvAPIMemWrite>(mem_req);
-    if (write_req) {
+    switch (mem_req.type()) {
+    case DrvAPI::DrvAPIThreadStateMemWrite: {
         /* do write */
-        uint64_t size = write_req->getSize();
-        uint64_t addr = write_req->getAddress();
+        uint64_t size = mem_req.getSize();
+        uint64_t addr = mem_req.getAddress();
         output_.verbose(CALL_INFO, 10, DrvMemory::VERBOSE_REQ,
                         "Sending write request addr=%" PRIx64 " size=%" PRIu64 "\n",
                         addr, size);
         std::vector<uint8_t> data(size);
-        write_req->getPayload(&data[0]);
+        mem_req.getPayload(&data[0]);
         StandardMem::Write *req = new StandardMem::Write(addr, size, data);
-        req->tid = core->getThreadID(thread);
         if (noncacheable) req->setNoncacheable();
         // add statistic
         core->addStoreStat(paddr, thread);
-        mem_->send(req);
+        sendThreadRequest(req, thread, mem_req);
         return;
     }
-
-    auto read_req = std::dynamic_pointer_cast<DrvAPI::DrvAPIMemRead>(mem_req);
-    if (read_req) {
+    case DrvAPI::DrvAPIThreadStateMemRead: {
         /* do read */
-        uint64_t size = read_req->getSize();
-        uint64_t addr = read_req->getAddress();
+        uint64_t size = mem_req.getSize();
+        uint64_t addr = mem_req.getAddress();
         output_.verbose(CALL_INFO, 10, DrvMemory::VERBOSE_REQ,
                                 "Sending read request addr=%" PRIx64 " size=%" PRIu64 "\n",
                                 addr, size);
         StandardMem::Read *req = new StandardMem::Read(addr, size);
-        req->tid = core->getThreadID(thread);
         if (noncacheable) req->setNoncacheable();
         core->addLoadStat(paddr, thread);
-        mem_->send(req);
+        sendThreadRequest(req, thread, mem_req);
         return;
     }
-
-    auto to_native_req = std::dynamic_pointer_cast<DrvAPI::DrvAPIToNativePointer>(mem_req);
-    if (to_native_req) {
-        uint64_t paddr = to_native_req->getAddress();
+    case DrvAPI::DrvAPIThreadStateToNativePointer: {
         void *ptr=nullptr;
         size_t size=0;
-        toNativePointer(paddr, &ptr, &size);
-        to_native_req->setNativePointer(ptr);
-        to_native_req->setRegionSize(size);
-        to_native_req->complete();
+        toNativePointer(mem_req.getAddress(), &ptr, &size);
+        mem_req.setNativePointer(ptr);
+        mem_req.setRegionSize(size);
+        core->completeThreadState(thread, mem_req);
         return;
     }
-
-    auto atomic_req = std::dynamic_pointer_cast<DrvAPI::DrvAPIMemAtomic>(mem_req);
-    if (atomic_req) {
+    case DrvAPI::DrvAPIThreadStateMemAtomic: {
         /* do atomic */
         /* we implement the atomic in terms of read-lock and write-unlockprovided by stdMem.h
          * we could also do this with ll and sc, but those do not guarantee success
          */
-        uint64_t size = atomic_req->getSize();
-        uint64_t addr = atomic_req->getAddress();
+        uint64_t size = mem_req.getSize();
+        uint64_t addr = mem_req.getAddress();
         output_.verbose(CALL_INFO, 10, DrvMemory::VERBOSE_REQ,
                         "Sending atomic request addr=%" PRIx64 " size=%" PRIu64 "\n",
                         addr, size);
@@ -312,32 +302,277 @@ DrvStdMemory::sendRequest(DrvCore *core
         data->pAddr = addr;
         data->size = size;
         data->wdata.resize(size);
-        data->opcode = atomic_req->getOp();
-        atomic_req->getPayload(&data->wdata[0]);
-        if (atomic_req->hasExt()) {
+        data->opcode = mem_req.getOp();
+        mem_req.getPayload(&data->wdata[0]);
+        if (mem_req.hasExt()) {
             data->extdata.resize(size);
-            atomic_req->getPayloadExt(&data->extdata[0]);
+            mem_req.getPayloadExt(&data->extdata[0]);
         }
         // set atomic type
         StandardMem::CustomReq *req = new StandardMem::CustomReq(data);
-        req->tid = core->getThreadID(thread);
-        mem_->send(req);
+        sendThreadRequest(req, thread, mem_req);
         return;
     }
+    case DrvAPI::DrvAPIThreadStateMemWait: {
+        uint64_t size = mem_req.getSize();
+        uint64_t addr = mem_req.getAddress();
+        output_.verbose(CALL_INFO, 10, DrvMemory::VERBOSE_REQ,
+                        "Sending wait request addr=%" PRIx64 " size=%" PRIu64 "\n",
+                        addr, size);
+        core->addLoadStat(paddr, thread);
+        WaitReqData *data = new WaitReqData();
+        data->pAddr = addr;
+        data->size = size;
+        data->expected.resize(size);
+        mem_req.getPayload(&data->expected[0]);
+        StandardMem::CustomReq *req = new StandardMem::CustomReq(data);
+        if (noncacheable) req->setNoncacheable();
+        sendThreadRequest(req, thread, mem_req);
+        return;
+    }
+    case DrvAPI::DrvAPIThreadStateActiveMessage: {
+        uint64_t addr = mem_req.getAddress();
+        output_.verbose(CALL_INFO, 10, DrvMemory::VERBOSE_REQ,
+                        "Sending active message addr=%" PRIx64 " function=%d size=%" PRIu64 "\n",
+                        addr, mem_req.getFunctionId(), mem_req.getSize());
+        core->addAtomicStat(paddr, thread);
+        ActiveMessageReqData *data = new ActiveMessageReqData();
+        data->pAddr = addr;
+        data->executable = core->executableKey();
+        data->function_id = mem_req.getFunctionId();
+        data->result_size = mem_req.getResultSize();
+        data->data.resize(mem_req.getSize());
+        mem_req.getPayload(&data->data[0]);
+        StandardMem::CustomReq *req = new StandardMem::CustomReq(data);
+        sendThreadRequest(req, thread, mem_req);
+        return;
+    }
+    case DrvAPI::DrvAPIThreadStateMemReadBlock:
+    case DrvAPI::DrvAPIThreadStateMemWriteBlock:
+    case DrvAPI::DrvAPIThreadStateMemFillBlock:
+        return sendBlockRequests(core, thread, mem_req);
+    case DrvAPI::DrvAPIThreadStateMemGather:
+    case DrvAPI::DrvAPIThreadStateMemScatter:
+        return sendGatherScatterRequests(core, thread, mem_req);
+    case DrvAPI::DrvAPIThreadStateFlushLine:
+        return sendFlushLine(core, thread, mem_req);
+    case DrvAPI::DrvAPIThreadStateInvLine:
+        return sendInvalidateLine(core, thread, mem_req);
+    case DrvAPI::DrvAPIThreadStateFlushRange:
+    case DrvAPI::DrvAPIThreadStateInvRange:
+    case DrvAPI::DrvAPIThreadStateFlushCache:
+    case DrvAPI::DrvAPIThreadStateInvCache:
+        return sendFlushRequests(core, thread, mem_req);
+    case DrvAPI::DrvAPIThreadStateDMAStart:
+    case DrvAPI::DrvAPIThreadStateDMAWait:
+        return sendDMARequest(core, thread, mem_req);
+    default:
+        // fatally error if we don't know the request type
+        core->output()->fatal(CALL_INFO, -1, "Unknown memory request type\n");
+    }
+}
+
+/**
+ * @brief Send requests for a read/write/fill block
+ */
+void
+DrvStdMemory::sendBlockRequests(DrvCore *core, DrvThread *thread, DrvAPI::DrvAPIThreadState &block_req) {
+    while (block_req.blockRemaining() > 0 && block_req.blockPending() < block_max_requests_) {
+        uint64_t size = 0;
+        uint64_t offset = block_req.issueBlock(block_request_size_, &size);
+        uint64_t addr = block_req.getAddress() + offset;
+        DrvAPI::DrvAPIAddressInfo paddr = core->decoder().decode(addr);
+        bool noncacheable = !paddr.is_dram();
+        output_.verbose(CALL_INFO, 10, DrvMemory::VERBOSE_REQ,
+                        "Sending block request addr=%" PRIx64 " size=%" PRIu64 "\n",
+                        addr, size);
+        if (block_req.type() == DrvAPI::DrvAPIThreadStateMemReadBlock) {
+            StandardMem::Read *read = new StandardMem::Read(addr, size);
+            if (noncacheable) read->setNoncacheable();
+            core->addLoadStat(paddr, thread);
+            sendThreadRequest(read, thread, block_req, offset);
+        } else {
+            std::vector<uint8_t> data;
+            if (block_req.type() == DrvAPI::DrvAPIThreadStateMemWriteBlock) {
+                data.assign(block_req.getBlock() + offset, block_req.getBlock() + offset + size);
+            } else {
+                data.assign(size, block_req.getFill());
+            }
+            StandardMem::Write *write = new StandardMem::Write(addr, size, data);
+            if (noncacheable) write->setNoncacheable();
+            core->addStoreStat(paddr, thread);
+            sendThreadRequest(write, thread, block_req, offset);
+        }
+    }
+}
 
-    auto flush_req = std::dynamic_pointer_cast<DrvAPI::DrvAPIFlushLine>(mem_req);
-    if (flush_req) {
-        return sendFlushLine(core, thread, flush_req);
+/**
+ * @brief retire one response of a block request
+ */
+void
+DrvStdMemory::completeBlockResponse(DrvThread *thread, DrvAPI::DrvAPIThreadState &block_req) {
+    if (block_req.completeBlock()) {
+        core_->completeThreadState(thread, block_req);
+    } else if (block_req.isFlushBlock()) {
+        sendFlushRequests(core_, thread, block_req);
+    } else {
+        sendBlockRequests(core_, thread, block_req);
     }
+}
 
-    auto inv_req = std::dynamic_pointer_cast<DrvAPI::DrvAPIInvLine>(mem_req);
-    if (inv_req) {
-        return sendInvalidateLine(core, thread, inv_req);
+/**
+ * @brief Send requests for a gather/scatter
+ */
+void
+DrvStdMemory::sendGatherScatterRequests(DrvCore *core, DrvThread *thread, DrvAPI::DrvAPIThreadState &gs_req) {
+    const DrvAPI::DrvAPIAddress *addrs = gs_req.getAddresses();
+    uint64_t size = gs_req.getSize();
+    bool scatter = gs_req.type() == DrvAPI::DrvAPIThreadStateMemScatter;
+    GatherScatterContext &ctx = gather_scatter_[&gs_req];
+    ctx.order.resize(gs_req.getElements());
+    for (size_t i = 0; i < ctx.order.size(); i++) {
+        ctx.order[i] = i;
     }
-    
-    // fatally error if we don't know the request type
-    if (!(write_req || read_req || to_native_req || atomic_req || inv_req || flush_req)) {
-        core->output()->fatal(CALL_INFO, -1, "Unknown memory request type\n");
+    // stable, so the last write to a repeated scatter index sorts last
+    std::stable_sort(ctx.order.begin(), ctx.order.end(), [addrs](size_t a, size_t b) {
+        return addrs[a] < addrs[b];
+    });
+    if (scatter) {
+        // only the last write to a repeated index is kept, so no two
+        // requests in flight write the same bytes
+        size_t n = 0;
+        for (size_t i = 0; i < ctx.order.size(); i++) {
+            if (i + 1 < ctx.order.size() && addrs[ctx.order[i]] == addrs[ctx.order[i + 1]]) {
+                continue;
+            }
+            ctx.order[n++] = ctx.order[i];
+        }
+        ctx.order.resize(n);
+    }
+    // merge elements that share a line; split elements that cross one
+    ctx.groups.clear();
+    for (size_t i = 0; i < ctx.order.size(); i++) {
+        uint64_t addr = addrs[ctx.order[i]];
+        uint64_t end = addr + size;
+        while (addr < end) {
+            uint64_t line_end = (addr / block_request_size_ + 1) * block_request_size_;
+            uint64_t piece_end = std::min(end, line_end);
+            if (!ctx.groups.empty()) {
+                GatherScatterGroup &g = ctx.groups.back();
+                bool same_line = (g.start / block_request_size_) == (addr / block_request_size_);
+                if (same_line && (!scatter || addr <= g.end)) {
+                    g.end = std::max(g.end, piece_end);
+                    g.last = i + 1;
+                    addr = piece_end;
+                    continue;
+                }
+            }
+            ctx.groups.push_back({addr, piece_end, i, i + 1});
+            addr = piece_end;
+        }
+    }
+    ctx.issued = 0;
+    ctx.pending = 0;
+    output_.verbose(CALL_INFO, 10, DrvMemory::VERBOSE_REQ,
+                    "Sending %s of %zu elements as %zu requests\n",
+                    scatter ? "scatter" : "gather", ctx.order.size(), ctx.groups.size());
+    issueGatherScatterRequests(core, thread, gs_req);
+}
+
+/**
+ * @brief issue a gather/scatter's requests until block_max_requests are in flight
+ */
+void
+DrvStdMemory::issueGatherScatterRequests(DrvCore *core, DrvThread *thread, DrvAPI::DrvAPIThreadState &gs_req) {
+    const DrvAPI::DrvAPIAddress *addrs = gs_req.getAddresses();
+    uint64_t size = gs_req.getSize();
+    bool scatter = gs_req.type() == DrvAPI::DrvAPIThreadStateMemScatter;
+    GatherScatterContext &ctx = gather_scatter_[&gs_req];
+    while (ctx.issued < ctx.groups.size() && ctx.pending < block_max_requests_) {
+        size_t g = ctx.issued++;
+        ctx.pending++;
+        const GatherScatterGroup &group = ctx.groups[g];
+        DrvAPI::DrvAPIAddressInfo paddr = core->decoder().decode(group.start);
+        bool noncacheable = !paddr.is_dram();
+        if (scatter) {
+            std::vector<uint8_t> data(group.end - group.start);
+            for (size_t i = group.first; i < group.last; i++) {
+                size_t e = ctx.order[i];
+                uint64_t lo = std::max<uint64_t>(addrs[e], group.start);
+                uint64_t hi = std::min<uint64_t>(addrs[e] + size, group.end);
+                std::memcpy(&data[lo - group.start], gs_req.getBlock() + e * size + (lo - addrs[e]), hi - lo);
+            }
+            StandardMem::Write *write = new StandardMem::Write(group.start, data.size(), data);
+            if (noncacheable) write->setNoncacheable();
+            core->addStoreStat(paddr, thread);
+            sendThreadRequest(write, thread, gs_req, g);
+        } else {
+            StandardMem::Read *read = new StandardMem::Read(group.start, group.end - group.start);
+            if (noncacheable) read->setNoncacheable();
+            core->addLoadStat(paddr, thread);
+            sendThreadRequest(read, thread, gs_req, g);
+        }
+    }
+}
+
+/**
+ * @brief retire one response of a gather/scatter
+ */
+void
+DrvStdMemory::completeGatherScatterResponse(DrvThread *thread, DrvAPI::DrvAPIThreadState &gs_req, uint64_t group, const uint8_t *data) {
+    auto it = gather_scatter_.find(&gs_req);
+    if (it == gather_scatter_.end()) {
+        output_.fatal(CALL_INFO, -1, "Response for unknown gather/scatter\n");
+    }
+    GatherScatterContext &ctx = it->second;
+    if (data) {
+        const GatherScatterGroup &g = ctx.groups[group];
+        const DrvAPI::DrvAPIAddress *addrs = gs_req.getAddresses();
+        uint64_t size = gs_req.getSize();
+        for (size_t i = g.first; i < g.last; i++) {
+            size_t e = ctx.order[i];
+            uint64_t lo = std::max<uint64_t>(addrs[e], g.start);
+            uint64_t hi = std::min<uint64_t>(addrs[e] + size, g.end);
+            std::memcpy(gs_req.getBlock() + e * size + (lo - addrs[e]), &data[lo - g.start], hi - lo);
+        }
+    }
+    ctx.pending--;
+    if (ctx.pending == 0 && ctx.issued == ctx.groups.size()) {
+        gather_scatter_.erase(it);
+        core_->completeThreadState(thread, gs_req);
+    } else {
+        issueGatherScatterRequests(core_, thread, gs_req);
+    }
+}
+
+/**
+ * @brief find and forget the thread request matching a response
+ */
+template <typename ResponseType>
+DrvStdMemory::outstanding_type
+DrvStdMemory::popOutstanding(ResponseType *rsp) {
+    uint32_t tag = rsp->tid;
+    if (tag >= outstanding_.size() || std::get<0>(outstanding_[tag]) == nullptr) {
+        output_.fatal(CALL_INFO, -1, "Failed to find memory request for id=%" PRIu64 " tag=%" PRIu32 "\n", rsp->getID(), tag);
+    }
+    outstanding_type outstanding = outstanding_[tag];
+    outstanding_[tag] = outstanding_type(nullptr, nullptr, 0);
+    free_tags_.push_back(tag);
+    return outstanding;
+}
+
+/**
+ * @brief double the number of request tags
+ */
+void
+DrvStdMemory::growOutstanding() {
+    size_t old_size = outstanding_.size();
+    size_t new_size = std::max<size_t>(2 * old_size, 64);
+    outstanding_.resize(new_size, outstanding_type(nullptr, nullptr, 0));
+    free_tags_.reserve(new_size);
+    // hand out low tags first
+    for (size_t tag = new_size; tag > old_size; tag--) {
+        free_tags_.push_back(static_cast<uint32_t>(tag - 1));
     }
 }
 
@@ -349,15 +584,18 @@ DrvStdMemory::sendRequest(DrvCore *core
 void
 DrvStdMemory::handleEvent(SST::Interfaces::StandardMem::Request *req) {
     output_.verbose(CALL_INFO, 10, DrvMemory::VERBOSE_REQ, "Received memory request\n");
+    // responses to the dma engine's copies
+    if (dma_->handleResponse(req)) {
+        delete req;
+        core_->assertCoreOn();
+        return;
+    }
     DrvThread *thread = nullptr;
-    std::shared_ptr<DrvAPI::DrvAPIMem> mem_req = nullptr;
+    DrvAPI::DrvAPIThreadState *state = nullptr;
+    uint64_t offset = 0;
     auto write_rsp = dynamic_cast<StandardMem::WriteResp*>(req);
     if (write_rsp) {
-        thread = core_->getThread(write_rsp->tid);
-        if (!thread) {
-            output_.fatal(CALL_INFO, -1, "Failed to find thread for tid=%" PRIu32 "\n", write_rsp->tid);
-        }
-        
+        std::tie(thread, state, offset) = popOutstanding(write_rsp);
         output_.verbose(CALL_INFO, 10, DrvMemory::VERBOSE_REQ,
                         "Received write response from addr=%" PRIx64 " size=%" PRIu64 "\n",
                         write_rsp->pAddr, write_rsp->size);
@@ -367,20 +605,21 @@ DrvStdMemory::handleEvent(SST::Interfaces::StandardMem::Request *req) {
             core_->traceRemotePxnMem(DrvCore::TRACE_REMOTE_PXN_STORE, "write_rsp", paddr, thread);
         }
         // complete write
-        mem_req = std::dynamic_pointer_cast<DrvAPI::DrvAPIMem>(thread->getAPIThread().getState());
-        if (mem_req) {
-            mem_req->complete();
+        if (state->type() == DrvAPI::DrvAPIThreadStateMemWrite) {
+            core_->completeThreadState(thread, *state);
+        } else if (state->type() == DrvAPI::DrvAPIThreadStateMemWriteBlock
+                   || state->type() == DrvAPI::DrvAPIThreadStateMemFillBlock) {
+            completeBlockResponse(thread, *state);
+        } else if (state->type() == DrvAPI::DrvAPIThreadStateMemScatter) {
+            completeGatherScatterResponse(thread, *state, offset, nullptr);
         } else {
-            output_.fatal(CALL_INFO, -1, "Failed to find memory request for tid=%" PRIu32 "\n", write_rsp->tid);
+            output_.fatal(CALL_INFO, -1, "Write response for non-write request for tag=%" PRIu32 "\n", write_rsp->tid);
         }
     }
 
     auto read_rsp = dynamic_cast<StandardMem::ReadResp*>(req);
     if (read_rsp) {
-        thread = core_->getThread(read_rsp->tid);
-        if (!thread) {
-            output_.fatal(CALL_INFO, -1, "Failed to find thread for tid=%" PRIu32 "\n", read_rsp->tid);
-        }
+        std::tie(thread, state, offset) = popOutstanding(read_rsp);
         output_.verbose(CALL_INFO, 10, DrvMemory::VERBOSE_REQ,
                         "Received read response from addr=%" PRIx64 " size=%" PRIu64 "\n",
                         read_rsp->pAddr, read_rsp->size);
@@ -389,39 +628,76 @@ DrvStdMemory::handleEvent(SST::Interfaces::StandardMem::Request *req) {
         if (paddr.pxn() != (int64_t)core_->pxn_) {
             core_->traceRemotePxnMem(DrvCore::TRACE_REMOTE_PXN_LOAD, "read_rsp", paddr, thread);
         }
-        // complete read, if this was a read request
-        auto read_req = std::dynamic_pointer_cast<DrvAPI::DrvAPIMemRead>(thread->getAPIThread().getState());
-        if (read_req) {
-            read_req->setResult(&read_rsp->data[0]);
-            read_req->complete();            
-        }
-
-        if (!read_req) {
-            output_.fatal(CALL_INFO, -1, "Failed to find memory request for tid=%" PRIu32 "\n", read_rsp->tid);
+        // complete read
+        if (state->type() == DrvAPI::DrvAPIThreadStateMemRead) {
+            state->setResult(&read_rsp->data[0]);
+            core_->completeThreadState(thread, *state);
+        } else if (state->type() == DrvAPI::DrvAPIThreadStateMemReadBlock) {
+            std::copy(read_rsp->data.begin(), read_rsp->data.end(), state->getBlock() + offset);
+            completeBlockResponse(thread, *state);
+        } else if (state->type() == DrvAPI::DrvAPIThreadStateMemGather) {
+            completeGatherScatterResponse(thread, *state, offset, &read_rsp->data[0]);
+        } else {
+            output_.fatal(CALL_INFO, -1, "Read response for non-read request for tag=%" PRIu32 "\n", read_rsp->tid);
         }
     }
 
     auto custom_rsp = dynamic_cast<StandardMem::CustomResp*>(req);
     AtomicReqData* areq_data = nullptr;
+    bool am_rsp = false; // checked after the response data is deleted
+    bool wait_rsp = false; // checked after the response data is deleted
     if (custom_rsp) {
         areq_data = dynamic_cast<AtomicReqData*>(custom_rsp->data);
         if (areq_data) {
             output_.verbose(CALL_INFO, 10, DrvMemory::VERBOSE_REQ,
                             "Received custom response\n");            
-            DrvThread *thread = core_->getThread(custom_rsp->tid);
+            std::tie(thread, state, offset) = popOutstanding(custom_rsp);
             DrvAPI::DrvAPIAddressInfo paddr = core_->decoder().decode(areq_data->pAddr);
             if (paddr.pxn() != (int64_t)core_->pxn_) {
                 core_->traceRemotePxnMem(DrvCore::TRACE_REMOTE_PXN_ATOMIC, "atomic_rsp", paddr, thread);
             }
-            auto atomic_req = std::dynamic_pointer_cast<DrvAPI::DrvAPIMemAtomic>(thread->getAPIThread().getState());
-            if (atomic_req) {
-                atomic_req->setResult(&areq_data->rdata[0]);
-                atomic_req->complete();
+            if (state->type() == DrvAPI::DrvAPIThreadStateMemAtomic) {
+                state->setResult(&areq_data->rdata[0]);
+                core_->completeThreadState(thread, *state);
             } else {
-                output_.fatal(CALL_INFO, -1, "Failed to find memory request for tid=%" PRIu32 "\n", custom_rsp->tid);
+                output_.fatal(CALL_INFO, -1, "Atomic response for non-atomic request for tag=%" PRIu32 "\n", custom_rsp->tid);
             }
         }
+        ActiveMessageReqData *amreq_data = dynamic_cast<ActiveMessageReqData*>(custom_rsp->data);
+        am_rsp = amreq_data != nullptr;
+        if (amreq_data) {
+            output_.verbose(CALL_INFO, 10, DrvMemory::VERBOSE_REQ,
+                            "Received active message response\n");
+            std::tie(thread, state, offset) = popOutstanding(custom_rsp);
+            if (state->type() == DrvAPI::DrvAPIThreadStateActiveMessage) {
+                if (amreq_data->rdata.size() != state->getResultSize()) {
+                    output_.fatal(CALL_INFO, -1, "Active message result size mismatch for tag=%" PRIu32 "\n", custom_rsp->tid);
+                }
+                if (!amreq_data->rdata.empty()) {
+                    state->setActiveMessageResult(&amreq_data->rdata[0]);
+                }
+                core_->completeThreadState(thread, *state);
+            } else {
+                output_.fatal(CALL_INFO, -1, "Active message response for non-active message request for tag=%" PRIu32 "\n", custom_rsp->tid);
+            }
+        }
+        WaitReqData *wreq_data = dynamic_cast<WaitReqData*>(custom_rsp->data);
+        wait_rsp = wreq_data != nullptr;
+        if (wreq_data) {
+            output_.verbose(CALL_INFO, 10, DrvMemory::VERBOSE_REQ,
+                            "Received wait response\n");
+            std::tie(thread, state, offset) = popOutstanding(custom_rsp);
+            if (state->type() == DrvAPI::DrvAPIThreadStateMemWait) {
+                state->setResult(&wreq_data->rdata[0]);
+                core_->completeThreadState(thread, *state);
+            } else {
+                output_.fatal(CALL_INFO, -1, "Wait response for non-wait request for tag=%" PRIu32 "\n", custom_rsp->tid);
+            }
+        }
+        // the data is cast above as each type, so free it only once all casts are done
         delete areq_data;
+        delete amreq_data;
+        delete wreq_data;
     }
 
     auto write_req = dynamic_cast<StandardMem::Write*>(req);
@@ -438,12 +714,13 @@ DrvStdMemory::handleEvent(SST::Interfaces::StandardMem::Request *req) {
     if (flush_rsp) {
         output_.verbose(CALL_INFO, 10, DrvMemory::VERBOSE_REQ,
                         "Received flush response\n");
-        DrvThread *thread = core_->getThread(flush_rsp->tid);
-        auto flush_req = std::dynamic_pointer_cast<DrvAPI::DrvAPIFlushLine>(thread->getAPIThread().getState());
-        if (flush_req) {
-            flush_req->complete();
+        std::tie(thread, state, offset) = popOutstanding(flush_rsp);
+        if (state->type() == DrvAPI::DrvAPIThreadStateFlushLine) {
+            core_->completeThreadState(thread, *state);
+        } else if (state->type() == DrvAPI::DrvAPIThreadStateFlushCache) {
+            completeBlockResponse(thread, *state);
         } else {
-            output_.fatal(CALL_INFO, -1, "Failed to find memory request for tid=%" PRIu32 "\n", flush_rsp->tid);
+            output_.fatal(CALL_INFO, -1, "Flush response for non-flush request for tag=%" PRIu32 "\n", flush_rsp->tid);
         }
     }
 
@@ -451,17 +728,33 @@ DrvStdMemory::handleEvent(SST::Interfaces::StandardMem::Request *req) {
     if (inv_rsp) {
         output_.verbose(CALL_INFO, 10, DrvMemory::VERBOSE_REQ,
                         "Received inv response\n");
-        DrvThread *thread = core_->getThread(inv_rsp->tid);
-        auto inv_req = std::dynamic_pointer_cast<DrvAPI::DrvAPIInvLine>(thread->getAPIThread().getState());
-        if (inv_req) {
-            inv_req->complete();
+        std::tie(thread, state, offset) = popOutstanding(inv_rsp);
+        if (state->type() == DrvAPI::DrvAPIThreadStateInvLine) {
+            core_->completeThreadState(thread, *state);
+        } else if (state->type() == DrvAPI::DrvAPIThreadStateInvCache) {
+            completeBlockResponse(thread, *state);
         } else {
-            output_.fatal(CALL_INFO, -1, "Failed to find memory request for tid=%" PRIu32 "\n", inv_rsp->tid);
+            output_.fatal(CALL_INFO, -1, "Invalidate response for non-invalidate request for tag=%" PRIu32 "\n", inv_rsp->tid);
+        }
+    }
+
+    // line responses are matched above
+    auto flush_addr_rsp = (flush_rsp || inv_rsp) ? nullptr : dynamic_cast<StandardMem::FlushResp*>(req);
+    if (flush_addr_rsp) {
+        output_.verbose(CALL_INFO, 10, DrvMemory::VERBOSE_REQ,
+                        "Received flush address response addr=%" PRIx64 "\n",
+                        flush_addr_rsp->pAddr);
+        std::tie(thread, state, offset) = popOutstanding(flush_addr_rsp);
+        if (state->type() == DrvAPI::DrvAPIThreadStateFlushRange ||
+            state->type() == DrvAPI::DrvAPIThreadStateInvRange) {
+            completeBlockResponse(thread, *state);
+        } else {
+            output_.fatal(CALL_INFO, -1, "Flush address response for non-range request for tag=%" PRIu32 "\n", flush_addr_rsp->tid);
         }
     }
 
     // fatally error if we don't know the response type
-    if (!(write_rsp || read_rsp || (custom_rsp && areq_data) || write_req || flush_rsp || inv_rsp)) {
+    if (!(write_rsp || read_rsp || (custom_rsp && (areq_data || am_rsp || wait_rsp)) || write_req || flush_rsp || inv_rsp || flush_addr_rsp)) {
         output_.fatal(CALL_INFO, -1, "Unknown memory response type: %s\n", req->getString().c_str());
     }
 
@@ -470,18 +763,85 @@ DrvStdMemory::handleEvent(SST::Interfaces::StandardMem::Request *req) {
     core_->assertCoreOn();
 }
 
-void DrvStdMemory::sendFlushLine(DrvCore *core, DrvThread *thread, const std::shared_ptr<DrvAPI::DrvAPIFlushLine> &flush) {
-    DrvAPI::DrvAPIAddress paddr = flush->getAddress();
+void DrvStdMemory::sendFlushLine(DrvCore *core, DrvThread *thread, DrvAPI::DrvAPIThreadState &flush) {
+    DrvAPI::DrvAPIAddress paddr = flush.getAddress();
     DrvAPI::DrvAPIAddressInfo info = core->decoder().decode(paddr).set_absolute(true);        
-    StandardMem::FlushLine *req = new StandardMem::FlushLine(core_->decoder().encode(info), flush->line_);
-    req->tid = core->getThreadID(thread);
-    mem_->send(req);
+    StandardMem::FlushLine *req = new StandardMem::FlushLine(core_->decoder().encode(info), flush.getLine());
+    sendThreadRequest(req, thread, flush);
+}
+
+void DrvStdMemory::sendFlushRequests(DrvCore *core, DrvThread *thread, DrvAPI::DrvAPIThreadState &flush) {
+    DrvAPI::DrvAPISysConfig cfg = core->sysConfig().config();
+    bool range = flush.type() == DrvAPI::DrvAPIThreadStateFlushRange
+        || flush.type() == DrvAPI::DrvAPIThreadStateInvRange;
+    bool inv = flush.type() == DrvAPI::DrvAPIThreadStateInvRange
+        || flush.type() == DrvAPI::DrvAPIThreadStateInvCache;
+    uint64_t line_size = cfg.pxnDRAMCacheLineSize() > 0 ? cfg.pxnDRAMCacheLineSize() : block_request_size_;
+    uint64_t bank_lines = static_cast<uint64_t>(cfg.pxnDRAMCacheSets()) * cfg.pxnDRAMCacheWays();
+    while (flush.blockRemaining() > 0 && flush.blockPending() < block_max_requests_) {
+        uint64_t size = 0;
+        if (range) {
+            // one flush per line of the range
+            uint64_t offset = flush.issueBlock(line_size, &size);
+            uint64_t addr = flush.getAddress() + offset;
+            output_.verbose(CALL_INFO, 10, DrvMemory::VERBOSE_REQ,
+                            "Sending %s addr=%" PRIx64 " size=%" PRIu64 "\n",
+                            inv ? "flush+invalidate" : "flush", addr, size);
+            StandardMem::FlushAddr *req = new StandardMem::FlushAddr(addr, size, inv, flush_depth_);
+            sendThreadRequest(req, thread, flush, offset);
+        } else {
+            // one flush per line index; banks are interleaved from the pxn's dram base
+            uint64_t index = flush.issueBlock(1, &size);
+            uint64_t addr = flush.getAddress() + (index / bank_lines) * cfg.pxnDRAMInterleaveSize();
+            uint64_t line = index % bank_lines;
+            if (inv) {
+                StandardMem::InvLine *req = new StandardMem::InvLine(addr, line);
+                sendThreadRequest(req, thread, flush, index);
+            } else {
+                StandardMem::FlushLine *req = new StandardMem::FlushLine(addr, line);
+                sendThreadRequest(req, thread, flush, index);
+            }
+        }
+    }
+}
+
+void DrvStdMemory::sendDMARequest(DrvCore *core, DrvThread *thread, DrvAPI::DrvAPIThreadState &dma_req) {
+    if (dma_req.type() == DrvAPI::DrvAPIThreadStateDMAWait) {
+        int64_t handle = dma_req.result<int64_t>();
+        if (dma_->complete(handle)) {
+            core->completeThreadState(thread, dma_req);
+        } else {
+            dma_waiters_.emplace(handle, dma_blocked_type(thread, &dma_req));
+        }
+        return;
+    }
+    // a start blocks while the queue is full, and behind earlier blocked starts
+    if (dma_->full() || !dma_blocked_.empty()) {
+        dma_blocked_.emplace_back(thread, &dma_req);
+        return;
+    }
+    dma_req.setDMAHandle(dma_->push(dma_req.getAddress(), dma_req.getDMASource(), dma_req.getSize()));
+    core->completeThreadState(thread, dma_req);
+}
+
+void DrvStdMemory::completeDMA(int64_t handle) {
+    auto waiters = dma_waiters_.equal_range(handle);
+    for (auto it = waiters.first; it != waiters.second; ++it) {
+        core_->completeThreadState(it->second.first, *it->second.second);
+    }
+    dma_waiters_.erase(waiters.first, waiters.second);
+    while (!dma_blocked_.empty() && !dma_->full()) {
+        DrvThread *thread = dma_blocked_.front().first;
+        DrvAPI::DrvAPIThreadState *dma_req = dma_blocked_.front().second;
+        dma_blocked_.pop_front();
+        dma_req->setDMAHandle(dma_->push(dma_req->getAddress(), dma_req->getDMASource(), dma_req->getSize()));
+        core_->completeThreadState(thread, *dma_req);
+    }
 }
 
-void DrvStdMemory::sendInvalidateLine(DrvCore *core, DrvThread *thread, const std::shared_ptr<DrvAPI::DrvAPIInvLine> &inv_req) {
-    DrvAPI::DrvAPIAddress paddr = inv_req->getAddress();
+void DrvStdMemory::sendInvalidateLine(DrvCore *core, DrvThread *thread, DrvAPI::DrvAPIThreadState &inv_req) {
+    DrvAPI::DrvAPIAddress paddr = inv_req.getAddress();
     DrvAPI::DrvAPIAddressInfo info = core->decoder().decode(paddr).set_absolute(true);        
-    StandardMem::InvLine *req = new StandardMem::InvLine(core_->decoder().encode(info), inv_req->line_);
-    req->tid = core->getThreadID(thread);
-    mem_->send(req);
+    StandardMem::InvLine *req = new StandardMem::InvLine(core_->decoder().encode(info), inv_req.getLine());
+    sendThreadRequest(req, thread, inv_req);
 }
@@ -5,12 +5,17 @@
 #include <DrvAPIAddress.hpp>
 #include <DrvAPIAddressMap.hpp>
 #include "DrvMemory.hpp"
+#include "DrvDMAEngine.hpp"
 #include <sst/core/component.h>
 #include <sst/core/link.h>
 #include <sst/core/interfaces/stdMem.h>
 #include <sst/core/event.h>
 #include <sst/elements/memHierarchy/memoryController.h>
 #include <atomic>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <tuple>
 #include <cmath>
 namespace SST {
 namespace Drv {
@@ -55,6 +60,23 @@ public:
                 uint64_t offset = addr & offset_mask;
                 return std::make_tuple(bank, offset);
             }
+            /**
+             * @brief Get the offset into a bank's backing store
+             *
+             * @brief addr is an offset address from the start of the bank's range
+             */
+            uint64_t getLocal(uint64_t addr) const {
+                return ((addr >> segment_shift) << bank_shift) | (addr & offset_mask);
+            }
+        };
+
+        /**
+         * the backing store of one memory controller
+         */
+        struct NativeBank {
+            DrvAPI::DrvAPIAddress start = 0; //!< first address of the controller's range
+            uint8_t *base = nullptr; //!< native pointer to the first byte of the range
+            uint64_t size = 0; //!< bytes of backing store from base
         };
         ToNativeMetaData() = default;
         ToNativeMetaData(const ToNativeMetaData&) = delete;
@@ -73,6 +95,15 @@ public:
         std::vector<std::vector<record_type>> dram_mcs; //!< drams mem controllers and their address ranges
         InterleaveDecoder l2sp_interleave_decode;
         InterleaveDecoder dram_interleave_decode;
+        int64_t pods = 0; //!< pods per pxn
+        int64_t cores = 0; //!< cores per pod
+        int64_t l2sp_banks_per_pod = 0; //!< l2sp banks per pod
+        int64_t dram_banks_per_pxn = 0; //!< dram banks per pxn
+        uint64_t l2sp_interleave = 0; //!< l2sp interleave size
+        uint64_t dram_interleave = 0; //!< dram interleave size
+        std::vector<NativeBank> l1sp_banks; //!< l1sp backing by (pxn, pod, core)
+        std::vector<NativeBank> l2sp_banks; //!< l2sp backing by (pxn, pod, bank)
+        std::vector<NativeBank> dram_banks; //!< dram backing by (pxn, bank)
         std::atomic<bool> initialized = false;        
     };
 
@@ -92,6 +123,13 @@ public:
     SST_ELI_DOCUMENT_PARAMS(
         {"memory_region_start", "start of memory mapped region", "0"},
         {"memory_region_size",  "size of memory mapped region", "4192"},
+        {"block_request_size", "maximum size of each request a block request is split into", "64"},
+        {"block_max_requests", "maximum number of requests in flight per block request", "8"},
+        {"flush_depth", "number of cache levels a range flush/invalidate goes through", "1"},
+        {"dma_bandwidth", "bytes per cycle the dma engine reads", "32"},
+        {"dma_max_requests", "maximum number of dma copies in flight", "8"},
+        {"dma_request_size", "maximum size of each request a dma copy is split into", "64"},
+        {"dma_queue_depth", "maximum number of dma descriptors queued or in flight", "16"},
     )
     // register subcomponent slots
     SST_ELI_DOCUMENT_SUBCOMPONENT_SLOTS(
@@ -122,7 +160,7 @@ public:
      */
     void sendRequest(DrvCore *core
                      ,DrvThread *thread
-                     ,const std::shared_ptr<DrvAPI::DrvAPIMem> &mem_req);
+                     ,DrvAPI::DrvAPIThreadState &mem_req);
 
     /**
      * @brief Send a request to flush and invalidate cache
@@ -131,7 +169,7 @@ public:
      * @param thread
      * @param flush_inv
      */
-    void sendFlushLine(DrvCore *core, DrvThread *thread, const std::shared_ptr<DrvAPI::DrvAPIFlushLine> &flush);
+    void sendFlushLine(DrvCore *core, DrvThread *thread, DrvAPI::DrvAPIThreadState &flush);
 
     /**
      * @brief Send a request to invalidate a cache line
@@ -140,7 +178,53 @@ public:
      * @param thread
      * @param inv_req
      */
-    void sendInvalidateLine(DrvCore *core, DrvThread *thread, const std::shared_ptr<DrvAPI::DrvAPIInvLine> &inv_req);
+    void sendInvalidateLine(DrvCore *core, DrvThread *thread, DrvAPI::DrvAPIThreadState &inv_req);
+
+    /**
+     * @brief Send requests for a range or whole-cache flush/invalidate
+     *
+     * A range is sent as one address flush per line it touches; a whole
+     * cache as one line flush per line index of each bank. Like a block
+     * request, at most block_max_requests are in flight at once.
+     *
+     * @param core
+     * @param thread
+     * @param flush
+     */
+    void sendFlushRequests(DrvCore *core, DrvThread *thread, DrvAPI::DrvAPIThreadState &flush);
+
+    /**
+     * @brief Send requests for a read/write/fill block
+     *
+     * Issues line-sized requests until block_max_requests are in flight
+     * or the whole block has been sent. Called again as responses return.
+     *
+     * @param core
+     * @param thread
+     * @param block_req
+     */
+    void sendBlockRequests(DrvCore *core, DrvThread *thread, DrvAPI::DrvAPIThreadState &block_req);
+
+    /**
+     * @brief Send requests for a gather/scatter
+     *
+     * Elements that fall in the same block_request_size line are merged
+     * into one request (for scatter, only if they are also contiguous);
+     * an element that straddles a line is split between two requests.
+     * Like a block request, at most block_max_requests are in flight at once.
+     *
+     * @param core
+     * @param thread
+     * @param gs_req
+     */
+    void sendGatherScatterRequests(DrvCore *core, DrvThread *thread, DrvAPI::DrvAPIThreadState &gs_req);
+
+    /**
+     * @brief issue a gather/scatter's requests until block_max_requests are in flight
+     *
+     * Called again as responses return.
+     */
+    void issueGatherScatterRequests(DrvCore *core, DrvThread *thread, DrvAPI::DrvAPIThreadState &gs_req);
 
     /**
      * @brief init is called at the beginning of the simulation
@@ -162,7 +246,99 @@ public:
      */
     void toNativePointer(DrvAPI::DrvAPIAddress addr, void **ptr, size_t *size);
 
+    /**
+     * @brief issue this cycle's dma requests
+     */
+    void tick() override { dma_->tick(); }
+
+    /**
+     * @brief true while dma copies are queued or in flight
+     */
+    bool busy() const override { return dma_->busy(); }
+
 private:
+    /**
+     * @brief a thread, the request state it is waiting on, and the offset into a block request
+     */
+    typedef std::tuple<DrvThread*, DrvAPI::DrvAPIThreadState*, uint64_t> outstanding_type;
+
+    /**
+     * @brief send a request on behalf of a thread and remember it by tag
+     *
+     * The tag is carried in the request's tid and comes back on the
+     * response. Tags index a slot array that only grows when every slot is
+     * in flight, so steady-state requests do not allocate here.
+     */
+    template <typename RequestType>
+    void sendThreadRequest(RequestType *req, DrvThread *thread, DrvAPI::DrvAPIThreadState &state, uint64_t offset = 0) {
+        if (free_tags_.empty()) {
+            growOutstanding();
+        }
+        uint32_t tag = free_tags_.back();
+        free_tags_.pop_back();
+        outstanding_[tag] = outstanding_type(thread, &state, offset);
+        req->tid = tag;
+        mem_->send(req);
+    }
+
+    /**
+     * @brief double the number of request tags
+     */
+    void growOutstanding();
+
+    /**
+     * @brief retire one response of a block request
+     */
+    void completeBlockResponse(DrvThread *thread, DrvAPI::DrvAPIThreadState &block_req);
+
+    /**
+     * @brief elements of a gather/scatter merged into one request
+     */
+    struct GatherScatterGroup {
+        uint64_t start; //!< first byte address of the request
+        uint64_t end;   //!< one past the last byte address of the request
+        size_t first;   //!< first element, as an index into order
+        size_t last;    //!< one past the last element, as an index into order; the first and last may lie partly outside the request
+    };
+
+    /**
+     * @brief in-flight state of a gather/scatter
+     */
+    struct GatherScatterContext {
+        std::vector<size_t> order; //!< element indices sorted by address
+        std::vector<GatherScatterGroup> groups; //!< merged requests
+        size_t issued = 0;  //!< requests issued so far
+        size_t pending = 0; //!< requests in flight
+    };
+
+    /**
+     * @brief retire one response of a gather/scatter
+     *
+     * @param data the read response data, or nullptr for a scatter
+     */
+    void completeGatherScatterResponse(DrvThread *thread, DrvAPI::DrvAPIThreadState &gs_req, uint64_t group, const uint8_t *data);
+
+    /**
+     * @brief a thread and the dma request it is blocked on
+     */
+    typedef std::pair<DrvThread*, DrvAPI::DrvAPIThreadState*> dma_blocked_type;
+
+    /**
+     * @brief queue a dma copy or wait for one to complete
+     */
+    void sendDMARequest(DrvCore *core, DrvThread *thread, DrvAPI::DrvAPIThreadState &dma_req);
+
+    /**
+     * @brief wake the threads waiting on a dma copy and admit blocked starts
+     */
+    void completeDMA(int64_t handle);
+
+    /**
+     * @brief find the thread request matching a response and free its tag
+     */
+    template <typename ResponseType>
+    outstanding_type popOutstanding(ResponseType *rsp);
+
     /**
      * @brief handleEvent is called when a message is received
      * 
@@ -186,6 +362,15 @@ private:
     void toNativePointerL1SP(DrvAPI::DrvAPIAddress addr, const DrvAPI::DrvAPIAddressInfo &decode, void **ptr, size_t *size);
 
     Interfaces::StandardMem *mem_; //!< The memory
+    uint64_t block_request_size_; //!< maximum size of each request of a block
+    uint64_t block_max_requests_; //!< maximum requests in flight per block
+    uint32_t flush_depth_; //!< cache levels a range flush/invalidate goes through
+    std::unordered_map<DrvAPI::DrvAPIThreadState*, GatherScatterContext> gather_scatter_; //!< in-flight gather/scatters
+    std::vector<outstanding_type> outstanding_; //!< in-flight requests by tag; a null thread marks a free tag
+    std::vector<uint32_t> free_tags_; //!< tags not in flight
+    std::unique_ptr<DrvDMAEngine> dma_; //!< the core's dma engine
+    std::deque<dma_blocked_type> dma_blocked_; //!< starts waiting for room in the dma queue
+    std::unordered_multimap<int64_t, dma_blocked_type> dma_waiters_; //!< waits by dma handle
 
     static ToNativeMetaData to_native_meta_data_; //!< holds data to help with toNative function
 };
@@ -10,11 +10,13 @@ using namespace Drv;
 void DrvSystem::addressToNative(DrvAPI::DrvAPIAddress address,
                                         void **native,
                                         std::size_t *size) {
-    DrvStdMemory *memory = dynamic_cast<DrvStdMemory *>(core().memory_);
-    if (memory == nullptr) {
-        throw std::runtime_error("DrvSystem::addressToNative() requires a DrvStdMemory");
+    if (std_memory_ == nullptr) {
+        std_memory_ = dynamic_cast<DrvStdMemory *>(core().memory_);
+        if (std_memory_ == nullptr) {
+            throw std::runtime_error("DrvSystem::addressToNative() requires a DrvStdMemory");
+        }
     }
-    memory->toNativePointer(address, native, size);
+    std_memory_->toNativePointer(address, native, size);
 }
 
 uint64_t DrvSystem::getCycleCount() {
@@ -8,6 +8,7 @@ namespace SST {
 namespace Drv {
 
 class DrvCore;
+class DrvStdMemory;
 class DrvSystem : public DrvAPI::DrvAPISystem
 {
 public:
@@ -29,6 +30,7 @@ public:
     virtual double getSeconds() override; 
     virtual void outputStatistics(const std::string& tagname) override;
     DrvCore &core_;
+    DrvStdMemory *std_memory_ = nullptr; //!< core's memory, resolved on first translation
 };
 
 }
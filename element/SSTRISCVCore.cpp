@@ -3,6 +3,7 @@
 
 #include "SSTRISCVCore.hpp"
 #include "SSTRISCVSimulator.hpp"
+#include "DrvBarrierEvent.hpp"
 #include <DrvAPIAddressMap.hpp>
 #include <DrvAPIInfo.hpp>
 namespace SST {
@@ -70,6 +71,20 @@ void RISCVCore::configureHarts(Params &params) {
             harts_[sp.key].sp() = sp.value;
         }
     }
+    uint64_t vlen = params.find<uint64_t>("vlen", 128);
+    if (vlen != 0 && (vlen < 64 || (vlen & (vlen - 1)) != 0)) {
+        output_.fatal(CALL_INFO, -1, "vlen must be 0 or a power of two no less than 64\n");
+    }
+    for (RISCVSimHart &hart : harts_) {
+        hart.setVLEN(vlen);
+    }
+    // enough slots for a full load queue and store buffer, or for one
+    // blocking access of each kind, and for a vector access's requests
+    completion_slots_ = std::max<uint64_t>(load_queue_depth_, 1) + std::max<uint64_t>(store_buffer_depth_, 1);
+    if (vlen != 0) {
+        completion_slots_ += vector_max_requests_;
+    }
+    completions_.resize(harts_.size() * completion_slots_);
 }
 
 void RISCVCore::configureICache(Params &params) {
@@ -79,8 +94,34 @@ void RISCVCore::configureICache(Params &params) {
     }
     uint64_t icache_instructions = params.find<uint64_t>("icache_instructions", 1024);
     uint64_t icache_associativity = params.find<uint64_t>("icache_associativity", 1);
-    auto *backing = new ICacheBacking(program.c_str());
-    icache_ = new ICache(backing, icache_instructions, icache_associativity);
+    uint64_t icache_line_instructions = params.find<uint64_t>("icache_line_instructions", 1);
+    if (!ICache::validGeometry(icache_instructions, icache_associativity, icache_line_instructions)) {
+        output_.fatal(CALL_INFO, -1, "icache_instructions must be a power of two multiple of"
+                      " icache_associativity * icache_line_instructions,"
+                      " and icache_line_instructions must be a power of two\n");
+    }
+    image_ = RISCVProgramImage::get(program);
+    icache_ = new ICache(image_->backing(), icache_instructions, icache_associativity, icache_line_instructions);
+    uint64_t decode_cache_pages = params.find<uint64_t>("decode_cache_pages", 64);
+    if (decode_cache_pages == 0) {
+        output_.fatal(CALL_INFO, -1, "decode_cache_pages must be positive\n");
+    }
+    decode_cache_ = new RISCVDecodeCache(image_.get(), &decoder_, decode_cache_pages);
+    block_dispatch_ = params.find<bool>("block_dispatch", false);
+    load_queue_depth_ = params.find<uint64_t>("load_queue_depth", 0);
+    store_buffer_depth_ = params.find<uint64_t>("store_buffer_depth", 0);
+    vector_request_size_ = params.find<uint64_t>("vector_request_size", 64);
+    if (vector_request_size_ == 0 || (vector_request_size_ & (vector_request_size_ - 1)) != 0) {
+        output_.fatal(CALL_INFO, -1, "vector_request_size must be a power of two\n");
+    }
+    vector_max_requests_ = params.find<uint64_t>("vector_max_requests", 8);
+    if (vector_max_requests_ == 0) {
+        output_.fatal(CALL_INFO, -1, "vector_max_requests must be positive\n");
+    }
+    tick_quantum_ = params.find<uint64_t>("tick_quantum", 1);
+    if (tick_quantum_ == 0) {
+        output_.fatal(CALL_INFO, -1, "tick_quantum must be positive\n");
+    }
     load_program_ = params.find<bool>("load", false);
 }
 
@@ -135,11 +176,20 @@ void RISCVCore::configureStatistics(Params &params) {
     busy_cycles_ = registerStatistic<uint64_t>("busy_cycles");
     stall_cycles_ = registerStatistic<uint64_t>("stall_cycles");
     icache_miss_ = registerStatistic<uint64_t>("icache_miss");
+    icache_hit_ = registerStatistic<uint64_t>("icache_hit");
+    icache_miss_pc_ = registerStatistic<uint64_t>("icache_miss_pc");
+    barrier_wait_cycles_ = registerStatistic<uint64_t>("barrier_wait_cycles");
 }
 
 void RISCVCore::configureLinks(Params &params) {
     loopback_ = configureSelfLink("loopback", new Event::Handler<RISCVCore>(this, &RISCVCore::handleLoopback));
     loopback_->addSendLatency(1, "ns");
+    loopback_cycles_ = getTimeConverter("1ns")->getFactor() / clocktc_->getFactor();
+    wake_cycle_.assign(harts_.size(), 0);
+    barrier_ = configureLink("barrier", new Event::Handler<RISCVCore>(this, &RISCVCore::handleBarrier));
+    barrier_start_.assign(harts_.size(), 0);
+    barrier_rd_.assign(harts_.size(), 0);
+    barrier_participants_ = harts_.size();
     reset_time_ = params.find<uint64_t>("release_reset", 0);
 }
 
@@ -148,6 +198,9 @@ RISCVCore::RISCVCore(ComponentId_t id, Params& params)
     : Component(id)
     , mem_(nullptr)
     , icache_(nullptr)
+    , decode_cache_(nullptr)
+    , block_dispatch_(false)
+    , tick_quantum_(1)
     , harts_()
     , last_hart_(0) {
     configureOuptut(params);
@@ -166,6 +219,7 @@ RISCVCore::RISCVCore(ComponentId_t id, Params& params)
 
 /* destructor */
 RISCVCore::~RISCVCore() {
+    delete decode_cache_;
     delete icache_;
     delete sim_;
 }
@@ -359,12 +413,20 @@ void RISCVCore::handleMemEvent(RISCVCore::Request *req) {
         handleMMIOWrite(write_req);
     }
 
-    if (rd_rsp || wr_rsp || custom_rsp) {
-        auto it = rsp_handlers_.find(tid);
-        if (it == rsp_handlers_.end()) {
-            output_.fatal(CALL_INFO, -1, "Received memory response for unknown hart\n");
+    if ((rd_rsp || wr_rsp || custom_rsp) && tid >= 0 && static_cast<size_t>(tid) < harts_.size()) {
+        RISCVMemCompletion *slots = &completions_[tid * completion_slots_];
+        for (size_t slot = 0; slot < completion_slots_; slot++) {
+            if (slots[slot].handler && slots[slot].id == req->getID()) {
+                RISCVMemCompletion completion = slots[slot];
+                slots[slot].handler = nullptr;
+                completion.handler(sim_, completion, req);
+                return;
+            }
         }
-        it->second(req);     
+    }
+
+    if (rd_rsp || wr_rsp || custom_rsp) {
+        output_.fatal(CALL_INFO, -1, "Received memory response for unknown request (hart %d)\n", tid);
     } else if (!write_req) {
         output_.fatal(CALL_INFO, -1, "Unknown memory request type\n");
     }
@@ -384,43 +446,168 @@ int RISCVCore::selectNextHart() {
     return NO_HART;
 }
 
+/**
+ * run the basic block at the hart's pc
+ *
+ * The block's instructions issue back to back in this tick; the hart then
+ * sleeps for the cycles they would have taken one at a time, so other
+ * harts still get the issue slots in between.
+ */
+uint64_t RISCVCore::executeBlock(int hart_id) {
+    RISCVSimHart &hart = harts_[hart_id];
+    uint64_t pc = hart.pc();
+    const RISCVBlock *block = nullptr;
+    try {
+        block = decode_cache_->block(pc);
+    } catch (std::runtime_error &e) {
+        std::stringstream ss;
+        ss << "Failed to decode instruction at pc = 0x" << std::hex << pc << ": " << e.what();
+        throw std::runtime_error(ss.str());
+    }
+    if (block->empty() || hart.pendingLoads() > 0) {
+        // blocks do not check the scoreboard
+        return 0;
+    }
+    output_.verbose(CALL_INFO, 100, 0, "Ticking hart %2d: pc = 0x%016" PRIx64 ", block of %zu instructions\n"
+                    ,hart_id
+                    ,pc
+                    ,block->size()
+                    );
+    uint64_t at = pc;
+    for (const RISCVBlockOp &op : block->ops) {
+        accessICache(at);
+        at += op.length;
+    }
+    auto &stats = thread_stats_[hart_id];
+    for (auto &mix : block->mix) {
+        stats.instruction_count[mix.first]->addDataNTimes(mix.second, 1);
+    }
+#ifdef SST_RISCV_CORE_PROFILE_INSTRUCTIONS
+    for (const RISCVBlockOp &op : block->ops) {
+        profileInstruction(hart, *op.instruction);
+        op.handler(hart, op);
+    }
+#else
+    block->execute(hart);
+#endif
+    if (block->size() > 1) {
+        putHartToSleep(hart, block->size() - 1);
+    }
+    return block->size();
+}
+
+/**
+ * the decoded instruction at pc
+ */
+RISCVInstruction *RISCVCore::fetch(uint64_t pc) {
+    try {
+        return decode_cache_->lookup(pc);
+    } catch (std::runtime_error &e) {
+        std::stringstream ss;
+        ss << "Failed to decode instruction at pc = 0x" << std::hex << pc << ": " << e.what();
+        throw std::runtime_error(ss.str());
+    }
+}
+
+/**
+ * model the icache access fetching the instruction at pc
+ */
+void RISCVCore::accessICache(uint64_t pc) {
+    if (icache_->access(pc)) {
+        icache_hit_->addData(1);
+        return;
+    }
+    icache_miss_->addData(1);
+    icache_miss_pc_->addData(pc);
+}
+
+/**
+ * execute the instruction at the hart's pc
+ */
+RISCVInstruction *RISCVCore::executeInstruction(int hart_id) {
+    uint64_t pc = harts_[hart_id].pc();
+    RISCVInstruction *i = fetch(pc);
+    if (sim_->mustWait(harts_[hart_id], *i)) {
+        // retried once one of the hart's accesses completes
+        output_.verbose(CALL_INFO, 100, 0, "Stalling hart %2d: pc = 0x%016" PRIx64 " waits on memory\n"
+                        ,hart_id
+                        ,pc
+                        );
+        harts_[hart_id].stalledScoreboard() = true;
+        return nullptr;
+    }
+    accessICache(pc);
+    output_.verbose(CALL_INFO, 100, 0, "Ticking hart %2d: pc = 0x%016" PRIx64 ", instr = 0x%08" PRIx32" (%s)\n"
+                    ,hart_id
+                    ,pc
+                    ,i->instruction()
+                    ,i->getMnemonic()
+                    );
+    profileInstruction(harts_[hart_id], *i);
+    auto &stats = thread_stats_[hart_id];
+    stats.instruction_count[i->getInstructionId()]->addData(1);
+    sim_->visit(harts_[hart_id], *i);
+    return i;
+}
+
+/**
+ * stop issuing for some cycles after a batch
+ *
+ * @return true if the clock should be unregistered
+ */
+bool RISCVCore::pauseCore(uint64_t cycles) {
+    if (cycles < loopback_cycles_) {
+        // too short to come back in time through the loopback
+        skip_ticks_ = cycles;
+        return false;
+    }
+    // the loopback latency makes up the rest of the pause; the clock is
+    // reregistered on the first cycle after the resume event arrives
+    loopback_->send(cycles - loopback_cycles_, clocktc_, new Resume());
+    paused_ = true;
+    unregister_cycle_ = getCycleCount() + cycles;
+    return true;
+}
+
 /* tick */
 bool RISCVCore::tick(Cycle_t cycle) {
+    if (skip_ticks_ > 0) {
+        skip_ticks_--;
+        return false;
+    }
+    if (short_sleepers_ > 0) {
+        wakeShortSleepers(cycle);
+    }
     int hart_id = selectNextHart();
     bool unregister = false;
-    if (hart_id != NO_HART) {
-        addBusyCycleStat(1);
-        uint64_t pc = harts_[hart_id].pc();
-        auto [hit, inst] = icache_->read(pc);
-        if (!hit) {
-            icache_miss_->addData(1);
+    uint64_t block_size = 0;
+    if (hart_id != NO_HART && block_dispatch_) {
+        block_size = executeBlock(hart_id);
+    }
+    if (block_size > 0) {
+        // one busy cycle for each instruction the block issued
+        addBusyCycleStat(block_size);
+    } else if (hart_id != NO_HART) {
+        // run on while the hart's next instruction touches only its registers;
+        // each of them takes the cycle it would have had on its own
+        uint64_t executed = 0;
+        while (executeInstruction(hart_id)) {
+            executed++;
+            if (executed == tick_quantum_
+                || !harts_[hart_id].ready()
+                || !RISCVSimulator::isRegisterOnly(*fetch(harts_[hart_id].pc()))) {
+                break;
+            }
         }
-        RISCVInstruction *i = nullptr;
-        try {
-            i = decoder_.decode(inst);
-        } catch (std::runtime_error &e) {
-            std::stringstream ss;
-            ss << "Failed to decode instruction at pc = 0x" << std::hex << pc << ": " << e.what();
-            throw std::runtime_error(ss.str());
+        if (executed > 0) {
+            addBusyCycleStat(executed);
+        }
+        if (executed > 1) {
+            unregister = pauseCore(executed - 1);
         }
-        // std::stringstream ss;
-        // // std::cout << inst << std::endl;
-        // std::string str(i->getMnemonic());
-        // ss << str << " ";
-        // std::cout << ss.str() << std::endl;
-        output_.verbose(CALL_INFO, 100, 0, "Ticking hart %2d: pc = 0x%016" PRIx64 ", instr = 0x%08" PRIx32" (%s)\n"
-                        ,hart_id
-                        ,pc
-                        ,inst
-                        ,i->getMnemonic()
-                        );
-        profileInstruction(harts_[hart_id], *i);
-        auto &stats = thread_stats_[hart_id];
-        stats.instruction_count[i->getInstructionId()]->addData(1);
-        sim_->visit(harts_[hart_id], *i);
-        delete i;
     } else {
-        unregister = shouldUnregisterClock();
+        // harts in a short sleep are woken by the clock, so keep it on
+        unregister = short_sleepers_ == 0 && shouldUnregisterClock();
         if (unregister) {
             output_.verbose(CALL_INFO, 0, DEBUG_IDLE, "Unregistering clock\n");
             unregister_cycle_ = getCycleCount();
@@ -437,25 +624,53 @@ bool RISCVCore::tick(Cycle_t cycle) {
 }
 
 /**
- * issue a memory request
+ * issue a memory request completed through one of the hart's completion slots
  */
-void RISCVCore::issueMemoryRequest(Request *req, int tid, ICompletionHandler &handler) {
+void RISCVCore::issueMemoryRequest(Request *req, int tid, const RISCVMemCompletion &completion) {
     output_.verbose(CALL_INFO, 0, DEBUG_REQ, "Issuing memory request\n");
-    // TODO: check if tid is valid
-    // std::cout << "issueMemoryRequest" << std::endl;
-    rsp_handlers_[tid] = handler;
-    mem_->send(req);
-    // std::cout << req << std::endl;
+    if (tid < 0 || static_cast<size_t>(tid) >= harts_.size()) {
+        output_.fatal(CALL_INFO, -1, "Memory request from invalid hart %d\n", tid);
+    }
+    RISCVMemCompletion *slots = &completions_[tid * completion_slots_];
+    for (size_t slot = 0; slot < completion_slots_; slot++) {
+        if (!slots[slot].handler) {
+            slots[slot] = completion;
+            slots[slot].id = req->getID();
+            mem_->send(req);
+            return;
+        }
+    }
+    output_.fatal(CALL_INFO, -1, "hart %d has no free completion slot\n", tid);
 }
 
 /**
  * put a hart to sleep
  */
 void RISCVCore::putHartToSleep(RISCVSimHart &hart, uint64_t sleep_cycles) {
+    hart.stalledSleep() = true;
+    if (sleep_cycles < loopback_cycles_) {
+        // too short to come back in time through the loopback
+        wake_cycle_[getHartId(hart)] = getCycleCount() + sleep_cycles + 1;
+        short_sleepers_++;
+        return;
+    }
+    // the loopback latency makes up the rest of the sleep
     auto *wake = new Wake();
     wake->hart() = getHartId(hart);
-    loopback_->send(sleep_cycles, clocktc_, wake);
-    hart.stalledSleep() = true;
+    loopback_->send(sleep_cycles - loopback_cycles_, clocktc_, wake);
+}
+
+/**
+ * wake harts whose sleep was too short for the loopback
+ */
+void RISCVCore::wakeShortSleepers(Cycle_t cycle) {
+    for (size_t h = 0; h < harts_.size(); h++) {
+        if (wake_cycle_[h] != 0 && wake_cycle_[h] <= cycle) {
+            wake_cycle_[h] = 0;
+            harts_[h].stalledSleep() = false;
+            short_sleepers_--;
+        }
+    }
 }
 
 /**
@@ -477,9 +692,88 @@ void RISCVCore::handleLoopback(Event *evt) {
         harts_[wake->hart_].stalledSleep() = false;
         assertCoreOn();
     }
+    Resume *resume = dynamic_cast<Resume*>(evt);
+    if (resume) {
+        output_.verbose(CALL_INFO, 1, 0, "Received resume event\n");
+        paused_ = false;
+        assertCoreOn();
+    }
+    delete evt;
+}
+
+/**
+ * handle a release from the barrier network
+ */
+void RISCVCore::handleBarrier(Event *evt) {
+    DrvBarrierEvent *release = dynamic_cast<DrvBarrierEvent*>(evt);
+    if (!release || release->type != DrvBarrierEvent::RELEASE) {
+        output_.fatal(CALL_INFO, -1, "barrier event is not a release\n");
+    }
+    barrierRelease(release->value);
+    assertCoreOn();
     delete evt;
 }
 
+/**
+ * a hart has arrived at the barrier
+ */
+void RISCVCore::barrierArrive(RISCVSimHart &hart, int64_t value, int rd) {
+    int id = getHartId(hart);
+    hart.stalledBarrier() = true;
+    barrier_start_[id] = getCycleCount();
+    barrier_rd_[id] = rd;
+    barrier_sum_ += value;
+    barrier_arrived_++;
+    barrierTryComplete();
+}
+
+/**
+ * a hart has exited and no longer takes part in barriers
+ */
+void RISCVCore::barrierDepart() {
+    if (--barrier_participants_ == 0) {
+        if (barrier_) {
+            barrier_->send(new DrvBarrierEvent(DrvBarrierEvent::DEPART, 0));
+        }
+        return;
+    }
+    barrierTryComplete();
 }
+
+/**
+ * send the summed values up once every remaining hart has arrived
+ */
+void RISCVCore::barrierTryComplete() {
+    if (barrier_arrived_ == 0 || barrier_arrived_ < barrier_participants_) {
+        return;
+    }
+    // every remaining hart on this core has arrived
+    int64_t sum = barrier_sum_;
+    barrier_arrived_ = 0;
+    barrier_sum_ = 0;
+    if (barrier_) {
+        barrier_->send(new DrvBarrierEvent(DrvBarrierEvent::ARRIVE, sum));
+    } else {
+        barrierRelease(sum);
+    }
+}
+
+/**
+ * release every hart waiting at the barrier
+ */
+void RISCVCore::barrierRelease(int64_t total) {
+    Cycle_t now = getCycleCount();
+    for (auto &hart : harts_) {
+        if (!hart.stalledBarrier()) {
+            continue;
+        }
+        int id = getHartId(hart);
+        hart.x(barrier_rd_[id]) = total;
+        hart.pc() += 4;
+        hart.stalledBarrier() = false;
+        barrier_wait_cycles_->addData(now - barrier_start_[id]);
+    }
 }
 
+}
+}
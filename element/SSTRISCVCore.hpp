@@ -4,6 +4,7 @@
 #pragma once
 #include <sstream>
 #include <map>
+#include <memory>
 #include <string>
 #include <sst/core/component.h>
 #include <sst/core/interfaces/stdMem.h>
@@ -12,7 +13,9 @@
 #include <RISCVDecoder.hpp>
 #include <RISCVInterpreter.hpp>
 #include <ICacheBacking.hpp>
+#include <RISCVProgramImage.hpp>
 #include <ICache.hpp>
+#include <RISCVDecodeCache.hpp>
 #include "SSTRISCVSimulator.hpp"
 #include "SSTRISCVHart.hpp"
 #include "DrvSysConfig.hpp"
@@ -25,7 +28,6 @@ namespace Drv {
 class RISCVCore : public SST::Component {
 public:
     typedef Interfaces::StandardMem::Request Request;
-    typedef std::function<void(Request *)> ICompletionHandler;
     
     // REGISTER THIS COMPONENT INTO THE ELEMENT LIBRARY
     SST_ELI_REGISTER_COMPONENT(
@@ -65,11 +67,21 @@ public:
         {"test_name", "Optional name of the test", ""},
         {"icache_instructions",  "Number of icache instructions", "1024"},
         {"icache_associativity", "Associativity of the icache", "1"},
+        {"icache_line_instructions", "Instructions per icache line; a miss fills the whole line", "1"},
+        {"decode_cache_pages", "Number of 4KiB text pages of decoded instructions held at once", "64"},
+        {"block_dispatch", "Run straight-line integer code a basic block per tick", "0"},
+        {"load_queue_depth", "Loads each hart may have outstanding before it stalls; 0 makes loads blocking", "0"},
+        {"store_buffer_depth", "Stores each hart may have posted before it stalls; 0 makes stores blocking", "0"},
+        {"tick_quantum", "Most instructions a hart runs per tick; instructions after the first must not touch memory. Exact for one hart; with more, the other harts wait out the batch", "1"},
+        {"vlen", "Bits per vector register; 0 leaves the harts without a vector unit", "128"},
+        {"vector_request_size", "Largest memory request a vector load or store is split into, in bytes; requests do not cross a multiple of it", "64"},
+        {"vector_max_requests", "Requests a vector load or store may have outstanding at once", "8"},
     )
 
     // Document the ports that this component accepts
     SST_ELI_DOCUMENT_PORTS(
        {"loopback", "A loopback link", {"Drv.DrvEvent", ""}},
+       {"barrier", "Link to the barrier network; optional", {"Drv.DrvBarrierEvent", ""}},
     )
     
     // DOCUMENT SUBCOMPONENTS
@@ -117,6 +129,9 @@ public:
             {"stall_cycles", "Number of stalled cycles", "count", 1},
             {"busy_cycles", "Number of busy cycles", "count", 1},
             {"icache_miss", "Number of icache misses", "count", 1},
+            {"icache_hit", "Number of icache hits", "count", 1},
+            {"icache_miss_pc", "PC of each icache miss; enable as an sst.HistogramStatistic to count misses by pc", "address", 1},
+            {"barrier_wait_cycles", "Number of cycles harts spent waiting at a barrier", "count", 1},
         };
 
 #undef DEFINSTR
@@ -183,6 +198,18 @@ public:
         ImplementSerializable(SST::Drv::RISCVCore::Wake);
     };
 
+    /**
+     * resume issuing after a batch
+     */
+    class Resume : public SST::Event {
+    public:
+        Resume() : SST::Event() {}
+        void serialize_order(SST::Core::Serialization::serializer &ser) override {
+            Event::serialize_order(ser);
+        }
+        ImplementSerializable(SST::Drv::RISCVCore::Resume);
+    };
+
     /**
      * Constructor for RISCVCore
      */
@@ -297,6 +324,97 @@ public:
      */
     void handleLoopback(Event *evt);
 
+    /**
+     * handle a release from the barrier network
+     */
+    void handleBarrier(Event *evt);
+
+    /**
+     * a hart has arrived at the barrier adding value
+     *
+     * the hart stalls until the barrier releases, when rd is set
+     * to the sum over all harts and the hart moves past the csrrw
+     */
+    void barrierArrive(RISCVSimHart &hart, int64_t value, int rd);
+
+    /**
+     * a hart has exited and no longer takes part in barriers
+     *
+     * once every hart has exited the core departs the barrier network
+     */
+    void barrierDepart();
+
+    /**
+     * send the summed values up once every remaining hart has arrived
+     */
+    void barrierTryComplete();
+
+    /**
+     * release every hart waiting at the barrier with the total
+     */
+    void barrierRelease(int64_t total);
+
+    /**
+     * the decoded instruction at pc
+     */
+    RISCVInstruction *fetch(uint64_t pc);
+
+    /**
+     * model the icache access fetching the instruction at pc
+     */
+    void accessICache(uint64_t pc);
+
+    /**
+     * execute the instruction at the hart's pc
+     *
+     * @return the instruction, or nullptr if it must wait for outstanding memory accesses
+     */
+    RISCVInstruction *executeInstruction(int hart_id);
+
+    /**
+     * stop issuing for some cycles after a batch
+     *
+     * @return true if the clock should be unregistered
+     */
+    bool pauseCore(uint64_t cycles);
+
+    /**
+     * run the basic block at the hart's pc
+     *
+     * @return instructions run; 0 if the block is empty and the instruction at pc must be simulated
+     */
+    uint64_t executeBlock(int hart_id);
+
+    /**
+     * loads a hart may have outstanding; 0 if loads block
+     */
+    uint64_t loadQueueDepth() const { return load_queue_depth_; }
+
+    /**
+     * stores a hart may have posted; 0 if stores block
+     */
+    uint64_t storeBufferDepth() const { return store_buffer_depth_; }
+
+    /**
+     * largest request a vector load or store is split into
+     */
+    uint64_t vectorRequestSize() const { return vector_request_size_; }
+
+    /**
+     * requests a vector load or store may have outstanding
+     */
+    uint64_t vectorMaxRequests() const { return vector_max_requests_; }
+
+    /**
+     * requests a hart may have outstanding
+     */
+    size_t completionSlots() const { return completion_slots_; }
+
+    /**
+     * forget all decoded instructions (fence.i)
+     */
+    void invalidateDecodeCache() { decode_cache_->invalidate(); }
+
     /**
      * get the number of harts on this core
      */
@@ -326,14 +444,19 @@ public:
     int selectNextHart();
 
     /**
-     * issue a memory request
+     * issue a memory request completed through one of the hart's completion slots
      */
-    void issueMemoryRequest(Request *req, int tid, ICompletionHandler &handler);
+    void issueMemoryRequest(Request *req, int tid, const RISCVMemCompletion &completion);
 
     /**
      * put a hart to sleep */
     void putHartToSleep(RISCVSimHart &hart, uint64_t sleep_cycles);
 
+    /**
+     * wake harts whose sleep was too short for the loopback
+     */
+    void wakeShortSleepers(Cycle_t cycle);
+
     /**
      * return true if we should exit
      */
@@ -487,8 +610,8 @@ public:
      * turn the core on if it's off
      */
     void assertCoreOn() {
-        if (!core_on_) {
-            core_on_;
+        if (!core_on_ && !paused_) {
+            core_on_ = true;
             Cycle_t reregister_cycle = getCycleCount();
             addStallCycleStat(reregister_cycle - unregister_cycle_);
             reregisterClock(clocktc_, clock_handler_);
@@ -506,10 +629,24 @@ public:
     Interfaces::StandardMem *mem_; //!< memory interface
     RISCVSimulator *sim_; //!< simulator
     ICache *icache_; //!< icache
+    std::shared_ptr<RISCVProgramImage> image_; //!< the program, shared with other cores running it
     RISCVDecoder decoder_; //!< decoder
+    RISCVDecodeCache *decode_cache_; //!< decoded instructions by pc
+    bool block_dispatch_; //!< run basic blocks rather than single instructions
+    uint64_t tick_quantum_; //!< most instructions a hart runs per tick
+    uint64_t load_queue_depth_ = 0; //!< loads a hart may have outstanding
+    uint64_t store_buffer_depth_ = 0; //!< stores a hart may have posted
+    uint64_t vector_request_size_ = 64; //!< largest request of a vector load or store
+    uint64_t vector_max_requests_ = 8; //!< outstanding requests per vector load or store
+    uint64_t loopback_cycles_ = 0; //!< whole cycles of loopback latency
+    uint64_t skip_ticks_ = 0; //!< ticks left in a pause too short for the loopback
+    std::vector<Cycle_t> wake_cycle_; //!< cycle a hart wakes from a sleep too short for the loopback; 0 if none
+    int short_sleepers_ = 0; //!< harts sleeping until their wake_cycle_
+    bool paused_ = false; //!< clock is off until a batch's cycles have passed
     DrvAPI::DrvAPIAddressDecoder address_decoder_; //!< address decoder
     std::vector<RISCVSimHart> harts_; //!< harts
-    std::map<int, ICompletionHandler> rsp_handlers_; //!< response handlers
+    std::vector<RISCVMemCompletion> completions_; //!< completion slots for every memory request; completion_slots_ per hart
+    size_t completion_slots_ = 1; //!< completion slots per hart
     Clock::Handler<RISCVCore> *clock_handler_ = nullptr; //!< clock handler
     SST::TimeConverter *clocktc_; //!< the clock time converter
     int last_hart_; //!< last hart to execute
@@ -525,9 +662,18 @@ public:
     Statistic<uint64_t> *busy_cycles_; //!< cycle count
     Statistic<uint64_t> *stall_cycles_; //!< stall cycle count
     Statistic<uint64_t> *icache_miss_; //!< icache miss count
+    Statistic<uint64_t> *icache_hit_; //!< icache hit count
+    Statistic<uint64_t> *icache_miss_pc_; //!< pc of each icache miss
     DrvAPI::DrvAPIAddress mmio_start_; //!< mmio start address
     DrvAPI::DrvAPIAddress mmio_end_; //!< mmio end address
     SST::Link *loopback_; //!< loopback link
+    SST::Link *barrier_ = nullptr; //!< link to the barrier network, null if not connected
+    int barrier_arrived_ = 0; //!< harts waiting at the barrier
+    int barrier_participants_ = 0; //!< harts that have not exited
+    int64_t barrier_sum_ = 0; //!< sum of the values of harts waiting at the barrier
+    std::vector<Cycle_t> barrier_start_; //!< cycle each hart arrived at the barrier
+    std::vector<int> barrier_rd_; //!< destination register of each hart waiting at the barrier
+    Statistic<uint64_t> *barrier_wait_cycles_; //!< cycles harts spent waiting at a barrier
     bool core_on_ = true; //!< core on
     Cycle_t unregister_cycle_; //!< cycle clock was unregistered
 };
@@ -2,6 +2,8 @@
 // Copyright (c) 2023 University of Washington
 
 #include <RISCVHart.hpp>
+#include <vector>
+#include <functional>
 namespace SST {
 namespace Drv {
 
@@ -13,7 +15,9 @@ public:
     /**
      * @brief ready
      */
-    bool ready() { return !reset() && !stalledMemory() && !stalledSleep(); }
+    bool ready() {
+        return !reset() && !stalledMemory() && !stalledSleep() && !stalledBarrier() && !stalledScoreboard();
+    }
 
     /**
      * @brief reset
@@ -35,6 +39,7 @@ public:
                 _hart.pc() = _hart.resetPC();
                 _hart.exitCode() = 0;
                 _hart.stalledMemory() = false;
+                _hart.stalledScoreboard() = false;
             }
             return *this;
         }
@@ -66,6 +71,124 @@ public:
     bool & stalledSleep() { return _stalled_sleep; }
     bool   stalledSleep() const { return _stalled_sleep; }
 
+    /**
+     * @brief stalledBarrier
+     */
+    bool & stalledBarrier() { return _stalled_barrier; }
+    bool   stalledBarrier() const { return _stalled_barrier; }
+
+    /**
+     * @brief stalledScoreboard
+     *
+     * the next instruction waits on an outstanding load or store
+     */
+    bool & stalledScoreboard() { return _stalled_scoreboard; }
+    bool   stalledScoreboard() const { return _stalled_scoreboard; }
+
+    /**
+     * @brief a load or store that has been issued but not completed
+     */
+    struct Access {
+        uint64_t addr;
+        uint64_t size;
+        bool store;
+    };
+
+    /**
+     * @brief number of outstanding loads
+     */
+    size_t pendingLoads() const { return _in_flight.size() - _pending_stores; }
+
+    /**
+     * @brief number of outstanding stores
+     */
+    size_t pendingStores() const { return _pending_stores; }
+
+    /**
+     * @brief record an outstanding access
+     */
+    void issueAccess(uint64_t addr, uint64_t size, bool store) {
+        _in_flight.push_back(Access{addr, size, store});
+        _pending_stores += store;
+    }
+
+    /**
+     * @brief retire an outstanding access
+     */
+    void retireAccess(uint64_t addr, uint64_t size, bool store) {
+        for (auto it = _in_flight.begin(); it != _in_flight.end(); ++it) {
+            if (it->addr == addr && it->size == size && it->store == store) {
+                _in_flight.erase(it);
+                _pending_stores -= store;
+                break;
+            }
+        }
+        _stalled_scoreboard = false;
+    }
+
+    /**
+     * @brief true if an access must wait for an outstanding one to the same bytes
+     *
+     * loads wait for stores; stores wait for loads and stores
+     */
+    bool accessConflicts(uint64_t addr, uint64_t size, bool store) const {
+        for (const Access &a : _in_flight) {
+            if ((store || a.store) && addr < a.addr + a.size && a.addr < addr + size) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief a vector load or store split into requests
+     *
+     * Each chunk is a run of elements contiguous both in memory and in
+     * the register file that fits in one request.
+     */
+    struct VectorAccess {
+        struct Chunk {
+            uint64_t addr;      //!< address, before translation to absolute
+            uint64_t size;      //!< bytes
+            uint64_t offset;    //!< offset into the vector registers
+            bool noncacheable;  //!< the address is not dram
+        };
+        std::vector<Chunk> chunks; //!< requests in issue order
+        size_t issued = 0;         //!< chunks issued so far
+        size_t completed = 0;      //!< chunks whose response has arrived
+        bool store = false;        //!< a store rather than a load
+        uint32_t length = 4;       //!< bytes of the instruction; pc steps past it when every chunk completes
+    };
+
+    /**
+     * @brief the hart's vector load or store in progress
+     */
+    VectorAccess & vectorAccess() { return _vector_access; }
+
+    /**
+     * @brief a system call's buffer copied to or from memory line by line
+     */
+    struct SysAccess {
+        std::vector<uint8_t> data;  //!< bytes to write, or the bytes read so far
+        uint64_t addr = 0;          //!< absolute address of the buffer
+        size_t issued = 0;          //!< bytes requested so far
+        size_t outstanding = 0;     //!< requests awaiting their response
+        bool write = false;         //!< a write rather than a read
+        bool noncacheable = false;  //!< the buffer is not in dram
+        std::function<void(std::vector<uint8_t>&)> done; //!< called with the buffer when every request completes
+    };
+
+    /**
+     * @brief the hart's system call buffer transfer in progress
+     */
+    SysAccess & sysAccess() { return _sys_access; }
+
+    /**
+     * @brief waitAddr
+     */
+    uint64_t & waitAddr() { return _wait_addr; }
+    uint64_t   waitAddr() const { return _wait_addr; }
+
     /**
      * @brief spLow
      */
@@ -116,10 +239,17 @@ public:
     bool _f_scoreboard [32] = {false};
     bool _stalled_sleep = false;
     bool _stalled_memory = false;
+    bool _stalled_barrier = false;
+    bool _stalled_scoreboard = false;
+    std::vector<Access> _in_flight; //!< outstanding loads and stores in issue order
+    size_t _pending_stores = 0;
     bool _reset = false;
     int  _exit = false;
     int64_t _exit_code = 0;
     uint64_t _reset_pc = 0;
+    uint64_t _wait_addr = 0; //!< address set with CSR_WAITADDR
+    VectorAccess _vector_access; //!< vector load or store in progress
+    SysAccess _sys_access; //!< system call buffer transfer in progress
     // sp boundaries
     uint64_t sp_low_ = 0x0;
     uint64_t sp_high_ = 0x10;
@@ -6,6 +6,7 @@
 #include <unistd.h>
 #include <fcntl.h>
 
+#include <cstring>
 #include <sstream>
 #include <type_traits>
 #include "SSTRISCVSimulator.hpp"
@@ -20,11 +21,58 @@ namespace Drv {
 using namespace SST::Interfaces;
 
 void RISCVSimulator::visit(RISCVHart &hart, RISCVInstruction &instruction) {
-    RISCVSimHart &shart = static_cast<RISCVSimHart &>(hart);
-    // check the scoreboard
     RISCVInterpreter::visit(hart, instruction);
 }
 
+bool RISCVSimulator::mustWait(RISCVSimHart &hart, RISCVInstruction &i) {
+    if (hart.pendingLoads() == 0 && hart.pendingStores() == 0) {
+        return false;
+    }
+    // check the scoreboard
+    if ((i.uses_rs1() && hart.xScoreboard(i.rs1()))
+        || (i.uses_rs2() && hart.xScoreboard(i.rs2()))
+        || (i.uses_rs3() && hart.xScoreboard(i.rs3()))
+        || (i.uses_rd() && hart.xScoreboard(i.rd()))
+        || (i.uses_frs1() && hart.fScoreboard(i.rs1()))
+        || (i.uses_frs2() && hart.fScoreboard(i.rs2()))
+        || (i.uses_frs3() && hart.fScoreboard(i.rs3()))
+        || (i.uses_frd() && hart.fScoreboard(i.rd()))) {
+        return true;
+    }
+    if (isVectorMemory(i)) {
+        return true;
+    }
+    // funct3 holds log2 of the access size for loads and stores
+    uint64_t size = 1ull << ((i.instruction() >> 12) & 0x3);
+    switch (i.instruction() & 0x7f) {
+    case 0x03: // load
+    case 0x07: { // load-fp
+        uint64_t addr = core_->address_decoder_.to_absolute(hart.x(i.rs1()) + i.SIimm());
+        uint64_t depth = core_->loadQueueDepth();
+        return (depth > 0 && hart.pendingLoads() >= depth)
+            || hart.accessConflicts(addr, size, false);
+    }
+    case 0x23: // store
+    case 0x27: { // store-fp
+        uint64_t addr = hart.x(i.rs1()) + i.Simm();
+        if (isMMIO(addr)) {
+            return false;
+        }
+        addr = core_->address_decoder_.to_absolute(addr);
+        uint64_t depth = core_->storeBufferDepth();
+        return (depth > 0 && hart.pendingStores() >= depth)
+            || hart.accessConflicts(addr, size, true);
+    }
+    case 0x0f: // misc-mem
+    case 0x2b: // amocas, amofadd
+    case 0x2f: // amo
+    case 0x73: // system
+        return true;
+    default:
+        return false;
+    }
+}
+
 bool RISCVSimulator::isMMIO(SST::Interfaces::StandardMem::Addr addr) {
     return (addr >= MMIO_BASE) && (addr < MMIO_BASE + MMIO_SIZE);
 }
@@ -77,7 +125,7 @@ void RISCVSimulator::visitStoreMMIO(RISCVHart &hart, RISCVInstruction &i) {
     default:
         core_->output_.fatal(CALL_INFO, -1, "Unknown MMIO address: 0x%lx\n", addr);
     }
-    shart.pc() += 4;
+    shart.pc() += i.length();
 }
 
 template <typename R, typename T>
@@ -101,29 +149,28 @@ void RISCVSimulator::visitLoad(RISCVHart &hart, RISCVInstruction &i) {
    if (noncacheable) rd->setNoncacheable();
 
    rd->tid = core_->getHartId(shart);
-   shart.stalledMemory() = true;
    auto ird = i.rd();
-
-   RISCVCore::ICompletionHandler ch([this, &shart, addr, ird](StandardMem::Request *req) {
-       // handle the read response
-       auto*rsp = static_cast<StandardMem::ReadResp *>(req);
-       T *ptr = (T*)&rsp->data[0];
-       core_->output_.verbose(CALL_INFO, 0, RISCVCore::DEBUG_MEMORY
-                               ,"PC=%08" PRIx64 ": LOAD COMPLETE: 0x%016" PRIx64 " = 0x%016" PRIx64 "\n"
-                               ,static_cast<uint64_t>(shart.pc())
-                               ,addr
-                               ,static_cast<uint64_t>(*ptr));
+   // with a load queue the hart runs on until it needs ird
+   bool blocking = core_->loadQueueDepth() == 0;
+   if (blocking) {
+       shart.stalledMemory() = true;
+   } else {
        if (FLOAT_REGISTERS) {
-           shart.f(ird) = static_cast<R>(*ptr);
-       } else {
-           shart.x(ird) = static_cast<R>(*ptr);
-//           core_->output_.verbose(CALL_INFO, 0, RISCVCore::DEBUG_RSP, "Req completion - PC=%08" PRIx64 "0x%016" PRIx64 "\n", static_cast<uint64_t>(shart.pc()), static_cast<uint64_t>(*ptr));
-//           std::cout << std::hex << "Req completion - pc: " << static_cast<uint64_t>(shart.pc()) << " val: " << static_cast<uint64_t>(*ptr) << std::dec << std::endl;
+           shart.fScoreboard(ird) = true;
+       } else if (ird != 0) {
+           shart.xScoreboard(ird) = true;
        }
-       shart.pc() += 4;
-       shart.stalledMemory() = false;
-       delete req;
-   });
+       shart.issueAccess(addr, sizeof(T), false);
+       shart.pc() += i.length();
+   }
+
+   RISCVMemCompletion ch;
+   ch.handler = &RISCVSimulator::completeLoad<R, T>;
+   ch.hart = &shart;
+   ch.addr = addr;
+   ch.reg = ird;
+   ch.blocking = blocking;
+   ch.length = i.length();
    core_->output_.verbose(CALL_INFO, 0, RISCVCore::DEBUG_MEMORY
                            ,"PC=%08" PRIx64 ": LOAD ISSUED:   0x%016" PRIx64 "\n"
                            ,static_cast<uint64_t>(shart.pc())
@@ -132,6 +179,37 @@ void RISCVSimulator::visitLoad(RISCVHart &hart, RISCVInstruction &i) {
    core_->issueMemoryRequest(rd, rd->tid, ch);
 }
 
+template <typename R, typename T>
+void RISCVSimulator::completeLoad(RISCVSimulator *sim, const RISCVMemCompletion &c, StandardMem::Request *req) {
+    static constexpr bool FLOAT_REGISTERS = std::is_floating_point<T>::value;
+    RISCVSimHart &shart = *c.hart;
+    // handle the read response
+    auto*rsp = static_cast<StandardMem::ReadResp *>(req);
+    T *ptr = (T*)&rsp->data[0];
+    sim->core_->output_.verbose(CALL_INFO, 0, RISCVCore::DEBUG_MEMORY
+                                ,"PC=%08" PRIx64 ": LOAD COMPLETE: 0x%016" PRIx64 " = 0x%016" PRIx64 "\n"
+                                ,static_cast<uint64_t>(shart.pc())
+                                ,c.addr
+                                ,static_cast<uint64_t>(*ptr));
+    if (FLOAT_REGISTERS) {
+        shart.f(c.reg) = static_cast<R>(*ptr);
+    } else {
+        shart.x(c.reg) = static_cast<R>(*ptr);
+    }
+    if (c.blocking) {
+        shart.pc() += c.length;
+        shart.stalledMemory() = false;
+    } else {
+        if (FLOAT_REGISTERS) {
+            shart.fScoreboard(c.reg) = false;
+        } else {
+            shart.xScoreboard(c.reg) = false;
+        }
+        shart.retireAccess(c.addr, sizeof(T), false);
+    }
+    delete req;
+}
+
 template <typename T>
 void RISCVSimulator::visitStore(RISCVHart &hart, RISCVInstruction &i) {
     static constexpr bool FLOAT_REGISTERS = std::is_floating_point<T>::value;
@@ -159,33 +237,55 @@ void RISCVSimulator::visitStore(RISCVHart &hart, RISCVInstruction &i) {
 
     // create the write request
     addr = core_->address_decoder_.to_absolute(addr);
-    std::vector<uint8_t> data(sizeof(T));
-    T *ptr = (T*)&data[0];
-    *ptr = FLOAT_REGISTERS
+    T value = FLOAT_REGISTERS
         ? static_cast<T>(hart.f(i.rs2()))
         : static_cast<T>(hart.x(i.rs2()));
-    StandardMem::Write *wr = new StandardMem::Write(addr, sizeof(T), data);
+    // fill the request's payload in place rather than copying one in
+    std::vector<uint8_t> no_data;
+    StandardMem::Write *wr = new StandardMem::Write(addr, sizeof(T), no_data);
+    wr->data.resize(sizeof(T));
+    memcpy(&wr->data[0], &value, sizeof(T));
 
     // determine if the address is cacheable
     bool noncacheable = !decode.is_dram();
     if (noncacheable) wr->setNoncacheable();
 
     wr->tid = core_->getHartId(shart);    
-    shart.stalledMemory() = true; // stores are blocking
-    RISCVCore::ICompletionHandler ch([&shart](StandardMem::Request *req) {
-        // handle the write response
-        shart.pc() += 4;
-        shart.stalledMemory() = false;
-        delete req;
-    });
+    // with a store buffer the store is posted and the hart runs on
+    bool blocking = core_->storeBufferDepth() == 0;
+    if (blocking) {
+        shart.stalledMemory() = true;
+    } else {
+        shart.issueAccess(addr, sizeof(T), true);
+        shart.pc() += i.length();
+    }
+    RISCVMemCompletion ch;
+    ch.handler = &RISCVSimulator::completeStore<T>;
+    ch.hart = &shart;
+    ch.addr = addr;
+    ch.blocking = blocking;
+    ch.length = i.length();
     core_->output_.verbose(CALL_INFO, 0, RISCVCore::DEBUG_MEMORY
                            ,"PC=%08" PRIx64 ": STORE: 0x%016" PRIx64 " = %" PRIx64 "\n"
                            ,static_cast<uint64_t>(shart.pc())
                            ,static_cast<uint64_t>(addr)
-                           ,static_cast<uint64_t>(*ptr));
+                           ,static_cast<uint64_t>(value));
     core_->issueMemoryRequest(wr, wr->tid, ch);
 }
 
+template <typename T>
+void RISCVSimulator::completeStore(RISCVSimulator *sim, const RISCVMemCompletion &c, StandardMem::Request *req) {
+    RISCVSimHart &shart = *c.hart;
+    // handle the write response
+    if (c.blocking) {
+        shart.pc() += c.length;
+        shart.stalledMemory() = false;
+    } else {
+        shart.retireAccess(c.addr, sizeof(T), true);
+    }
+    delete req;
+}
+
 template <typename T>
 void RISCVSimulator::visitAMO(RISCVHart &hart, RISCVInstruction &i, DrvAPI::DrvAPIMemAtomicType op) {
     RISCVSimHart &shart = static_cast<RISCVSimHart &>(hart);
@@ -212,20 +312,13 @@ void RISCVSimulator::visitAMO(RISCVHart &hart, RISCVInstruction &i, DrvAPI::DrvA
     req->tid = core_->getHartId(shart);
     shart.stalledMemory() = true;
     int ird = i.rd();
-    RISCVCore::ICompletionHandler ch([&shart, ird, this, addr](StandardMem::Request *req) {
-        // handle the atomic response
-        auto *rsp = static_cast<StandardMem::CustomResp *>(req);
-        auto *data = static_cast<AtomicReqData*>(rsp->data);
-       core_->output_.verbose(CALL_INFO, 0, RISCVCore::DEBUG_MEMORY
-                              ,"PC=%08" PRIx64 ": ATOMIC COMPLETE: 0x%016" PRIx64 " = 0x%016" PRIx64 "\n"
-                              ,static_cast<uint64_t>(shart.pc())
-                              ,addr
-                              ,static_cast<uint64_t>(*(T*)&data->rdata[0]));
-        shart.x(ird) = *(T*)&data->rdata[0];
-        shart.pc() += 4;
-        shart.stalledMemory() = false;
-        delete req;
-    });
+    RISCVMemCompletion ch;
+    ch.handler = &RISCVSimulator::completeAMO<T>;
+    ch.hart = &shart;
+    ch.addr = addr;
+    ch.reg = ird;
+    ch.blocking = true;
+    ch.length = i.length();
     core_->output_.verbose(CALL_INFO, 0, RISCVCore::DEBUG_MEMORY
                            ,"PC=%08" PRIx64 ": ATOMIC ISSUED:     0x%016" PRIx64 " = %" PRIx64 "\n"
                            ,static_cast<uint64_t>(shart.pc())
@@ -234,6 +327,23 @@ void RISCVSimulator::visitAMO(RISCVHart &hart, RISCVInstruction &i, DrvAPI::DrvA
     core_->issueMemoryRequest(req, req->tid, ch);
 }
 
+template <typename T>
+void RISCVSimulator::completeAMO(RISCVSimulator *sim, const RISCVMemCompletion &c, StandardMem::Request *req) {
+    RISCVSimHart &shart = *c.hart;
+    // handle the atomic response
+    auto *rsp = static_cast<StandardMem::CustomResp *>(req);
+    auto *data = static_cast<AtomicReqData*>(rsp->data);
+    sim->core_->output_.verbose(CALL_INFO, 0, RISCVCore::DEBUG_MEMORY
+                                ,"PC=%08" PRIx64 ": ATOMIC COMPLETE: 0x%016" PRIx64 " = 0x%016" PRIx64 "\n"
+                                ,static_cast<uint64_t>(shart.pc())
+                                ,c.addr
+                                ,static_cast<uint64_t>(*(T*)&data->rdata[0]));
+    shart.x(c.reg) = *(T*)&data->rdata[0];
+    shart.pc() += c.length;
+    shart.stalledMemory() = false;
+    delete req;
+}
+
 void RISCVSimulator::visitLB(RISCVHart &hart, RISCVInstruction &i) {
     visitLoad<int64_t, int8_t>(hart, i);
 }
@@ -297,6 +407,226 @@ void RISCVSimulator::visitFSD(RISCVHart &hart, RISCVInstruction &i) { //stores d
 void RISCVSimulator::visitFLD(RISCVHart &hart, RISCVInstruction &i) {
     visitLoad<double, double>(hart, i);
 }
+void RISCVSimulator::visitVectorMemory(RISCVHart &hart, RISCVInstruction &i, uint64_t eew, VectorAddressing addressing, bool store) {
+    RISCVSimHart &shart = static_cast<RISCVSimHart &>(hart);
+    requireVector(shart, i);
+    // indexed accesses move SEW-wide elements at eew-wide offsets
+    uint64_t size = addressing == VECTOR_INDEXED ? sew(shart) : eew;
+    checkGroup(shart, i, i.rd(), size);
+    if (addressing == VECTOR_INDEXED) {
+        checkGroup(shart, i, i.rs2(), eew);
+    }
+    uint64_t line = core_->vectorRequestSize();
+    uint64_t base = shart.x(i.rs1());
+    uint64_t stride = addressing == VECTOR_STRIDED ? static_cast<uint64_t>(shart.x(i.rs2())) : size;
+    RISCVSimHart::VectorAccess &access = shart.vectorAccess();
+    access.chunks.clear();
+    access.issued = 0;
+    access.completed = 0;
+    access.store = store;
+    access.length = i.length();
+    for (uint64_t e = 0; e < shart._vl; e++) {
+        if (!active(shart, i, e)) {
+            continue;
+        }
+        uint64_t addr = base + e * stride;
+        if (addressing == VECTOR_INDEXED) {
+            switch (eew) {
+            case 1:  addr = base + shart.vget<uint8_t>(i.rs2(), e); break;
+            case 2:  addr = base + shart.vget<uint16_t>(i.rs2(), e); break;
+            case 4:  addr = base + shart.vget<uint32_t>(i.rs2(), e); break;
+            default: addr = base + shart.vget<uint64_t>(i.rs2(), e); break;
+            }
+        }
+        if (isMMIO(addr)) {
+            core_->output_.fatal(CALL_INFO, -1, "Vector access to MMIO address: 0x%" PRIx64 "\n", addr);
+        }
+        uint64_t offset = i.rd() * shart.vlenb() + e * size;
+        // extend the last request if the element follows it in memory and
+        // in the registers without leaving its line
+        if (!access.chunks.empty()) {
+            RISCVSimHart::VectorAccess::Chunk &last = access.chunks.back();
+            if (last.addr + last.size == addr && last.offset + last.size == offset
+                && (addr + size - 1) / line == last.addr / line) {
+                last.size += size;
+                continue;
+            }
+        }
+        DrvAPI::DrvAPIAddressInfo decode = core_->decodeAddress(addr);
+        if (store) {
+            core_->addStoreStat(decode, shart);
+        } else {
+            core_->addLoadStat(decode, shart);
+        }
+        access.chunks.push_back(RISCVSimHart::VectorAccess::Chunk{addr, size, offset, !decode.is_dram()});
+    }
+    core_->output_.verbose(CALL_INFO, 0, RISCVCore::DEBUG_MEMORY
+                           ,"PC=%08" PRIx64 ": VECTOR %s ISSUED: %zu requests\n"
+                           ,static_cast<uint64_t>(shart.pc())
+                           ,store ? "STORE" : "LOAD"
+                           ,access.chunks.size());
+    if (access.chunks.empty()) {
+        shart.pc() += i.length();
+        return;
+    }
+    shart.stalledMemory() = true;
+    issueVectorRequests(shart);
+}
+
+void RISCVSimulator::issueVectorRequests(RISCVSimHart &shart) {
+    RISCVSimHart::VectorAccess &access = shart.vectorAccess();
+    while (access.issued < access.chunks.size()
+           && access.issued - access.completed < core_->vectorMaxRequests()) {
+        size_t chunk = access.issued++;
+        const RISCVSimHart::VectorAccess::Chunk &c = access.chunks[chunk];
+        StandardMem::Addr addr = core_->address_decoder_.to_absolute(c.addr);
+        int tid = core_->getHartId(shart);
+        StandardMem::Request *req = nullptr;
+        if (access.store) {
+            // fill the request's payload in place rather than copying one in
+            std::vector<uint8_t> no_data;
+            StandardMem::Write *wr = new StandardMem::Write(addr, c.size, no_data);
+            wr->data.assign(shart._v.begin() + c.offset, shart._v.begin() + c.offset + c.size);
+            wr->tid = tid;
+            req = wr;
+        } else {
+            StandardMem::Read *rd = new StandardMem::Read(addr, c.size);
+            rd->tid = tid;
+            req = rd;
+        }
+        if (c.noncacheable) req->setNoncacheable();
+        RISCVMemCompletion ch;
+        ch.handler = &RISCVSimulator::completeVectorRequest;
+        ch.hart = &shart;
+        ch.addr = addr;
+        ch.blocking = true;
+        ch.length = access.length;
+        ch.chunk = chunk;
+        core_->issueMemoryRequest(req, tid, ch);
+    }
+}
+
+void RISCVSimulator::completeVectorRequest(RISCVSimulator *sim, const RISCVMemCompletion &completion, StandardMem::Request *req) {
+    RISCVSimHart &shart = *completion.hart;
+    RISCVSimHart::VectorAccess &access = shart.vectorAccess();
+    const RISCVSimHart::VectorAccess::Chunk &c = access.chunks[completion.chunk];
+    if (!access.store) {
+        auto *rsp = static_cast<StandardMem::ReadResp *>(req);
+        memcpy(&shart._v[c.offset], &rsp->data[0], c.size);
+    }
+    delete req;
+    access.completed++;
+    if (access.completed < access.chunks.size()) {
+        sim->issueVectorRequests(shart);
+        return;
+    }
+    sim->core_->output_.verbose(CALL_INFO, 0, RISCVCore::DEBUG_MEMORY
+                                ,"PC=%08" PRIx64 ": VECTOR %s COMPLETE\n"
+                                ,static_cast<uint64_t>(shart.pc())
+                                ,access.store ? "STORE" : "LOAD");
+    access.chunks.clear();
+    shart.pc() += access.length;
+    shart.stalledMemory() = false;
+}
+
+// ordered and unordered indexed accesses are the same: requests go out in element order
+void RISCVSimulator::visitVLE8_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 1, VECTOR_UNIT_STRIDE, false);
+}
+void RISCVSimulator::visitVLE16_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 2, VECTOR_UNIT_STRIDE, false);
+}
+void RISCVSimulator::visitVLE32_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 4, VECTOR_UNIT_STRIDE, false);
+}
+void RISCVSimulator::visitVLE64_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 8, VECTOR_UNIT_STRIDE, false);
+}
+void RISCVSimulator::visitVSE8_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 1, VECTOR_UNIT_STRIDE, true);
+}
+void RISCVSimulator::visitVSE16_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 2, VECTOR_UNIT_STRIDE, true);
+}
+void RISCVSimulator::visitVSE32_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 4, VECTOR_UNIT_STRIDE, true);
+}
+void RISCVSimulator::visitVSE64_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 8, VECTOR_UNIT_STRIDE, true);
+}
+void RISCVSimulator::visitVLSE8_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 1, VECTOR_STRIDED, false);
+}
+void RISCVSimulator::visitVLSE16_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 2, VECTOR_STRIDED, false);
+}
+void RISCVSimulator::visitVLSE32_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 4, VECTOR_STRIDED, false);
+}
+void RISCVSimulator::visitVLSE64_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 8, VECTOR_STRIDED, false);
+}
+void RISCVSimulator::visitVSSE8_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 1, VECTOR_STRIDED, true);
+}
+void RISCVSimulator::visitVSSE16_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 2, VECTOR_STRIDED, true);
+}
+void RISCVSimulator::visitVSSE32_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 4, VECTOR_STRIDED, true);
+}
+void RISCVSimulator::visitVSSE64_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 8, VECTOR_STRIDED, true);
+}
+void RISCVSimulator::visitVLUXEI8_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 1, VECTOR_INDEXED, false);
+}
+void RISCVSimulator::visitVLUXEI16_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 2, VECTOR_INDEXED, false);
+}
+void RISCVSimulator::visitVLUXEI32_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 4, VECTOR_INDEXED, false);
+}
+void RISCVSimulator::visitVLUXEI64_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 8, VECTOR_INDEXED, false);
+}
+void RISCVSimulator::visitVLOXEI8_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 1, VECTOR_INDEXED, false);
+}
+void RISCVSimulator::visitVLOXEI16_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 2, VECTOR_INDEXED, false);
+}
+void RISCVSimulator::visitVLOXEI32_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 4, VECTOR_INDEXED, false);
+}
+void RISCVSimulator::visitVLOXEI64_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 8, VECTOR_INDEXED, false);
+}
+void RISCVSimulator::visitVSUXEI8_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 1, VECTOR_INDEXED, true);
+}
+void RISCVSimulator::visitVSUXEI16_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 2, VECTOR_INDEXED, true);
+}
+void RISCVSimulator::visitVSUXEI32_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 4, VECTOR_INDEXED, true);
+}
+void RISCVSimulator::visitVSUXEI64_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 8, VECTOR_INDEXED, true);
+}
+void RISCVSimulator::visitVSOXEI8_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 1, VECTOR_INDEXED, true);
+}
+void RISCVSimulator::visitVSOXEI16_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 2, VECTOR_INDEXED, true);
+}
+void RISCVSimulator::visitVSOXEI32_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 4, VECTOR_INDEXED, true);
+}
+void RISCVSimulator::visitVSOXEI64_V(RISCVHart &hart, RISCVInstruction &i) {
+    visitVectorMemory(hart, i, 8, VECTOR_INDEXED, true);
+}
+
 void RISCVSimulator::visitAMOSWAPW(RISCVHart &hart, RISCVInstruction &i) {    
     visitAMO<int32_t>(hart, i, DrvAPI::DrvAPIMemAtomicSWAP);
 }
@@ -397,6 +727,206 @@ void RISCVSimulator::visitAMOORD_RL_AQ(RISCVHart &hart, RISCVInstruction &i) {
     visitAMO<int64_t>(hart, i, DrvAPI::DrvAPIMemAtomicOR);
 }
 
+void RISCVSimulator::visitAMOXORW(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int32_t>(hart, i, DrvAPI::DrvAPIMemAtomicXOR);
+}
+
+void RISCVSimulator::visitAMOXORW_RL(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int32_t>(hart, i, DrvAPI::DrvAPIMemAtomicXOR);
+}
+
+void RISCVSimulator::visitAMOXORW_AQ(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int32_t>(hart, i, DrvAPI::DrvAPIMemAtomicXOR);
+}
+
+void RISCVSimulator::visitAMOXORW_RL_AQ(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int32_t>(hart, i, DrvAPI::DrvAPIMemAtomicXOR);
+}
+
+void RISCVSimulator::visitAMOANDW(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int32_t>(hart, i, DrvAPI::DrvAPIMemAtomicAND);
+}
+
+void RISCVSimulator::visitAMOANDW_RL(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int32_t>(hart, i, DrvAPI::DrvAPIMemAtomicAND);
+}
+
+void RISCVSimulator::visitAMOANDW_AQ(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int32_t>(hart, i, DrvAPI::DrvAPIMemAtomicAND);
+}
+
+void RISCVSimulator::visitAMOANDW_RL_AQ(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int32_t>(hart, i, DrvAPI::DrvAPIMemAtomicAND);
+}
+
+void RISCVSimulator::visitAMOMINW(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int32_t>(hart, i, DrvAPI::DrvAPIMemAtomicMIN);
+}
+
+void RISCVSimulator::visitAMOMINW_RL(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int32_t>(hart, i, DrvAPI::DrvAPIMemAtomicMIN);
+}
+
+void RISCVSimulator::visitAMOMINW_AQ(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int32_t>(hart, i, DrvAPI::DrvAPIMemAtomicMIN);
+}
+
+void RISCVSimulator::visitAMOMINW_RL_AQ(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int32_t>(hart, i, DrvAPI::DrvAPIMemAtomicMIN);
+}
+
+void RISCVSimulator::visitAMOMAXW(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int32_t>(hart, i, DrvAPI::DrvAPIMemAtomicMAX);
+}
+
+void RISCVSimulator::visitAMOMAXW_RL(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int32_t>(hart, i, DrvAPI::DrvAPIMemAtomicMAX);
+}
+
+void RISCVSimulator::visitAMOMAXW_AQ(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int32_t>(hart, i, DrvAPI::DrvAPIMemAtomicMAX);
+}
+
+void RISCVSimulator::visitAMOMAXW_RL_AQ(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int32_t>(hart, i, DrvAPI::DrvAPIMemAtomicMAX);
+}
+
+void RISCVSimulator::visitAMOMINUW(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int32_t>(hart, i, DrvAPI::DrvAPIMemAtomicMINU);
+}
+
+void RISCVSimulator::visitAMOMINUW_RL(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int32_t>(hart, i, DrvAPI::DrvAPIMemAtomicMINU);
+}
+
+void RISCVSimulator::visitAMOMINUW_AQ(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int32_t>(hart, i, DrvAPI::DrvAPIMemAtomicMINU);
+}
+
+void RISCVSimulator::visitAMOMINUW_RL_AQ(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int32_t>(hart, i, DrvAPI::DrvAPIMemAtomicMINU);
+}
+
+void RISCVSimulator::visitAMOMAXUW(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int32_t>(hart, i, DrvAPI::DrvAPIMemAtomicMAXU);
+}
+
+void RISCVSimulator::visitAMOMAXUW_RL(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int32_t>(hart, i, DrvAPI::DrvAPIMemAtomicMAXU);
+}
+
+void RISCVSimulator::visitAMOMAXUW_AQ(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int32_t>(hart, i, DrvAPI::DrvAPIMemAtomicMAXU);
+}
+
+void RISCVSimulator::visitAMOMAXUW_RL_AQ(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int32_t>(hart, i, DrvAPI::DrvAPIMemAtomicMAXU);
+}
+
+void RISCVSimulator::visitAMOXORD(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int64_t>(hart, i, DrvAPI::DrvAPIMemAtomicXOR);
+}
+
+void RISCVSimulator::visitAMOXORD_RL(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int64_t>(hart, i, DrvAPI::DrvAPIMemAtomicXOR);
+}
+
+void RISCVSimulator::visitAMOXORD_AQ(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int64_t>(hart, i, DrvAPI::DrvAPIMemAtomicXOR);
+}
+
+void RISCVSimulator::visitAMOXORD_RL_AQ(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int64_t>(hart, i, DrvAPI::DrvAPIMemAtomicXOR);
+}
+
+void RISCVSimulator::visitAMOANDD(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int64_t>(hart, i, DrvAPI::DrvAPIMemAtomicAND);
+}
+
+void RISCVSimulator::visitAMOANDD_RL(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int64_t>(hart, i, DrvAPI::DrvAPIMemAtomicAND);
+}
+
+void RISCVSimulator::visitAMOANDD_AQ(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int64_t>(hart, i, DrvAPI::DrvAPIMemAtomicAND);
+}
+
+void RISCVSimulator::visitAMOANDD_RL_AQ(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int64_t>(hart, i, DrvAPI::DrvAPIMemAtomicAND);
+}
+
+void RISCVSimulator::visitAMOMIND(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int64_t>(hart, i, DrvAPI::DrvAPIMemAtomicMIN);
+}
+
+void RISCVSimulator::visitAMOMIND_RL(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int64_t>(hart, i, DrvAPI::DrvAPIMemAtomicMIN);
+}
+
+void RISCVSimulator::visitAMOMIND_AQ(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int64_t>(hart, i, DrvAPI::DrvAPIMemAtomicMIN);
+}
+
+void RISCVSimulator::visitAMOMIND_RL_AQ(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int64_t>(hart, i, DrvAPI::DrvAPIMemAtomicMIN);
+}
+
+void RISCVSimulator::visitAMOMAXD(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int64_t>(hart, i, DrvAPI::DrvAPIMemAtomicMAX);
+}
+
+void RISCVSimulator::visitAMOMAXD_RL(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int64_t>(hart, i, DrvAPI::DrvAPIMemAtomicMAX);
+}
+
+void RISCVSimulator::visitAMOMAXD_AQ(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int64_t>(hart, i, DrvAPI::DrvAPIMemAtomicMAX);
+}
+
+void RISCVSimulator::visitAMOMAXD_RL_AQ(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int64_t>(hart, i, DrvAPI::DrvAPIMemAtomicMAX);
+}
+
+void RISCVSimulator::visitAMOMINUD(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int64_t>(hart, i, DrvAPI::DrvAPIMemAtomicMINU);
+}
+
+void RISCVSimulator::visitAMOMINUD_RL(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int64_t>(hart, i, DrvAPI::DrvAPIMemAtomicMINU);
+}
+
+void RISCVSimulator::visitAMOMINUD_AQ(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int64_t>(hart, i, DrvAPI::DrvAPIMemAtomicMINU);
+}
+
+void RISCVSimulator::visitAMOMINUD_RL_AQ(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int64_t>(hart, i, DrvAPI::DrvAPIMemAtomicMINU);
+}
+
+void RISCVSimulator::visitAMOMAXUD(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int64_t>(hart, i, DrvAPI::DrvAPIMemAtomicMAXU);
+}
+
+void RISCVSimulator::visitAMOMAXUD_RL(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int64_t>(hart, i, DrvAPI::DrvAPIMemAtomicMAXU);
+}
+
+void RISCVSimulator::visitAMOMAXUD_AQ(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int64_t>(hart, i, DrvAPI::DrvAPIMemAtomicMAXU);
+}
+
+void RISCVSimulator::visitAMOMAXUD_RL_AQ(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int64_t>(hart, i, DrvAPI::DrvAPIMemAtomicMAXU);
+}
+
+void RISCVSimulator::visitAMOFADDW(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int32_t>(hart, i, DrvAPI::DrvAPIMemAtomicFADD);
+}
+
+void RISCVSimulator::visitAMOFADDD(RISCVHart &hart, RISCVInstruction &i) {
+    visitAMO<int64_t>(hart, i, DrvAPI::DrvAPIMemAtomicFADD);
+}
+
 void RISCVSimulator::visitAMOCASW(RISCVHart &hart, RISCVInstruction &instruction) {
     visitAMO<int32_t>(hart, instruction, DrvAPI::DrvAPIMemAtomicCAS);
 }
@@ -431,9 +961,16 @@ void RISCVSimulator::visitAMOCASD_RL_AQ(RISCVHart &hart, RISCVInstruction &instr
 }
 
 void RISCVSimulator::visitFENCE(RISCVHart &hart, RISCVInstruction &i) {
-    // currently a no-op
-    // implement when we non-blocking memory operations
-    hart.pc() += 4;
+    // the core holds a fence until mustWait() finds every load and store
+    // drained, so by now there is nothing left to order
+    hart.pc() += i.length();
+}
+
+void RISCVSimulator::visitFENCE_I(RISCVHart &hart, RISCVInstruction &i) {
+    // instructions are fetched from the program image, so only
+    // previously decoded instructions need to be dropped
+    core_->invalidateDecodeCache();
+    hart.pc() += i.length();
 }
 
 /////////
@@ -485,6 +1022,16 @@ uint64_t RISCVSimulator::visitCSRRWUnderMask(RISCVHart &hart, uint64_t csr, uint
     case CSR_SLEEP: // write-only
         core_->putHartToSleep(shart, wval);
         break;
+    case CSR_WAITADDR: // read-write
+        rval = shart.waitAddr();
+        shart.waitAddr() &= ~mask;
+        shart.waitAddr() |= wval & mask;
+        break;
+    case CSR_WAIT64:
+    case CSR_WAIT32:
+    case CSR_BARRIER:
+        core_->output_.fatal(CALL_INFO, -1, "CSR %" PRIx64 " must be accessed with csrrw\n", csr);
+        break;
     case CSR_FRM: // read-write
         rval = shart.rm();
         shart.rm() &= ~mask;
@@ -505,19 +1052,94 @@ uint64_t RISCVSimulator::visitCSRRWUnderMask(RISCVHart &hart, uint64_t csr, uint
     case CSR_CYCLE: // read-only
         rval = core_->clocktc_->convertFromCoreTime(core_->getCurrentSimCycle());
         break;
+    case CSR_VL: // read-only
+        rval = shart._vl;
+        break;
+    case CSR_VTYPE: // read-only
+        rval = shart._vtype;
+        break;
+    case CSR_VLENB: // read-only
+        rval = shart.vlenb();
+        break;
+    case CSR_VSTART: // read-write; instructions always run from element 0
+        if ((wval & mask) != 0) {
+            core_->output_.fatal(CALL_INFO, -1, "vstart other than 0 is not supported\n");
+        }
+        break;
     default:
         core_->output_.fatal(CALL_INFO, -1, "CSR %" PRIx64 " is not implemented\n", csr);
     }
     return rval;
 }
 
+template <typename T>
+void RISCVSimulator::visitWait(RISCVHart &hart, RISCVInstruction &i) {
+    RISCVSimHart &shart = static_cast<RISCVSimHart &>(hart);
+    StandardMem::Addr addr = shart.waitAddr();
+
+    DrvAPI::DrvAPIAddressInfo decode = core_->decodeAddress(addr);
+    core_->addLoadStat(decode, shart); // add to statistics
+    bool noncacheable = !decode.is_dram();
+
+    WaitReqData *data = new WaitReqData();
+    addr = core_->address_decoder_.to_absolute(addr);
+    data->pAddr = addr;
+    data->size = sizeof(T);
+    data->expected.resize(sizeof(T));
+    *(T*)&data->expected[0] = shart.x(i.rs1());
+    StandardMem::CustomReq *req = new StandardMem::CustomReq(data);
+    if (noncacheable) req->setNoncacheable();
+
+    req->tid = core_->getHartId(shart);
+    shart.stalledMemory() = true;
+    int ird = i.rd();
+    RISCVMemCompletion ch;
+    ch.handler = &RISCVSimulator::completeWait<T>;
+    ch.hart = &shart;
+    ch.addr = addr;
+    ch.reg = ird;
+    ch.blocking = true;
+    ch.length = i.length();
+    core_->output_.verbose(CALL_INFO, 0, RISCVCore::DEBUG_MEMORY
+                           ,"PC=%08" PRIx64 ": WAIT ISSUED:     0x%016" PRIx64 "\n"
+                           ,static_cast<uint64_t>(shart.pc())
+                           ,static_cast<uint64_t>(addr));
+    core_->issueMemoryRequest(req, req->tid, ch);
+}
+
+template <typename T>
+void RISCVSimulator::completeWait(RISCVSimulator *sim, const RISCVMemCompletion &c, StandardMem::Request *req) {
+    // the hart is woken with the value of the word
+    RISCVSimHart &shart = *c.hart;
+    auto *rsp = static_cast<StandardMem::CustomResp *>(req);
+    auto *data = static_cast<WaitReqData*>(rsp->data);
+    sim->core_->output_.verbose(CALL_INFO, 0, RISCVCore::DEBUG_MEMORY
+                                ,"PC=%08" PRIx64 ": WAIT COMPLETE: 0x%016" PRIx64 " = 0x%016" PRIx64 "\n"
+                                ,static_cast<uint64_t>(shart.pc())
+                                ,c.addr
+                                ,static_cast<uint64_t>(*(T*)&data->rdata[0]));
+    shart.x(c.reg) = *(T*)&data->rdata[0];
+    shart.pc() += c.length;
+    shart.stalledMemory() = false;
+    delete data;
+    delete req;
+}
+
 void RISCVSimulator::visitCSRRW(RISCVHart &hart, RISCVInstruction &i) {
     RISCVSimHart &shart = static_cast<RISCVSimHart &>(hart);
     uint64_t csr = i.Iimm();
+    if (csr == CSR_WAIT64) {
+        return visitWait<int64_t>(shart, i);
+    } else if (csr == CSR_WAIT32) {
+        return visitWait<int32_t>(shart, i);
+    } else if (csr == CSR_BARRIER) {
+        // pc and rd are updated when the barrier releases
+        return core_->barrierArrive(shart, shart.x(i.rs1()), i.rd());
+    }
     uint64_t wval = shart.x(i.rs1());
     uint64_t rval = visitCSRRWUnderMask(shart, csr, wval, 0xFFFFFFFFFFFFFFFF);
     shart.x(i.rd()) = rval;
-    shart.pc() += 4;
+    shart.pc() += i.length();
 }
 
 void RISCVSimulator::visitCSRRS(RISCVHart &hart, RISCVInstruction &i) {
@@ -526,7 +1148,7 @@ void RISCVSimulator::visitCSRRS(RISCVHart &hart, RISCVInstruction &i) {
     uint64_t wval = shart.x(i.rs1());
     uint64_t rval = visitCSRRWUnderMask(shart, csr, 0xFFFFFFFFFFFFFFFF, wval);
     shart.x(i.rd()) = rval;
-    shart.pc() += 4;
+    shart.pc() += i.length();
 }
 
 void RISCVSimulator::visitCSRRC(RISCVHart &shart, RISCVInstruction &i) {
@@ -534,7 +1156,7 @@ void RISCVSimulator::visitCSRRC(RISCVHart &shart, RISCVInstruction &i) {
     uint64_t wval = shart.x(i.rs1());
     uint64_t rval = visitCSRRWUnderMask(shart, csr, 0x0000000000000000, wval);
     shart.x(i.rd()) = rval;
-    shart.pc() += 4;
+    shart.pc() += i.length();
 }
 
 void RISCVSimulator::visitCSRRWI(RISCVHart &hart, RISCVInstruction &i) {
@@ -543,7 +1165,7 @@ void RISCVSimulator::visitCSRRWI(RISCVHart &hart, RISCVInstruction &i) {
     uint64_t wval = i.rs1();
     uint64_t rval = visitCSRRWUnderMask(shart, csr, wval, 0xFFFFFFFFFFFFFFFF);
     shart.x(i.rd()) = rval;
-    shart.pc() += 4;
+    shart.pc() += i.length();
 }
 
 void RISCVSimulator::visitCSRRSI(RISCVHart &hart, RISCVInstruction &i) {
@@ -552,7 +1174,7 @@ void RISCVSimulator::visitCSRRSI(RISCVHart &hart, RISCVInstruction &i) {
     uint64_t wval = i.rs1();
     uint64_t rval = visitCSRRWUnderMask(shart, csr, 0xFFFFFFFFFFFFFFFF, wval);
     shart.x(i.rd()) = rval;
-    shart.pc() += 4;
+    shart.pc() += i.length();
 }
 
 void RISCVSimulator::visitCSRRCI(RISCVHart &hart, RISCVInstruction &i) {
@@ -561,7 +1183,7 @@ void RISCVSimulator::visitCSRRCI(RISCVHart &hart, RISCVInstruction &i) {
     uint64_t wval = i.rs1();
     uint64_t rval = visitCSRRWUnderMask(shart, csr, 0x0000000000000000, wval);
     shart.x(i.rd()) = rval;
-    shart.pc() += 4;
+    shart.pc() += i.length();
 }
 
 //////////////////
@@ -613,6 +1235,7 @@ void RISCVSimulator::sysBRK(RISCVSimHart &shart, RISCVInstruction &i) {
 void RISCVSimulator::sysEXIT(RISCVSimHart &shart, RISCVInstruction &i) {
     shart.exit() = true;
     shart.exitCode() = shart.sa(0);
+    core_->barrierDepart();
     if (shart.exitCode() == 0) {
         core_->isa_test_output_.verbose(CALL_INFO, 1, 0, "%10s TEST PASS\n"
                                         ,core_->testName().c_str()
@@ -675,76 +1298,81 @@ void RISCVSimulator::sysOPEN(RISCVSimHart &shart, RISCVInstruction &i) {
  * Write an arbitrarily large buffer to the simulator's memory
  */
 void RISCVSimulator::sysWriteBuffer(RISCVSimHart &shart, StandardMem::Addr paddr, std::vector<uint8_t> &data, std::function<void(void)> && cont) {
-    // create a large request handler
-    size_t reqSz = core_->getMaxReqSize();
-    size_t nReqs = 0;
-    size_t payloadSz = data.size();
-    size_t payloadOff = 0;
-    std::shared_ptr<LargeWriteHandler> handler(new LargeWriteHandler(std::move(cont)));
-
-    // create a completion handler for when small requests return
-    RISCVCore::ICompletionHandler ch([handler](StandardMem::Request *req) {
-        handler->recvRsp(req);
-    });
-
-    DrvAPI::DrvAPIAddressInfo info = core_->address_decoder_.decode(paddr);
-    bool noncacheable = !info.is_dram();
-
-    // issue writes along cache line boundaries
-    while  (payloadSz > 0) {
-        // determine the size of the next write
-        size_t sz = std::min(payloadSz, reqSz);
-        sz = std::min(sz, reqSz - (paddr % reqSz));
-        std::vector<uint8_t> wdata(data.begin() + payloadOff, data.begin() + payloadOff + sz);
-        // create the write request
-        auto wr = new StandardMem::Write(paddr, sz, wdata);
-        if (noncacheable) wr->setNoncacheable();
-        wr->tid = core_->getHartId(shart);
-        core_->issueMemoryRequest(wr, wr->tid, ch);
-        // increment bookkeeping
-        nReqs++;
-        paddr += sz;
-        payloadSz  -= sz;
-        payloadOff += sz;
-    }
-
-    handler->n_requests = nReqs;
+    RISCVSimHart::SysAccess &access = shart.sysAccess();
+    access.data = data;
+    access.addr = paddr;
+    access.issued = 0;
+    access.outstanding = 0;
+    access.write = true;
+    access.noncacheable = !core_->address_decoder_.decode(paddr).is_dram();
+    access.done = [cont](std::vector<uint8_t> &) { cont(); };
+    issueSysRequests(shart);
 }
 
 /**
  * Read an arbitrarily large buffer from the simulator's memory
  */
 void RISCVSimulator::sysReadBuffer(RISCVSimHart &shart, StandardMem::Addr paddr, size_t n, std::function<void(std::vector<uint8_t>&)> && cont) {
-    // create a large request handler
+    RISCVSimHart::SysAccess &access = shart.sysAccess();
+    access.data.assign(n, 0);
+    access.addr = paddr;
+    access.issued = 0;
+    access.outstanding = 0;
+    access.write = false;
+    access.noncacheable = !core_->address_decoder_.decode(paddr).is_dram();
+    access.done = std::move(cont);
+    issueSysRequests(shart);
+}
+
+void RISCVSimulator::issueSysRequests(RISCVSimHart &shart) {
+    RISCVSimHart::SysAccess &access = shart.sysAccess();
+    if (access.issued == access.data.size() && access.outstanding == 0) {
+        std::function<void(std::vector<uint8_t>&)> done = std::move(access.done);
+        done(access.data);
+        return;
+    }
     size_t reqSz = core_->getMaxReqSize();
-    size_t nReqs = 0;
-    size_t payloadSz = n;
-    size_t payloadOff = 0;
-    std::shared_ptr<LargeReadHandler> handler(new LargeReadHandler(std::move(cont)));
-
-    // create a completion handler for when small requests return
-    RISCVCore::ICompletionHandler ch([handler](StandardMem::Request *req) {
-        handler->recvRsp(req);
-    });
-
-    bool noncacheable = !core_->address_decoder_.decode(paddr).is_dram();
-    // issue reads along cache line boundaries
-    while (payloadSz > 0) {
-        // determine the size of the next read
-        size_t sz = std::min(payloadSz, reqSz);
+    int tid = core_->getHartId(shart);
+    // issue along cache line boundaries
+    while (access.issued < access.data.size()
+           && access.outstanding < core_->completionSlots()) {
+        StandardMem::Addr paddr = access.addr + access.issued;
+        size_t sz = std::min(access.data.size() - access.issued, reqSz);
         sz = std::min(sz, reqSz - (paddr % reqSz));
-        // create the read request
-        auto rd = new StandardMem::Read(paddr, sz);
-        if (noncacheable) rd->setNoncacheable();
-        rd->tid = core_->getHartId(shart);
-        core_->issueMemoryRequest(rd, rd->tid, ch);
-        // increment bookkeeping
-        nReqs++;
-        paddr += sz;
-        payloadSz  -= sz;
-        payloadOff += sz;
+        StandardMem::Request *req = nullptr;
+        if (access.write) {
+            std::vector<uint8_t> wdata(access.data.begin() + access.issued, access.data.begin() + access.issued + sz);
+            StandardMem::Write *wr = new StandardMem::Write(paddr, sz, wdata);
+            wr->tid = tid;
+            req = wr;
+        } else {
+            StandardMem::Read *rd = new StandardMem::Read(paddr, sz);
+            rd->tid = tid;
+            req = rd;
+        }
+        if (access.noncacheable) req->setNoncacheable();
+        RISCVMemCompletion ch;
+        ch.handler = &RISCVSimulator::completeSysRequest;
+        ch.hart = &shart;
+        ch.addr = paddr;
+        ch.chunk = access.issued;
+        access.issued += sz;
+        access.outstanding++;
+        core_->issueMemoryRequest(req, tid, ch);
+    }
+}
+
+void RISCVSimulator::completeSysRequest(RISCVSimulator *sim, const RISCVMemCompletion &c, StandardMem::Request *req) {
+    RISCVSimHart &shart = *c.hart;
+    RISCVSimHart::SysAccess &access = shart.sysAccess();
+    if (!access.write) {
+        // responses may arrive in any order; each lands at its own offset
+        auto *rsp = static_cast<StandardMem::ReadResp *>(req);
+        memcpy(&access.data[c.chunk], &rsp->data[0], rsp->data.size());
     }
-    handler->n_requests = nReqs;
+    delete req;
+    access.outstanding--;
+    sim->issueSysRequests(shart);
 }
 
 void RISCVSimulator::sysCLOSE(RISCVSimHart &shart, RISCVInstruction &i) {
@@ -784,7 +1412,7 @@ void RISCVSimulator::visitECALL(RISCVHart &hart, RISCVInstruction &i) {
     default:
         core_->output_.fatal(CALL_INFO, -1, "Unknown ECALL %lu\n", (unsigned long)shart.a(7));
     }
-    hart.pc() += 4;
+    hart.pc() += i.length();
 }
 
 }
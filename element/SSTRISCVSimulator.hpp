@@ -2,7 +2,7 @@
 // Copyright (c) 2023 University of Washington
 
 #pragma once
-#include <RV64IMFInterpreter.hpp>
+#include <RV64IMFVInterpreter.hpp>
 #include <sst/core/interfaces/stdMem.h>
 #include <map>
 #include <functional>
@@ -14,11 +14,31 @@ namespace Drv {
 
 class RISCVCore;
 class RISCVSimHart;
+class RISCVSimulator;
+
+/**
+ * @brief a load, store, atomic or vector request chunk awaiting its response
+ *
+ * A plain record rather than a closure, so issuing a request does not
+ * allocate; the core keeps a fixed number of these per hart.
+ */
+struct RISCVMemCompletion {
+    typedef void (*Handler)(RISCVSimulator *sim, const RISCVMemCompletion &c, SST::Interfaces::StandardMem::Request *rsp);
+
+    Handler handler = nullptr; //!< called with the response; null if the slot is free
+    SST::Interfaces::StandardMem::id_t id = 0; //!< id of the request
+    RISCVSimHart *hart = nullptr; //!< hart that issued the request
+    uint64_t addr = 0; //!< absolute address accessed
+    int reg = 0; //!< destination register
+    bool blocking = false; //!< the hart is stalled until the response
+    uint32_t length = 4; //!< bytes of the instruction; a blocking completion steps pc past it
+    size_t chunk = 0; //!< index of a vector access's chunk
+};
 
 /**
  * @brief a riscv simulator
  */
-class RISCVSimulator : public RV64IMFInterpreter {
+class RISCVSimulator : public RV64IMFVInterpreter {
 public:
     /**
      * constructor
@@ -32,6 +52,52 @@ public:
 
     void visit(RISCVHart &hart, RISCVInstruction &instruction) override;
 
+    /**
+     * true if the instruction reads and writes only the hart's registers
+     *
+     * Loads, stores, atomics, fences and system instructions (csrs, ecall)
+     * are the ones this class simulates; everything else is interpreted.
+     */
+    static bool isRegisterOnly(const RISCVInstruction &instruction) {
+        switch (instruction.instruction() & 0x7f) {
+        case 0x03: // load
+        case 0x07: // load-fp
+        case 0x0f: // misc-mem
+        case 0x23: // store
+        case 0x27: // store-fp
+        case 0x2b: // amocas, amofadd
+        case 0x2f: // amo
+        case 0x73: // system
+            return false;
+        default:
+            return true;
+        }
+    }
+
+    /**
+     * true if the instruction is a vector load or store
+     *
+     * They share the load-fp and store-fp opcodes; the widths that are not
+     * scalar sizes mark them.
+     */
+    static bool isVectorMemory(const RISCVInstruction &instruction) {
+        uint32_t opcode = instruction.instruction() & 0x7f;
+        uint32_t width = (instruction.instruction() >> 12) & 0x7;
+        return (opcode == 0x07 || opcode == 0x27) && (width == 0 || width >= 5);
+    }
+
+    /**
+     * true if the instruction must wait for the hart's outstanding loads or stores
+     *
+     * An instruction waits if it reads or writes a register an outstanding
+     * load will write. A load waits for outstanding stores to the same
+     * bytes; a store for any outstanding access to them. Either also waits
+     * for room in the load queue or store buffer. Atomics, fences and
+     * system instructions wait for every outstanding access, and so do
+     * vector loads and stores.
+     */
+    bool mustWait(RISCVSimHart &hart, RISCVInstruction &instruction);
+
     // load/stores
     void visitLB(RISCVHart &hart, RISCVInstruction &instruction) override;
     void visitLH(RISCVHart &hart, RISCVInstruction &instruction) override;
@@ -46,14 +112,58 @@ public:
     void visitSW(RISCVHart &hart, RISCVInstruction &instruction) override;
     void visitSD(RISCVHart &hart, RISCVInstruction &instruction) override;
     void visitFENCE(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitFENCE_I(RISCVHart &hart, RISCVInstruction &instruction) override;
     void visitFSW(RISCVHart &hart, RISCVInstruction &instruction) override;
     void visitFSD(RISCVHart &hart, RISCVInstruction &instruction) override;
     void visitFLD(RISCVHart &hart, RISCVInstruction &instruction) override;
 
+    // vector load/stores
+    void visitVLE8_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVLE16_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVLE32_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVLE64_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVSE8_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVSE16_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVSE32_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVSE64_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVLSE8_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVLSE16_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVLSE32_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVLSE64_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVSSE8_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVSSE16_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVSSE32_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVSSE64_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVLUXEI8_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVLUXEI16_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVLUXEI32_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVLUXEI64_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVLOXEI8_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVLOXEI16_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVLOXEI32_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVLOXEI64_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVSUXEI8_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVSUXEI16_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVSUXEI32_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVSUXEI64_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVSOXEI8_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVSOXEI16_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVSOXEI32_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitVSOXEI64_V(RISCVHart &hart, RISCVInstruction &instruction) override;
+
     // csr instructions
 private:
     uint64_t visitCSRRWUnderMask(RISCVHart &hart, uint64_t csr, uint64_t wval, uint64_t mask);
 
+    /**
+     * @brief park the hart at the memory until the word at its wait address may equal rs1
+     */
+    template <typename T>
+    void visitWait(RISCVHart &hart, RISCVInstruction &instruction);
+
+    template <typename T>
+    static void completeWait(RISCVSimulator *sim, const RISCVMemCompletion &c, SST::Interfaces::StandardMem::Request *rsp);
+
 public:
     void visitCSRRW(RISCVHart &hart, RISCVInstruction &instruction) override;
     void visitCSRRS(RISCVHart &hart, RISCVInstruction &instruction) override;
@@ -67,6 +177,9 @@ private:
     template <typename T>
     void visitAMO(RISCVHart &hart, RISCVInstruction &i, DrvAPI::DrvAPIMemAtomicType op);
 
+    template <typename T>
+    static void completeAMO(RISCVSimulator *sim, const RISCVMemCompletion &c, SST::Interfaces::StandardMem::Request *rsp);
+
     void visitAMOSWAPW(RISCVHart &hart, RISCVInstruction &instruction) override;
     void visitAMOSWAPW_RL(RISCVHart &hart, RISCVInstruction &instruction) override;
     void visitAMOSWAPW_AQ(RISCVHart &hart, RISCVInstruction &instruction) override;
@@ -98,6 +211,69 @@ private:
     void visitAMOORD_AQ(RISCVHart &hart, RISCVInstruction &instruction) override;
     void visitAMOORD_RL_AQ(RISCVHart &hart, RISCVInstruction &instruction) override;
 
+    void visitAMOXORW(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOXORW_RL(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOXORW_AQ(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOXORW_RL_AQ(RISCVHart &hart, RISCVInstruction &instruction) override;
+
+    void visitAMOANDW(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOANDW_RL(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOANDW_AQ(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOANDW_RL_AQ(RISCVHart &hart, RISCVInstruction &instruction) override;
+
+    void visitAMOMINW(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOMINW_RL(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOMINW_AQ(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOMINW_RL_AQ(RISCVHart &hart, RISCVInstruction &instruction) override;
+
+    void visitAMOMAXW(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOMAXW_RL(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOMAXW_AQ(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOMAXW_RL_AQ(RISCVHart &hart, RISCVInstruction &instruction) override;
+
+    void visitAMOMINUW(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOMINUW_RL(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOMINUW_AQ(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOMINUW_RL_AQ(RISCVHart &hart, RISCVInstruction &instruction) override;
+
+    void visitAMOMAXUW(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOMAXUW_RL(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOMAXUW_AQ(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOMAXUW_RL_AQ(RISCVHart &hart, RISCVInstruction &instruction) override;
+
+    void visitAMOXORD(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOXORD_RL(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOXORD_AQ(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOXORD_RL_AQ(RISCVHart &hart, RISCVInstruction &instruction) override;
+
+    void visitAMOANDD(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOANDD_RL(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOANDD_AQ(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOANDD_RL_AQ(RISCVHart &hart, RISCVInstruction &instruction) override;
+
+    void visitAMOMIND(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOMIND_RL(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOMIND_AQ(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOMIND_RL_AQ(RISCVHart &hart, RISCVInstruction &instruction) override;
+
+    void visitAMOMAXD(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOMAXD_RL(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOMAXD_AQ(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOMAXD_RL_AQ(RISCVHart &hart, RISCVInstruction &instruction) override;
+
+    void visitAMOMINUD(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOMINUD_RL(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOMINUD_AQ(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOMINUD_RL_AQ(RISCVHart &hart, RISCVInstruction &instruction) override;
+
+    void visitAMOMAXUD(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOMAXUD_RL(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOMAXUD_AQ(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOMAXUD_RL_AQ(RISCVHart &hart, RISCVInstruction &instruction) override;
+
+    void visitAMOFADDW(RISCVHart &hart, RISCVInstruction &instruction) override;
+    void visitAMOFADDD(RISCVHart &hart, RISCVInstruction &instruction) override;
+
     template <typename T>
     void visitAMOCAS(RISCVHart &hart, RISCVInstruction &i);
 
@@ -142,91 +318,62 @@ private:
     static constexpr uint64_t CSR_MTVEC   = 0x305; // where to jump on trap
     static constexpr uint64_t CSR_MEPC    = 0x341; // where to jump on exception
     static constexpr uint64_t CSR_CYCLE   = 0xC00;
+    static constexpr uint64_t CSR_VSTART  = 0x008;
+    static constexpr uint64_t CSR_VL      = 0xC20;
+    static constexpr uint64_t CSR_VTYPE   = 0xC21;
+    static constexpr uint64_t CSR_VLENB   = 0xC22;
 
     static constexpr uint64_t CSR_SLEEP = 0x7A5; // sleep for x cycles
     static constexpr uint64_t CSR_L1SPBASE = 0x7A6; // get the absolute top of this cores L1 scratchpad
+    static constexpr uint64_t CSR_WAITADDR = 0x7A7; // address to wait on
+    static constexpr uint64_t CSR_WAIT64 = 0x7A8; // csrrw: park until the 64-bit word at CSR_WAITADDR may equal rs1; rd = value
+    static constexpr uint64_t CSR_WAIT32 = 0x7A9; // csrrw: park until the 32-bit word at CSR_WAITADDR may equal rs1; rd = value
+    static constexpr uint64_t CSR_BARRIER = 0x7AA; // csrrw: wait at the barrier network adding rs1; rd = sum over all harts
 private:
 
-    /**
-     * @brief The LargeReadHandler class
-     * coealesces multiple read requests into a single callback
-     */
-    class LargeReadHandler {
-    public:
-        using ResponseType = SST::Interfaces::StandardMem::ReadResp;
-        LargeReadHandler(std::function<void(std::vector<uint8_t>&)> &&completion) :
-            n_requests(0), completion(completion) {
-            responses.reserve(n_requests);
-        }
-        virtual ~LargeReadHandler() {
-            for (ResponseType *rsp : responses) {
-                delete rsp;
-            }
-        }
-        void recvRsp(SST::Interfaces::StandardMem::Request *req) {
-            ResponseType *rsp = dynamic_cast<ResponseType*>(req);
-            if (rsp == nullptr) {
-                SST::Output::getDefaultObject().fatal(CALL_INFO, -1, "LargeReadHandler: received a response of the wrong type\n");
-            }
-            responses.push_back(rsp);
-            if (responses.size() == n_requests) {
-                // 1.. sort responses by address
-                std::sort(responses.begin(), responses.end(), [](ResponseType  *a, ResponseType *b) {
-                    return a->pAddr < b->pAddr;
-                });
-                std::vector<uint8_t> data;
-                for (ResponseType *rsp : responses) {
-                    data.insert(data.end(), rsp->data.begin(), rsp->data.end());
-                }
-                completion(data);
-            }
-        }
-        size_t n_requests;
-        std::vector<ResponseType *> responses;
-        std::function<void(std::vector<uint8_t>&)> completion;
-    };
-
-
-    /**
-     * @brief LargeWriteHandler
-     * coalesces multiple write responses into a single callback
-     */
-    class LargeWriteHandler {
-    public:
-        using ResponseType = SST::Interfaces::StandardMem::WriteResp;
-        LargeWriteHandler(std::function<void()> &&completion) :
-            n_requests(0), completion(completion) {
-            responses.reserve(n_requests);
-        }
-        virtual ~LargeWriteHandler() {
-            for (ResponseType *rsp : responses) {
-                delete rsp;
-            }
-        }
-        void recvRsp(SST::Interfaces::StandardMem::Request *req) {
-            ResponseType *rsp = dynamic_cast<ResponseType*>(req);
-            if (rsp == nullptr) {
-                SST::Output::getDefaultObject().fatal(CALL_INFO, -1, "LargeWriteHandler: received a response of the wrong type\n");
-            }
-            responses.push_back(rsp);
-            if (responses.size() == n_requests) {
-                completion();
-            }
-        }
-        size_t n_requests;
-        std::vector<ResponseType *> responses;
-        std::function<void()> completion;
-    };
-
     template <typename R, typename T>
     void visitLoad(RISCVHart &hart, RISCVInstruction &instruction);
 
+    template <typename R, typename T>
+    static void completeLoad(RISCVSimulator *sim, const RISCVMemCompletion &c, SST::Interfaces::StandardMem::Request *rsp);
+
     template <typename T>
     void visitStore(RISCVHart &hart, RISCVInstruction &instruction);
 
+    template <typename T>
+    static void completeStore(RISCVSimulator *sim, const RISCVMemCompletion &c, SST::Interfaces::StandardMem::Request *rsp);
+
     template <typename T>
     void visitStoreMMIO(RISCVHart &shart, RISCVInstruction &i);
 
+    /**
+     * @brief how a vector load or store finds the address of each element
+     */
+    enum VectorAddressing {
+        VECTOR_UNIT_STRIDE, //!< consecutive elements
+        VECTOR_STRIDED,     //!< elements x[rs2] bytes apart
+        VECTOR_INDEXED,     //!< byte offsets in vs2
+    };
+
+    /**
+     * @brief split a vector load or store into requests and start issuing them
+     *
+     * The hart stalls until every request completes.
+     *
+     * @param eew bytes per element, or per index for an indexed access
+     */
+    void visitVectorMemory(RISCVHart &hart, RISCVInstruction &i, uint64_t eew, VectorAddressing addressing, bool store);
+
+    /**
+     * @brief issue a hart's vector requests until vector_max_requests are outstanding
+     */
+    void issueVectorRequests(RISCVSimHart &shart);
+
+    /**
+     * @brief handle the response to one of a hart's vector requests
+     */
+    static void completeVectorRequest(RISCVSimulator *sim, const RISCVMemCompletion &c, SST::Interfaces::StandardMem::Request *req);
+
     // TODO: implement this for malloc/free
     // or provide a different malloc/free implementation...
     void sysBRK(RISCVSimHart &shart, RISCVInstruction &i);
@@ -238,6 +385,18 @@ private:
     void sysReadBuffer(RISCVSimHart &shart, SST::Interfaces::StandardMem::Addr paddr, size_t n, std::function<void(std::vector<uint8_t>&)> && cont);
     void sysWriteBuffer(RISCVSimHart &shart, SST::Interfaces::StandardMem::Addr paddr, std::vector<uint8_t> &data, std::function<void(void)> && cont);
 
+    /**
+     * @brief issue a hart's system call buffer requests until every completion slot is in use
+     *
+     * System calls drain the hart's loads and stores first, so the slots are all free.
+     */
+    void issueSysRequests(RISCVSimHart &shart);
+
+    /**
+     * @brief handle the response to one of a hart's system call buffer requests
+     */
+    static void completeSysRequest(RISCVSimulator *sim, const RISCVMemCompletion &c, SST::Interfaces::StandardMem::Request *req);
+
     // TODO: implement these for stdio
     
     // void sysREADV(RISCVSimHart &shart, RISCVInstruction &i);
@@ -1,7 +1,10 @@
 #ifndef ICACHE_HPP
 #define ICACHE_HPP
 #include <cmath>
+#include <cstdint>
 #include <sstream>
+#include <utility>
+#include <vector>
 #include "ICacheBacking.hpp"
 
 namespace interp
@@ -22,237 +25,140 @@ inline INT clog2(INT x) {
 }
 }
 
+/**
+ * @brief A set-associative instruction cache timing model with true LRU replacement
+ *
+ * Only tags are modeled; instruction words always come from the backing.
+ * Tags and LRU stamps live in flat arrays indexed by set * associativity
+ * + way, and a way's stamp is the value of a running counter at its last
+ * access, so the least recently used way is the one with the smallest
+ * stamp. Invalid ways have stamp 0 and are filled first.
+ *
+ * The number of sets and the line size must be powers of two; see
+ * validGeometry().
+ */
 class ICache
 {
 public:
-    /**
-     * bitrange_handle - A class to handle bitfields in a register.
-     */
-    template <typename INT>
-    struct bitrange_handle {
-    public:
-        typedef INT  value_type;
-        typedef INT& reference_type;
-
-        /**
-         * constructor
-         */
-        bitrange_handle(value_type &val, value_type hi, value_type lo)
-            :v_(val)
-            ,hi_(hi)
-            ,lo_(lo) {
-        }
-
-        /**
-         * destructor
-         */
-        ~bitrange_handle() = default;
-
-        /**
-         * move constructor
-         */
-        bitrange_handle(bitrange_handle &&o) = default;
-
-        /**
-         * move constructor
-         */
-        bitrange_handle(const bitrange_handle &o) = default;
-
-        /**
-         * move assignment operator
-         */
-        bitrange_handle &operator=(bitrange_handle &&o) {
-            setbits(o.getbits());
-            return *this;
-        }
-
-        /**
-         * copy assignment operator
-         */
-        bitrange_handle &operator=(const bitrange_handle &o) {
-            setbits(o.getbits());
-            return *this;
-        }
-
-
-        /**
-         * Conversion operator to an integer
-         */
-        operator value_type() const {
-            return getbits();
-        }
-
-        /**
-         * Assignment operator to an integer
-         */
-        bitrange_handle &operator=(value_type val) {
-            setbits(val);
-            return *this;
-        }
-
-        value_type lo()   const {
-            return lo_;
-        }
-
-        value_type hi() const {
-            return hi_;
-        }
-
-        const reference_type v() const {
-            return v_;
-        }
-
-        reference_type v() {
-            return v_;
-        }
-
-        value_type bits() const {
-            return hi_ - lo_ + 1;
-        }
-
-        value_type mask() const {
-            return ((1ull << bits()) - 1) << lo();
-        }
-
-        value_type getbits() const
-        {
-            return (v() & mask()) >> lo();
-        }
-
-        void setbits(value_type val)
-        {
-            v() &= ~mask();
-            v() |=  mask() & (val << lo());
-        }
-
-        reference_type v_;
-        value_type    hi_;
-        value_type    lo_;
-    };
-
+    static constexpr uint64_t INVALID_LINE = ~0ull; //!< tag of an empty way
 
     /**
-     * bitrange - A class to make bitrange_handle
+     * constructor
+     *
+     * @param icache_backing the program text
+     * @param instructions capacity in instructions
+     * @param associativity ways per set
+     * @param line_instructions instructions filled by one miss
      */
-    template <typename INT>
-    struct  bitrange {
-        typedef INT value_type;
-        bitrange(value_type hi, value_type lo) : hi_(hi), lo_(lo) {}
-        bitrange() : hi_(0), lo_(0) {}
-
-        bitrange_handle<value_type>
-        operator()(value_type &v) const {
-            return bitrange_handle<value_type>(v, hi_, lo_);
-        }
-
-        value_type hi() const {
-            return hi_;
-        }
-        value_type lo() const {
-            return lo_;
-        }
-        value_type hi_;
-        value_type lo_;
-    };
+    ICache(ICacheBacking* icache_backing, size_t instructions, size_t associativity, size_t line_instructions = 1)
+        : icache_backing_(icache_backing)
+        , associativity_(associativity)
+        , line_shift_(2 + log2(line_instructions))
+        , set_mask_(instructions / (associativity * line_instructions) - 1)
+        , tags_(instructions / line_instructions, INVALID_LINE)
+        , stamps_(instructions / line_instructions, 0) {
+    }
 
     /**
-     * Set - A class to represent a set in the cache.
+     * true if the cache can be built with this geometry
      */
-    class Set {
-    public:
-        Set(size_t associativity) : associativity_(associativity) {}
-
-        size_t search(Elf64_Addr tag) {
-            for (size_t w = 0; w < ways_.size(); w++) {
-                if (ways_[w] == tag) {
-                    return w;
-                }
-            }
-            return -1u;
-        }
-
-        bool find(Elf64_Addr tag) {
-            //std::cout << __PRETTY_FUNCTION__ << " finding : " << fmt_addr(tag) << std::endl;
-            size_t w = search(tag);
-            if (w == -1u) {
-                return false;
-            }
-            //std::cout << __PRETTY_FUNCTION__ << " found   : " << fmt_addr(tag) << ", way #" << w << std::endl;
-            // move the way to the front
-            auto way = ways_[w];
-            ways_.erase(ways_.begin() + w);
-            ways_.insert(ways_.begin(), way);
-            //std::cout << __PRETTY_FUNCTION__ << " updated : " << fmt_addr(tag) << std::endl;
-            return true;
-        }
-
-        void fetch(Elf64_Addr tag) {
-            if (ways_.size() == associativity_) {
-                ways_.pop_back();
-            }
-            ways_.insert(ways_.begin(), tag);
+    static bool validGeometry(size_t instructions, size_t associativity, size_t line_instructions) {
+        if (instructions == 0 || associativity == 0 || line_instructions == 0
+            || instructions % (associativity * line_instructions) != 0) {
+            return false;
         }
+        size_t sets = instructions / (associativity * line_instructions);
+        return isPow2(sets) && isPow2(line_instructions);
+    }
 
-    private:
-        std::vector<Elf64_Addr> ways_;
-        size_t associativity_;
-    };
-
-    /**
-     * constructor
-     */
-    ICache(ICacheBacking* icache_backing, size_t instructions, size_t associativity)
-        : icache_backing_(icache_backing)
-        , instructions_(instructions)
-        , associativity_(associativity) {
-        auto idx_bits = interp::clog2(instructions / associativity);
-        index_ = bitrange<Elf64_Addr>(idx_bits+02-1, 02);
-        tag_   = bitrange<Elf64_Addr>(63,   idx_bits+02);
-        cache_ = std::vector<Set>(sets(), Set(associativity));
+    size_t sets() const {
+        return set_mask_ + 1;
     }
 
-    size_t sets() {
-        return instructions_ / associativity_;
+    size_t lineInstructions() const {
+        return size_t(1) << (line_shift_ - 2);
     }
 
     /**
      * return (hit, data)
      */
     std::pair<bool, uint32_t> read(Elf64_Addr addr) {
-        //std::cout << __PRETTY_FUNCTION__ << " reading: " << fmt_addr(addr) << std::endl;
+        bool found = access(addr);
+        return {found, icache_backing_->read(addr)};
+    }
+
+    /**
+     * model a fetch without reading the backing; return hit
+     */
+    bool access(Elf64_Addr addr) {
         bool found = find(addr);
-        //std::cout << __PRETTY_FUNCTION__ << "    find:" << fmt_addr(addr) << ", " << fmt_bool(found) << std::endl;
         if (!found) {
             fetch(addr);
         }
-        //std::cout << __PRETTY_FUNCTION__ << "    read: " << fmt_addr(addr) << std::endl;
-        return {found, icache_backing_->read(addr)};
+        return found;
     }
 
     ICacheBacking* backing() {
         return icache_backing_;
     }
 
+    /**
+     * look up the line holding addr and mark it most recently used; return hit
+     */
     bool find(Elf64_Addr addr) {
-        Elf64_Addr index = index_(addr);
-        Elf64_Addr tag = tag_(addr);
-        auto & set = cache_[index];
-        return set.find(tag);
+        uint64_t line = addr >> line_shift_;
+        if (line == mru_line_) {
+            // already the most recently used line; its stamp is current
+            return true;
+        }
+        size_t base = (line & set_mask_) * associativity_;
+        for (size_t w = base; w < base + associativity_; w++) {
+            if (tags_[w] == line) {
+                stamps_[w] = ++clock_;
+                mru_line_ = line;
+                return true;
+            }
+        }
+        return false;
     }
 
+    /**
+     * fill the line holding addr, evicting the least recently used way of its set
+     */
     void fetch(Elf64_Addr addr) {
-        Elf64_Addr index = index_(addr);
-        Elf64_Addr tag = tag_(addr);
-        auto & set = cache_[index];
-        set.fetch(tag);
+        uint64_t line = addr >> line_shift_;
+        size_t base = (line & set_mask_) * associativity_;
+        size_t victim = base;
+        for (size_t w = base + 1; w < base + associativity_; w++) {
+            if (stamps_[w] < stamps_[victim]) {
+                victim = w;
+            }
+        }
+        tags_[victim] = line;
+        stamps_[victim] = ++clock_;
+        mru_line_ = line;
     }
 
 private:
+    static bool isPow2(size_t x) {
+        return x != 0 && (x & (x - 1)) == 0;
+    }
+
+    static uint64_t log2(size_t x) {
+        uint64_t n = 0;
+        while ((size_t(1) << n) < x) {
+            n++;
+        }
+        return n;
+    }
+
     ICacheBacking* icache_backing_;
-    bitrange<Elf64_Addr> index_;
-    bitrange<Elf64_Addr> tag_;
-    size_t associativity_;
-    size_t instructions_;
-    std::vector<Set> cache_;
+    size_t associativity_; //!< ways per set
+    uint64_t line_shift_; //!< log2 of the line size in bytes
+    uint64_t set_mask_; //!< sets - 1
+    std::vector<uint64_t> tags_; //!< line number held by each way, or INVALID_LINE
+    std::vector<uint64_t> stamps_; //!< clock_ at each way's last access
+    uint64_t clock_ = 0; //!< bumped on every access that changes the LRU order
+    uint64_t mru_line_ = INVALID_LINE; //!< the most recently accessed line
 };
 #endif
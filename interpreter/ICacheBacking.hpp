@@ -11,6 +11,7 @@
 #include <unistd.h>
 #include <sys/mman.h>
 #include <cstdint>
+#include <cstring>
 #include <sstream>
 #include <iomanip>
 #include <vector>
@@ -54,6 +55,7 @@ public:
         pr_debug("opened %s @ %p: %d sections\n", file, ehdr(), ehdr()->e_shnum);
         findTextPhdrs();
         pr_debug("found %zu text phdrs\n", text_phdrs_.size());
+        flattenText();
         printEIdent();
         //printSectionsInfo();
         printProgramHeaders();
@@ -112,7 +114,43 @@ public:
         });
     }
 
-    Elf64_Phdr *findTextPhdr(Elf64_Addr addr) {
+    static constexpr uint64_t MAX_FLAT_TEXT = 256ull << 20; //!< largest text span copied into text_
+
+    /**
+     * copy the text segments into one array indexed by addr - textBase()
+     *
+     * skipped if the segments span more than MAX_FLAT_TEXT bytes
+     */
+    void flattenText() {
+        if (text_phdrs_.empty()) {
+            return;
+        }
+        Elf64_Addr lo = text_phdrs_.front()->p_vaddr;
+        Elf64_Addr hi = lo;
+        for (auto ph : text_phdrs_) {
+            hi = std::max(hi, ph->p_vaddr + ph->p_memsz);
+        }
+        if (hi - lo > MAX_FLAT_TEXT) {
+            return;
+        }
+        text_base_ = lo;
+        text_.assign(hi - lo, 0);
+        for (auto ph : text_phdrs_) {
+            memcpy(&text_[ph->p_vaddr - lo], data_ + ph->p_offset, ph->p_filesz);
+        }
+    }
+
+    /**
+     * first address of the flattened text
+     */
+    Elf64_Addr textBase() const { return text_base_; }
+
+    /**
+     * bytes of flattened text; 0 if the text was not flattened
+     */
+    uint64_t textSize() const { return text_.size(); }
+
+    Elf64_Phdr *findTextPhdr(Elf64_Addr addr) const {
         if (text_phdrs_.empty()) {
             return nullptr;
         }
@@ -125,7 +163,18 @@ public:
         return nullptr;
     }
 
-    uint32_t read(Elf64_Addr addr) {
+    uint32_t read(Elf64_Addr addr) const {
+        uint64_t offset = addr - text_base_;
+        if (offset < text_.size()) {
+            // a compressed instruction may end the text with only a halfword left
+            uint32_t word = 0;
+            memcpy(&word, &text_[offset], std::min<uint64_t>(sizeof(word), text_.size() - offset));
+            return word;
+        }
+        return readSegment(addr);
+    }
+
+    uint32_t readSegment(Elf64_Addr addr) const {
         auto ph = findTextPhdr(addr);
         if (ph == nullptr) {
             pr_info("no text phdr for addr %016lx\n", addr);
@@ -269,5 +318,7 @@ public:
     uint8_t  *data_;    
     int       fd_;
     std::vector<Elf64_Phdr*> text_phdrs_;
+    Elf64_Addr text_base_ = 0; //!< address of text_[0]
+    std::vector<uint8_t> text_; //!< text segments, flattened
 };
 #endif
@@ -28,8 +28,9 @@
 #ifndef R4TYPE_MASK
 #define R4TYPE_MASK     0x0600707f
 #endif
+// RV64 shift immediates: the six-bit shamt is free, funct6 is fixed
 #ifndef SHIFT64TYPE_MASK
-#define SHIFT64TYPE_MASK 0x4000707f
+#define SHIFT64TYPE_MASK 0xfc00707f
 #endif
 #ifndef CASTYPE_MASK
 #define CASTYPE_MASK    0x0600707f
@@ -41,6 +42,19 @@
 #define FTYPE_MASK      0xfff0707f 
 #endif
 
+// vector arithmetic: funct6 and funct3 select the operation, vm is free
+#ifndef VTYPE_MASK
+#define VTYPE_MASK      0xfc00707f
+#endif
+// vector unit-stride loads and stores: nf, mew, mop and lumop/sumop are fixed
+#ifndef VMEMUNIT_MASK
+#define VMEMUNIT_MASK   0xfdf0707f
+#endif
+// vector strided and indexed loads and stores: nf, mew and mop are fixed
+#ifndef VMEM_MASK
+#define VMEM_MASK       0xfc00707f
+#endif
+
 #ifndef RTYPE_INSTR_VALUE
 #define RTYPE_INSTR_VALUE(opcode, funct3, funct7)       \
   ((opcode << 0) | (funct3 << 12) | (funct7 << 25))
@@ -91,6 +105,16 @@
     R4TYPE_INSTR_VALUE(opcode, funct3, funct2)
 #endif
 
+#ifndef VTYPE_INSTR_VALUE
+#define VTYPE_INSTR_VALUE(opcode, funct3, funct6)       \
+  ((opcode << 0) | (funct3 << 12) | (funct6 << 26))
+#endif
+
+#ifndef VMEM_INSTR_VALUE
+#define VMEM_INSTR_VALUE(opcode, width, mop)            \
+  ((opcode << 0) | (width << 12) | (mop << 26))
+#endif
+
 /* DEFINSTR(mnemonic, value_under_mask, mask) */
 #include <RISCVRegisterIndices.h>
 
@@ -336,6 +360,10 @@ DEFINSTR(AMOCASD_RL, CASTYPE_INSTR_VALUE(0x2b, 3, 1), CASTYPE_MASK, _RS1_|_RS2_|
 DEFINSTR(AMOCASD_AQ, CASTYPE_INSTR_VALUE(0x2b, 3, 2), CASTYPE_MASK, _RS1_|_RS2_|_RS3_|_RD_)
 DEFINSTR(AMOCASD_RL_AQ, CASTYPE_INSTR_VALUE(0x2b, 3, 3), CASTYPE_MASK, _RS1_|_RS2_|_RS3_|_RD_)
 
+/* PANDO extension: floating point fetch-and-add; rs2 holds the float/double bits */
+DEFINSTR(AMOFADDW, RTYPE_INSTR_VALUE(0x2b, 6, 0), RTYPE_MASK, _RS1_|_RS2_|_RD_)
+DEFINSTR(AMOFADDD, RTYPE_INSTR_VALUE(0x2b, 7, 0), RTYPE_MASK, _RS1_|_RS2_|_RD_)
+
 /*********/
 /* RV32F */
 /*********/
@@ -646,3 +674,265 @@ DEFINSTR(FCVT_D_LU_RMM, FTYPE_INSTR_VALUE(0x53, FP_RMM, 105, 3), FTYPE_MASK, _FR
 DEFINSTR(FCVT_D_LU_DYN, FTYPE_INSTR_VALUE(0x53, FP_DYN, 105, 3), FTYPE_MASK, _FRD_|_RS1_)
 
 DEFINSTR(FMV_D_X, FTYPE_INSTR_VALUE(0x53, 0, 121, 0), FTYPE_MASK, _FRD_|_RS1_)
+
+/**********/
+/* Zve64d */
+/**********/
+
+// configuration
+DEFINSTR(VSETVLI,  0x00007057, 0x8000707f, _RD_|_RS1_)
+DEFINSTR(VSETIVLI, 0xc0007057, 0xc000707f, _RD_)
+DEFINSTR(VSETVL,   0x80007057, 0xfe00707f, _RD_|_RS1_|_RS2_)
+
+// unit-stride, strided and indexed loads and stores; width selects the element size
+DEFINSTR(VLE8_V,     VMEM_INSTR_VALUE(0x07, 0, 0), VMEMUNIT_MASK, _RS1_)
+DEFINSTR(VLE16_V,    VMEM_INSTR_VALUE(0x07, 5, 0), VMEMUNIT_MASK, _RS1_)
+DEFINSTR(VLE32_V,    VMEM_INSTR_VALUE(0x07, 6, 0), VMEMUNIT_MASK, _RS1_)
+DEFINSTR(VLE64_V,    VMEM_INSTR_VALUE(0x07, 7, 0), VMEMUNIT_MASK, _RS1_)
+
+DEFINSTR(VSE8_V,     VMEM_INSTR_VALUE(0x27, 0, 0), VMEMUNIT_MASK, _RS1_)
+DEFINSTR(VSE16_V,    VMEM_INSTR_VALUE(0x27, 5, 0), VMEMUNIT_MASK, _RS1_)
+DEFINSTR(VSE32_V,    VMEM_INSTR_VALUE(0x27, 6, 0), VMEMUNIT_MASK, _RS1_)
+DEFINSTR(VSE64_V,    VMEM_INSTR_VALUE(0x27, 7, 0), VMEMUNIT_MASK, _RS1_)
+
+DEFINSTR(VLSE8_V,    VMEM_INSTR_VALUE(0x07, 0, 2), VMEM_MASK, _RS1_|_RS2_)
+DEFINSTR(VLSE16_V,   VMEM_INSTR_VALUE(0x07, 5, 2), VMEM_MASK, _RS1_|_RS2_)
+DEFINSTR(VLSE32_V,   VMEM_INSTR_VALUE(0x07, 6, 2), VMEM_MASK, _RS1_|_RS2_)
+DEFINSTR(VLSE64_V,   VMEM_INSTR_VALUE(0x07, 7, 2), VMEM_MASK, _RS1_|_RS2_)
+
+DEFINSTR(VSSE8_V,    VMEM_INSTR_VALUE(0x27, 0, 2), VMEM_MASK, _RS1_|_RS2_)
+DEFINSTR(VSSE16_V,   VMEM_INSTR_VALUE(0x27, 5, 2), VMEM_MASK, _RS1_|_RS2_)
+DEFINSTR(VSSE32_V,   VMEM_INSTR_VALUE(0x27, 6, 2), VMEM_MASK, _RS1_|_RS2_)
+DEFINSTR(VSSE64_V,   VMEM_INSTR_VALUE(0x27, 7, 2), VMEM_MASK, _RS1_|_RS2_)
+
+DEFINSTR(VLUXEI8_V,  VMEM_INSTR_VALUE(0x07, 0, 1), VMEM_MASK, _RS1_)
+DEFINSTR(VLUXEI16_V, VMEM_INSTR_VALUE(0x07, 5, 1), VMEM_MASK, _RS1_)
+DEFINSTR(VLUXEI32_V, VMEM_INSTR_VALUE(0x07, 6, 1), VMEM_MASK, _RS1_)
+DEFINSTR(VLUXEI64_V, VMEM_INSTR_VALUE(0x07, 7, 1), VMEM_MASK, _RS1_)
+
+DEFINSTR(VLOXEI8_V,  VMEM_INSTR_VALUE(0x07, 0, 3), VMEM_MASK, _RS1_)
+DEFINSTR(VLOXEI16_V, VMEM_INSTR_VALUE(0x07, 5, 3), VMEM_MASK, _RS1_)
+DEFINSTR(VLOXEI32_V, VMEM_INSTR_VALUE(0x07, 6, 3), VMEM_MASK, _RS1_)
+DEFINSTR(VLOXEI64_V, VMEM_INSTR_VALUE(0x07, 7, 3), VMEM_MASK, _RS1_)
+
+DEFINSTR(VSUXEI8_V,  VMEM_INSTR_VALUE(0x27, 0, 1), VMEM_MASK, _RS1_)
+DEFINSTR(VSUXEI16_V, VMEM_INSTR_VALUE(0x27, 5, 1), VMEM_MASK, _RS1_)
+DEFINSTR(VSUXEI32_V, VMEM_INSTR_VALUE(0x27, 6, 1), VMEM_MASK, _RS1_)
+DEFINSTR(VSUXEI64_V, VMEM_INSTR_VALUE(0x27, 7, 1), VMEM_MASK, _RS1_)
+
+DEFINSTR(VSOXEI8_V,  VMEM_INSTR_VALUE(0x27, 0, 3), VMEM_MASK, _RS1_)
+DEFINSTR(VSOXEI16_V, VMEM_INSTR_VALUE(0x27, 5, 3), VMEM_MASK, _RS1_)
+DEFINSTR(VSOXEI32_V, VMEM_INSTR_VALUE(0x27, 6, 3), VMEM_MASK, _RS1_)
+DEFINSTR(VSOXEI64_V, VMEM_INSTR_VALUE(0x27, 7, 3), VMEM_MASK, _RS1_)
+
+// integer arithmetic
+DEFINSTR(VADD_VV,       VTYPE_INSTR_VALUE(0x57, 0, 0x00), VTYPE_MASK, 0)
+DEFINSTR(VADD_VX,       VTYPE_INSTR_VALUE(0x57, 4, 0x00), VTYPE_MASK, _RS1_)
+DEFINSTR(VADD_VI,       VTYPE_INSTR_VALUE(0x57, 3, 0x00), VTYPE_MASK, 0)
+DEFINSTR(VSUB_VV,       VTYPE_INSTR_VALUE(0x57, 0, 0x02), VTYPE_MASK, 0)
+DEFINSTR(VSUB_VX,       VTYPE_INSTR_VALUE(0x57, 4, 0x02), VTYPE_MASK, _RS1_)
+DEFINSTR(VRSUB_VX,      VTYPE_INSTR_VALUE(0x57, 4, 0x03), VTYPE_MASK, _RS1_)
+DEFINSTR(VRSUB_VI,      VTYPE_INSTR_VALUE(0x57, 3, 0x03), VTYPE_MASK, 0)
+DEFINSTR(VMINU_VV,      VTYPE_INSTR_VALUE(0x57, 0, 0x04), VTYPE_MASK, 0)
+DEFINSTR(VMINU_VX,      VTYPE_INSTR_VALUE(0x57, 4, 0x04), VTYPE_MASK, _RS1_)
+DEFINSTR(VMIN_VV,       VTYPE_INSTR_VALUE(0x57, 0, 0x05), VTYPE_MASK, 0)
+DEFINSTR(VMIN_VX,       VTYPE_INSTR_VALUE(0x57, 4, 0x05), VTYPE_MASK, _RS1_)
+DEFINSTR(VMAXU_VV,      VTYPE_INSTR_VALUE(0x57, 0, 0x06), VTYPE_MASK, 0)
+DEFINSTR(VMAXU_VX,      VTYPE_INSTR_VALUE(0x57, 4, 0x06), VTYPE_MASK, _RS1_)
+DEFINSTR(VMAX_VV,       VTYPE_INSTR_VALUE(0x57, 0, 0x07), VTYPE_MASK, 0)
+DEFINSTR(VMAX_VX,       VTYPE_INSTR_VALUE(0x57, 4, 0x07), VTYPE_MASK, _RS1_)
+DEFINSTR(VAND_VV,       VTYPE_INSTR_VALUE(0x57, 0, 0x09), VTYPE_MASK, 0)
+DEFINSTR(VAND_VX,       VTYPE_INSTR_VALUE(0x57, 4, 0x09), VTYPE_MASK, _RS1_)
+DEFINSTR(VAND_VI,       VTYPE_INSTR_VALUE(0x57, 3, 0x09), VTYPE_MASK, 0)
+DEFINSTR(VOR_VV,        VTYPE_INSTR_VALUE(0x57, 0, 0x0a), VTYPE_MASK, 0)
+DEFINSTR(VOR_VX,        VTYPE_INSTR_VALUE(0x57, 4, 0x0a), VTYPE_MASK, _RS1_)
+DEFINSTR(VOR_VI,        VTYPE_INSTR_VALUE(0x57, 3, 0x0a), VTYPE_MASK, 0)
+DEFINSTR(VXOR_VV,       VTYPE_INSTR_VALUE(0x57, 0, 0x0b), VTYPE_MASK, 0)
+DEFINSTR(VXOR_VX,       VTYPE_INSTR_VALUE(0x57, 4, 0x0b), VTYPE_MASK, _RS1_)
+DEFINSTR(VXOR_VI,       VTYPE_INSTR_VALUE(0x57, 3, 0x0b), VTYPE_MASK, 0)
+// vm=0 merges under v0; vm=1 is vmv.v.v, vmv.v.x and vmv.v.i
+DEFINSTR(VMERGE_VVM,    VTYPE_INSTR_VALUE(0x57, 0, 0x17), VTYPE_MASK, 0)
+DEFINSTR(VMERGE_VXM,    VTYPE_INSTR_VALUE(0x57, 4, 0x17), VTYPE_MASK, _RS1_)
+DEFINSTR(VMERGE_VIM,    VTYPE_INSTR_VALUE(0x57, 3, 0x17), VTYPE_MASK, 0)
+DEFINSTR(VMSEQ_VV,      VTYPE_INSTR_VALUE(0x57, 0, 0x18), VTYPE_MASK, 0)
+DEFINSTR(VMSEQ_VX,      VTYPE_INSTR_VALUE(0x57, 4, 0x18), VTYPE_MASK, _RS1_)
+DEFINSTR(VMSEQ_VI,      VTYPE_INSTR_VALUE(0x57, 3, 0x18), VTYPE_MASK, 0)
+DEFINSTR(VMSNE_VV,      VTYPE_INSTR_VALUE(0x57, 0, 0x19), VTYPE_MASK, 0)
+DEFINSTR(VMSNE_VX,      VTYPE_INSTR_VALUE(0x57, 4, 0x19), VTYPE_MASK, _RS1_)
+DEFINSTR(VMSNE_VI,      VTYPE_INSTR_VALUE(0x57, 3, 0x19), VTYPE_MASK, 0)
+DEFINSTR(VMSLTU_VV,     VTYPE_INSTR_VALUE(0x57, 0, 0x1a), VTYPE_MASK, 0)
+DEFINSTR(VMSLTU_VX,     VTYPE_INSTR_VALUE(0x57, 4, 0x1a), VTYPE_MASK, _RS1_)
+DEFINSTR(VMSLT_VV,      VTYPE_INSTR_VALUE(0x57, 0, 0x1b), VTYPE_MASK, 0)
+DEFINSTR(VMSLT_VX,      VTYPE_INSTR_VALUE(0x57, 4, 0x1b), VTYPE_MASK, _RS1_)
+DEFINSTR(VMSLEU_VV,     VTYPE_INSTR_VALUE(0x57, 0, 0x1c), VTYPE_MASK, 0)
+DEFINSTR(VMSLEU_VX,     VTYPE_INSTR_VALUE(0x57, 4, 0x1c), VTYPE_MASK, _RS1_)
+DEFINSTR(VMSLEU_VI,     VTYPE_INSTR_VALUE(0x57, 3, 0x1c), VTYPE_MASK, 0)
+DEFINSTR(VMSLE_VV,      VTYPE_INSTR_VALUE(0x57, 0, 0x1d), VTYPE_MASK, 0)
+DEFINSTR(VMSLE_VX,      VTYPE_INSTR_VALUE(0x57, 4, 0x1d), VTYPE_MASK, _RS1_)
+DEFINSTR(VMSLE_VI,      VTYPE_INSTR_VALUE(0x57, 3, 0x1d), VTYPE_MASK, 0)
+DEFINSTR(VMSGTU_VX,     VTYPE_INSTR_VALUE(0x57, 4, 0x1e), VTYPE_MASK, _RS1_)
+DEFINSTR(VMSGTU_VI,     VTYPE_INSTR_VALUE(0x57, 3, 0x1e), VTYPE_MASK, 0)
+DEFINSTR(VMSGT_VX,      VTYPE_INSTR_VALUE(0x57, 4, 0x1f), VTYPE_MASK, _RS1_)
+DEFINSTR(VMSGT_VI,      VTYPE_INSTR_VALUE(0x57, 3, 0x1f), VTYPE_MASK, 0)
+DEFINSTR(VSLL_VV,       VTYPE_INSTR_VALUE(0x57, 0, 0x25), VTYPE_MASK, 0)
+DEFINSTR(VSLL_VX,       VTYPE_INSTR_VALUE(0x57, 4, 0x25), VTYPE_MASK, _RS1_)
+DEFINSTR(VSLL_VI,       VTYPE_INSTR_VALUE(0x57, 3, 0x25), VTYPE_MASK, 0)
+DEFINSTR(VSRL_VV,       VTYPE_INSTR_VALUE(0x57, 0, 0x28), VTYPE_MASK, 0)
+DEFINSTR(VSRL_VX,       VTYPE_INSTR_VALUE(0x57, 4, 0x28), VTYPE_MASK, _RS1_)
+DEFINSTR(VSRL_VI,       VTYPE_INSTR_VALUE(0x57, 3, 0x28), VTYPE_MASK, 0)
+DEFINSTR(VSRA_VV,       VTYPE_INSTR_VALUE(0x57, 0, 0x29), VTYPE_MASK, 0)
+DEFINSTR(VSRA_VX,       VTYPE_INSTR_VALUE(0x57, 4, 0x29), VTYPE_MASK, _RS1_)
+DEFINSTR(VSRA_VI,       VTYPE_INSTR_VALUE(0x57, 3, 0x29), VTYPE_MASK, 0)
+
+// reductions, moves and mask instructions
+DEFINSTR(VREDSUM_VS,    VTYPE_INSTR_VALUE(0x57, 2, 0x00), VTYPE_MASK, 0)
+DEFINSTR(VREDAND_VS,    VTYPE_INSTR_VALUE(0x57, 2, 0x01), VTYPE_MASK, 0)
+DEFINSTR(VREDOR_VS,     VTYPE_INSTR_VALUE(0x57, 2, 0x02), VTYPE_MASK, 0)
+DEFINSTR(VREDXOR_VS,    VTYPE_INSTR_VALUE(0x57, 2, 0x03), VTYPE_MASK, 0)
+DEFINSTR(VREDMINU_VS,   VTYPE_INSTR_VALUE(0x57, 2, 0x04), VTYPE_MASK, 0)
+DEFINSTR(VREDMIN_VS,    VTYPE_INSTR_VALUE(0x57, 2, 0x05), VTYPE_MASK, 0)
+DEFINSTR(VREDMAXU_VS,   VTYPE_INSTR_VALUE(0x57, 2, 0x06), VTYPE_MASK, 0)
+DEFINSTR(VREDMAX_VS,    VTYPE_INSTR_VALUE(0x57, 2, 0x07), VTYPE_MASK, 0)
+// vmv.x.s, vcpop.m and vfirst.m, selected by vs1
+DEFINSTR(VWXUNARY0,     VTYPE_INSTR_VALUE(0x57, 2, 0x10), VTYPE_MASK, _RD_)
+DEFINSTR(VMV_S_X,      VTYPE_INSTR_VALUE(0x57, 6, 0x10) | (1 << 25), 0xfff0707f, _RS1_)
+// viota.m and vid.v, selected by vs1
+DEFINSTR(VMUNARY0,      VTYPE_INSTR_VALUE(0x57, 2, 0x14), VTYPE_MASK, 0)
+DEFINSTR(VMANDN_MM,     VTYPE_INSTR_VALUE(0x57, 2, 0x18), VTYPE_MASK, 0)
+DEFINSTR(VMAND_MM,      VTYPE_INSTR_VALUE(0x57, 2, 0x19), VTYPE_MASK, 0)
+DEFINSTR(VMOR_MM,       VTYPE_INSTR_VALUE(0x57, 2, 0x1a), VTYPE_MASK, 0)
+DEFINSTR(VMXOR_MM,      VTYPE_INSTR_VALUE(0x57, 2, 0x1b), VTYPE_MASK, 0)
+DEFINSTR(VMORN_MM,      VTYPE_INSTR_VALUE(0x57, 2, 0x1c), VTYPE_MASK, 0)
+DEFINSTR(VMNAND_MM,     VTYPE_INSTR_VALUE(0x57, 2, 0x1d), VTYPE_MASK, 0)
+DEFINSTR(VMNOR_MM,      VTYPE_INSTR_VALUE(0x57, 2, 0x1e), VTYPE_MASK, 0)
+DEFINSTR(VMXNOR_MM,     VTYPE_INSTR_VALUE(0x57, 2, 0x1f), VTYPE_MASK, 0)
+
+// integer multiply, divide and multiply-add
+DEFINSTR(VDIVU_VV,      VTYPE_INSTR_VALUE(0x57, 2, 0x20), VTYPE_MASK, 0)
+DEFINSTR(VDIVU_VX,      VTYPE_INSTR_VALUE(0x57, 6, 0x20), VTYPE_MASK, _RS1_)
+DEFINSTR(VDIV_VV,       VTYPE_INSTR_VALUE(0x57, 2, 0x21), VTYPE_MASK, 0)
+DEFINSTR(VDIV_VX,       VTYPE_INSTR_VALUE(0x57, 6, 0x21), VTYPE_MASK, _RS1_)
+DEFINSTR(VREMU_VV,      VTYPE_INSTR_VALUE(0x57, 2, 0x22), VTYPE_MASK, 0)
+DEFINSTR(VREMU_VX,      VTYPE_INSTR_VALUE(0x57, 6, 0x22), VTYPE_MASK, _RS1_)
+DEFINSTR(VREM_VV,       VTYPE_INSTR_VALUE(0x57, 2, 0x23), VTYPE_MASK, 0)
+DEFINSTR(VREM_VX,       VTYPE_INSTR_VALUE(0x57, 6, 0x23), VTYPE_MASK, _RS1_)
+DEFINSTR(VMULHU_VV,     VTYPE_INSTR_VALUE(0x57, 2, 0x24), VTYPE_MASK, 0)
+DEFINSTR(VMULHU_VX,     VTYPE_INSTR_VALUE(0x57, 6, 0x24), VTYPE_MASK, _RS1_)
+DEFINSTR(VMUL_VV,       VTYPE_INSTR_VALUE(0x57, 2, 0x25), VTYPE_MASK, 0)
+DEFINSTR(VMUL_VX,       VTYPE_INSTR_VALUE(0x57, 6, 0x25), VTYPE_MASK, _RS1_)
+DEFINSTR(VMULHSU_VV,    VTYPE_INSTR_VALUE(0x57, 2, 0x26), VTYPE_MASK, 0)
+DEFINSTR(VMULHSU_VX,    VTYPE_INSTR_VALUE(0x57, 6, 0x26), VTYPE_MASK, _RS1_)
+DEFINSTR(VMULH_VV,      VTYPE_INSTR_VALUE(0x57, 2, 0x27), VTYPE_MASK, 0)
+DEFINSTR(VMULH_VX,      VTYPE_INSTR_VALUE(0x57, 6, 0x27), VTYPE_MASK, _RS1_)
+DEFINSTR(VMADD_VV,      VTYPE_INSTR_VALUE(0x57, 2, 0x29), VTYPE_MASK, 0)
+DEFINSTR(VMADD_VX,      VTYPE_INSTR_VALUE(0x57, 6, 0x29), VTYPE_MASK, _RS1_)
+DEFINSTR(VNMSUB_VV,     VTYPE_INSTR_VALUE(0x57, 2, 0x2b), VTYPE_MASK, 0)
+DEFINSTR(VNMSUB_VX,     VTYPE_INSTR_VALUE(0x57, 6, 0x2b), VTYPE_MASK, _RS1_)
+DEFINSTR(VMACC_VV,      VTYPE_INSTR_VALUE(0x57, 2, 0x2d), VTYPE_MASK, 0)
+DEFINSTR(VMACC_VX,      VTYPE_INSTR_VALUE(0x57, 6, 0x2d), VTYPE_MASK, _RS1_)
+DEFINSTR(VNMSAC_VV,     VTYPE_INSTR_VALUE(0x57, 2, 0x2f), VTYPE_MASK, 0)
+DEFINSTR(VNMSAC_VX,     VTYPE_INSTR_VALUE(0x57, 6, 0x2f), VTYPE_MASK, _RS1_)
+
+// floating point
+DEFINSTR(VFADD_VV,      VTYPE_INSTR_VALUE(0x57, 1, 0x00), VTYPE_MASK, 0)
+DEFINSTR(VFADD_VF,      VTYPE_INSTR_VALUE(0x57, 5, 0x00), VTYPE_MASK, _FRS1_)
+DEFINSTR(VFSUB_VV,      VTYPE_INSTR_VALUE(0x57, 1, 0x02), VTYPE_MASK, 0)
+DEFINSTR(VFSUB_VF,      VTYPE_INSTR_VALUE(0x57, 5, 0x02), VTYPE_MASK, _FRS1_)
+DEFINSTR(VFMIN_VV,      VTYPE_INSTR_VALUE(0x57, 1, 0x04), VTYPE_MASK, 0)
+DEFINSTR(VFMIN_VF,      VTYPE_INSTR_VALUE(0x57, 5, 0x04), VTYPE_MASK, _FRS1_)
+DEFINSTR(VFMAX_VV,      VTYPE_INSTR_VALUE(0x57, 1, 0x06), VTYPE_MASK, 0)
+DEFINSTR(VFMAX_VF,      VTYPE_INSTR_VALUE(0x57, 5, 0x06), VTYPE_MASK, _FRS1_)
+DEFINSTR(VFSGNJ_VV,     VTYPE_INSTR_VALUE(0x57, 1, 0x08), VTYPE_MASK, 0)
+DEFINSTR(VFSGNJ_VF,     VTYPE_INSTR_VALUE(0x57, 5, 0x08), VTYPE_MASK, _FRS1_)
+DEFINSTR(VFSGNJN_VV,    VTYPE_INSTR_VALUE(0x57, 1, 0x09), VTYPE_MASK, 0)
+DEFINSTR(VFSGNJN_VF,    VTYPE_INSTR_VALUE(0x57, 5, 0x09), VTYPE_MASK, _FRS1_)
+DEFINSTR(VFSGNJX_VV,    VTYPE_INSTR_VALUE(0x57, 1, 0x0a), VTYPE_MASK, 0)
+DEFINSTR(VFSGNJX_VF,    VTYPE_INSTR_VALUE(0x57, 5, 0x0a), VTYPE_MASK, _FRS1_)
+DEFINSTR(VFREDUSUM_VS,  VTYPE_INSTR_VALUE(0x57, 1, 0x01), VTYPE_MASK, 0)
+DEFINSTR(VFREDOSUM_VS,  VTYPE_INSTR_VALUE(0x57, 1, 0x03), VTYPE_MASK, 0)
+DEFINSTR(VFREDMIN_VS,   VTYPE_INSTR_VALUE(0x57, 1, 0x05), VTYPE_MASK, 0)
+DEFINSTR(VFREDMAX_VS,   VTYPE_INSTR_VALUE(0x57, 1, 0x07), VTYPE_MASK, 0)
+// vfmv.f.s; vs1 must be 0
+DEFINSTR(VWFUNARY0,     VTYPE_INSTR_VALUE(0x57, 1, 0x10), VTYPE_MASK, _FRD_)
+DEFINSTR(VFMV_S_F,     VTYPE_INSTR_VALUE(0x57, 5, 0x10) | (1 << 25), 0xfff0707f, _FRS1_)
+// vm=0 merges under v0; vm=1 is vfmv.v.f
+DEFINSTR(VFMERGE_VFM,   VTYPE_INSTR_VALUE(0x57, 5, 0x17), VTYPE_MASK, _FRS1_)
+DEFINSTR(VMFEQ_VV,      VTYPE_INSTR_VALUE(0x57, 1, 0x18), VTYPE_MASK, 0)
+DEFINSTR(VMFEQ_VF,      VTYPE_INSTR_VALUE(0x57, 5, 0x18), VTYPE_MASK, _FRS1_)
+DEFINSTR(VMFLE_VV,      VTYPE_INSTR_VALUE(0x57, 1, 0x19), VTYPE_MASK, 0)
+DEFINSTR(VMFLE_VF,      VTYPE_INSTR_VALUE(0x57, 5, 0x19), VTYPE_MASK, _FRS1_)
+DEFINSTR(VMFLT_VV,      VTYPE_INSTR_VALUE(0x57, 1, 0x1b), VTYPE_MASK, 0)
+DEFINSTR(VMFLT_VF,      VTYPE_INSTR_VALUE(0x57, 5, 0x1b), VTYPE_MASK, _FRS1_)
+DEFINSTR(VMFNE_VV,      VTYPE_INSTR_VALUE(0x57, 1, 0x1c), VTYPE_MASK, 0)
+DEFINSTR(VMFNE_VF,      VTYPE_INSTR_VALUE(0x57, 5, 0x1c), VTYPE_MASK, _FRS1_)
+DEFINSTR(VMFGT_VF,      VTYPE_INSTR_VALUE(0x57, 5, 0x1d), VTYPE_MASK, _FRS1_)
+DEFINSTR(VMFGE_VF,      VTYPE_INSTR_VALUE(0x57, 5, 0x1f), VTYPE_MASK, _FRS1_)
+DEFINSTR(VFDIV_VV,      VTYPE_INSTR_VALUE(0x57, 1, 0x20), VTYPE_MASK, 0)
+DEFINSTR(VFDIV_VF,      VTYPE_INSTR_VALUE(0x57, 5, 0x20), VTYPE_MASK, _FRS1_)
+DEFINSTR(VFRDIV_VF,     VTYPE_INSTR_VALUE(0x57, 5, 0x21), VTYPE_MASK, _FRS1_)
+DEFINSTR(VFMUL_VV,      VTYPE_INSTR_VALUE(0x57, 1, 0x24), VTYPE_MASK, 0)
+DEFINSTR(VFMUL_VF,      VTYPE_INSTR_VALUE(0x57, 5, 0x24), VTYPE_MASK, _FRS1_)
+DEFINSTR(VFRSUB_VF,     VTYPE_INSTR_VALUE(0x57, 5, 0x27), VTYPE_MASK, _FRS1_)
+DEFINSTR(VFMADD_VV,     VTYPE_INSTR_VALUE(0x57, 1, 0x28), VTYPE_MASK, 0)
+DEFINSTR(VFMADD_VF,     VTYPE_INSTR_VALUE(0x57, 5, 0x28), VTYPE_MASK, _FRS1_)
+DEFINSTR(VFNMADD_VV,    VTYPE_INSTR_VALUE(0x57, 1, 0x29), VTYPE_MASK, 0)
+DEFINSTR(VFNMADD_VF,    VTYPE_INSTR_VALUE(0x57, 5, 0x29), VTYPE_MASK, _FRS1_)
+DEFINSTR(VFMSUB_VV,     VTYPE_INSTR_VALUE(0x57, 1, 0x2a), VTYPE_MASK, 0)
+DEFINSTR(VFMSUB_VF,     VTYPE_INSTR_VALUE(0x57, 5, 0x2a), VTYPE_MASK, _FRS1_)
+DEFINSTR(VFNMSUB_VV,    VTYPE_INSTR_VALUE(0x57, 1, 0x2b), VTYPE_MASK, 0)
+DEFINSTR(VFNMSUB_VF,    VTYPE_INSTR_VALUE(0x57, 5, 0x2b), VTYPE_MASK, _FRS1_)
+DEFINSTR(VFMACC_VV,     VTYPE_INSTR_VALUE(0x57, 1, 0x2c), VTYPE_MASK, 0)
+DEFINSTR(VFMACC_VF,     VTYPE_INSTR_VALUE(0x57, 5, 0x2c), VTYPE_MASK, _FRS1_)
+DEFINSTR(VFNMACC_VV,    VTYPE_INSTR_VALUE(0x57, 1, 0x2d), VTYPE_MASK, 0)
+DEFINSTR(VFNMACC_VF,    VTYPE_INSTR_VALUE(0x57, 5, 0x2d), VTYPE_MASK, _FRS1_)
+DEFINSTR(VFMSAC_VV,     VTYPE_INSTR_VALUE(0x57, 1, 0x2e), VTYPE_MASK, 0)
+DEFINSTR(VFMSAC_VF,     VTYPE_INSTR_VALUE(0x57, 5, 0x2e), VTYPE_MASK, _FRS1_)
+DEFINSTR(VFNMSAC_VV,    VTYPE_INSTR_VALUE(0x57, 1, 0x2f), VTYPE_MASK, 0)
+DEFINSTR(VFNMSAC_VF,    VTYPE_INSTR_VALUE(0x57, 5, 0x2f), VTYPE_MASK, _FRS1_)
+
+/***************/
+/* Zba Zbb Zbs */
+/***************/
+// shift immediates reuse SHIFT64TYPE_MASK: funct6 sits in bits 31:26 as funct7 >> 1
+DEFINSTR(ADD_UW,    RTYPE_INSTR_VALUE(0x3b, 0, 0x04), RTYPE_MASK, _RS1_|_RS2_|_RD_)
+DEFINSTR(SH1ADD,    RTYPE_INSTR_VALUE(0x33, 2, 0x10), RTYPE_MASK, _RS1_|_RS2_|_RD_)
+DEFINSTR(SH2ADD,    RTYPE_INSTR_VALUE(0x33, 4, 0x10), RTYPE_MASK, _RS1_|_RS2_|_RD_)
+DEFINSTR(SH3ADD,    RTYPE_INSTR_VALUE(0x33, 6, 0x10), RTYPE_MASK, _RS1_|_RS2_|_RD_)
+DEFINSTR(SH1ADD_UW, RTYPE_INSTR_VALUE(0x3b, 2, 0x10), RTYPE_MASK, _RS1_|_RS2_|_RD_)
+DEFINSTR(SH2ADD_UW, RTYPE_INSTR_VALUE(0x3b, 4, 0x10), RTYPE_MASK, _RS1_|_RS2_|_RD_)
+DEFINSTR(SH3ADD_UW, RTYPE_INSTR_VALUE(0x3b, 6, 0x10), RTYPE_MASK, _RS1_|_RS2_|_RD_)
+DEFINSTR(SLLI_UW,   RTYPE_INSTR_VALUE(0x1b, 1, 0x04), SHIFT64TYPE_MASK, _RS1_|_RD_)
+
+DEFINSTR(ANDN,      RTYPE_INSTR_VALUE(0x33, 7, 0x20), RTYPE_MASK, _RS1_|_RS2_|_RD_)
+DEFINSTR(ORN,       RTYPE_INSTR_VALUE(0x33, 6, 0x20), RTYPE_MASK, _RS1_|_RS2_|_RD_)
+DEFINSTR(XNOR,      RTYPE_INSTR_VALUE(0x33, 4, 0x20), RTYPE_MASK, _RS1_|_RS2_|_RD_)
+DEFINSTR(CLZ,       ETYPE_INSTR_VALUE(0x13, 1, 0x600), ETYPE_MASK, _RS1_|_RD_)
+DEFINSTR(CTZ,       ETYPE_INSTR_VALUE(0x13, 1, 0x601), ETYPE_MASK, _RS1_|_RD_)
+DEFINSTR(CPOP,      ETYPE_INSTR_VALUE(0x13, 1, 0x602), ETYPE_MASK, _RS1_|_RD_)
+DEFINSTR(SEXT_B,    ETYPE_INSTR_VALUE(0x13, 1, 0x604), ETYPE_MASK, _RS1_|_RD_)
+DEFINSTR(SEXT_H,    ETYPE_INSTR_VALUE(0x13, 1, 0x605), ETYPE_MASK, _RS1_|_RD_)
+DEFINSTR(CLZW,      ETYPE_INSTR_VALUE(0x1b, 1, 0x600), ETYPE_MASK, _RS1_|_RD_)
+DEFINSTR(CTZW,      ETYPE_INSTR_VALUE(0x1b, 1, 0x601), ETYPE_MASK, _RS1_|_RD_)
+DEFINSTR(CPOPW,     ETYPE_INSTR_VALUE(0x1b, 1, 0x602), ETYPE_MASK, _RS1_|_RD_)
+DEFINSTR(ZEXT_H,    ETYPE_INSTR_VALUE(0x3b, 4, 0x080), ETYPE_MASK, _RS1_|_RD_)
+DEFINSTR(MIN,       RTYPE_INSTR_VALUE(0x33, 4, 0x05), RTYPE_MASK, _RS1_|_RS2_|_RD_)
+DEFINSTR(MINU,      RTYPE_INSTR_VALUE(0x33, 5, 0x05), RTYPE_MASK, _RS1_|_RS2_|_RD_)
+DEFINSTR(MAX,       RTYPE_INSTR_VALUE(0x33, 6, 0x05), RTYPE_MASK, _RS1_|_RS2_|_RD_)
+DEFINSTR(MAXU,      RTYPE_INSTR_VALUE(0x33, 7, 0x05), RTYPE_MASK, _RS1_|_RS2_|_RD_)
+DEFINSTR(ROL,       RTYPE_INSTR_VALUE(0x33, 1, 0x30), RTYPE_MASK, _RS1_|_RS2_|_RD_)
+DEFINSTR(ROR,       RTYPE_INSTR_VALUE(0x33, 5, 0x30), RTYPE_MASK, _RS1_|_RS2_|_RD_)
+DEFINSTR(RORI,      RTYPE_INSTR_VALUE(0x13, 5, 0x30), SHIFT64TYPE_MASK, _RS1_|_RD_)
+DEFINSTR(ROLW,      RTYPE_INSTR_VALUE(0x3b, 1, 0x30), RTYPE_MASK, _RS1_|_RS2_|_RD_)
+DEFINSTR(RORW,      RTYPE_INSTR_VALUE(0x3b, 5, 0x30), RTYPE_MASK, _RS1_|_RS2_|_RD_)
+DEFINSTR(RORIW,     RTYPE_INSTR_VALUE(0x1b, 5, 0x30), RTYPE_MASK, _RS1_|_RD_)
+DEFINSTR(ORC_B,     ETYPE_INSTR_VALUE(0x13, 5, 0x287), ETYPE_MASK, _RS1_|_RD_)
+DEFINSTR(REV8,      ETYPE_INSTR_VALUE(0x13, 5, 0x6b8), ETYPE_MASK, _RS1_|_RD_)
+
+DEFINSTR(BCLR,      RTYPE_INSTR_VALUE(0x33, 1, 0x24), RTYPE_MASK, _RS1_|_RS2_|_RD_)
+DEFINSTR(BCLRI,     RTYPE_INSTR_VALUE(0x13, 1, 0x24), SHIFT64TYPE_MASK, _RS1_|_RD_)
+DEFINSTR(BEXT,      RTYPE_INSTR_VALUE(0x33, 5, 0x24), RTYPE_MASK, _RS1_|_RS2_|_RD_)
+DEFINSTR(BEXTI,     RTYPE_INSTR_VALUE(0x13, 5, 0x24), SHIFT64TYPE_MASK, _RS1_|_RD_)
+DEFINSTR(BINV,      RTYPE_INSTR_VALUE(0x33, 1, 0x34), RTYPE_MASK, _RS1_|_RS2_|_RD_)
+DEFINSTR(BINVI,     RTYPE_INSTR_VALUE(0x13, 1, 0x34), SHIFT64TYPE_MASK, _RS1_|_RD_)
+DEFINSTR(BSET,      RTYPE_INSTR_VALUE(0x33, 1, 0x14), RTYPE_MASK, _RS1_|_RS2_|_RD_)
+DEFINSTR(BSETI,     RTYPE_INSTR_VALUE(0x13, 1, 0x14), SHIFT64TYPE_MASK, _RS1_|_RD_)
@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+
+#ifndef RISCVBITMANIP_HPP
+#define RISCVBITMANIP_HPP
+#include <cstdint>
+
+/**
+ * @brief bit manipulation shared by RV64IInterpreter and basic blocks
+ *
+ * Zero operands are defined here rather than left to the compiler
+ * builtins, which are undefined for them.
+ */
+namespace riscv_bitmanip {
+
+inline uint64_t clz(uint64_t x) { return x ? __builtin_clzll(x) : 64; }
+inline uint64_t ctz(uint64_t x) { return x ? __builtin_ctzll(x) : 64; }
+inline uint64_t cpop(uint64_t x) { return __builtin_popcountll(x); }
+
+inline uint64_t clzw(uint32_t x) { return x ? __builtin_clz(x) : 32; }
+inline uint64_t ctzw(uint32_t x) { return x ? __builtin_ctz(x) : 32; }
+inline uint64_t cpopw(uint32_t x) { return __builtin_popcount(x); }
+
+inline uint64_t rol(uint64_t x, uint64_t shamt) {
+    shamt &= 63;
+    return (x << shamt) | (x >> ((64 - shamt) & 63));
+}
+inline uint64_t ror(uint64_t x, uint64_t shamt) {
+    shamt &= 63;
+    return (x >> shamt) | (x << ((64 - shamt) & 63));
+}
+
+/**
+ * @brief rotate the low word, sign extending the result
+ */
+inline int64_t rolw(uint64_t x, uint64_t shamt) {
+    uint32_t w = static_cast<uint32_t>(x);
+    shamt &= 31;
+    return static_cast<int32_t>((w << shamt) | (w >> ((32 - shamt) & 31)));
+}
+inline int64_t rorw(uint64_t x, uint64_t shamt) {
+    uint32_t w = static_cast<uint32_t>(x);
+    shamt &= 31;
+    return static_cast<int32_t>((w >> shamt) | (w << ((32 - shamt) & 31)));
+}
+
+/**
+ * @brief set every byte holding a set bit to 0xff
+ */
+inline uint64_t orcb(uint64_t x) {
+    uint64_t r = 0;
+    for (int b = 0; b < 64; b += 8) {
+        if ((x >> b) & 0xff) {
+            r |= 0xffull << b;
+        }
+    }
+    return r;
+}
+
+inline uint64_t rev8(uint64_t x) { return __builtin_bswap64(x); }
+
+}
+
+#endif
@@ -0,0 +1,301 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+
+#ifndef RISCVBLOCK_HPP
+#define RISCVBLOCK_HPP
+#include "RISCVBitmanip.hpp"
+#include "RISCVHart.hpp"
+#include "RISCVInstruction.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+struct RISCVBlockOp;
+
+/**
+ * @brief executes one pre-decoded instruction of a block
+ */
+typedef void (*RISCVBlockHandler)(RISCVHart &hart, const RISCVBlockOp &op);
+
+/**
+ * @brief a pre-decoded instruction
+ *
+ * Operands are extracted once when the block is formed; the handler is
+ * called directly, without going through the interpreter's visitor.
+ */
+struct RISCVBlockOp {
+    RISCVBlockHandler handler; //!< executes the instruction
+    RISCVInstruction *instruction; //!< the decoded instruction
+    RISCVInstructionId id; //!< instruction id
+    uint8_t rd;  //!< destination register
+    uint8_t rs1; //!< first source register
+    uint8_t rs2; //!< second source register
+    int64_t imm; //!< sign-extended immediate or shift amount
+    uint8_t length; //!< bytes of program text; 2 for a compressed instruction
+};
+
+/**
+ * @brief a straight-line run of pre-decoded integer instructions
+ *
+ * A block ends after a branch or jump, or before the first instruction
+ * that must go through the simulator (loads, stores, atomics, fences,
+ * csr and system instructions, floating point and multiply/divide).
+ * A block may be empty if the instruction at its start is one of those.
+ */
+struct RISCVBlock {
+    static constexpr size_t MAX_OPS = 64; //!< most instructions in a block
+
+    std::vector<RISCVBlockOp> ops; //!< instructions in program order
+    std::vector<std::pair<RISCVInstructionId, uint64_t>> mix; //!< instruction ids and how often each occurs
+
+    bool empty() const { return ops.empty(); }
+    size_t size() const { return ops.size(); }
+
+    /**
+     * @brief run every instruction in the block
+     */
+    void execute(RISCVHart &hart) const {
+        for (const RISCVBlockOp &op : ops) {
+            op.handler(hart, op);
+        }
+    }
+};
+
+namespace riscv_block {
+
+// these match the semantics of RV64IInterpreter
+inline void LUI(RISCVHart &hart, const RISCVBlockOp &op) {
+    hart.sx(op.rd) = op.imm;
+    hart.pc() += op.length;
+}
+inline void AUIPC(RISCVHart &hart, const RISCVBlockOp &op) {
+    hart.x(op.rd) = hart.pc() + op.imm;
+    hart.pc() += op.length;
+}
+inline void JAL(RISCVHart &hart, const RISCVBlockOp &op) {
+    hart.x(op.rd) = hart.pc() + op.length;
+    hart.pc() += op.imm;
+}
+inline void JALR(RISCVHart &hart, const RISCVBlockOp &op) {
+    uint64_t target = hart.x(op.rs1) + op.imm;
+    hart.x(op.rd) = hart.pc() + op.length;
+    hart.pc() = target;
+}
+
+#define DEFBRANCH(name, reg, cmp)                                       \
+    inline void name(RISCVHart &hart, const RISCVBlockOp &op) {         \
+        if (hart.reg(op.rs1) cmp hart.reg(op.rs2)) {                    \
+            hart.pc() += op.imm;                                        \
+        } else {                                                        \
+            hart.pc() += op.length;                                     \
+        }                                                               \
+    }
+DEFBRANCH(BEQ,  x,  ==)
+DEFBRANCH(BNE,  x,  !=)
+DEFBRANCH(BLT,  sx, <)
+DEFBRANCH(BGE,  sx, >=)
+DEFBRANCH(BLTU, x,  <)
+DEFBRANCH(BGEU, x,  >=)
+#undef DEFBRANCH
+
+#define DEFALU(name, expr)                                              \
+    inline void name(RISCVHart &hart, const RISCVBlockOp &op) {         \
+        hart.x(op.rd) = (expr);                                         \
+        hart.pc() += op.length;                                         \
+    }
+DEFALU(ADDI,  hart.sx(op.rs1) + op.imm)
+DEFALU(SLTI,  hart.sx(op.rs1) < op.imm)
+DEFALU(SLTIU, hart.x(op.rs1) < static_cast<uint64_t>(op.imm))
+DEFALU(XORI,  hart.x(op.rs1) ^ op.imm)
+DEFALU(ORI,   hart.x(op.rs1) | op.imm)
+DEFALU(ANDI,  hart.x(op.rs1) & op.imm)
+DEFALU(SLLI,  hart.x(op.rs1) << op.imm)
+DEFALU(SRLI,  hart.x(op.rs1) >> op.imm)
+DEFALU(SRAI,  hart.sx(op.rs1) >> op.imm)
+DEFALU(ADD,   hart.sx(op.rs1) + hart.sx(op.rs2))
+DEFALU(SUB,   hart.sx(op.rs1) - hart.sx(op.rs2))
+DEFALU(SLL,   hart.x(op.rs1) << (hart.x(op.rs2) & 63))
+DEFALU(SLT,   hart.sx(op.rs1) < hart.sx(op.rs2))
+DEFALU(SLTU,  hart.x(op.rs1) < hart.x(op.rs2))
+DEFALU(XOR,   hart.x(op.rs1) ^ hart.x(op.rs2))
+DEFALU(SRL,   hart.x(op.rs1) >> (hart.x(op.rs2) & 63))
+DEFALU(SRA,   hart.sx(op.rs1) >> (hart.x(op.rs2) & 63))
+DEFALU(OR,    hart.x(op.rs1) | hart.x(op.rs2))
+DEFALU(AND,   hart.x(op.rs1) & hart.x(op.rs2))
+DEFALU(ADD_UW,    hart.x(op.rs2) + static_cast<uint32_t>(hart.x(op.rs1)))
+DEFALU(SH1ADD,    hart.x(op.rs2) + (hart.x(op.rs1) << 1))
+DEFALU(SH2ADD,    hart.x(op.rs2) + (hart.x(op.rs1) << 2))
+DEFALU(SH3ADD,    hart.x(op.rs2) + (hart.x(op.rs1) << 3))
+DEFALU(SH1ADD_UW, hart.x(op.rs2) + (static_cast<uint64_t>(static_cast<uint32_t>(hart.x(op.rs1))) << 1))
+DEFALU(SH2ADD_UW, hart.x(op.rs2) + (static_cast<uint64_t>(static_cast<uint32_t>(hart.x(op.rs1))) << 2))
+DEFALU(SH3ADD_UW, hart.x(op.rs2) + (static_cast<uint64_t>(static_cast<uint32_t>(hart.x(op.rs1))) << 3))
+DEFALU(SLLI_UW,   static_cast<uint64_t>(static_cast<uint32_t>(hart.x(op.rs1))) << op.imm)
+DEFALU(ANDN,  hart.x(op.rs1) & ~hart.x(op.rs2))
+DEFALU(ORN,   hart.x(op.rs1) | ~hart.x(op.rs2))
+DEFALU(XNOR,  ~(hart.x(op.rs1) ^ hart.x(op.rs2)))
+DEFALU(CLZ,   riscv_bitmanip::clz(hart.x(op.rs1)))
+DEFALU(CTZ,   riscv_bitmanip::ctz(hart.x(op.rs1)))
+DEFALU(CPOP,  riscv_bitmanip::cpop(hart.x(op.rs1)))
+DEFALU(CLZW,  riscv_bitmanip::clzw(hart.x(op.rs1)))
+DEFALU(CTZW,  riscv_bitmanip::ctzw(hart.x(op.rs1)))
+DEFALU(CPOPW, riscv_bitmanip::cpopw(hart.x(op.rs1)))
+DEFALU(SEXT_B, static_cast<int8_t>(hart.x(op.rs1)))
+DEFALU(SEXT_H, static_cast<int16_t>(hart.x(op.rs1)))
+DEFALU(ZEXT_H, static_cast<uint16_t>(hart.x(op.rs1)))
+DEFALU(MIN,   std::min<int64_t>(hart.sx(op.rs1), hart.sx(op.rs2)))
+DEFALU(MINU,  std::min<uint64_t>(hart.x(op.rs1), hart.x(op.rs2)))
+DEFALU(MAX,   std::max<int64_t>(hart.sx(op.rs1), hart.sx(op.rs2)))
+DEFALU(MAXU,  std::max<uint64_t>(hart.x(op.rs1), hart.x(op.rs2)))
+DEFALU(ROL,   riscv_bitmanip::rol(hart.x(op.rs1), hart.x(op.rs2)))
+DEFALU(ROR,   riscv_bitmanip::ror(hart.x(op.rs1), hart.x(op.rs2)))
+DEFALU(RORI,  riscv_bitmanip::ror(hart.x(op.rs1), op.imm))
+DEFALU(ROLW,  riscv_bitmanip::rolw(hart.x(op.rs1), hart.x(op.rs2)))
+DEFALU(RORW,  riscv_bitmanip::rorw(hart.x(op.rs1), hart.x(op.rs2)))
+DEFALU(RORIW, riscv_bitmanip::rorw(hart.x(op.rs1), op.imm))
+DEFALU(ORC_B, riscv_bitmanip::orcb(hart.x(op.rs1)))
+DEFALU(REV8,  riscv_bitmanip::rev8(hart.x(op.rs1)))
+DEFALU(BCLR,  hart.x(op.rs1) & ~(1ull << (hart.x(op.rs2) & 63)))
+DEFALU(BCLRI, hart.x(op.rs1) & ~(1ull << op.imm))
+DEFALU(BEXT,  (hart.x(op.rs1) >> (hart.x(op.rs2) & 63)) & 1)
+DEFALU(BEXTI, (hart.x(op.rs1) >> op.imm) & 1)
+DEFALU(BINV,  hart.x(op.rs1) ^ (1ull << (hart.x(op.rs2) & 63)))
+DEFALU(BINVI, hart.x(op.rs1) ^ (1ull << op.imm))
+DEFALU(BSET,  hart.x(op.rs1) | (1ull << (hart.x(op.rs2) & 63)))
+DEFALU(BSETI, hart.x(op.rs1) | (1ull << op.imm))
+#undef DEFALU
+
+// 32-bit results are sign extended to 64 bits
+#define DEFALUW(name, expr)                                             \
+    inline void name(RISCVHart &hart, const RISCVBlockOp &op) {         \
+        int32_t rd = (expr);                                            \
+        hart.sx(op.rd) = rd;                                            \
+        hart.pc() += op.length;                                         \
+    }
+DEFALUW(ADDIW, static_cast<int32_t>(hart.sx(op.rs1)) + static_cast<int32_t>(op.imm))
+DEFALUW(SLLIW, static_cast<uint32_t>(hart.x(op.rs1)) << op.imm)
+DEFALUW(SRLIW, static_cast<uint32_t>(hart.x(op.rs1)) >> op.imm)
+DEFALUW(SRAIW, static_cast<int32_t>(hart.sx(op.rs1)) >> op.imm)
+DEFALUW(ADDW,  static_cast<int32_t>(hart.sx(op.rs1)) + static_cast<int32_t>(hart.sx(op.rs2)))
+DEFALUW(SUBW,  static_cast<int32_t>(hart.sx(op.rs1)) - static_cast<int32_t>(hart.sx(op.rs2)))
+DEFALUW(SLLW,  static_cast<uint32_t>(hart.x(op.rs1)) << (hart.x(op.rs2) & 31))
+DEFALUW(SRLW,  static_cast<uint32_t>(hart.x(op.rs1)) >> (hart.x(op.rs2) & 31))
+DEFALUW(SRAW,  static_cast<int32_t>(hart.sx(op.rs1)) >> (hart.x(op.rs2) & 31))
+#undef DEFALUW
+
+/**
+ * @brief pre-decode an instruction into a block op
+ *
+ * @param[out] terminator true if the instruction ends its block
+ * @return false if the instruction cannot be run from a block
+ */
+inline bool compile(RISCVInstruction &i, RISCVBlockOp &op, bool &terminator) {
+    op.instruction = &i;
+    op.id = i.getInstructionId();
+    op.rd = i.rd();
+    op.rs1 = i.rs1();
+    op.rs2 = i.rs2();
+    op.imm = 0;
+    op.length = i.length();
+    terminator = false;
+    switch (op.id) {
+#define CASE(name, immediate)                   \
+    case name##InstructionId:                   \
+        op.handler = &name;                     \
+        op.imm = (immediate);                   \
+        break;
+    CASE(LUI,   i.SUimm())
+    CASE(AUIPC, i.SUimm())
+    CASE(ADDI,  i.SIimm())
+    CASE(SLTI,  i.SIimm())
+    CASE(SLTIU, i.SIimm())
+    CASE(XORI,  i.SIimm())
+    CASE(ORI,   i.SIimm())
+    CASE(ANDI,  i.SIimm())
+    CASE(SLLI,  i.shamt6())
+    CASE(SRLI,  i.shamt6())
+    CASE(SRAI,  i.shamt6())
+    CASE(ADD,   0)
+    CASE(SUB,   0)
+    CASE(SLL,   0)
+    CASE(SLT,   0)
+    CASE(SLTU,  0)
+    CASE(XOR,   0)
+    CASE(SRL,   0)
+    CASE(SRA,   0)
+    CASE(OR,    0)
+    CASE(AND,   0)
+    CASE(ADDIW, i.SIimm())
+    CASE(SLLIW, i.shamt5())
+    CASE(SRLIW, i.shamt5())
+    CASE(SRAIW, i.shamt5())
+    CASE(ADDW,  0)
+    CASE(SUBW,  0)
+    CASE(SLLW,  0)
+    CASE(SRLW,  0)
+    CASE(SRAW,  0)
+    CASE(ADD_UW,    0)
+    CASE(SH1ADD,    0)
+    CASE(SH2ADD,    0)
+    CASE(SH3ADD,    0)
+    CASE(SH1ADD_UW, 0)
+    CASE(SH2ADD_UW, 0)
+    CASE(SH3ADD_UW, 0)
+    CASE(SLLI_UW,   i.shamt6())
+    CASE(ANDN,      0)
+    CASE(ORN,       0)
+    CASE(XNOR,      0)
+    CASE(CLZ,       0)
+    CASE(CTZ,       0)
+    CASE(CPOP,      0)
+    CASE(CLZW,      0)
+    CASE(CTZW,      0)
+    CASE(CPOPW,     0)
+    CASE(SEXT_B,    0)
+    CASE(SEXT_H,    0)
+    CASE(ZEXT_H,    0)
+    CASE(MIN,       0)
+    CASE(MINU,      0)
+    CASE(MAX,       0)
+    CASE(MAXU,      0)
+    CASE(ROL,       0)
+    CASE(ROR,       0)
+    CASE(RORI,      i.shamt6())
+    CASE(ROLW,      0)
+    CASE(RORW,      0)
+    CASE(RORIW,     i.shamt5())
+    CASE(ORC_B,     0)
+    CASE(REV8,      0)
+    CASE(BCLR,      0)
+    CASE(BCLRI,     i.shamt6())
+    CASE(BEXT,      0)
+    CASE(BEXTI,     i.shamt6())
+    CASE(BINV,      0)
+    CASE(BINVI,     i.shamt6())
+    CASE(BSET,      0)
+    CASE(BSETI,     i.shamt6())
+#undef CASE
+#define CASE(name, immediate)                   \
+    case name##InstructionId:                   \
+        op.handler = &name;                     \
+        op.imm = (immediate);                   \
+        terminator = true;                      \
+        break;
+    CASE(JAL,   i.Jimm())
+    CASE(JALR,  i.SIimm())
+    CASE(BEQ,   i.Bimm())
+    CASE(BNE,   i.Bimm())
+    CASE(BLT,   i.Bimm())
+    CASE(BGE,   i.Bimm())
+    CASE(BLTU,  i.Bimm())
+    CASE(BGEU,  i.Bimm())
+#undef CASE
+    default:
+        return false;
+    }
+    return true;
+}
+
+}
+
+#endif
@@ -0,0 +1,182 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+
+#ifndef RISCVDECODECACHE_HPP
+#define RISCVDECODECACHE_HPP
+#include "RISCVDecoder.hpp"
+#include "RISCVBlock.hpp"
+#include "RISCVProgramImage.hpp"
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @brief A direct-mapped cache of decoded instructions, keyed by pc
+ *
+ * Each entry holds one text page of decoded instructions; an instruction is
+ * decoded the first time its pc is executed and the decoded object is reused
+ * on every later execution, so a loop pays for decode once rather than once
+ * per iteration.
+ *
+ * Pages also hold the basic blocks formed from their instructions; a block
+ * never crosses a page, so it is dropped with the instructions it was
+ * formed from.
+ *
+ * Text the program image decoded up front is shared with every other core
+ * running the program and is never decoded here; pages still hold its
+ * blocks.
+ *
+ * invalidate() (FENCE.I) only bumps a generation count; pages decoded under
+ * an older generation are cleared on their next lookup. This keeps the
+ * instruction being executed alive until it returns.
+ */
+class RISCVDecodeCache {
+public:
+    static constexpr uint64_t PAGE_SHIFT = 12; //!< log2 of the page size in bytes
+    static constexpr uint64_t PAGE_SIZE = 1ull << PAGE_SHIFT; //!< page size in bytes
+    static constexpr uint64_t PAGE_SLOTS = PAGE_SIZE / 2; //!< instruction slots per page, one per halfword
+
+    /**
+     * @brief constructor
+     *
+     * @param image the program
+     * @param decoder decodes each instruction word the image did not
+     * @param pages number of pages held at once; rounded up to a power of two
+     */
+    RISCVDecodeCache(RISCVProgramImage *image, RISCVDecoder *decoder, size_t pages)
+        : image_(image)
+        , decoder_(decoder) {
+        size_t n = 1;
+        while (n < pages) {
+            n <<= 1;
+        }
+        pages_.resize(n);
+    }
+
+    /**
+     * @brief the decoded instruction at pc
+     *
+     * Throws std::runtime_error if the word at pc does not decode.
+     */
+    RISCVInstruction *lookup(uint64_t pc) {
+        if (RISCVInstruction *shared = image_->lookup(pc)) {
+            return shared;
+        }
+        std::unique_ptr<RISCVInstruction> &i = page(pc).instructions[slot(pc)];
+        if (!i) {
+            i.reset(decoder_->decode(image_->backing()->read(pc)));
+        }
+        return i.get();
+    }
+
+    /**
+     * @brief the basic block starting at pc
+     *
+     * Throws std::runtime_error if the word at pc does not decode.
+     */
+    const RISCVBlock *block(uint64_t pc) {
+        std::unique_ptr<RISCVBlock> &b = page(pc).blocks[slot(pc)];
+        if (!b) {
+            b.reset(form(pc));
+        }
+        return b.get();
+    }
+
+    /**
+     * @brief forget all decoded instructions
+     */
+    void invalidate() { generation_++; }
+
+private:
+    /**
+     * @brief a decoded text page
+     */
+    struct Page {
+        bool valid = false; //!< page has been decoded
+        uint64_t vpn = 0; //!< page number
+        uint64_t generation = 0; //!< generation the page was decoded in
+        std::vector<std::unique_ptr<RISCVInstruction>> instructions; //!< instructions the image did not decode, null until executed
+        std::vector<std::unique_ptr<RISCVBlock>> blocks; //!< blocks by starting instruction, null until executed
+    };
+
+    /**
+     * @brief the current page holding pc
+     */
+    Page &page(uint64_t pc) {
+        uint64_t vpn = pc >> PAGE_SHIFT;
+        Page &entry = pages_[vpn & (pages_.size() - 1)];
+        if (!entry.valid || entry.vpn != vpn || entry.generation != generation_) {
+            fill(entry, vpn);
+        }
+        return entry;
+    }
+
+    /**
+     * @brief index of pc within its page
+     */
+    static uint64_t slot(uint64_t pc) { return (pc & (PAGE_SIZE - 1)) >> 1; }
+
+    /**
+     * @brief claim an entry for a page
+     */
+    void fill(Page &page, uint64_t vpn) {
+        page.valid = true;
+        page.vpn = vpn;
+        page.generation = generation_;
+        page.instructions.clear();
+        page.instructions.resize(PAGE_SLOTS);
+        page.blocks.clear();
+        page.blocks.resize(PAGE_SLOTS);
+    }
+
+    /**
+     * @brief form the basic block starting at pc
+     */
+    RISCVBlock *form(uint64_t pc) {
+        std::unique_ptr<RISCVBlock> b(new RISCVBlock);
+        uint64_t end = (pc | (PAGE_SIZE - 1)) + 1;
+        for (uint64_t at = pc; at < end && b->size() < RISCVBlock::MAX_OPS; at += b->ops.back().length) {
+            RISCVInstruction *i = nullptr;
+            if (at == pc) {
+                i = lookup(at);
+            } else {
+                // a word that does not decode ends the block; the error is
+                // raised if it is ever executed
+                try {
+                    i = lookup(at);
+                } catch (std::runtime_error &) {
+                    break;
+                }
+            }
+            RISCVBlockOp op;
+            bool terminator = false;
+            if (!riscv_block::compile(*i, op, terminator)) {
+                break;
+            }
+            b->ops.push_back(op);
+            if (terminator) {
+                break;
+            }
+        }
+        for (const RISCVBlockOp &op : b->ops) {
+            auto it = b->mix.begin();
+            while (it != b->mix.end() && it->first != op.id) {
+                ++it;
+            }
+            if (it == b->mix.end()) {
+                b->mix.emplace_back(op.id, 1);
+            } else {
+                it->second++;
+            }
+        }
+        return b.release();
+    }
+
+    RISCVProgramImage *image_; //!< the program
+    RISCVDecoder *decoder_; //!< decodes each instruction word
+    uint64_t generation_ = 0; //!< bumped by invalidate()
+    std::vector<Page> pages_; //!< direct-mapped decoded pages
+};
+
+#endif
@@ -4,21 +4,403 @@
 #ifndef RISCVDECODER_HPP
 #define RISCVDECODER_HPP
 #include "RISCVInstruction.hpp"
+#include <cstddef>
+#include <cstdint>
 #include <sstream>
 #include <iomanip>
 
+/**
+ * @brief Compile-time decode tables built from InstructionTable.h
+ *
+ * Level one is indexed by opcode and funct3 and selects a level two table,
+ * which is indexed by funct7 and selects a short run of candidates in
+ * table order. Nearly every run holds a single instruction; the ones that
+ * don't (e.g. fcvt variants that differ in rs2) are checked against their
+ * full mask in order, so the first match is the same instruction the
+ * linear scan of InstructionTable.h would find.
+ */
+namespace riscv_decode {
+
+constexpr uint32_t MASKS[] = {
+#define DEFINSTR(mnemonic, value_under_mask, mask, ...) static_cast<uint32_t>(mask),
+#include "InstructionTable.h"
+#undef DEFINSTR
+};
+
+constexpr uint32_t VALUES[] = {
+#define DEFINSTR(mnemonic, value_under_mask, mask, ...) static_cast<uint32_t>(value_under_mask),
+#include "InstructionTable.h"
+#undef DEFINSTR
+};
+
+constexpr size_t NUM_BUCKETS = 1 << 10; //!< opcode (7 bits) x funct3 (3 bits)
+constexpr size_t NUM_FUNCT7 = 1 << 7;
+constexpr uint16_t NO_TABLE = 0xffff;
+constexpr uint32_t BUCKET_BITS = 0x0000707f;
+constexpr uint32_t FUNCT7_BITS = 0xfe000000;
+
+constexpr uint32_t bucket(uint32_t instruction) {
+    return (instruction & 0x7f) | (((instruction >> 12) & 0x7) << 7);
+}
+
+constexpr uint32_t bucketEncoding(uint32_t b) {
+    return (b & 0x7f) | ((b >> 7) << 12);
+}
+
+constexpr bool inBucket(size_t id, uint32_t b) {
+    return ((VALUES[id] ^ bucketEncoding(b)) & MASKS[id] & BUCKET_BITS) == 0;
+}
+
+constexpr bool inFunct7(size_t id, uint32_t f7) {
+    return ((VALUES[id] ^ (f7 << 25)) & MASKS[id] & FUNCT7_BITS) == 0;
+}
+
+/**
+ * @brief the bucket of instruction id with funct3 f3, or NUM_BUCKETS if it has none
+ *
+ * every instruction fixes the opcode; most also fix funct3
+ */
+constexpr uint32_t bucketOf(size_t id, uint32_t f3) {
+    uint32_t b = (VALUES[id] & 0x7f) | (f3 << 7);
+    return inBucket(id, b) ? b : static_cast<uint32_t>(NUM_BUCKETS);
+}
+
+/**
+ * @brief number of opcode/funct3 buckets holding at least one instruction
+ */
+constexpr size_t countTables() {
+    bool used[NUM_BUCKETS] = {};
+    size_t n = 0;
+    for (size_t id = 0; id < NumInstructionIds; id++) {
+        for (uint32_t f3 = 0; f3 < 8; f3++) {
+            uint32_t b = bucketOf(id, f3);
+            if (b != NUM_BUCKETS && !used[b]) {
+                used[b] = true;
+                n++;
+            }
+        }
+    }
+    return n;
+}
+
+/**
+ * @brief number of (bucket, funct7, instruction) matches
+ */
+constexpr size_t countCandidates() {
+    size_t n = 0;
+    for (size_t id = 0; id < NumInstructionIds; id++) {
+        size_t f7s = 0;
+        for (uint32_t f7 = 0; f7 < NUM_FUNCT7; f7++) {
+            f7s += inFunct7(id, f7) ? 1 : 0;
+        }
+        for (uint32_t f3 = 0; f3 < 8; f3++) {
+            n += bucketOf(id, f3) != NUM_BUCKETS ? f7s : 0;
+        }
+    }
+    return n;
+}
+
+constexpr size_t NUM_TABLES = countTables();
+constexpr size_t NUM_CANDIDATES = countCandidates();
+constexpr size_t NUM_BUCKET_ENTRIES = NumInstructionIds * 8; //!< upper bound on (bucket, instruction) matches
+
+/**
+ * @brief a run of candidates in the candidate pool
+ */
+struct Run {
+    uint16_t start;
+    uint16_t count;
+};
+
+struct Tables {
+    uint16_t level1[NUM_BUCKETS]; //!< bucket => level two table, or NO_TABLE
+    Run level2[NUM_TABLES][NUM_FUNCT7]; //!< table, funct7 => candidates
+    uint16_t candidates[NUM_CANDIDATES]; //!< instruction ids
+};
+
+static_assert(NumInstructionIds < 0xffff, "instruction ids must fit in 16 bits");
+static_assert(NUM_CANDIDATES < 0xffff, "candidate pool must be indexable by 16 bits");
+
+constexpr Tables buildTables() {
+    Tables t{};
+    // group instructions by bucket, keeping table order within a bucket
+    uint16_t first[NUM_BUCKETS + 1] = {};
+    uint16_t ids[NUM_BUCKET_ENTRIES] = {};
+    for (size_t id = 0; id < NumInstructionIds; id++) {
+        for (uint32_t f3 = 0; f3 < 8; f3++) {
+            uint32_t b = bucketOf(id, f3);
+            if (b != NUM_BUCKETS) {
+                first[b + 1]++;
+            }
+        }
+    }
+    for (size_t b = 0; b < NUM_BUCKETS; b++) {
+        first[b + 1] += first[b];
+    }
+    uint16_t fill[NUM_BUCKETS] = {};
+    for (size_t id = 0; id < NumInstructionIds; id++) {
+        for (uint32_t f3 = 0; f3 < 8; f3++) {
+            uint32_t b = bucketOf(id, f3);
+            if (b != NUM_BUCKETS) {
+                ids[first[b] + fill[b]++] = static_cast<uint16_t>(id);
+            }
+        }
+    }
+
+    uint16_t table = 0;
+    uint16_t pool = 0;
+    for (uint32_t b = 0; b < NUM_BUCKETS; b++) {
+        t.level1[b] = NO_TABLE;
+        if (first[b] == first[b + 1]) {
+            continue;
+        }
+        t.level1[b] = table;
+        for (uint32_t f7 = 0; f7 < NUM_FUNCT7; f7++) {
+            Run &run = t.level2[table][f7];
+            run.start = pool;
+            run.count = 0;
+            for (uint16_t i = first[b]; i < first[b + 1]; i++) {
+                if (inFunct7(ids[i], f7)) {
+                    t.candidates[pool++] = ids[i];
+                    run.count++;
+                }
+            }
+        }
+        table++;
+    }
+    return t;
+}
+
+/**
+ * @brief construct an instruction object by id
+ */
+typedef RISCVInstruction *(*Factory)(uint32_t);
+
+#define DEFINSTR(mnemonic, ...)                                         \
+    inline RISCVInstruction *make##mnemonic(uint32_t instruction) {     \
+        return new mnemonic##Instruction(instruction);                  \
+    }
+#include "InstructionTable.h"
+#undef DEFINSTR
+
+constexpr Factory FACTORIES[] = {
+#define DEFINSTR(mnemonic, ...) &make##mnemonic,
+#include "InstructionTable.h"
+#undef DEFINSTR
+};
+
+/**
+ * @brief encoders for the base instruction formats
+ */
+inline uint32_t itype(uint32_t opcode, uint32_t f3, uint32_t rd, uint32_t rs1, int32_t imm) {
+    return (static_cast<uint32_t>(imm) << 20) | (rs1 << 15) | (f3 << 12) | (rd << 7) | opcode;
+}
+
+inline uint32_t stype(uint32_t opcode, uint32_t f3, uint32_t rs1, uint32_t rs2, int32_t imm) {
+    uint32_t u = static_cast<uint32_t>(imm);
+    return ((u >> 5) << 25) | (rs2 << 20) | (rs1 << 15) | (f3 << 12) | ((u & 0x1f) << 7) | opcode;
+}
+
+inline uint32_t rtype(uint32_t opcode, uint32_t f3, uint32_t f7, uint32_t rd, uint32_t rs1, uint32_t rs2) {
+    return (f7 << 25) | (rs2 << 20) | (rs1 << 15) | (f3 << 12) | (rd << 7) | opcode;
+}
+
+inline uint32_t btype(uint32_t f3, uint32_t rs1, uint32_t rs2, int32_t imm) {
+    uint32_t u = static_cast<uint32_t>(imm);
+    return (((u >> 12) & 1) << 31) | (((u >> 5) & 0x3f) << 25) | (rs2 << 20) | (rs1 << 15)
+        | (f3 << 12) | (((u >> 1) & 0xf) << 8) | (((u >> 11) & 1) << 7) | 0x63;
+}
+
+inline uint32_t jtype(uint32_t rd, int32_t imm) {
+    uint32_t u = static_cast<uint32_t>(imm);
+    return (((u >> 20) & 1) << 31) | (((u >> 1) & 0x3ff) << 21) | (((u >> 11) & 1) << 20)
+        | (((u >> 12) & 0xff) << 12) | (rd << 7) | 0x6f;
+}
+
+/**
+ * @brief sign extend the low bits of x
+ */
+inline int32_t sext(uint32_t x, unsigned bits) {
+    return static_cast<int32_t>(x << (32 - bits)) >> (32 - bits);
+}
+
+/**
+ * @brief expand an RV64C instruction to the base instruction it stands for
+ *
+ * @return the 32-bit instruction, or 0 if c is illegal or reserved
+ */
+inline uint32_t expandCompressed(uint16_t c) {
+    uint32_t rd = (c >> 7) & 0x1f;          // rd/rs1, full register
+    uint32_t rs2 = (c >> 2) & 0x1f;         // rs2, full register
+    uint32_t rdp = 8 + ((c >> 2) & 0x7);    // rd'/rs2', x8-x15
+    uint32_t rs1p = 8 + ((c >> 7) & 0x7);   // rs1'/rd', x8-x15
+    uint32_t imm6 = ((c >> 7) & 0x20) | ((c >> 2) & 0x1f); // imm[5] | imm[4:0]
+    uint32_t uimm_w = ((c >> 7) & 0x38) | ((c >> 4) & 0x4) | ((c << 1) & 0x40);
+    uint32_t uimm_d = ((c >> 7) & 0x38) | ((c << 1) & 0xc0);
+    uint32_t f3 = c >> 13;
+    switch (c & 3) {
+    case 0:
+        switch (f3) {
+        case 0: { // C.ADDI4SPN
+            uint32_t nzuimm = ((c >> 7) & 0x30) | ((c >> 1) & 0x3c0) | ((c >> 4) & 0x4) | ((c >> 2) & 0x8);
+            return nzuimm ? itype(0x13, 0, rdp, 2, nzuimm) : 0;
+        }
+        case 1: return itype(0x07, 3, rdp, rs1p, uimm_d); // C.FLD
+        case 2: return itype(0x03, 2, rdp, rs1p, uimm_w); // C.LW
+        case 3: return itype(0x03, 3, rdp, rs1p, uimm_d); // C.LD
+        case 5: return stype(0x27, 3, rs1p, rdp, uimm_d); // C.FSD
+        case 6: return stype(0x23, 2, rs1p, rdp, uimm_w); // C.SW
+        case 7: return stype(0x23, 3, rs1p, rdp, uimm_d); // C.SD
+        default: return 0;
+        }
+    case 1:
+        switch (f3) {
+        case 0: return itype(0x13, 0, rd, rd, sext(imm6, 6)); // C.ADDI, C.NOP
+        case 1: return rd ? itype(0x1b, 0, rd, rd, sext(imm6, 6)) : 0; // C.ADDIW
+        case 2: return itype(0x13, 0, rd, 0, sext(imm6, 6)); // C.LI
+        case 3:
+            if (rd == 2) { // C.ADDI16SP
+                uint32_t nzimm = ((c >> 3) & 0x200) | ((c >> 2) & 0x10) | ((c << 1) & 0x40)
+                    | ((c << 4) & 0x180) | ((c << 3) & 0x20);
+                return nzimm ? itype(0x13, 0, 2, 2, sext(nzimm, 10)) : 0;
+            }
+            // C.LUI
+            return imm6 ? ((static_cast<uint32_t>(sext(imm6, 6)) << 12) | (rd << 7) | 0x37) : 0;
+        case 4:
+            switch ((c >> 10) & 3) {
+            case 0: return itype(0x13, 5, rs1p, rs1p, imm6); // C.SRLI
+            case 1: return itype(0x13, 5, rs1p, rs1p, 0x400 | imm6); // C.SRAI
+            case 2: return itype(0x13, 7, rs1p, rs1p, sext(imm6, 6)); // C.ANDI
+            default:
+                switch (((c >> 10) & 4) | ((c >> 5) & 3)) {
+                case 0: return rtype(0x33, 0, 0x20, rs1p, rs1p, rdp); // C.SUB
+                case 1: return rtype(0x33, 4, 0, rs1p, rs1p, rdp); // C.XOR
+                case 2: return rtype(0x33, 6, 0, rs1p, rs1p, rdp); // C.OR
+                case 3: return rtype(0x33, 7, 0, rs1p, rs1p, rdp); // C.AND
+                case 4: return rtype(0x3b, 0, 0x20, rs1p, rs1p, rdp); // C.SUBW
+                case 5: return rtype(0x3b, 0, 0, rs1p, rs1p, rdp); // C.ADDW
+                default: return 0;
+                }
+            }
+        case 5: { // C.J
+            uint32_t offset = ((c >> 1) & 0x800) | ((c >> 7) & 0x10) | ((c >> 1) & 0x300)
+                | ((c << 2) & 0x400) | ((c >> 1) & 0x40) | ((c << 1) & 0x80)
+                | ((c >> 2) & 0xe) | ((c << 3) & 0x20);
+            return jtype(0, sext(offset, 12));
+        }
+        default: { // C.BEQZ, C.BNEZ
+            uint32_t offset = ((c >> 4) & 0x100) | ((c >> 7) & 0x18) | ((c << 1) & 0xc0)
+                | ((c >> 2) & 0x6) | ((c << 3) & 0x20);
+            return btype(f3 == 6 ? 0 : 1, rs1p, 0, sext(offset, 9));
+        }
+        }
+    default:
+        switch (f3) {
+        case 0: return itype(0x13, 1, rd, rd, imm6); // C.SLLI
+        case 1: // C.FLDSP
+            return itype(0x07, 3, rd, 2, ((c >> 7) & 0x20) | ((c >> 2) & 0x18) | ((c << 4) & 0x1c0));
+        case 2: // C.LWSP
+            return rd ? itype(0x03, 2, rd, 2, ((c >> 7) & 0x20) | ((c >> 2) & 0x1c) | ((c << 4) & 0xc0)) : 0;
+        case 3: // C.LDSP
+            return rd ? itype(0x03, 3, rd, 2, ((c >> 7) & 0x20) | ((c >> 2) & 0x18) | ((c << 4) & 0x1c0)) : 0;
+        case 4:
+            if (!(c & 0x1000)) {
+                if (rs2 == 0) {
+                    return rd ? itype(0x67, 0, 0, rd, 0) : 0; // C.JR
+                }
+                return rtype(0x33, 0, 0, rd, 0, rs2); // C.MV
+            }
+            if (rs2 == 0) {
+                return rd ? itype(0x67, 0, 1, rd, 0) : 0x00100073; // C.JALR, C.EBREAK
+            }
+            return rtype(0x33, 0, 0, rd, rd, rs2); // C.ADD
+        case 5: // C.FSDSP
+            return stype(0x27, 3, 2, rs2, ((c >> 7) & 0x38) | ((c >> 1) & 0x1c0));
+        case 6: // C.SWSP
+            return stype(0x23, 2, 2, rs2, ((c >> 7) & 0x3c) | ((c >> 1) & 0xc0));
+        default: // C.SDSP
+            return stype(0x23, 3, 2, rs2, ((c >> 7) & 0x38) | ((c >> 1) & 0x1c0));
+        }
+    }
+}
+
+}
+
 class RISCVDecoder {
 public:
     RISCVDecoder() {}
-    RISCVInstruction *decode(uint32_t instruction) {
+
+    /**
+     * @brief the id of an instruction, or NumInstructionIds if it does not decode
+     */
+    static RISCVInstructionId decodeId(uint32_t instruction) {
+        static constexpr riscv_decode::Tables tables = riscv_decode::buildTables();
+        uint16_t table = tables.level1[riscv_decode::bucket(instruction)];
+        if (table == riscv_decode::NO_TABLE) {
+            return NumInstructionIds;
+        }
+        const riscv_decode::Run &run = tables.level2[table][instruction >> 25];
+        for (uint16_t c = run.start; c < run.start + run.count; c++) {
+            uint16_t id = tables.candidates[c];
+            if ((instruction & riscv_decode::MASKS[id]) == riscv_decode::VALUES[id]) {
+                return static_cast<RISCVInstructionId>(id);
+            }
+        }
+        return NumInstructionIds;
+    }
+
+    /**
+     * @brief the id of an instruction by a linear scan of InstructionTable.h
+     *
+     * The reference decodeId() is checked against.
+     */
+    static RISCVInstructionId decodeIdLinear(uint32_t instruction) {
 #define DEFINSTR(mnemonic, value_under_mask, mask, ...) \
         if ((instruction & mask) == static_cast<uint32_t>(value_under_mask)) { \
-            return new mnemonic##Instruction(instruction); \
+            return mnemonic##InstructionId; \
         }
 #include "InstructionTable.h"
 #undef DEFINSTR
+        return NumInstructionIds;
+    }
+
+    /**
+     * @brief true if the low bits of a word mark a 16-bit compressed instruction
+     */
+    static bool isCompressed(uint32_t instruction) { return (instruction & 3) != 3; }
+
+    /**
+     * @brief decode the instruction at the start of a word, or return null if it does not decode
+     *
+     * A compressed instruction is expanded to the base instruction it
+     * stands for, so it runs through the same handler; only its length()
+     * differs.
+     */
+    static RISCVInstruction *tryDecode(uint32_t instruction) {
+        uint32_t length = 4;
+        if (isCompressed(instruction)) {
+            instruction = riscv_decode::expandCompressed(instruction & 0xffff);
+            length = 2;
+        }
+        RISCVInstructionId id = instruction ? decodeId(instruction) : NumInstructionIds;
+        if (id == NumInstructionIds) {
+            return nullptr;
+        }
+        RISCVInstruction *i = riscv_decode::FACTORIES[id](instruction);
+        i->length_ = length;
+        return i;
+    }
+
+    RISCVInstruction *decode(uint32_t instruction) {
+        if (RISCVInstruction *i = tryDecode(instruction)) {
+            return i;
+        }
         std::stringstream ss;
-        ss << std::hex << std::setw(8) << std::setfill('0') << instruction;
+        if (isCompressed(instruction)) {
+            ss << std::hex << std::setw(4) << std::setfill('0') << (instruction & 0xffff);
+        } else {
+            ss << std::hex << std::setw(8) << std::setfill('0') << instruction;
+        }
         throw std::runtime_error("Unknown instruction: " +ss.str() + "");
     }
 };
@@ -10,6 +10,7 @@
 #include <cassert>
 #include <cfenv>
 #include <cstring>
+#include <vector>
 
 class RISCVInstruction;
 
@@ -36,6 +37,12 @@ public:
     bool reservation_valid_flag;
     uint64_t reservation_address;
 
+    std::vector<uint8_t> _v; //!< vector registers, vlenb() bytes each; empty without a vector unit
+    uint64_t        _vl;     //!< vector length
+    uint64_t        _vtype;  //!< vector type; VTYPE_VILL until the first vsetvl
+
+    static constexpr uint64_t VTYPE_VILL = 1ull << 63; //!< vtype is illegal
+
     /**
      * @brief floating point class bitmasks
      */
@@ -52,7 +59,9 @@ public:
 
     RISCVHart()
         : _rm(FE_TONEAREST)
-        , _pc(0) {
+        , _pc(0)
+        , _vl(0)
+        , _vtype(VTYPE_VILL) {
         memset(_x, 0, sizeof(_x));
         memset(_f, 0, sizeof(_f));        
     }
@@ -233,6 +242,49 @@ public:
     int &rm() {
         return _rm;
     }
+
+    /**
+     * @brief give the hart a vector unit of vlen bits, or none if vlen is 0
+     */
+    void setVLEN(uint64_t vlen) {
+        _v.assign(32 * (vlen / 8), 0);
+        _vl = 0;
+        _vtype = VTYPE_VILL;
+    }
+
+    /**
+     * @brief bytes per vector register; 0 without a vector unit
+     */
+    uint64_t vlenb() const {
+        return _v.size() / 32;
+    }
+
+    /**
+     * @brief element idx of the register group starting at vreg
+     */
+    template <typename T>
+    T vget(uint32_t vreg, uint64_t idx) const {
+        T e;
+        memcpy(&e, &_v[vreg * vlenb() + idx * sizeof(T)], sizeof(T));
+        return e;
+    }
+
+    template <typename T>
+    void vset(uint32_t vreg, uint64_t idx, T e) {
+        memcpy(&_v[vreg * vlenb() + idx * sizeof(T)], &e, sizeof(T));
+    }
+
+    /**
+     * @brief bit idx of mask register vreg
+     */
+    bool vmask(uint32_t vreg, uint64_t idx) const {
+        return (_v[vreg * vlenb() + idx / 8] >> (idx % 8)) & 1;
+    }
+
+    void vsetmask(uint32_t vreg, uint64_t idx, bool bit) {
+        uint8_t &byte = _v[vreg * vlenb() + idx / 8];
+        byte = (byte & ~(1 << (idx % 8))) | (bit << (idx % 8));
+    }
     
     std::string to_string() const {
         std::stringstream ss;
@@ -53,6 +53,11 @@ public:
     uint32_t shamt5() const { return shamt(); }
     uint32_t shamt6() const { return (instruction_ >> 20) & 0x3F; }
     uint32_t instruction() const { return instruction_; }
+    /**
+     * bytes of program text the instruction occupies; 2 if it was
+     * expanded from a compressed instruction
+     */
+    uint32_t length() const { return length_; }
     bool uses_rs1()  const { return uses_ & _RS1_; }
     bool uses_rs2()  const { return uses_ & _RS2_; }
     bool uses_rs3()  const { return uses_ & _RS3_; }
@@ -63,6 +68,7 @@ public:
     bool uses_frd()  const { return uses_ & _FRD_; }
     uint32_t instruction_;
     uint32_t uses_;
+    uint32_t length_ = 4;
 };
 
 #endif
@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+
+#ifndef RISCVPROGRAMIMAGE_HPP
+#define RISCVPROGRAMIMAGE_HPP
+#include "ICacheBacking.hpp"
+#include "RISCVDecoder.hpp"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A loaded program, shared by every core that runs it
+ *
+ * Holds the mapped ELF, its flattened text, and the instruction at every
+ * text word decoded up front; every halfword if the ELF is flagged as
+ * using compressed instructions. Nothing changes after construction, so
+ * cores on different threads read it without locking.
+ *
+ * Use get() rather than the constructor; it hands out one image per path
+ * and frees it when the last core lets go.
+ */
+class RISCVProgramImage {
+public:
+    /**
+     * @brief the shared image of the program at path, loading it if needed
+     */
+    static std::shared_ptr<RISCVProgramImage> get(const std::string &path) {
+        static std::mutex lock;
+        static std::map<std::string, std::weak_ptr<RISCVProgramImage>> images;
+        std::lock_guard<std::mutex> guard(lock);
+        std::weak_ptr<RISCVProgramImage> &entry = images[path];
+        std::shared_ptr<RISCVProgramImage> image = entry.lock();
+        if (!image) {
+            image = std::make_shared<RISCVProgramImage>(path);
+            entry = image;
+        }
+        return image;
+    }
+
+    /**
+     * @brief constructor
+     *
+     * @param path the ELF file
+     */
+    explicit RISCVProgramImage(const std::string &path)
+        : backing_(path.c_str())
+        , slot_shift_((backing_.ehdr()->e_flags & EF_RISCV_RVC) ? 1 : 2) {
+        predecode();
+    }
+
+    RISCVProgramImage(const RISCVProgramImage &) = delete;
+    RISCVProgramImage &operator=(const RISCVProgramImage &) = delete;
+
+    /**
+     * @brief the mapped ELF file
+     */
+    ICacheBacking *backing() { return &backing_; }
+
+    /**
+     * @brief true if the ELF is flagged as using compressed instructions
+     */
+    bool compressed() const { return slot_shift_ == 1; }
+
+    /**
+     * @brief the decoded instruction at pc
+     *
+     * @return null if pc is outside the flattened text, is not at a predecoded
+     * slot, or its word does not decode
+     */
+    RISCVInstruction *lookup(uint64_t pc) const {
+        uint64_t offset = pc - backing_.textBase();
+        uint64_t slot = offset >> slot_shift_;
+        if ((offset & ((1ull << slot_shift_) - 1)) || slot >= instructions_.size()) {
+            return nullptr;
+        }
+        return instructions_[slot].get();
+    }
+
+private:
+    /**
+     * @brief decode the instruction starting at each slot of the flattened text
+     *
+     * With compressed instructions any halfword may start one; slots in
+     * the middle of a 32-bit instruction are decoded too and simply never
+     * looked up. Without them only words are decoded, halving the work
+     * and the memory held.
+     */
+    void predecode() {
+        instructions_.resize(backing_.textSize() >> slot_shift_);
+        for (uint64_t slot = 0; slot < instructions_.size(); slot++) {
+            uint32_t word = backing_.read(backing_.textBase() + (slot << slot_shift_));
+            instructions_[slot].reset(RISCVDecoder::tryDecode(word));
+        }
+    }
+
+    ICacheBacking backing_; //!< the mapped ELF file
+    uint64_t slot_shift_; //!< log2 of the bytes per predecoded slot: 1 with compressed instructions, else 2
+    std::vector<std::unique_ptr<RISCVInstruction>> instructions_; //!< decoded text by (pc - text base) >> slot_shift_
+};
+
+#endif
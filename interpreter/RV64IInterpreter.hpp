@@ -7,6 +7,8 @@
 #include "RISCVInterpreter.hpp"
 #include "RISCVInstruction.hpp"
 #include "RISCVHart.hpp"
+#include "RISCVBitmanip.hpp"
+#include <algorithm>
 #include <iostream>
 
 class RV64IInterpreter : public RISCVInterpreter
@@ -16,14 +18,14 @@ public:
 
     void visitLUI(RISCVHart &hart, RISCVInstruction &i) override {
         hart.sx(i.rd()) = static_cast<int64_t>(i.SUimm());
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitAUIPC(RISCVHart &hart, RISCVInstruction &i) override {
         hart.x(i.rd()) = hart.pc() + static_cast<int64_t>(i.SUimm());
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitJAL(RISCVHart &hart, RISCVInstruction &i) override {
-        hart.x(i.rd()) = hart.pc() + 4;
+        hart.x(i.rd()) = hart.pc() + i.length();
         hart.pc() += i.Jimm();
     }
 
@@ -32,7 +34,7 @@ public:
         hart.reservation_valid_flag = true;
         hart.reservation_address = i.rs1();
         hart.x(i.rd()) = load;
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
 //    void visitLRW(RISCVHart &hart, RISCVInstruction &i) override {
@@ -43,7 +45,7 @@ public:
 //        hart.reservation_valid_flag = true;
 //        hart.reservation_address    = addr;
 
-//        hart.pc() += 4;
+//        hart.pc() += i.length();
 //    }
 
 
@@ -54,12 +56,12 @@ public:
         } else {
             hart.x(i.rd()) = 0xDEADBEEF;
         }
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitJALR(RISCVHart &hart, RISCVInstruction &i) override {
         uint64_t jmp_target = (hart.x(i.rs1()) + i.SIimm());
-        hart.x(i.rd()) = hart.pc() + 4;
+        hart.x(i.rd()) = hart.pc() + i.length();
         hart.pc() = jmp_target;
 
         int rs1 = i.rs1();
@@ -73,122 +75,122 @@ public:
         if (hart.x(i.rs1()) == hart.x(i.rs2())) {
             hart.pc() += i.Bimm();
         } else {
-            hart.pc() += 4;
+            hart.pc() += i.length();
         }
     }
     void visitBNE(RISCVHart &hart, RISCVInstruction &i) override {
         if (hart.x(i.rs1()) != hart.x(i.rs2())) {
             hart.pc() += i.Bimm();
         } else {
-            hart.pc() += 4;
+            hart.pc() += i.length();
         }
     }
     void visitBLT(RISCVHart &hart, RISCVInstruction &i) override {
         if (hart.sx(i.rs1()) < hart.sx(i.rs2())) {
             hart.pc() += i.Bimm();
         } else {
-            hart.pc() += 4;
+            hart.pc() += i.length();
         }
     }
     void visitBGE(RISCVHart &hart, RISCVInstruction &i) override {
         if (hart.sx(i.rs1()) >= hart.sx(i.rs2())) {
             hart.pc() += i.Bimm();
         } else {
-            hart.pc() += 4;
+            hart.pc() += i.length();
         }
     }
     void visitBLTU(RISCVHart &hart, RISCVInstruction &i) override {
         if (hart.x(i.rs1()) < hart.x(i.rs2())) {
             hart.pc() += i.Bimm();
         } else {
-            hart.pc() += 4;
+            hart.pc() += i.length();
         }
     }
     void visitBGEU(RISCVHart &hart, RISCVInstruction &i) override {
         if (hart.x(i.rs1()) >=hart.x(i.rs2())) {
             hart.pc() += i.Bimm();
         } else {
-            hart.pc() += 4;
+            hart.pc() += i.length();
         }
     }
 
     // skip loads for now
     void visitADDI(RISCVHart &hart, RISCVInstruction &i) override {
         hart.x(i.rd()) = hart.sx(i.rs1()) + i.SIimm();
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitSLTI(RISCVHart &hart, RISCVInstruction &i) override {
         hart.x(i.rd()) = hart.sx(i.rs1()) < i.SIimm();
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitSLTIU(RISCVHart &hart, RISCVInstruction &i) override {
         uint64_t imm = i.SIimm(); // sign extend
         hart.x(i.rd()) = hart.x(i.rs1()) < imm;
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitXORI(RISCVHart &hart, RISCVInstruction &i) override {
         hart.x(i.rd()) = hart.x(i.rs1()) ^ i.SIimm();
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitORI(RISCVHart &hart, RISCVInstruction &i) override {
         hart.x(i.rd()) = hart.x(i.rs1()) | i.SIimm();
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitANDI(RISCVHart &hart, RISCVInstruction &i) override {
         hart.x(i.rd()) = hart.x(i.rs1()) & i.SIimm();
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitSLLI(RISCVHart &hart, RISCVInstruction &i) override {
         hart.x(i.rd()) = hart.x(i.rs1()) << i.shamt6();
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitSRLI(RISCVHart &hart, RISCVInstruction &i) override {
         hart.x(i.rd()) = hart.x(i.rs1()) >> i.shamt6();
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitSRAI(RISCVHart &hart, RISCVInstruction &i) override {
         hart.x(i.rd()) = hart.sx(i.rs1()) >> i.shamt6();
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitADD(RISCVHart &hart, RISCVInstruction &i) override {
         hart.x(i.rd()) = hart.sx(i.rs1()) + hart.sx(i.rs2());
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitSUB(RISCVHart &hart, RISCVInstruction &i) override {
         hart.x(i.rd()) = hart.sx(i.rs1()) - hart.sx(i.rs2());
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitSLL(RISCVHart &hart, RISCVInstruction &i) override {
         hart.x(i.rd()) = hart.x(i.rs1()) << hart.x(i.rs2());
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitSLT(RISCVHart &hart, RISCVInstruction &i) override {
         hart.x(i.rd()) = hart.sx(i.rs1()) < hart.sx(i.rs2());
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitSLTU(RISCVHart &hart, RISCVInstruction &i) override {
         hart.x(i.rd()) = hart.x(i.rs1()) < hart.x(i.rs2());
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitXOR(RISCVHart &hart, RISCVInstruction &i) override {
         hart.x(i.rd()) = hart.x(i.rs1()) ^ hart.x(i.rs2());
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitSRL(RISCVHart &hart, RISCVInstruction &i) override {
         hart.x(i.rd()) = hart.x(i.rs1()) >> hart.x(i.rs2());
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitSRA(RISCVHart &hart, RISCVInstruction &i) override {
         hart.x(i.rd()) = hart.sx(i.rs1()) >> hart.x(i.rs2());
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitOR(RISCVHart &hart, RISCVInstruction &i) override {
         hart.x(i.rd()) = hart.x(i.rs1()) | hart.x(i.rs2());
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitAND(RISCVHart &hart, RISCVInstruction &i) override {
         hart.x(i.rd()) = hart.x(i.rs1()) & hart.x(i.rs2());
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     // skip fence for now
@@ -201,28 +203,28 @@ public:
         int32_t rs = hart.sx(i.rs1());
         int32_t rd = rs + i.SIimm();
         hart.sx(i.rd()) = rd;
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitSLLIW(RISCVHart &hart, RISCVInstruction &i) override {
         // truncate to signed 32 bits
         uint32_t rs = hart.sx(i.rs1());
         int32_t rd = rs << i.shamt5();
         hart.sx(i.rd()) = rd;
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitSRLIW(RISCVHart &hart, RISCVInstruction &i) override {
         // truncate to signed 32 bits
         uint32_t rs = hart.x(i.rs1());
         int32_t rd = rs >> i.shamt5();
         hart.sx(i.rd()) = rd;
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitSRAIW(RISCVHart &hart, RISCVInstruction &i) override {
         // truncate to signed 32 bits
         int32_t rs = hart.sx(i.rs1());
         int32_t rd = rs >> i.shamt5();
         hart.sx(i.rd()) = rd;
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitADDW(RISCVHart &hart, RISCVInstruction &i) override {
         // truncate to signed 32 bits
@@ -231,7 +233,7 @@ public:
         int32_t rd = rs1 + rs2;
         //std::cout << "ADDW: rs1 = " << rs1 << ", rs2 = " << rs2 << ", rd = " << rd << std::endl;
         hart.x(i.rd()) = rd;
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitSUBW(RISCVHart &hart, RISCVInstruction &i) override {
         // truncate to signed 32 bits
@@ -239,7 +241,7 @@ public:
         int32_t rs2 = hart.sx(i.rs2());
         int32_t rd = rs1 - rs2;
         hart.x(i.rd()) = rd;
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitSLLW(RISCVHart &hart, RISCVInstruction &i) override {
         // truncate to signed 32 bits
@@ -247,7 +249,7 @@ public:
         uint32_t rs2 = hart.sx(i.rs2());
         int32_t rd = rs1 << rs2;
         hart.x(i.rd()) = rd;
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitSRLW(RISCVHart &hart, RISCVInstruction &i) override {
         // truncate to signed 32 bits
@@ -255,7 +257,7 @@ public:
         uint32_t rs2 = hart.sx(i.rs2());
         int32_t rd = rs1 >> rs2;
         hart.x(i.rd()) = rd;
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitSRAW(RISCVHart &hart, RISCVInstruction &i) override {
         // truncate to signed 32 bits
@@ -263,7 +265,177 @@ public:
         int32_t rs2 = hart.sx(i.rs2());
         int32_t rd = rs1 >> rs2;
         hart.x(i.rd()) = rd;
-        hart.pc() += 4;
+        hart.pc() += i.length();
+    }
+
+    /* Zba */
+    void visitADD_UW(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.x(i.rd()) = hart.x(i.rs2()) + static_cast<uint32_t>(hart.x(i.rs1()));
+        hart.pc() += i.length();
+    }
+    void visitSH1ADD(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.x(i.rd()) = hart.x(i.rs2()) + (hart.x(i.rs1()) << 1);
+        hart.pc() += i.length();
+    }
+    void visitSH2ADD(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.x(i.rd()) = hart.x(i.rs2()) + (hart.x(i.rs1()) << 2);
+        hart.pc() += i.length();
+    }
+    void visitSH3ADD(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.x(i.rd()) = hart.x(i.rs2()) + (hart.x(i.rs1()) << 3);
+        hart.pc() += i.length();
+    }
+    void visitSH1ADD_UW(RISCVHart &hart, RISCVInstruction &i) override {
+        uint64_t index = static_cast<uint32_t>(hart.x(i.rs1()));
+        hart.x(i.rd()) = hart.x(i.rs2()) + (index << 1);
+        hart.pc() += i.length();
+    }
+    void visitSH2ADD_UW(RISCVHart &hart, RISCVInstruction &i) override {
+        uint64_t index = static_cast<uint32_t>(hart.x(i.rs1()));
+        hart.x(i.rd()) = hart.x(i.rs2()) + (index << 2);
+        hart.pc() += i.length();
+    }
+    void visitSH3ADD_UW(RISCVHart &hart, RISCVInstruction &i) override {
+        uint64_t index = static_cast<uint32_t>(hart.x(i.rs1()));
+        hart.x(i.rd()) = hart.x(i.rs2()) + (index << 3);
+        hart.pc() += i.length();
+    }
+    void visitSLLI_UW(RISCVHart &hart, RISCVInstruction &i) override {
+        uint64_t index = static_cast<uint32_t>(hart.x(i.rs1()));
+        hart.x(i.rd()) = index << i.shamt6();
+        hart.pc() += i.length();
+    }
+
+    /* Zbb */
+    void visitANDN(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.x(i.rd()) = hart.x(i.rs1()) & ~hart.x(i.rs2());
+        hart.pc() += i.length();
+    }
+    void visitORN(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.x(i.rd()) = hart.x(i.rs1()) | ~hart.x(i.rs2());
+        hart.pc() += i.length();
+    }
+    void visitXNOR(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.x(i.rd()) = ~(hart.x(i.rs1()) ^ hart.x(i.rs2()));
+        hart.pc() += i.length();
+    }
+    void visitCLZ(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.x(i.rd()) = riscv_bitmanip::clz(hart.x(i.rs1()));
+        hart.pc() += i.length();
+    }
+    void visitCTZ(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.x(i.rd()) = riscv_bitmanip::ctz(hart.x(i.rs1()));
+        hart.pc() += i.length();
+    }
+    void visitCPOP(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.x(i.rd()) = riscv_bitmanip::cpop(hart.x(i.rs1()));
+        hart.pc() += i.length();
+    }
+    void visitCLZW(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.x(i.rd()) = riscv_bitmanip::clzw(hart.x(i.rs1()));
+        hart.pc() += i.length();
+    }
+    void visitCTZW(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.x(i.rd()) = riscv_bitmanip::ctzw(hart.x(i.rs1()));
+        hart.pc() += i.length();
+    }
+    void visitCPOPW(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.x(i.rd()) = riscv_bitmanip::cpopw(hart.x(i.rs1()));
+        hart.pc() += i.length();
+    }
+    void visitSEXT_B(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.sx(i.rd()) = static_cast<int8_t>(hart.x(i.rs1()));
+        hart.pc() += i.length();
+    }
+    void visitSEXT_H(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.sx(i.rd()) = static_cast<int16_t>(hart.x(i.rs1()));
+        hart.pc() += i.length();
+    }
+    void visitZEXT_H(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.x(i.rd()) = static_cast<uint16_t>(hart.x(i.rs1()));
+        hart.pc() += i.length();
+    }
+    void visitMIN(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.sx(i.rd()) = std::min<int64_t>(hart.sx(i.rs1()), hart.sx(i.rs2()));
+        hart.pc() += i.length();
+    }
+    void visitMINU(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.x(i.rd()) = std::min<uint64_t>(hart.x(i.rs1()), hart.x(i.rs2()));
+        hart.pc() += i.length();
+    }
+    void visitMAX(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.sx(i.rd()) = std::max<int64_t>(hart.sx(i.rs1()), hart.sx(i.rs2()));
+        hart.pc() += i.length();
+    }
+    void visitMAXU(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.x(i.rd()) = std::max<uint64_t>(hart.x(i.rs1()), hart.x(i.rs2()));
+        hart.pc() += i.length();
+    }
+    void visitROL(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.x(i.rd()) = riscv_bitmanip::rol(hart.x(i.rs1()), hart.x(i.rs2()));
+        hart.pc() += i.length();
+    }
+    void visitROR(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.x(i.rd()) = riscv_bitmanip::ror(hart.x(i.rs1()), hart.x(i.rs2()));
+        hart.pc() += i.length();
+    }
+    void visitRORI(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.x(i.rd()) = riscv_bitmanip::ror(hart.x(i.rs1()), i.shamt6());
+        hart.pc() += i.length();
+    }
+    void visitROLW(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.sx(i.rd()) = riscv_bitmanip::rolw(hart.x(i.rs1()), hart.x(i.rs2()));
+        hart.pc() += i.length();
+    }
+    void visitRORW(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.sx(i.rd()) = riscv_bitmanip::rorw(hart.x(i.rs1()), hart.x(i.rs2()));
+        hart.pc() += i.length();
+    }
+    void visitRORIW(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.sx(i.rd()) = riscv_bitmanip::rorw(hart.x(i.rs1()), i.shamt5());
+        hart.pc() += i.length();
+    }
+    void visitORC_B(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.x(i.rd()) = riscv_bitmanip::orcb(hart.x(i.rs1()));
+        hart.pc() += i.length();
+    }
+    void visitREV8(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.x(i.rd()) = riscv_bitmanip::rev8(hart.x(i.rs1()));
+        hart.pc() += i.length();
+    }
+
+    /* Zbs */
+    void visitBCLR(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.x(i.rd()) = hart.x(i.rs1()) & ~(1ull << (hart.x(i.rs2()) & 63));
+        hart.pc() += i.length();
+    }
+    void visitBCLRI(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.x(i.rd()) = hart.x(i.rs1()) & ~(1ull << i.shamt6());
+        hart.pc() += i.length();
+    }
+    void visitBEXT(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.x(i.rd()) = (hart.x(i.rs1()) >> (hart.x(i.rs2()) & 63)) & 1;
+        hart.pc() += i.length();
+    }
+    void visitBEXTI(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.x(i.rd()) = (hart.x(i.rs1()) >> i.shamt6()) & 1;
+        hart.pc() += i.length();
+    }
+    void visitBINV(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.x(i.rd()) = hart.x(i.rs1()) ^ (1ull << (hart.x(i.rs2()) & 63));
+        hart.pc() += i.length();
+    }
+    void visitBINVI(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.x(i.rd()) = hart.x(i.rs1()) ^ (1ull << i.shamt6());
+        hart.pc() += i.length();
+    }
+    void visitBSET(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.x(i.rd()) = hart.x(i.rs1()) | (1ull << (hart.x(i.rs2()) & 63));
+        hart.pc() += i.length();
+    }
+    void visitBSETI(RISCVHart &hart, RISCVInstruction &i) override {
+        hart.x(i.rd()) = hart.x(i.rs1()) | (1ull << i.shamt6());
+        hart.pc() += i.length();
     }
 };
 
@@ -36,7 +36,7 @@ public:
         hart.f(i.rd()) = std::fmaf(hart.sf(i.rs1()),
                                    hart.sf(i.rs2()),
                                    hart.sf(i.rs3()));
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFMSUB_S_DYN(RISCVHart &hart, RISCVInstruction &i) override {
@@ -44,7 +44,7 @@ public:
         hart.f(i.rd()) = std::fmaf(hart.sf(i.rs1()),
                                    hart.sf(i.rs2()),
                                    -hart.sf(i.rs3()));
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFNMSUB_S_DYN(RISCVHart &hart, RISCVInstruction &i) override {
@@ -52,7 +52,7 @@ public:
         hart.f(i.rd()) = std::fmaf(-hart.sf(i.rs1()),
                                    hart.sf(i.rs2()),
                                    hart.sf(i.rs3()));
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFNMADD_S_DYN(RISCVHart &hart, RISCVInstruction &i) override {
@@ -60,134 +60,134 @@ public:
         hart.f(i.rd()) = std::fmaf(-hart.sf(i.rs1()),
                                    hart.sf(i.rs2()),
                                    -hart.sf(i.rs3()));
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFADD_S_DYN(RISCVHart &hart, RISCVInstruction &i) override {
         RoundingModeGuard guard(hart.rm());
         hart.f(i.rd()) = hart.sf(i.rs1()) + hart.sf(i.rs2());
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFSUB_S_DYN(RISCVHart &hart, RISCVInstruction &i) override {
         RoundingModeGuard guard(hart.rm());
         hart.f(i.rd()) = hart.sf(i.rs1()) - hart.sf(i.rs2());
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFMUL_S_DYN(RISCVHart &hart, RISCVInstruction &i) override {
         RoundingModeGuard guard(hart.rm());
         hart.f(i.rd()) = hart.sf(i.rs1()) * hart.sf(i.rs2());
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFDIV_S_DYN(RISCVHart &hart, RISCVInstruction &i) override {
         RoundingModeGuard guard(hart.rm());
         hart.f(i.rd()) = hart.sf(i.rs1()) / hart.sf(i.rs2());
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFSQRT_S_DYN(RISCVHart &hart, RISCVInstruction &i) override {
         RoundingModeGuard guard(hart.rm());
         hart.f(i.rd()) = std::sqrt(hart.sf(i.rs1()));
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFSGNJ_S(RISCVHart &hart, RISCVInstruction &i) override {
         hart.f(i.rd()) = std::copysignf(hart.sf(i.rs1()), hart.sf(i.rs2()));
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFSGNJN_S(RISCVHart &hart, RISCVInstruction &i) override {
         hart.f(i.rd()) = std::copysignf(hart.sf(i.rs1()), -hart.sf(i.rs2()));
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFSGNJX_S(RISCVHart &hart, RISCVInstruction &i) override {
         float s1 = std::copysignf(1.0, hart.sf(i.rs1()));
         float s2 = std::copysignf(1.0, hart.sf(i.rs2()));
         hart.f(i.rd()) = hart.sf(i.rs1()) * s2 * s1;
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFMIN_S(RISCVHart &hart, RISCVInstruction &i) override {
         hart.f(i.rd()) = std::fminf(hart.sf(i.rs1()), hart.sf(i.rs2()));
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFMAX_S(RISCVHart &hart, RISCVInstruction &i) override {
         hart.f(i.rd()) = std::fmaxf(hart.sf(i.rs1()), hart.sf(i.rs2()));
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFCVT_W_S_DYN(RISCVHart &hart, RISCVInstruction &i) override {
         RoundingModeGuard guard(hart.rm());
         int32_t result = std::rintf(hart.sf(i.rs1()));
         hart.sx(i.rd()) = result;
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFCVT_D_WU_RNE(RISCVHart &hart, RISCVInstruction &i) override {
         RoundingModeGuard guard(hart.rm());
         uint32_t src = static_cast<uint32_t>(hart.x(i.rs1()));
         hart.df(i.rd()) = static_cast<double>(src);
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFCVT_L_S_DYN(RISCVHart &hart, RISCVInstruction &i) override {
         RoundingModeGuard guard(hart.rm());
         int64_t result = std::rintf(hart.sf(i.rs1()));
         hart.sx(i.rd()) = result;
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFCVT_WU_S_DYN(RISCVHart &hart, RISCVInstruction &i) override {
         RoundingModeGuard guard(hart.rm());
         uint32_t result = std::rintf(hart.sf(i.rs1()));
         hart.x(i.rd()) = result;
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFCVT_LU_S_DYN(RISCVHart &hart, RISCVInstruction &i) override {
         RoundingModeGuard guard(hart.rm());
         uint64_t result = std::rintf(hart.sf(i.rs1()));
         hart.x(i.rd()) = result;
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFCVT_S_W_DYN(RISCVHart &hart, RISCVInstruction &i) override {
         RoundingModeGuard guard(hart.rm());
         int32_t result = static_cast<int32_t>(hart.x(i.rs1()));
         hart.f(i.rd()) = result;
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFCVT_S_D_DYN(RISCVHart &hart, RISCVInstruction &i) override {
         RoundingModeGuard guard(hart.rm());
         double src = hart.df(i.rs1());
         hart.f(i.rd()) = static_cast<float>(src);
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFCVT_S_L_DYN(RISCVHart &hart, RISCVInstruction &i) override {
         RoundingModeGuard guard(hart.rm());
         int64_t result = static_cast<int64_t>(hart.x(i.rs1()));
         hart.f(i.rd()) = result;
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFCVT_S_WU_DYN(RISCVHart &hart, RISCVInstruction &i) override {
         RoundingModeGuard guard(hart.rm());
         uint32_t result = static_cast<uint32_t>(hart.x(i.rs1()));
         hart.f(i.rd()) = result;
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFCVT_S_LU_DYN(RISCVHart &hart, RISCVInstruction &i) override {
         RoundingModeGuard guard(hart.rm());
         uint64_t result = static_cast<uint64_t>(hart.x(i.rs1()));
         hart.f(i.rd()) = result;
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFMV_X_W(RISCVHart &hart, RISCVInstruction &i) override {
@@ -197,7 +197,7 @@ public:
         } u;
         u.f_ = hart.sf(i.rs1());
         hart.sx(i.rd()) = u.u_;
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFMV_X_D(RISCVHart &hart, RISCVInstruction &i) override {
@@ -207,7 +207,7 @@ public:
         } u;
         u.f_ = hart.df(i.rs1());
         hart.sx(i.rd()) = u.u_;
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFMV_D_X(RISCVHart &hart, RISCVInstruction &i) override {
@@ -217,7 +217,7 @@ public:
         } u;
         u.u_ = { static_cast<uint64_t>(hart.x(i.rs1())) };
         hart.df(i.rd()) = u.f_;
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFMV_W_X(RISCVHart &hart, RISCVInstruction &i) override {
@@ -227,7 +227,7 @@ public:
         } u;
         u.u_ = { static_cast<uint32_t>(hart.x(i.rs1())) };
         hart.sf(i.rd()) = u.f_;
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFEQ_S(RISCVHart &hart, RISCVInstruction &i) override {
@@ -238,7 +238,7 @@ public:
             = std::isnan(f1)||std::isnan(f2)
             ? 0
             : hart.sf(i.rs1()) == hart.sf(i.rs2());
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFEQ_D(RISCVHart &hart, RISCVInstruction &i) override {
@@ -248,7 +248,7 @@ public:
             = std::isnan(f1)||std::isnan(f2)
             ? 0
             : hart.df(i.rs1()) == hart.df(i.rs2());
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFLT_S(RISCVHart &hart, RISCVInstruction &i) override {
@@ -259,7 +259,7 @@ public:
             throw std::runtime_error("FLT_S: nan in " + which);
         }
         hart.x(i.rd()) = hart.sf(i.rs1()) < hart.sf(i.rs2());
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFLE_S(RISCVHart &hart, RISCVInstruction &i) override {
@@ -270,7 +270,7 @@ public:
             throw std::runtime_error("FLE_S: nan in " + which);
         }
         hart.x(i.rd()) = hart.sf(i.rs1()) <= hart.sf(i.rs2());
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitFCLASS_S(RISCVHart &hart, RISCVInstruction &i) override {
@@ -297,7 +297,7 @@ public:
         riscvbits::setbit(result, RISCVHart::FCLASS_IS_QUIET_NAN,
                           std::isnan(f));
         hart.x(i.rd()) = result;
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 };
 #endif
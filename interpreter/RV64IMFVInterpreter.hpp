@@ -0,0 +1,653 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+
+#ifndef RV64IMFVINTERPRETER_HPP
+#define RV64IMFVINTERPRETER_HPP
+#include "RISCVInstruction.hpp"
+#include "RISCVHart.hpp"
+#include "RV64IMFInterpreter.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+/**
+ * @brief Interprets the Zve64d vector subset
+ *
+ * Covers vsetvl, integer and floating point arithmetic, compares,
+ * merges, reductions and mask instructions. Masked-off and tail
+ * elements are left undisturbed, which both the agnostic and the
+ * undisturbed policies allow, and vstart is always 0.
+ *
+ * Vector loads and stores are left to the simulator, which turns them
+ * into memory requests.
+ */
+class RV64IMFVInterpreter : public RV64IMFInterpreter
+{
+public:
+    RV64IMFVInterpreter(): RV64IMFInterpreter() {}
+
+    /**
+     * @brief where the second operand of an arithmetic instruction comes from
+     */
+    enum Operand {
+        VV,  //!< vs1
+        VX,  //!< x[rs1]
+        VI,  //!< the sign-extended 5-bit immediate
+        VUI, //!< the zero-extended 5-bit immediate
+        VF,  //!< f[rs1]
+    };
+
+    /**
+     * @brief log2 of the element size in bytes
+     */
+    static uint64_t vsew(uint64_t vtype) { return (vtype >> 3) & 7; }
+
+    /**
+     * @brief element size in bytes
+     */
+    static uint64_t sew(const RISCVHart &hart) { return 1ull << vsew(hart._vtype); }
+
+    /**
+     * @brief elements a vtype setting holds, or 0 if the setting is not supported
+     */
+    static uint64_t vlmax(const RISCVHart &hart, uint64_t vtype) {
+        uint64_t lmul = vtype & 7;
+        uint64_t sew_bits = 8ull << vsew(vtype);
+        uint64_t vlen = hart.vlenb() * 8;
+        if ((vtype >> 8) != 0 || vsew(vtype) > 3 || lmul == 4) {
+            return 0;
+        }
+        if (lmul < 4) {
+            return (vlen << lmul) / sew_bits;
+        }
+        // fractional lmul needs SEW <= ELEN * LMUL
+        uint64_t shift = 8 - lmul;
+        if (sew_bits > (64u >> shift)) {
+            return 0;
+        }
+        return (vlen >> shift) / sew_bits;
+    }
+
+    /**
+     * @brief check that vreg starts a register group of elements eew bytes wide
+     *
+     * The group holds EEW/SEW * LMUL registers; groups of more than eight
+     * or that start off a multiple of their size are reserved.
+     */
+    static void checkGroup(const RISCVHart &hart, const RISCVInstruction &i, uint32_t vreg, uint64_t eew) {
+        uint64_t lmul = hart._vtype & 7;
+        uint64_t lmul8 = lmul < 4 ? 8ull << lmul : 8ull >> (8 - lmul);
+        uint64_t emul8 = lmul8 * eew / sew(hart);
+        uint64_t regs = std::max<uint64_t>(emul8 / 8, 1);
+        if (emul8 > 64 || vreg % regs != 0) {
+            throw std::runtime_error(std::string(i.getMnemonic()) + ": v" + std::to_string(vreg)
+                                     + " does not start a register group");
+        }
+    }
+
+    /**
+     * @brief throw unless vtype is legal
+     */
+    static void requireVector(const RISCVHart &hart, const RISCVInstruction &i) {
+        if (hart._vtype & RISCVHart::VTYPE_VILL) {
+            throw std::runtime_error(std::string(i.getMnemonic()) + ": vtype is illegal");
+        }
+    }
+
+    /**
+     * @brief true unless the instruction is masked and v0 masks off element e
+     */
+    static bool active(const RISCVHart &hart, const RISCVInstruction &i, uint64_t e) {
+        return vm(i) || hart.vmask(0, e);
+    }
+
+    static bool vm(const RISCVInstruction &i) { return (i.instruction() >> 25) & 1; }
+
+    static int32_t simm5(const RISCVInstruction &i) {
+        return static_cast<int32_t>(i.instruction() << 12) >> 27;
+    }
+
+    // configuration
+    void visitVSETVLI(RISCVHart &hart, RISCVInstruction &i) override {
+        setVType(hart, i, avl(hart, i), (i.instruction() >> 20) & 0x7ff);
+    }
+
+    void visitVSETIVLI(RISCVHart &hart, RISCVInstruction &i) override {
+        setVType(hart, i, i.rs1(), (i.instruction() >> 20) & 0x3ff);
+    }
+
+    void visitVSETVL(RISCVHart &hart, RISCVInstruction &i) override {
+        setVType(hart, i, avl(hart, i), hart.x(i.rs2()));
+    }
+
+    // integer arithmetic
+#define DEFVBINARY(name, elements, form, expr)                          \
+    void visit##name(RISCVHart &hart, RISCVInstruction &i) override {   \
+        binary<elements>(hart, i, form, [](auto a, auto b) { return (expr); }); \
+    }
+#define DEFVBINARY_VV_VX(name, expr)                                    \
+    DEFVBINARY(name##_VV, IntElements, VV, expr)                        \
+    DEFVBINARY(name##_VX, IntElements, VX, expr)
+#define DEFVBINARY_VV_VX_VI(name, expr)                                 \
+    DEFVBINARY_VV_VX(name, expr)                                        \
+    DEFVBINARY(name##_VI, IntElements, VI, expr)
+
+    DEFVBINARY_VV_VX_VI(VADD, a + b)
+    DEFVBINARY_VV_VX(VSUB, a - b)
+    DEFVBINARY(VRSUB_VX, IntElements, VX, b - a)
+    DEFVBINARY(VRSUB_VI, IntElements, VI, b - a)
+    DEFVBINARY_VV_VX(VMINU, std::min(a, b))
+    DEFVBINARY_VV_VX(VMIN,  sgn(a) < sgn(b) ? a : b)
+    DEFVBINARY_VV_VX(VMAXU, std::max(a, b))
+    DEFVBINARY_VV_VX(VMAX,  sgn(a) < sgn(b) ? b : a)
+    DEFVBINARY_VV_VX_VI(VAND, a & b)
+    DEFVBINARY_VV_VX_VI(VOR,  a | b)
+    DEFVBINARY_VV_VX_VI(VXOR, a ^ b)
+    // shifts use the low log2(SEW) bits of the shift amount
+    DEFVBINARY_VV_VX(VSLL, static_cast<uint64_t>(a) << (b & (8 * sizeof(a) - 1)))
+    DEFVBINARY_VV_VX(VSRL, a >> (b & (8 * sizeof(a) - 1)))
+    DEFVBINARY_VV_VX(VSRA, sgn(a) >> (b & (8 * sizeof(a) - 1)))
+    DEFVBINARY(VSLL_VI, IntElements, VUI, static_cast<uint64_t>(a) << (b & (8 * sizeof(a) - 1)))
+    DEFVBINARY(VSRL_VI, IntElements, VUI, a >> (b & (8 * sizeof(a) - 1)))
+    DEFVBINARY(VSRA_VI, IntElements, VUI, sgn(a) >> (b & (8 * sizeof(a) - 1)))
+    DEFVBINARY_VV_VX(VMUL,    static_cast<uint64_t>(a) * b)
+    DEFVBINARY_VV_VX(VMULH,   mulh(a, b))
+    DEFVBINARY_VV_VX(VMULHU,  mulhu(a, b))
+    DEFVBINARY_VV_VX(VMULHSU, mulhsu(a, b))
+    DEFVBINARY_VV_VX(VDIVU,   div(a, b))
+    DEFVBINARY_VV_VX(VDIV,    sdiv(a, b))
+    DEFVBINARY_VV_VX(VREMU,   rem(a, b))
+    DEFVBINARY_VV_VX(VREM,    srem(a, b))
+
+#define DEFVCOMPARE(name, elements, form, expr)                         \
+    void visit##name(RISCVHart &hart, RISCVInstruction &i) override {   \
+        compare<elements>(hart, i, form, [](auto a, auto b) { return (expr); }); \
+    }
+#define DEFVCOMPARE_VV_VX(name, expr)                                   \
+    DEFVCOMPARE(name##_VV, IntElements, VV, expr)                       \
+    DEFVCOMPARE(name##_VX, IntElements, VX, expr)
+
+    DEFVCOMPARE_VV_VX(VMSEQ,  a == b)
+    DEFVCOMPARE_VV_VX(VMSNE,  a != b)
+    DEFVCOMPARE_VV_VX(VMSLTU, a < b)
+    DEFVCOMPARE_VV_VX(VMSLT,  sgn(a) < sgn(b))
+    DEFVCOMPARE_VV_VX(VMSLEU, a <= b)
+    DEFVCOMPARE_VV_VX(VMSLE,  sgn(a) <= sgn(b))
+    DEFVCOMPARE(VMSGTU_VX, IntElements, VX, a > b)
+    DEFVCOMPARE(VMSGT_VX,  IntElements, VX, sgn(a) > sgn(b))
+    // the immediate is sign extended, then compared as unsigned for the unsigned compares
+    DEFVCOMPARE(VMSEQ_VI,  IntElements, VI, a == b)
+    DEFVCOMPARE(VMSNE_VI,  IntElements, VI, a != b)
+    DEFVCOMPARE(VMSLEU_VI, IntElements, VI, a <= b)
+    DEFVCOMPARE(VMSLE_VI,  IntElements, VI, sgn(a) <= sgn(b))
+    DEFVCOMPARE(VMSGTU_VI, IntElements, VI, a > b)
+    DEFVCOMPARE(VMSGT_VI,  IntElements, VI, sgn(a) > sgn(b))
+
+    // vd is the accumulator for vmacc/vnmsac and the multiplicand for vmadd/vnmsub
+#define DEFVTERNARY(name, elements, form, expr)                         \
+    void visit##name(RISCVHart &hart, RISCVInstruction &i) override {   \
+        ternary<elements>(hart, i, form, [](auto d, auto a, auto b) { return (expr); }); \
+    }
+#define DEFVTERNARY_VV_VX(name, expr)                                   \
+    DEFVTERNARY(name##_VV, IntElements, VV, expr)                       \
+    DEFVTERNARY(name##_VX, IntElements, VX, expr)
+
+    DEFVTERNARY_VV_VX(VMACC,  d + static_cast<uint64_t>(a) * b)
+    DEFVTERNARY_VV_VX(VNMSAC, d - static_cast<uint64_t>(a) * b)
+    DEFVTERNARY_VV_VX(VMADD,  static_cast<uint64_t>(a) * d + b)
+    DEFVTERNARY_VV_VX(VNMSUB, b - static_cast<uint64_t>(a) * d)
+
+    void visitVMERGE_VVM(RISCVHart &hart, RISCVInstruction &i) override { merge<IntElements>(hart, i, VV); }
+    void visitVMERGE_VXM(RISCVHart &hart, RISCVInstruction &i) override { merge<IntElements>(hart, i, VX); }
+    void visitVMERGE_VIM(RISCVHart &hart, RISCVInstruction &i) override { merge<IntElements>(hart, i, VI); }
+
+    // reductions
+#define DEFVREDUCE(name, elements, expr)                                \
+    void visit##name(RISCVHart &hart, RISCVInstruction &i) override {   \
+        reduce<elements>(hart, i, [](auto a, auto b) { return (expr); }); \
+    }
+    DEFVREDUCE(VREDSUM_VS,  IntElements, a + b)
+    DEFVREDUCE(VREDAND_VS,  IntElements, a & b)
+    DEFVREDUCE(VREDOR_VS,   IntElements, a | b)
+    DEFVREDUCE(VREDXOR_VS,  IntElements, a ^ b)
+    DEFVREDUCE(VREDMINU_VS, IntElements, std::min(a, b))
+    DEFVREDUCE(VREDMIN_VS,  IntElements, sgn(a) < sgn(b) ? a : b)
+    DEFVREDUCE(VREDMAXU_VS, IntElements, std::max(a, b))
+    DEFVREDUCE(VREDMAX_VS,  IntElements, sgn(a) < sgn(b) ? b : a)
+
+    // mask logical instructions; vd = vs2 op vs1
+#define DEFVMASK(name, expr)                                            \
+    void visit##name(RISCVHart &hart, RISCVInstruction &i) override {   \
+        requireVector(hart, i);                                         \
+        for (uint64_t e = 0; e < hart._vl; e++) {                       \
+            bool a = hart.vmask(i.rs2(), e);                            \
+            bool b = hart.vmask(i.rs1(), e);                            \
+            hart.vsetmask(i.rd(), e, (expr));                           \
+        }                                                               \
+        hart.pc() += i.length();                                        \
+    }
+    DEFVMASK(VMAND_MM,  a && b)
+    DEFVMASK(VMNAND_MM, !(a && b))
+    DEFVMASK(VMANDN_MM, a && !b)
+    DEFVMASK(VMXOR_MM,  a != b)
+    DEFVMASK(VMOR_MM,   a || b)
+    DEFVMASK(VMNOR_MM,  !(a || b))
+    DEFVMASK(VMORN_MM,  a || !b)
+    DEFVMASK(VMXNOR_MM, a == b)
+
+    void visitVWXUNARY0(RISCVHart &hart, RISCVInstruction &i) override {
+        requireVector(hart, i);
+        switch (i.rs1()) {
+        case 0x00: // vmv.x.s
+            IntElements::dispatch(hart, [&](auto zero) {
+                using T = decltype(zero);
+                hart.sx(i.rd()) = sgn(hart.vget<T>(i.rs2(), 0));
+            });
+            break;
+        case 0x10: { // vcpop.m
+            uint64_t count = 0;
+            for (uint64_t e = 0; e < hart._vl; e++) {
+                count += (active(hart, i, e) && hart.vmask(i.rs2(), e)) ? 1 : 0;
+            }
+            hart.x(i.rd()) = count;
+            break;
+        }
+        case 0x11: { // vfirst.m
+            int64_t first = -1;
+            for (uint64_t e = 0; e < hart._vl && first < 0; e++) {
+                if (active(hart, i, e) && hart.vmask(i.rs2(), e)) {
+                    first = static_cast<int64_t>(e);
+                }
+            }
+            hart.sx(i.rd()) = first;
+            break;
+        }
+        default:
+            throw std::runtime_error("VWXUNARY0: Not implemented");
+        }
+        hart.pc() += i.length();
+    }
+
+    void visitVMV_S_X(RISCVHart &hart, RISCVInstruction &i) override {
+        requireVector(hart, i);
+        IntElements::dispatch(hart, [&](auto zero) {
+            using T = decltype(zero);
+            if (hart._vl > 0) {
+                hart.vset<T>(i.rd(), 0, static_cast<T>(hart.x(i.rs1())));
+            }
+        });
+        hart.pc() += i.length();
+    }
+
+    void visitVMUNARY0(RISCVHart &hart, RISCVInstruction &i) override {
+        requireVector(hart, i);
+        if (i.rs1() != 0x10 && i.rs1() != 0x11) {
+            throw std::runtime_error("VMUNARY0: Not implemented");
+        }
+        IntElements::dispatch(hart, [&](auto zero) {
+            using T = decltype(zero);
+            checkGroup(hart, i, i.rd(), sizeof(T));
+            uint64_t count = 0;
+            for (uint64_t e = 0; e < hart._vl; e++) {
+                if (!active(hart, i, e)) {
+                    continue;
+                }
+                if (i.rs1() == 0x11) { // vid.v
+                    hart.vset<T>(i.rd(), e, static_cast<T>(e));
+                } else { // viota.m
+                    bool bit = hart.vmask(i.rs2(), e);
+                    hart.vset<T>(i.rd(), e, static_cast<T>(count));
+                    count += bit ? 1 : 0;
+                }
+            }
+        });
+        hart.pc() += i.length();
+    }
+
+    // floating point
+#define DEFVFBINARY_VV_VF(name, expr)                                   \
+    DEFVBINARY(name##_VV, FPElements, VV, expr)                         \
+    DEFVBINARY(name##_VF, FPElements, VF, expr)
+
+    DEFVFBINARY_VV_VF(VFADD, a + b)
+    DEFVFBINARY_VV_VF(VFSUB, a - b)
+    DEFVBINARY(VFRSUB_VF, FPElements, VF, b - a)
+    DEFVFBINARY_VV_VF(VFMUL, a * b)
+    DEFVFBINARY_VV_VF(VFDIV, a / b)
+    DEFVBINARY(VFRDIV_VF, FPElements, VF, b / a)
+    DEFVFBINARY_VV_VF(VFMIN, std::fmin(a, b))
+    DEFVFBINARY_VV_VF(VFMAX, std::fmax(a, b))
+    DEFVFBINARY_VV_VF(VFSGNJ,  std::copysign(a, b))
+    DEFVFBINARY_VV_VF(VFSGNJN, std::copysign(a, -b))
+    DEFVFBINARY_VV_VF(VFSGNJX, std::signbit(a) != std::signbit(b) ? -std::fabs(a) : std::fabs(a))
+
+#define DEFVFCOMPARE_VV_VF(name, expr)                                  \
+    DEFVCOMPARE(name##_VV, FPElements, VV, expr)                        \
+    DEFVCOMPARE(name##_VF, FPElements, VF, expr)
+
+    DEFVFCOMPARE_VV_VF(VMFEQ, a == b)
+    DEFVFCOMPARE_VV_VF(VMFNE, a != b)
+    DEFVFCOMPARE_VV_VF(VMFLT, a < b)
+    DEFVFCOMPARE_VV_VF(VMFLE, a <= b)
+    DEFVCOMPARE(VMFGT_VF, FPElements, VF, a > b)
+    DEFVCOMPARE(VMFGE_VF, FPElements, VF, a >= b)
+
+#define DEFVFTERNARY_VV_VF(name, expr)                                  \
+    DEFVTERNARY(name##_VV, FPElements, VV, expr)                        \
+    DEFVTERNARY(name##_VF, FPElements, VF, expr)
+
+    DEFVFTERNARY_VV_VF(VFMACC,  std::fma(a, b, d))
+    DEFVFTERNARY_VV_VF(VFNMACC, std::fma(-a, b, -d))
+    DEFVFTERNARY_VV_VF(VFMSAC,  std::fma(a, b, -d))
+    DEFVFTERNARY_VV_VF(VFNMSAC, std::fma(-a, b, d))
+    DEFVFTERNARY_VV_VF(VFMADD,  std::fma(a, d, b))
+    DEFVFTERNARY_VV_VF(VFNMADD, std::fma(-a, d, -b))
+    DEFVFTERNARY_VV_VF(VFMSUB,  std::fma(a, d, -b))
+    DEFVFTERNARY_VV_VF(VFNMSUB, std::fma(-a, d, b))
+
+    void visitVFMERGE_VFM(RISCVHart &hart, RISCVInstruction &i) override { merge<FPElements>(hart, i, VF); }
+
+    // both sums are computed in element order
+    DEFVREDUCE(VFREDUSUM_VS, FPElements, a + b)
+    DEFVREDUCE(VFREDOSUM_VS, FPElements, a + b)
+    DEFVREDUCE(VFREDMIN_VS,  FPElements, std::fmin(a, b))
+    DEFVREDUCE(VFREDMAX_VS,  FPElements, std::fmax(a, b))
+
+    void visitVWFUNARY0(RISCVHart &hart, RISCVInstruction &i) override {
+        requireVector(hart, i);
+        if (i.rs1() != 0) {
+            throw std::runtime_error("VWFUNARY0: Not implemented");
+        }
+        FPElements::dispatch(hart, [&](auto zero) {
+            using T = decltype(zero);
+            hart.df(i.rd()) = static_cast<double>(hart.vget<T>(i.rs2(), 0));
+        });
+        hart.pc() += i.length();
+    }
+
+    void visitVFMV_S_F(RISCVHart &hart, RISCVInstruction &i) override {
+        requireVector(hart, i);
+        FPElements::dispatch(hart, [&](auto zero) {
+            using T = decltype(zero);
+            if (hart._vl > 0) {
+                hart.vset<T>(i.rd(), 0, operand<T>(hart, i, VF, 0));
+            }
+        });
+        hart.pc() += i.length();
+    }
+
+#undef DEFVBINARY
+#undef DEFVBINARY_VV_VX
+#undef DEFVBINARY_VV_VX_VI
+#undef DEFVCOMPARE
+#undef DEFVCOMPARE_VV_VX
+#undef DEFVTERNARY
+#undef DEFVTERNARY_VV_VX
+#undef DEFVREDUCE
+#undef DEFVMASK
+#undef DEFVFBINARY_VV_VF
+#undef DEFVFCOMPARE_VV_VF
+#undef DEFVFTERNARY_VV_VF
+
+protected:
+    /**
+     * @brief calls f with a zero of the unsigned integer type SEW bits wide
+     */
+    struct IntElements {
+        template <typename F>
+        static void dispatch(RISCVHart &hart, F &&f) {
+            switch (vsew(hart._vtype)) {
+            case 0: f(uint8_t()); break;
+            case 1: f(uint16_t()); break;
+            case 2: f(uint32_t()); break;
+            default: f(uint64_t()); break;
+            }
+        }
+    };
+
+    /**
+     * @brief calls f with a zero of the floating point type SEW bits wide, in the hart's rounding mode
+     */
+    struct FPElements {
+        template <typename F>
+        static void dispatch(RISCVHart &hart, F &&f) {
+            RoundingModeGuard guard(hart.rm());
+            switch (vsew(hart._vtype)) {
+            case 2: f(float()); break;
+            case 3: f(double()); break;
+            default: throw std::runtime_error("vector floating point needs SEW=32 or SEW=64");
+            }
+        }
+    };
+
+    template <typename T>
+    static typename std::make_signed<T>::type sgn(T v) {
+        return static_cast<typename std::make_signed<T>::type>(v);
+    }
+
+    /**
+     * @brief the second operand of element e
+     */
+    template <typename T>
+    static T operand(RISCVHart &hart, RISCVInstruction &i, Operand form, uint64_t e) {
+        switch (form) {
+        case VV:  return hart.vget<T>(i.rs1(), e);
+        case VX:  return static_cast<T>(hart.x(i.rs1()));
+        case VI:  return static_cast<T>(simm5(i));
+        case VUI: return static_cast<T>(i.rs1());
+        default:  return static_cast<T>(static_cast<double>(hart.df(i.rs1())));
+        }
+    }
+
+    /**
+     * @brief vd[e] = f(vs2[e], operand) for each active element
+     */
+    template <typename Elements, typename F>
+    static void binary(RISCVHart &hart, RISCVInstruction &i, Operand form, F f) {
+        requireVector(hart, i);
+        Elements::dispatch(hart, [&](auto zero) {
+            using T = decltype(zero);
+            checkGroup(hart, i, i.rd(), sizeof(T));
+            checkGroup(hart, i, i.rs2(), sizeof(T));
+            if (form == VV) {
+                checkGroup(hart, i, i.rs1(), sizeof(T));
+            }
+            for (uint64_t e = 0; e < hart._vl; e++) {
+                if (active(hart, i, e)) {
+                    T a = hart.vget<T>(i.rs2(), e);
+                    T b = operand<T>(hart, i, form, e);
+                    hart.vset<T>(i.rd(), e, static_cast<T>(f(a, b)));
+                }
+            }
+        });
+        hart.pc() += i.length();
+    }
+
+    /**
+     * @brief mask bit e of vd = f(vs2[e], operand) for each active element
+     */
+    template <typename Elements, typename F>
+    static void compare(RISCVHart &hart, RISCVInstruction &i, Operand form, F f) {
+        requireVector(hart, i);
+        Elements::dispatch(hart, [&](auto zero) {
+            using T = decltype(zero);
+            checkGroup(hart, i, i.rs2(), sizeof(T));
+            if (form == VV) {
+                checkGroup(hart, i, i.rs1(), sizeof(T));
+            }
+            for (uint64_t e = 0; e < hart._vl; e++) {
+                if (active(hart, i, e)) {
+                    T a = hart.vget<T>(i.rs2(), e);
+                    T b = operand<T>(hart, i, form, e);
+                    hart.vsetmask(i.rd(), e, f(a, b));
+                }
+            }
+        });
+        hart.pc() += i.length();
+    }
+
+    /**
+     * @brief vd[e] = f(vd[e], operand, vs2[e]) for each active element
+     */
+    template <typename Elements, typename F>
+    static void ternary(RISCVHart &hart, RISCVInstruction &i, Operand form, F f) {
+        requireVector(hart, i);
+        Elements::dispatch(hart, [&](auto zero) {
+            using T = decltype(zero);
+            checkGroup(hart, i, i.rd(), sizeof(T));
+            checkGroup(hart, i, i.rs2(), sizeof(T));
+            if (form == VV) {
+                checkGroup(hart, i, i.rs1(), sizeof(T));
+            }
+            for (uint64_t e = 0; e < hart._vl; e++) {
+                if (active(hart, i, e)) {
+                    T d = hart.vget<T>(i.rd(), e);
+                    T a = operand<T>(hart, i, form, e);
+                    T b = hart.vget<T>(i.rs2(), e);
+                    hart.vset<T>(i.rd(), e, static_cast<T>(f(d, a, b)));
+                }
+            }
+        });
+        hart.pc() += i.length();
+    }
+
+    /**
+     * @brief vd[e] = v0[e] ? operand : vs2[e], or vd[e] = operand if unmasked (vmv.v.*)
+     */
+    template <typename Elements>
+    static void merge(RISCVHart &hart, RISCVInstruction &i, Operand form) {
+        requireVector(hart, i);
+        Elements::dispatch(hart, [&](auto zero) {
+            using T = decltype(zero);
+            checkGroup(hart, i, i.rd(), sizeof(T));
+            checkGroup(hart, i, i.rs2(), sizeof(T));
+            if (form == VV) {
+                checkGroup(hart, i, i.rs1(), sizeof(T));
+            }
+            for (uint64_t e = 0; e < hart._vl; e++) {
+                T value = active(hart, i, e) ? operand<T>(hart, i, form, e) : hart.vget<T>(i.rs2(), e);
+                hart.vset<T>(i.rd(), e, value);
+            }
+        });
+        hart.pc() += i.length();
+    }
+
+    /**
+     * @brief vd[0] = f(...f(f(vs1[0], vs2[0]), vs2[1])..., vs2[vl-1]) over the active elements
+     */
+    template <typename Elements, typename F>
+    static void reduce(RISCVHart &hart, RISCVInstruction &i, F f) {
+        requireVector(hart, i);
+        Elements::dispatch(hart, [&](auto zero) {
+            using T = decltype(zero);
+            checkGroup(hart, i, i.rs2(), sizeof(T));
+            if (hart._vl == 0) {
+                return;
+            }
+            T acc = hart.vget<T>(i.rs1(), 0);
+            for (uint64_t e = 0; e < hart._vl; e++) {
+                if (active(hart, i, e)) {
+                    acc = static_cast<T>(f(acc, hart.vget<T>(i.rs2(), e)));
+                }
+            }
+            hart.vset<T>(i.rd(), 0, acc);
+        });
+        hart.pc() += i.length();
+    }
+
+    /**
+     * @brief the application vector length of vsetvl and vsetvli
+     *
+     * rs1 = x0 asks for VLMAX, or keeps vl if rd is x0 too.
+     */
+    static uint64_t avl(RISCVHart &hart, RISCVInstruction &i) {
+        if (i.rs1() != 0) {
+            return hart.x(i.rs1());
+        }
+        return i.rd() != 0 ? std::numeric_limits<uint64_t>::max() : static_cast<uint64_t>(hart._vl);
+    }
+
+    /**
+     * @brief set vtype and vl = min(avl, VLMAX), and write vl to rd
+     *
+     * An unsupported vtype sets vill and vl = 0.
+     */
+    static void setVType(RISCVHart &hart, RISCVInstruction &i, uint64_t avl, uint64_t vtype) {
+        if (hart.vlenb() == 0) {
+            throw std::runtime_error(std::string(i.getMnemonic()) + ": no vector unit");
+        }
+        uint64_t max = vlmax(hart, vtype);
+        if (max == 0) {
+            hart._vtype = RISCVHart::VTYPE_VILL;
+            hart._vl = 0;
+        } else {
+            hart._vtype = vtype;
+            hart._vl = std::min(avl, max);
+        }
+        hart.x(i.rd()) = hart._vl;
+        hart.pc() += i.length();
+    }
+
+    // high halves of products; 64-bit elements need 128-bit products
+    template <typename T>
+    static T mulh(T a, T b) {
+        return static_cast<T>((static_cast<int64_t>(sgn(a)) * sgn(b)) >> (8 * sizeof(T)));
+    }
+    static uint64_t mulh(uint64_t a, uint64_t b) {
+        int128_t rd = int128_t(static_cast<int64_t>(a)) * static_cast<int64_t>(b);
+        return static_cast<uint64_t>(static_cast<int64_t>(rd >> 64));
+    }
+    template <typename T>
+    static T mulhu(T a, T b) {
+        return static_cast<T>((static_cast<uint64_t>(a) * b) >> (8 * sizeof(T)));
+    }
+    static uint64_t mulhu(uint64_t a, uint64_t b) {
+        uint128_t rd = uint128_t(a) * b;
+        return static_cast<uint64_t>(rd >> 64);
+    }
+    template <typename T>
+    static T mulhsu(T a, T b) {
+        return static_cast<T>((static_cast<int64_t>(sgn(a)) * static_cast<int64_t>(b)) >> (8 * sizeof(T)));
+    }
+    static uint64_t mulhsu(uint64_t a, uint64_t b) {
+        int128_t rd = int128_t(static_cast<int64_t>(a)) * int128_t(b);
+        return static_cast<uint64_t>(static_cast<int64_t>(rd >> 64));
+    }
+
+    // division by zero and overflow give the results the scalar divides do
+    template <typename T>
+    static T div(T a, T b) {
+        return b == 0 ? static_cast<T>(-1) : static_cast<T>(a / b);
+    }
+    template <typename T>
+    static T rem(T a, T b) {
+        return b == 0 ? a : static_cast<T>(a % b);
+    }
+    template <typename T>
+    static T sdiv(T a, T b) {
+        typedef typename std::make_signed<T>::type S;
+        if (b == 0) {
+            return static_cast<T>(-1);
+        }
+        if (sgn(a) == std::numeric_limits<S>::min() && sgn(b) == -1) {
+            return a;
+        }
+        return static_cast<T>(sgn(a) / sgn(b));
+    }
+    template <typename T>
+    static T srem(T a, T b) {
+        typedef typename std::make_signed<T>::type S;
+        if (b == 0) {
+            return a;
+        }
+        if (sgn(a) == std::numeric_limits<S>::min() && sgn(b) == -1) {
+            return 0;
+        }
+        return static_cast<T>(sgn(a) % sgn(b));
+    }
+};
+#endif
@@ -19,28 +19,28 @@ public:
         int128_t rs2 = static_cast<int64_t>(hart.sx(i.rs2()));
         int128_t rd = rs1 * rs2;
         hart.x(i.rd()) = static_cast<int64_t>(rd & std::numeric_limits<uint64_t>::max());
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitMULH(RISCVHart &hart, RISCVInstruction &i) override {
         int128_t rs1 = static_cast<int64_t>(hart.sx(i.rs1()));
         int128_t rs2 = static_cast<int64_t>(hart.sx(i.rs2()));
         int128_t rd = rs1 * rs2;
         hart.x(i.rd()) = static_cast<int64_t>(rd >> 64);
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitMULHU(RISCVHart &hart, RISCVInstruction &i) override {
         uint128_t rs1 = static_cast<uint64_t>(hart.x(i.rs1()));
         uint128_t rs2 = static_cast<uint64_t>(hart.x(i.rs2()));
         uint128_t rd = rs1 * rs2;
         hart.x(i.rd()) = static_cast<uint64_t>(rd >> 64);
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitMULHSU(RISCVHart &hart, RISCVInstruction &i) override {
         int128_t rs1 = static_cast<int64_t>(hart.sx(i.rs1()));
         uint128_t rs2 = static_cast<uint64_t>(hart.x(i.rs2()));
         int128_t rd = rs1 * rs2;
         hart.x(i.rd()) = static_cast<int64_t>(rd >> 64);
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitDIV(RISCVHart &hart, RISCVInstruction &i) override {
         int64_t rs1 = hart.sx(i.rs1());
@@ -53,7 +53,7 @@ public:
         } else {
             hart.x(i.rd()) = rs1 / rs2;
         }
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitDIVU(RISCVHart &hart, RISCVInstruction &i) override {
         uint64_t rs1 = hart.x(i.rs1());
@@ -63,7 +63,7 @@ public:
         } else {
             hart.x(i.rd()) = rs1 / rs2;
         }
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitREM(RISCVHart &hart, RISCVInstruction &i) override {
         int64_t rs1 = hart.sx(i.rs1());
@@ -76,7 +76,7 @@ public:
         } else {
             hart.x(i.rd()) = rs1 % rs2;
         }
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitREMU(RISCVHart &hart, RISCVInstruction &i) override {
         uint64_t rs1 = hart.x(i.rs1());
@@ -87,14 +87,14 @@ public:
         } else {
             hart.x(i.rd()) = rs1 % rs2;
         }
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitMULW(RISCVHart &hart, RISCVInstruction &i) override {
         int32_t rs1 = hart.sx(i.rs1());
         int32_t rs2 = hart.sx(i.rs2());
         int64_t rd = rs1 * rs2;
         hart.x(i.rd()) = rd;
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitDIVW(RISCVHart &hart, RISCVInstruction &i) override {
         int32_t rs1 = hart.sx(i.rs1());
@@ -107,7 +107,7 @@ public:
         } else {
             hart.x(i.rd()) = rs1 / rs2;
         }
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitDIVUW(RISCVHart &hart, RISCVInstruction &i) override {
         uint32_t rs1 = hart.x(i.rs1());
@@ -119,7 +119,7 @@ public:
             int32_t rd = rs1 / rs2;
             hart.sx(i.rd()) = rd;
         }
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitREMW(RISCVHart &hart, RISCVInstruction &i) override {
         int32_t rs1 = hart.sx(i.rs1());
@@ -132,7 +132,7 @@ public:
         } else {
             hart.x(i.rd()) = rs1 % rs2;
         }
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitREMUW(RISCVHart &hart, RISCVInstruction &i) override {
         uint32_t rs1 = hart.sx(i.rs1());
@@ -144,7 +144,7 @@ public:
             int32_t rd = rs1 % rs2;
             hart.x(i.rd()) = rd;
         }
-        hart.pc() += 4;        
+        hart.pc() += i.length();        
     }
 };
 #endif
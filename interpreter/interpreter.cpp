@@ -29,49 +29,49 @@ public:
     
     void visitLB(RISCVHart &hart, RISCVInstruction &i) override {
         hart.x(i.rd()) = visitLoad<int64_t, int8_t>(hart, i);
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitLH(RISCVHart &hart, RISCVInstruction &i) override {
         hart.x(i.rd()) = visitLoad<int64_t, int16_t>(hart, i);
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitLW(RISCVHart &hart, RISCVInstruction &i) override {
         hart.x(i.rd()) = visitLoad<int64_t, int32_t>(hart, i);
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitLBU(RISCVHart &hart, RISCVInstruction &i) override {
         hart.x(i.rd()) = visitLoad<uint64_t, uint8_t>(hart, i);
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitLHU(RISCVHart &hart, RISCVInstruction &i) override {
         hart.x(i.rd()) = visitLoad<uint64_t, uint16_t>(hart, i);
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitLWU(RISCVHart &hart, RISCVInstruction &i) override {
         hart.x(i.rd()) = visitLoad<uint64_t, uint32_t>(hart, i);
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitLD(RISCVHart &hart, RISCVInstruction &i) override {
         std::cout << "here" << std::endl;
         hart.x(i.rd()) = visitLoad<uint64_t, uint64_t>(hart, i);
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
 
     void visitSB(RISCVHart &hart, RISCVInstruction &i) override {
         visitStore<uint8_t>(hart, i);
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitSH(RISCVHart &hart, RISCVInstruction &i) override {
         visitStore<uint16_t>(hart, i);
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitSW(RISCVHart &hart, RISCVInstruction &i) override {
         visitStore<uint32_t>(hart, i);
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     void visitSD(RISCVHart &hart, RISCVInstruction &i) override {
         visitStore<uint64_t>(hart, i);
-        hart.pc() += 4;
+        hart.pc() += i.length();
     }
     
     std::vector<uint8_t> mem;
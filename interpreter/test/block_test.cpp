@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+
+// Checks that every instruction a basic block can hold has the same effect
+// run from a block as it does through the interpreter's visitor.
+#include "RISCVDecoder.hpp"
+#include "RISCVBlock.hpp"
+#include "RV64IMFInterpreter.hpp"
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+
+int main(int argc, char *argv[])
+{
+    std::mt19937_64 rng(0);
+    RV64IMFInterpreter interpreter;
+    RISCVDecoder decoder;
+
+    uint64_t checked = 0, mismatches = 0;
+    for (size_t id = 0; id < NumInstructionIds; id++) {
+        for (int trial = 0; trial < 4096; trial++) {
+            // random operands under the instruction's fixed bits
+            uint32_t instruction = (static_cast<uint32_t>(rng()) & ~riscv_decode::MASKS[id])
+                | riscv_decode::VALUES[id];
+            if (RISCVDecoder::decodeId(instruction) != id) {
+                continue;
+            }
+            std::unique_ptr<RISCVInstruction> i(decoder.decode(instruction));
+            RISCVBlockOp op;
+            bool terminator = false;
+            if (!riscv_block::compile(*i, op, terminator)) {
+                break;
+            }
+            RISCVHart expect, got;
+            for (int r = 1; r < 32; r++) {
+                // small values exercise the shift and compare edge cases
+                uint64_t v = rng();
+                expect._x[r] = got._x[r] = (trial & 1) ? v : (v & 0xff);
+            }
+            expect.pc() = 0x1000;
+            got.pc() = 0x1000;
+            interpreter.visit(expect, *i);
+            op.handler(got, op);
+            if (memcmp(expect._x, got._x, sizeof(expect._x)) != 0 || expect._pc != got._pc) {
+                if (mismatches++ < 16) {
+                    printf("FAIL: %08" PRIx32 " (%s): block result differs from interpreter\n",
+                           instruction, i->getMnemonic());
+                }
+            }
+            checked++;
+        }
+    }
+
+    printf("%s: %" PRIu64 " instructions, %" PRIu64 " mismatches\n",
+           mismatches == 0 ? "PASS" : "FAIL", checked, mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
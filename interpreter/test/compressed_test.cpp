@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+
+// Checks RV64C expansion against known encodings, that every legal
+// compressed instruction expands to one the decoder knows, and that
+// expanded instructions step pc by two through the interpreter.
+#include "RISCVDecoder.hpp"
+#include "RV64IMFInterpreter.hpp"
+#include <cinttypes>
+#include <cstdio>
+#include <memory>
+
+int main(int argc, char *argv[])
+{
+    struct Expansion { uint16_t compressed; uint32_t expanded; const char *assembly; };
+    const Expansion expansions[] = {
+        {0x0001, 0x00000013, "c.nop"},
+        {0x0808, 0x01010513, "c.addi4spn a0, sp, 16"},
+        {0x2508, 0x00853507, "c.fld fa0, 8(a0)"},
+        {0x414c, 0x00452583, "c.lw a1, 4(a0)"},
+        {0x6108, 0x00053503, "c.ld a0, 0(a0)"},
+        {0xc14c, 0x00b52223, "c.sw a1, 4(a0)"},
+        {0x4505, 0x00100513, "c.li a0, 1"},
+        {0x1141, 0xff010113, "c.addi sp, -16"},
+        {0x0141, 0x01010113, "c.addi sp, 16"},
+        {0x2505, 0x0015051b, "c.addiw a0, 1"},
+        {0x7179, 0xfd010113, "c.addi16sp sp, -48"},
+        {0x6505, 0x00001537, "c.lui a0, 0x1"},
+        {0x757d, 0xfffff537, "c.lui a0, 0xfffff"},
+        {0x8105, 0x00155513, "c.srli a0, 1"},
+        {0x8505, 0x40155513, "c.srai a0, 1"},
+        {0x8d09, 0x40a50533, "c.sub a0, a0"},
+        {0x9d2d, 0x00b5053b, "c.addw a0, a1"},
+        {0xa001, 0x0000006f, "c.j 0"},
+        {0xbffd, 0xfffff06f, "c.j -2"},
+        {0xc101, 0x00050063, "c.beqz a0, 0"},
+        {0xfd7d, 0xfe051fe3, "c.bnez a0, -2"},
+        {0x050e, 0x00351513, "c.slli a0, 3"},
+        {0x60a2, 0x00813083, "c.ldsp ra, 8(sp)"},
+        {0x8082, 0x00008067, "c.jr ra"},
+        {0x852e, 0x00b00533, "c.mv a0, a1"},
+        {0x9002, 0x00100073, "c.ebreak"},
+        {0x9502, 0x000500e7, "c.jalr a0"},
+        {0x9532, 0x00c50533, "c.add a0, a2"},
+        {0xe406, 0x00113423, "c.sdsp ra, 8(sp)"},
+        // illegal and reserved encodings
+        {0x0000, 0, "illegal"},
+        {0x8002, 0, "c.jr x0 (reserved)"},
+        {0x6101, 0, "c.addi16sp 0 (reserved)"},
+        {0x4002, 0, "c.lwsp x0 (reserved)"},
+    };
+
+    uint64_t checked = 0, legal = 0, mismatches = 0;
+    for (const Expansion &e : expansions) {
+        uint32_t got = riscv_decode::expandCompressed(e.compressed);
+        if (got != e.expanded) {
+            mismatches++;
+            printf("FAIL: %04x (%s): expanded to %08" PRIx32 ", expected %08" PRIx32 "\n",
+                   e.compressed, e.assembly, got, e.expanded);
+        }
+        checked++;
+    }
+
+    // every compressed encoding either is illegal or decodes with length 2
+    for (uint32_t c = 0; c < 0x10000; c++) {
+        if (!RISCVDecoder::isCompressed(c)) {
+            continue;
+        }
+        uint32_t expanded = riscv_decode::expandCompressed(c);
+        std::unique_ptr<RISCVInstruction> i(RISCVDecoder::tryDecode(c));
+        if (expanded != 0 && (!i || i->length() != 2 || i->instruction() != expanded)) {
+            if (mismatches++ < 16) {
+                printf("FAIL: %04" PRIx32 ": expansion %08" PRIx32 " does not decode\n", c, expanded);
+            }
+        } else if (expanded == 0 && i) {
+            if (mismatches++ < 16) {
+                printf("FAIL: %04" PRIx32 ": illegal encoding decoded\n", c);
+            }
+        }
+        legal += expanded != 0 ? 1 : 0;
+        checked++;
+    }
+
+    // pc steps by the instruction's length, and jumps link past it
+    RV64IMFInterpreter interpreter;
+    struct Step { uint16_t compressed; uint64_t pc; int link; };
+    const Step steps[] = {
+        {0x4505, 0x1002, 0},  // c.li a0, 1
+        {0x9502, 0x2000, 1},  // c.jalr a0, a0 = 0x2000
+    };
+    for (const Step &s : steps) {
+        std::unique_ptr<RISCVInstruction> i(RISCVDecoder::tryDecode(s.compressed));
+        RISCVHart hart;
+        hart.x(10) = 0x2000;
+        hart.pc() = 0x1000;
+        interpreter.visit(hart, *i);
+        if (hart._pc != s.pc || (s.link && hart.x(1) != 0x1002)) {
+            mismatches++;
+            printf("FAIL: %04x: pc = %016" PRIx64 ", ra = %016" PRIx64 "\n",
+                   s.compressed, static_cast<uint64_t>(hart._pc), static_cast<uint64_t>(hart.x(1)));
+        }
+        checked++;
+    }
+
+    printf("%s: %" PRIu64 " checks, %" PRIu64 " legal compressed encodings, %" PRIu64 " mismatches\n",
+           mismatches == 0 ? "PASS" : "FAIL", checked, legal, mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+
+// Checks the table-driven decoder against a linear scan of InstructionTable.h
+// for every encoding of the bits any instruction's mask inspects.
+#include "RISCVDecoder.hpp"
+#include <cinttypes>
+#include <cstdio>
+#include <memory>
+
+int main(int argc, char *argv[])
+{
+    // bits some instruction's mask inspects; no other bit affects decode
+    uint32_t inspected = 0;
+    for (uint32_t mask : riscv_decode::MASKS) {
+        inspected |= mask;
+    }
+    // fill the remaining bits with a few patterns for good measure
+    const uint32_t fills[] = {0x00000000, 0xffffffff, 0x55555555, 0xaaaaaaaa};
+
+    uint64_t checked = 0, decoded = 0, mismatches = 0;
+    for (uint32_t fill : fills) {
+        uint32_t bits = 0;
+        do {
+            uint32_t instruction = bits | (fill & ~inspected);
+            RISCVInstructionId expect = RISCVDecoder::decodeIdLinear(instruction);
+            RISCVInstructionId got = RISCVDecoder::decodeId(instruction);
+            if (got != expect) {
+                if (mismatches++ < 16) {
+                    printf("FAIL: %08" PRIx32 ": table decoded %d, linear decoded %d\n",
+                           instruction, (int)got, (int)expect);
+                }
+            } else if (got != NumInstructionIds) {
+                decoded++;
+            }
+            checked++;
+            // next subset of the inspected bits
+            bits = (bits - inspected) & inspected;
+        } while (bits != 0);
+    }
+
+    // every instruction constructs the right object
+    RISCVDecoder decoder;
+    for (size_t id = 0; id < NumInstructionIds; id++) {
+        std::unique_ptr<RISCVInstruction> i(decoder.decode(riscv_decode::VALUES[id]));
+        if (i->getInstructionId() != RISCVDecoder::decodeIdLinear(riscv_decode::VALUES[id])) {
+            printf("FAIL: %08" PRIx32 ": constructed %s\n", riscv_decode::VALUES[id], i->getMnemonic());
+            mismatches++;
+        }
+    }
+
+    printf("%s: %" PRIu64 " encodings (mask %08" PRIx32 "), %" PRIu64 " valid, %" PRIu64 " mismatches\n",
+           mismatches == 0 ? "PASS" : "FAIL", checked, inspected, decoded, mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+
+// Checks the icache's hits and misses against a list-based LRU model
+// for several geometries and address streams.
+#include "ICache.hpp"
+#include <cinttypes>
+#include <cstdio>
+#include <list>
+#include <random>
+#include <vector>
+
+/**
+ * each set is a list of lines, most recently used first
+ */
+struct ReferenceICache {
+    ReferenceICache(size_t instructions, size_t associativity, size_t line_instructions)
+        : associativity(associativity)
+        , line_bytes(line_instructions * 4)
+        , sets(instructions / (associativity * line_instructions)) {
+    }
+
+    bool access(uint64_t addr) {
+        uint64_t line = addr / line_bytes;
+        std::list<uint64_t> &set = sets[line % sets.size()];
+        for (auto it = set.begin(); it != set.end(); ++it) {
+            if (*it == line) {
+                set.erase(it);
+                set.push_front(line);
+                return true;
+            }
+        }
+        if (set.size() == associativity) {
+            set.pop_back();
+        }
+        set.push_front(line);
+        return false;
+    }
+
+    size_t associativity;
+    uint64_t line_bytes;
+    std::vector<std::list<uint64_t>> sets;
+};
+
+int main(int argc, char *argv[])
+{
+    struct Geometry { size_t instructions, associativity, line_instructions; };
+    const Geometry geometries[] = {
+        {1024, 1, 1}, {1024, 4, 1}, {1024, 1, 8}, {1024, 2, 16},
+        {256, 8, 4}, {64, 64, 1}, {512, 4, 32},
+    };
+
+    std::mt19937_64 rng(0x1cac4e);
+    uint64_t checked = 0, hits = 0, mismatches = 0;
+    for (const Geometry &g : geometries) {
+        if (!ICache::validGeometry(g.instructions, g.associativity, g.line_instructions)) {
+            printf("FAIL: %zu/%zu/%zu: rejected a valid geometry\n",
+                   g.instructions, g.associativity, g.line_instructions);
+            return 1;
+        }
+        ICache icache(nullptr, g.instructions, g.associativity, g.line_instructions);
+        ReferenceICache expect(g.instructions, g.associativity, g.line_instructions);
+        uint64_t pc = 0x10000;
+        for (int i = 0; i < 200000; i++) {
+            // mostly straight-line code with short loops and the odd far jump
+            uint64_t r = rng() % 100;
+            if (r < 80) {
+                pc += 4;
+            } else if (r < 95) {
+                pc -= 4 * (rng() % 64);
+            } else {
+                pc = 0x10000 + 4 * (rng() % (4 * g.instructions));
+            }
+            bool got = icache.access(pc);
+            bool want = expect.access(pc);
+            if (got != want) {
+                if (mismatches++ < 16) {
+                    printf("FAIL: %zu/%zu/%zu: access %d to %016" PRIx64 ": got %s, expected %s\n",
+                           g.instructions, g.associativity, g.line_instructions, i, pc,
+                           got ? "hit" : "miss", want ? "hit" : "miss");
+                }
+            }
+            hits += want ? 1 : 0;
+            checked++;
+        }
+    }
+
+    // sets and lines must be powers of two
+    if (ICache::validGeometry(1024, 3, 1) || ICache::validGeometry(1024, 1, 3)
+        || ICache::validGeometry(0, 1, 1) || ICache::validGeometry(96, 1, 1)) {
+        printf("FAIL: accepted an invalid geometry\n");
+        mismatches++;
+    }
+
+    printf("%s: %" PRIu64 " accesses, %" PRIu64 " hits, %" PRIu64 " mismatches\n",
+           mismatches ? "FAIL" : "PASS", checked, hits, mismatches);
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,208 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+
+// Runs vector instructions through the interpreter and checks vl, the
+// elements written, masking, reductions and floating point results.
+#include "RISCVDecoder.hpp"
+#include "RV64IMFVInterpreter.hpp"
+#include <cinttypes>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+
+namespace {
+
+// funct3 of each operand form
+enum { OPIVV = 0, OPFVV = 1, OPMVV = 2, OPIVI = 3, OPIVX = 4, OPFVF = 5, OPMVX = 6 };
+
+uint32_t vop(uint32_t funct6, uint32_t vm, uint32_t vs2, uint32_t vs1, uint32_t funct3, uint32_t vd) {
+    return (funct6 << 26) | (vm << 25) | (vs2 << 20) | (vs1 << 15) | (funct3 << 12) | (vd << 7) | 0x57;
+}
+
+uint32_t vsetvli(uint32_t rd, uint32_t rs1, uint32_t vtype) {
+    return (vtype << 20) | (rs1 << 15) | (7 << 12) | (rd << 7) | 0x57;
+}
+
+// vtype settings
+constexpr uint32_t E8M8 = (0 << 3) | 3;
+constexpr uint32_t E32M1 = (2 << 3) | 0;
+constexpr uint32_t E32M2 = (2 << 3) | 1;
+constexpr uint32_t E64M1 = (3 << 3) | 0;
+constexpr uint32_t E64MF2 = (3 << 3) | 7;
+
+RV64IMFVInterpreter interpreter;
+uint64_t checked = 0, mismatches = 0;
+
+void run(RISCVHart &hart, uint32_t word) {
+    std::unique_ptr<RISCVInstruction> i(RISCVDecoder::tryDecode(word));
+    if (!i) {
+        throw std::runtime_error("does not decode");
+    }
+    interpreter.visit(hart, *i);
+}
+
+void check(const char *what, uint64_t got, uint64_t expected) {
+    if (got != expected) {
+        mismatches++;
+        printf("FAIL: %s: got %016" PRIx64 ", expected %016" PRIx64 "\n", what, got, expected);
+    }
+    checked++;
+}
+
+void checkThrows(RISCVHart &hart, const char *what, uint32_t word) {
+    bool threw = false;
+    try {
+        run(hart, word);
+    } catch (std::runtime_error &) {
+        threw = true;
+    }
+    if (!threw) {
+        mismatches++;
+        printf("FAIL: %s: did not throw\n", what);
+    }
+    checked++;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    RISCVHart hart;
+    hart.setVLEN(128);
+
+    // vl = min(avl, VLMAX)
+    hart.x(10) = 10;
+    run(hart, vsetvli(11, 10, E32M1));
+    check("vsetvli e32 m1 avl 10", hart.x(11), 4);
+    run(hart, vsetvli(11, 0, E8M8));
+    check("vsetvli e8 m8 vlmax", hart.x(11), 128);
+    run(hart, vsetvli(0, 0, E32M2));
+    check("vsetvli keeps vl", hart._vl, 8);
+    run(hart, vsetvli(11, 10, E64MF2));
+    check("vsetvli e64 mf2 is illegal", hart._vtype >> 63, 1);
+    check("vsetvli illegal vl", hart.x(11), 0);
+    checkThrows(hart, "vadd with illegal vtype", vop(0x00, 1, 2, 4, OPIVV, 6));
+
+    // integer arithmetic over a two-register group of eight 32-bit elements
+    hart.x(10) = 8;
+    run(hart, vsetvli(0, 10, E32M2));
+    for (uint64_t e = 0; e < 8; e++) {
+        hart.vset<uint32_t>(2, e, static_cast<uint32_t>(e));
+        hart.vset<uint32_t>(4, e, static_cast<uint32_t>(10 * e) - 35);
+    }
+    run(hart, vop(0x00, 1, 2, 4, OPIVV, 6)); // vadd.vv v6, v2, v4
+    check("vadd.vv", hart.vget<uint32_t>(6, 7), 7 + 70 - 35);
+    hart.x(12) = 100;
+    run(hart, vop(0x02, 1, 2, 12, OPIVX, 6)); // vsub.vx v6, v2, a2
+    check("vsub.vx", hart.vget<uint32_t>(6, 3), static_cast<uint32_t>(3 - 100));
+    run(hart, vop(0x03, 1, 2, 0x1f, OPIVI, 6)); // vrsub.vi v6, v2, -1
+    check("vrsub.vi", hart.vget<uint32_t>(6, 5), static_cast<uint32_t>(-1 - 5));
+    run(hart, vop(0x05, 1, 4, 12, OPIVX, 6)); // vmin.vx v6, v4, a2
+    check("vmin.vx negative", hart.vget<uint32_t>(6, 0), static_cast<uint32_t>(-35));
+    check("vmin.vx positive", hart.vget<uint32_t>(6, 7), 35);
+    run(hart, vop(0x04, 1, 4, 12, OPIVX, 6)); // vminu.vx v6, v4, a2
+    check("vminu.vx", hart.vget<uint32_t>(6, 0), 100);
+    run(hart, vop(0x29, 1, 4, 2, OPIVI, 6)); // vsra.vi v6, v4, 2
+    check("vsra.vi", hart.vget<uint32_t>(6, 0), static_cast<uint32_t>(-9));
+    hart.x(12) = 33;
+    run(hart, vop(0x25, 1, 2, 12, OPIVX, 6)); // vsll.vx v6, v2, a2 shifts by 33 % 32
+    check("vsll.vx", hart.vget<uint32_t>(6, 3), 6);
+    run(hart, vop(0x21, 1, 4, 2, OPMVV, 6)); // vdiv.vv v6, v4, v2
+    check("vdiv.vv by zero", hart.vget<uint32_t>(6, 0), 0xffffffff);
+    check("vdiv.vv", hart.vget<uint32_t>(6, 4), 1);
+    run(hart, vop(0x23, 1, 4, 2, OPMVV, 6)); // vrem.vv v6, v4, v2
+    check("vrem.vv by zero", hart.vget<uint32_t>(6, 0), static_cast<uint32_t>(-35));
+    check("vrem.vv", hart.vget<uint32_t>(6, 4), 1);
+    for (uint64_t e = 0; e < 8; e++) {
+        hart.vset<uint32_t>(6, e, 1000);
+    }
+    run(hart, vop(0x2d, 1, 4, 2, OPMVV, 6)); // vmacc.vv v6, v2, v4
+    check("vmacc.vv", hart.vget<uint32_t>(6, 7), 1000 + 7 * 35);
+    checkThrows(hart, "vadd.vv to a misaligned group", vop(0x00, 1, 2, 4, OPIVV, 7));
+
+    // 64-bit high products
+    hart.x(10) = 2;
+    run(hart, vsetvli(0, 10, E64M1));
+    hart.vset<uint64_t>(2, 0, 0xffffffffffffffffull);
+    hart.vset<uint64_t>(2, 1, 0x8000000000000000ull);
+    hart.x(12) = 0xffffffffffffffffull;
+    run(hart, vop(0x27, 1, 2, 12, OPMVX, 6)); // vmulh.vx v6, v2, a2: -1 * -1
+    check("vmulh.vx", hart.vget<uint64_t>(6, 0), 0);
+    run(hart, vop(0x24, 1, 2, 12, OPMVX, 6)); // vmulhu.vx
+    check("vmulhu.vx", hart.vget<uint64_t>(6, 0), 0xfffffffffffffffeull);
+    run(hart, vop(0x26, 1, 2, 12, OPMVX, 6)); // vmulhsu.vx: -1 * (2^64 - 1)
+    check("vmulhsu.vx", hart.vget<uint64_t>(6, 0), 0xffffffffffffffffull);
+    run(hart, vop(0x21, 1, 2, 12, OPMVX, 6)); // vdiv.vx: INT64_MIN / -1
+    check("vdiv.vx overflow", hart.vget<uint64_t>(6, 1), 0x8000000000000000ull);
+
+    // compares write v0; masked-off elements are left alone
+    hart.x(10) = 8;
+    run(hart, vsetvli(0, 10, E32M2));
+    for (uint64_t e = 0; e < 8; e++) {
+        hart.vset<uint32_t>(2, e, static_cast<uint32_t>(e));
+    }
+    hart.x(12) = 4;
+    run(hart, vop(0x1b, 1, 2, 12, OPIVX, 0)); // vmslt.vx v0, v2, a2
+    check("vmslt.vx", hart._v[0], 0x0f);
+    for (uint64_t e = 0; e < 8; e++) {
+        hart.vset<uint32_t>(6, e, 7);
+    }
+    run(hart, vop(0x00, 0, 2, 5, OPIVI, 6)); // vadd.vi v6, v2, 5, v0.t
+    check("masked vadd.vi active", hart.vget<uint32_t>(6, 3), 8);
+    check("masked vadd.vi inactive", hart.vget<uint32_t>(6, 4), 7);
+    run(hart, vop(0x17, 0, 2, 0x1f, OPIVI, 6)); // vmerge.vim v6, v2, -1, v0
+    check("vmerge.vim v0 set", hart.vget<uint32_t>(6, 1), 0xffffffff);
+    check("vmerge.vim v0 clear", hart.vget<uint32_t>(6, 6), 6);
+    run(hart, vop(0x17, 1, 0, 12, OPIVX, 6)); // vmv.v.x v6, a2
+    check("vmv.v.x", hart.vget<uint32_t>(6, 6), 4);
+    run(hart, vop(0x10, 1, 0, 0x10, OPMVV, 13)); // vcpop.m a3, v0
+    check("vcpop.m", hart.x(13), 4);
+    run(hart, vop(0x1c, 1, 2, 12, OPIVX, 8)); // vmsleu.vx v8, v2, a2
+    run(hart, vop(0x18, 1, 8, 0, OPMVV, 9)); // vmandn.mm v9, v8, v0
+    run(hart, vop(0x10, 1, 9, 0x11, OPMVV, 13)); // vfirst.m a3, v9
+    check("vmandn.mm, vfirst.m", hart.x(13), 4);
+    run(hart, vop(0x14, 1, 0, 0x11, OPMVV, 10)); // vid.v v10
+    check("vid.v", hart.vget<uint32_t>(10, 5), 5);
+
+    // reductions
+    hart.vset<uint32_t>(12, 0, 1);
+    run(hart, vop(0x00, 1, 4, 12, OPMVV, 13)); // vredsum.vs v13, v4, v12
+    check("vredsum.vs", hart.vget<uint32_t>(13, 0), 1 + 280 - 8 * 35);
+    run(hart, vop(0x07, 0, 4, 12, OPMVV, 13)); // vredmax.vs v13, v4, v12, v0.t
+    check("masked vredmax.vs", hart.vget<uint32_t>(13, 0), 1);
+    run(hart, vop(0x10, 1, 4, 0, OPMVV, 13)); // vmv.x.s a3, v4
+    check("vmv.x.s sign extends", hart.x(13), static_cast<uint64_t>(-35));
+
+    // floating point
+    hart.x(10) = 2;
+    run(hart, vsetvli(0, 10, E64M1));
+    hart.vset<double>(2, 0, 1.5);
+    hart.vset<double>(2, 1, -2.0);
+    hart.vset<double>(6, 0, 10.0);
+    hart.vset<double>(6, 1, 10.0);
+    hart.df(1) = 4.0;
+    run(hart, vop(0x2c, 1, 2, 1, OPFVF, 6)); // vfmacc.vf v6, fa1, v2
+    check("vfmacc.vf", static_cast<uint64_t>(hart.vget<double>(6, 0)), 16);
+    check("vfmacc.vf negative", static_cast<uint64_t>(hart.vget<double>(6, 1)), 2);
+    run(hart, vop(0x1b, 1, 2, 1, OPFVF, 0)); // vmflt.vf v0, v2, fa1
+    check("vmflt.vf", hart._v[0] & 3, 3);
+    hart.x(10) = 4;
+    run(hart, vsetvli(0, 10, E32M1));
+    for (uint64_t e = 0; e < 4; e++) {
+        hart.vset<float>(4, e, 0.25f * (e + 1));
+    }
+    hart.vset<float>(5, 0, 100.0f);
+    run(hart, vop(0x03, 1, 4, 5, OPFVV, 7)); // vfredosum.vs v7, v4, v5
+    run(hart, vop(0x10, 1, 7, 0, OPFVV, 2)); // vfmv.f.s f2, v7
+    check("vfredosum.vs, vfmv.f.s", static_cast<uint64_t>(hart.sf(2) * 4), 410);
+    run(hart, vsetvli(0, 10, E8M8));
+    checkThrows(hart, "vfadd.vv at SEW=8", vop(0x00, 1, 2, 4, OPFVV, 6));
+
+    // no vector unit
+    RISCVHart scalar;
+    checkThrows(scalar, "vsetvli without a vector unit", vsetvli(11, 10, E32M1));
+
+    printf("%s: %" PRIu64 " checks, %" PRIu64 " mismatches\n",
+           mismatches == 0 ? "PASS" : "FAIL", checked, mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
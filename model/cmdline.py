@@ -35,6 +35,10 @@ def parser(core_l1sp_size=128*1024):
     p.add_argument("--pxn-dram-size", type=int, default=2*(1024**3), help=f"size of main memory per pxn (max {8*(2**30)} bytes)")
     p.add_argument("--pxn-dram-interleave", type=int, default=0, help="interleave size of dram addresses (defaults to no  interleaving)")
 
+    p.add_argument("--pod-barrier-latency", type=str, default="2ns", help="latency of the per-pod barrier unit")
+    p.add_argument("--pxn-barrier-latency", type=str, default="20ns", help="latency of the per-pxn barrier unit")
+    p.add_argument("--system-barrier-latency", type=str, default="200ns", help="latency of the cross-pxn barrier unit")
+
     p.add_argument("--without-pxn-dram-cache", action="store_true", help="disable dram cache")
     
     p.add_argument("--with-command-processor", type=str, default="",
@@ -939,6 +939,19 @@ def build_hammerblade(core_builder):
     # build the mesh
     mesh = mesh_builder.build()
 
+    # connect the cores to the pod's barrier unit
+    pod_barrier = sst.Component("pod_barrier", "Drv.DrvBarrier")
+    pod_barrier.addParams({
+        "children" : CORES_X*CORES_Y,
+        "latency" : ARGUMENTS.pod_barrier_latency,
+    })
+    for (i, (x,y)) in enumerate(core_coordinates()):
+        link = sst.Link(f"link_core_barrier_{x}_{y}_mesh0")
+        link.connect(
+            (mesh.tiles[(x,y)].core.core, "barrier", f'{CORE_CLOCK.cycle_ps}ps'),
+            (pod_barrier, f"child{i}", f'{CORE_CLOCK.cycle_ps}ps')
+        )
+
     # connect bus to vcs
     for (i, (x,y)) in enumerate(vcache_coordinates()):
         # connect vc to memory backend
@@ -110,6 +110,10 @@ class L1SPBuilder(MemoryBuilder):
         # make the command handler
         l1sp.cmdhandler = \
             l1sp.memctrl.setSubComponent("customCmdHandler", "Drv.DrvCmdMemHandler")
+        l1sp.cmdhandler.addParams({
+            "addr_range_start" : addr_start,
+            "addr_range_end" : addr_stop,
+        })
         
         # make the nic
         l1sp.nic = l1sp.memctrl.setSubComponent("cpulink", "memHierarchy.MemNIC")
@@ -191,6 +195,12 @@ class L2SPBuilder(MemoryBuilder):
 
         l2sp.cmdhandler = \
             l2sp.memctrl.setSubComponent("customCmdHandler", "Drv.DrvCmdMemHandler")
+        l2sp.cmdhandler.addParams({
+            "addr_range_start" : addr_start,
+            "addr_range_end" : addr_stop,
+            "interleave_size" : f'{addr_interleave_size}B',
+            "interleave_step" : f'{addr_interleave_step}B'
+        })
 
         l2sp.nic = l2sp.memctrl.setSubComponent("cpulink", "memHierarchy.MemNIC")
         l2sp.nic.addParams({
@@ -276,6 +286,10 @@ class DRAMBuilder(MemoryBuilder):
         dram.cmdhandler.addParams({
             "cache_line_size" : self.cache_line_size if self.is_coherent else 0,
             "shootdowns" : "true" if self.is_coherent else "false",
+            "addr_range_start" : addr_start,
+            "addr_range_end" : addr_stop,
+            "interleave_size" : f'{addr_interleave_size}B',
+            "interleave_step" : f'{addr_interleave_step}B',
         })
 
         return dram
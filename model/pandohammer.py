@@ -59,6 +59,7 @@ class PANDOHammer(object):
         pod.network_bw = f"{bandwidth_bytes_per_second_per_pod}B/s"
         pod.xbar_bw = f"{bandwidth_bytes_per_second_per_pod}B/s"
         pod.link_bw = f"{bandwidth_bytes_per_second_per_pod}B/s"
+        pod.barrier_latency = arguments.pod_barrier_latency
 
         # host core
         hostcore = RCoreBuilder()
@@ -93,11 +94,13 @@ class PANDOHammer(object):
         pxn.network_bw = f"{bandwidth_bytes_per_second_per_pxn}B/s"
         pxn.xbar_bw = f"{bandwidth_bytes_per_second_per_pxn}B/s"
         pxn.link_bw = f"{bandwidth_bytes_per_second_per_pxn}B/s"
+        pxn.barrier_latency = arguments.pxn_barrier_latency
 
         # system
         system = SystemBuilder()
         system.pxn = pxn
         system.pxns = arguments.num_pxn
+        system.barrier_latency = arguments.system_barrier_latency
         self.system = system
 
         return
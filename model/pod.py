@@ -15,6 +15,7 @@ class Pod(object):
         self.cores = []
         self.l2sp_banks = []
         self.bridge = None
+        self.barrier = None
         self.id = 0
         return
     
@@ -25,6 +26,13 @@ class Pod(object):
         """
         return (self.bridge, "network1")
 
+    def barrier_interface(self):
+        """
+        Returns the barrier unit and the port to its parent
+        (component, portname) pair
+        """
+        return (self.barrier, "parent")
+
 class PodBuilder(object):
     """
     A base class for a pod builder
@@ -44,6 +52,7 @@ class PodBuilder(object):
         self.output_buf_size = "1KB"
         self.router_latency = "0ns"
         self.network_bw = "1GB/s"
+        self.barrier_latency = "2ns"
         return
 
     @property
@@ -89,6 +98,12 @@ class PodBuilder(object):
         """
         return f"{name}_bridge"
 
+    def barrier_name(self, name):
+        """
+        Returns the barrier unit name
+        """
+        return f"{name}_barrier"
+
     def ports(self):
         """
         Returns the number of ports
@@ -160,4 +175,17 @@ class PodBuilder(object):
             (pod.bridge, "network0", "1ns")
         )
 
+        # build the barrier unit for the cores
+        pod.barrier = sst.Component(self.barrier_name(name), "Drv.DrvBarrier")
+        pod.barrier.addParams({
+            "children" : self.cores,
+            "latency" : self.barrier_latency,
+        })
+        for core_id, core in enumerate(pod.cores):
+            link = sst.Link(f"link_{core.name}_{self.barrier_name(name)}")
+            link.connect(
+                (core.core.component, "barrier", "1ns"),
+                (pod.barrier, f"child{core_id}", "1ns")
+            )
+
         return pod
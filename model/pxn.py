@@ -19,6 +19,7 @@ class PXN(object):
         self.hostcore = None
         self.network = None
         self.bridge = None
+        self.barrier = None
         self.name = name
         return
 
@@ -29,6 +30,13 @@ class PXN(object):
         """
         return (self.bridge, "network1")
 
+    def barrier_interface(self):
+        """
+        Returns the barrier unit and the port to its parent
+        (component, portname) pair
+        """
+        return (self.barrier, "parent")
+
 class PXNBuilder(object):
     """
     A base class for a pxn builder
@@ -52,6 +60,7 @@ class PXNBuilder(object):
         self.input_buf_size = "1KB"
         self.output_buf_size = "1KB"
         self.router_latency = "0ns"
+        self.barrier_latency = "20ns"
         return
 
     @property
@@ -99,6 +108,12 @@ class PXNBuilder(object):
         """
         return name + "_bridge"
 
+    def barrier_name(self, name):
+        """
+        Get the barrier unit name
+        """
+        return name + "_barrier"
+
     def ports(self):
         """
         Get the number of ports
@@ -187,4 +202,18 @@ class PXNBuilder(object):
             (bridge, "network0", "1ns")
         )        
         pxn.bridge = bridge
+
+        # build the barrier unit for the pods
+        pxn.barrier = sst.Component(self.barrier_name(name), "Drv.DrvBarrier")
+        pxn.barrier.addParams({
+            "children" : self.pods,
+            "latency" : self.barrier_latency,
+        })
+        for pod_id, pod in enumerate(pxn.pods):
+            barrier, port = pod.barrier_interface()
+            link = sst.Link(f"{pod.name}_to_{self.barrier_name(name)}")
+            link.connect(
+                (barrier, port, "1ns"),
+                (pxn.barrier, f"child{pod_id}", "1ns")
+            )
         return pxn
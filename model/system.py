@@ -14,6 +14,7 @@ class System(object):
         Initialize the system
         """
         self.pxns = []
+        self.barrier = None
         self.name = name
         return
 
@@ -32,6 +33,7 @@ class SystemBuilder(object):
         self.input_buf_size = "1KB"
         self.output_buf_size = "1KB"
         self.router_latency = "1ns"
+        self.barrier_latency = "200ns"
         return
 
     def addressmap(self):
@@ -56,6 +58,12 @@ class SystemBuilder(object):
         """
         return name + "_network"
 
+    def barrier_name(self, name):
+        """
+        Get the barrier unit name
+        """
+        return name + "_barrier"
+
     def pxn_name(self, name, pxn_id):
         """
         Get the PXN name
@@ -98,6 +106,22 @@ class SystemBuilder(object):
             )
             system.pxns.append(pxn)
 
+        # build the root of the barrier network across pxns
+        # with a single pxn its unit is the root
+        if self.pxns > 1:
+            system.barrier = sst.Component(self.barrier_name(name), "Drv.DrvBarrier")
+            system.barrier.addParams({
+                "children" : self.pxns,
+                "latency" : self.barrier_latency,
+            })
+            for pxn_id, pxn in enumerate(system.pxns):
+                barrier, port = pxn.barrier_interface()
+                link = sst.Link(f"{pxn.name}_to_{self.barrier_name(name)}")
+                link.connect(
+                    (barrier, port, "1ns"),
+                    (system.barrier, f"child{pxn_id}", "1ns")
+                )
+
         return system
 
     
@@ -18,39 +18,15 @@ namespace pandocommand
 void loadProgramSegment(PANDOHammerExe &executable, Elf64_Phdr *phdr, DrvAPIAddress segpaddr) {
     DrvAPIAddressInfo decode = decodeAddress(segpaddr);
     printf("Loading segment @ 0x%016" PRIx64 " (%s)\n", segpaddr, decode.to_string().c_str());
-    size_t segsz = phdr->p_filesz;
-    static constexpr size_t MAX_REQSZ = 64;
     char *data = executable.segment_data(phdr);
-    size_t off = 0;
     // send segment data
-    for (; off < phdr->p_filesz && (off % MAX_REQSZ); off += 1) {
-        dbg("writing  1 byte to 0x%016" PRIx64 "\n", segpaddr + off);
-        DrvAPI::write<char>(segpaddr + off, data[off]);
-    }
-    for (; off + MAX_REQSZ <= phdr->p_filesz; off += MAX_REQSZ) {
-        std::array<char, MAX_REQSZ> request;
-        memcpy(&request[0], &data[off], MAX_REQSZ);
-        dbg("writing %zu bytes to 0x%016" PRIx64 "\n", MAX_REQSZ, segpaddr + off);
-        DrvAPI::write(segpaddr + off, request);
-    }
-    for (; off < phdr->p_filesz; off += 1) {
-        dbg("writing  1 byte to 0x%016" PRIx64 "\n", segpaddr + off);
-        DrvAPI::write(segpaddr + off, data[off]);
-    }
+    dbg("writing %" PRIu64 " bytes to 0x%016" PRIx64 "\n", (uint64_t)phdr->p_filesz, segpaddr);
+    DrvAPI::write_block(segpaddr, data, phdr->p_filesz);
     // send zero data
-    for (; off < phdr->p_memsz && (off % MAX_REQSZ); off += 1) {
-        dbg("writing  1 byte to 0x%016" PRIx64 "\n", segpaddr + off);
-        DrvAPI::write<char>(segpaddr + off, 0);
-    }
-    for (; off + MAX_REQSZ <= phdr->p_memsz; off += MAX_REQSZ) {
-        dbg("writing %zu bytes to 0x%016" PRIx64 "\n", MAX_REQSZ, segpaddr + off);
-        std::array<char, MAX_REQSZ> request;
-        request.fill(0);
-        DrvAPI::write(segpaddr + off, request);
-    }
-    for (; off < phdr->p_memsz; off += 1) {
-        dbg("writing  1 byte to 0x%016" PRIx64 "\n", segpaddr + off);
-        DrvAPI::write<char>(segpaddr + off, 0);
+    if (phdr->p_memsz > phdr->p_filesz) {
+        dbg("zeroing %" PRIu64 " bytes at 0x%016" PRIx64 "\n",
+            (uint64_t)(phdr->p_memsz - phdr->p_filesz), segpaddr + phdr->p_filesz);
+        DrvAPI::memset(segpaddr + phdr->p_filesz, 0, phdr->p_memsz - phdr->p_filesz);
     }
 }
 
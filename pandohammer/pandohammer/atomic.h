@@ -17,6 +17,144 @@ static inline int64_t atomic_fetch_add_i64(volatile int64_t *ptr, int64_t val)
     asm volatile("amoadd.d %0, %2, 0(%1)" : "=r"(ret): "r"(ptr) , "r"(val));
     return ret;
 }
+static inline int32_t atomic_fetch_and_i32(volatile int32_t *ptr, int32_t val)
+{
+    int32_t ret;
+    asm volatile("amoand.w %0, %2, 0(%1)" : "=r"(ret): "r"(ptr) , "r"(val));
+    return ret;
+}
+
+static inline int64_t atomic_fetch_and_i64(volatile int64_t *ptr, int64_t val)
+{
+    int64_t ret;
+    asm volatile("amoand.d %0, %2, 0(%1)" : "=r"(ret): "r"(ptr) , "r"(val));
+    return ret;
+}
+
+static inline int32_t atomic_fetch_xor_i32(volatile int32_t *ptr, int32_t val)
+{
+    int32_t ret;
+    asm volatile("amoxor.w %0, %2, 0(%1)" : "=r"(ret): "r"(ptr) , "r"(val));
+    return ret;
+}
+
+static inline int64_t atomic_fetch_xor_i64(volatile int64_t *ptr, int64_t val)
+{
+    int64_t ret;
+    asm volatile("amoxor.d %0, %2, 0(%1)" : "=r"(ret): "r"(ptr) , "r"(val));
+    return ret;
+}
+
+static inline int32_t atomic_fetch_or_i32(volatile int32_t *ptr, int32_t val)
+{
+    int32_t ret;
+    asm volatile("amoor.w %0, %2, 0(%1)" : "=r"(ret): "r"(ptr) , "r"(val));
+    return ret;
+}
+
+static inline int64_t atomic_fetch_or_i64(volatile int64_t *ptr, int64_t val)
+{
+    int64_t ret;
+    asm volatile("amoor.d %0, %2, 0(%1)" : "=r"(ret): "r"(ptr) , "r"(val));
+    return ret;
+}
+
+static inline int32_t atomic_fetch_min_i32(volatile int32_t *ptr, int32_t val)
+{
+    int32_t ret;
+    asm volatile("amomin.w %0, %2, 0(%1)" : "=r"(ret): "r"(ptr) , "r"(val));
+    return ret;
+}
+
+static inline int64_t atomic_fetch_min_i64(volatile int64_t *ptr, int64_t val)
+{
+    int64_t ret;
+    asm volatile("amomin.d %0, %2, 0(%1)" : "=r"(ret): "r"(ptr) , "r"(val));
+    return ret;
+}
+
+static inline int32_t atomic_fetch_max_i32(volatile int32_t *ptr, int32_t val)
+{
+    int32_t ret;
+    asm volatile("amomax.w %0, %2, 0(%1)" : "=r"(ret): "r"(ptr) , "r"(val));
+    return ret;
+}
+
+static inline int64_t atomic_fetch_max_i64(volatile int64_t *ptr, int64_t val)
+{
+    int64_t ret;
+    asm volatile("amomax.d %0, %2, 0(%1)" : "=r"(ret): "r"(ptr) , "r"(val));
+    return ret;
+}
+
+static inline uint32_t atomic_fetch_min_u32(volatile uint32_t *ptr, uint32_t val)
+{
+    uint32_t ret;
+    asm volatile("amominu.w %0, %2, 0(%1)" : "=r"(ret): "r"(ptr) , "r"(val));
+    return ret;
+}
+
+static inline uint64_t atomic_fetch_min_u64(volatile uint64_t *ptr, uint64_t val)
+{
+    uint64_t ret;
+    asm volatile("amominu.d %0, %2, 0(%1)" : "=r"(ret): "r"(ptr) , "r"(val));
+    return ret;
+}
+
+static inline uint32_t atomic_fetch_max_u32(volatile uint32_t *ptr, uint32_t val)
+{
+    uint32_t ret;
+    asm volatile("amomaxu.w %0, %2, 0(%1)" : "=r"(ret): "r"(ptr) , "r"(val));
+    return ret;
+}
+
+static inline uint64_t atomic_fetch_max_u64(volatile uint64_t *ptr, uint64_t val)
+{
+    uint64_t ret;
+    asm volatile("amomaxu.d %0, %2, 0(%1)" : "=r"(ret): "r"(ptr) , "r"(val));
+    return ret;
+}
+
+static inline float atomic_fetch_add_f32(volatile float *ptr, float val)
+{
+    // address to rs1 (= t3 [x28])
+    // val     to rs2 (= t4 [x29])
+    // output  to rd  (= t6 [x31])
+    union {
+        float f;
+        int32_t i;
+    } in, out;
+    in.f = val;
+    asm volatile("mv x28, %1\n"
+                 "mv x29, %2\n"
+                 ".word 0x01de6fab\n"
+                 "mv %0, x31\n"
+                 : "=r"(out.i)
+                 : "r"(ptr), "r"(in.i)
+                 : "x28", "x29", "x31", "memory");
+    return out.f;
+}
+
+static inline double atomic_fetch_add_f64(volatile double *ptr, double val)
+{
+    // address to rs1 (= t3 [x28])
+    // val     to rs2 (= t4 [x29])
+    // output  to rd  (= t6 [x31])
+    union {
+        double f;
+        int64_t i;
+    } in, out;
+    in.f = val;
+    asm volatile("mv x28, %1\n"
+                 "mv x29, %2\n"
+                 ".word 0x01de7fab\n"
+                 "mv %0, x31\n"
+                 : "=r"(out.i)
+                 : "r"(ptr), "r"(in.i)
+                 : "x28", "x29", "x31", "memory");
+    return out.f;
+}
+
 static inline int32_t atomic_swap_i32(volatile int32_t *ptr, int32_t val)
 {
     int32_t ret;
@@ -0,0 +1,29 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+
+#ifndef PANDOHAMMER_HARTBARRIER_H
+#define PANDOHAMMER_HARTBARRIER_H
+#include <stdint.h>
+#include <pandohammer/register.h>
+#include <pandohammer/stringify.h>
+
+/**
+ * wait at the barrier network until every hart has arrived
+ *
+ * returns the sum of value over all harts
+ */
+static inline int64_t hartallreduce_add(int64_t value)
+{
+    int64_t sum;
+    asm volatile ("csrrw %0, " __stringify(MCSR_BARRIER) ", %1" : "=r"(sum) : "r"(value) : "memory");
+    return sum;
+}
+
+/**
+ * wait at the barrier network until every hart has arrived
+ */
+static inline void hartbarrier(void)
+{
+    hartallreduce_add(0);
+}
+#endif
@@ -0,0 +1,38 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 University of Washington
+
+#ifndef PANDOHAMMER_HARTWAIT_H
+#define PANDOHAMMER_HARTWAIT_H
+#include <stdint.h>
+#include <pandohammer/register.h>
+#include <pandohammer/stringify.h>
+
+/**
+ * park this hart until *addr == expected
+ *
+ * the hart is parked at the memory that owns addr and woken
+ * when a write or atomic touches it; returns the value read
+ */
+static inline int64_t hartwait_i64(volatile int64_t *addr, int64_t expected)
+{
+    int64_t v;
+    asm volatile ("csrw " __stringify(MCSR_WAITADDR) ", %0" : : "r"(addr));
+    do {
+        asm volatile ("csrrw %0, " __stringify(MCSR_WAIT64) ", %1" : "=r"(v) : "r"(expected) : "memory");
+    } while (v != expected);
+    return v;
+}
+
+/**
+ * park this hart until *addr == expected
+ */
+static inline int32_t hartwait_i32(volatile int32_t *addr, int32_t expected)
+{
+    int64_t v;
+    asm volatile ("csrw " __stringify(MCSR_WAITADDR) ", %0" : : "r"(addr));
+    do {
+        asm volatile ("csrrw %0, " __stringify(MCSR_WAIT32) ", %1" : "=r"(v) : "r"((int64_t)expected) : "memory");
+    } while ((int32_t)v != expected);
+    return (int32_t)v;
+}
+#endif
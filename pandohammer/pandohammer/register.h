@@ -3,6 +3,10 @@
 
 #define MCSR_SLEEP     0x7A5
 #define MCSR_L1SPBASE  0x7A6
+#define MCSR_WAITADDR  0x7A7
+#define MCSR_WAIT64    0x7A8
+#define MCSR_WAIT32    0x7A9
+#define MCSR_BARRIER   0x7AA
 
 #define MCSR_MCOREID    0xF15
 #define MCSR_MPODID     0xF16